@@ -0,0 +1,248 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/concepts.h>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace hexi {
+
+namespace impl {
+
+constexpr std::size_t max_aggregate_fields = 32;
+
+// converts to anything, used to probe how many initialisers an aggregate takes
+struct any_field {
+	template<typename T>
+	operator T() const;
+};
+
+/*
+ * Counts the fields of an aggregate by finding the largest number of
+ * initialisers it can be brace-initialised with. Built-in array members are
+ * brace-elided and would be counted once per element, so aren't supported.
+ * std::array should be used instead.
+ */
+template<typename T, typename... Fields>
+consteval std::size_t count_fields() {
+	if constexpr(sizeof...(Fields) > max_aggregate_fields) {
+		return sizeof...(Fields);
+	} else if constexpr(requires { T { Fields{}..., any_field{} }; }) {
+		return count_fields<T, Fields..., any_field>();
+	} else {
+		return sizeof...(Fields);
+	}
+}
+
+template<typename T>
+constexpr std::size_t field_count = count_fields<T>();
+
+/*
+ * Calls func with a reference to each field of the aggregate, in declaration order.
+ */
+template<typename T, typename Func>
+constexpr decltype(auto) visit_fields(T& object, Func&& func) {
+	constexpr auto count = field_count<std::remove_const_t<T>>;
+	static_assert(count > 0 && count <= max_aggregate_fields, "unsupported aggregate");
+
+	if constexpr(count == 1) {
+		auto& [f0] = object;
+		return func(f0);
+	} else if constexpr(count == 2) {
+		auto& [f0, f1] = object;
+		return func(f0, f1);
+	} else if constexpr(count == 3) {
+		auto& [f0, f1, f2] = object;
+		return func(f0, f1, f2);
+	} else if constexpr(count == 4) {
+		auto& [f0, f1, f2, f3] = object;
+		return func(f0, f1, f2, f3);
+	} else if constexpr(count == 5) {
+		auto& [f0, f1, f2, f3, f4] = object;
+		return func(f0, f1, f2, f3, f4);
+	} else if constexpr(count == 6) {
+		auto& [f0, f1, f2, f3, f4, f5] = object;
+		return func(f0, f1, f2, f3, f4, f5);
+	} else if constexpr(count == 7) {
+		auto& [f0, f1, f2, f3, f4, f5, f6] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6);
+	} else if constexpr(count == 8) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7);
+	} else if constexpr(count == 9) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+	} else if constexpr(count == 10) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+	} else if constexpr(count == 11) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+	} else if constexpr(count == 12) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+	} else if constexpr(count == 13) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+	} else if constexpr(count == 14) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+	} else if constexpr(count == 15) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+	} else if constexpr(count == 16) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+	} else if constexpr(count == 17) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16);
+	} else if constexpr(count == 18) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17);
+	} else if constexpr(count == 19) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18);
+	} else if constexpr(count == 20) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19);
+	} else if constexpr(count == 21) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20);
+	} else if constexpr(count == 22) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21);
+	} else if constexpr(count == 23) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22);
+	} else if constexpr(count == 24) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23);
+	} else if constexpr(count == 25) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24);
+	} else if constexpr(count == 26) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25);
+	} else if constexpr(count == 27) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26);
+	} else if constexpr(count == 28) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27);
+	} else if constexpr(count == 29) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28);
+	} else if constexpr(count == 30) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29);
+	} else if constexpr(count == 31) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30);
+	} else if constexpr(count == 32) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31);
+	}
+}
+
+struct field_types {
+	template<typename... Fields>
+	constexpr auto operator()(Fields&...) const {
+		return std::type_identity<std::tuple<std::remove_cvref_t<Fields>...>>{};
+	}
+};
+
+/*
+ * Works out where each field of an aggregate sits in memory from the sizes
+ * and alignments of the field types, which is how every mainstream ABI lays
+ * out a class with no bases. If the result doesn't add up to the size of the
+ * aggregate, the layout is flagged as unknown and no assumptions are made.
+ */
+template<typename T>
+struct aggregate_layout {
+	using types = typename decltype(visit_fields(std::declval<T&>(), field_types{}))::type;
+
+	static constexpr std::size_t count = std::tuple_size_v<types>;
+
+private:
+	template<std::size_t... I>
+	static consteval auto sizes(std::index_sequence<I...>) {
+		return std::array<std::size_t, count> { sizeof(std::tuple_element_t<I, types>)... };
+	}
+
+	template<std::size_t... I>
+	static consteval auto alignments(std::index_sequence<I...>) {
+		return std::array<std::size_t, count> { alignof(std::tuple_element_t<I, types>)... };
+	}
+
+	static consteval auto offsets() {
+		const auto size = sizes(std::make_index_sequence<count>());
+		const auto align = alignments(std::make_index_sequence<count>());
+		std::array<std::size_t, count> result{};
+		std::size_t offset = 0;
+
+		for(std::size_t i = 0; i < count; ++i) {
+			offset = (offset + align[i] - 1) / align[i] * align[i];
+			result[i] = offset;
+			offset += size[i];
+		}
+
+		return result;
+	}
+
+	static consteval bool verify() {
+		constexpr auto size = sizes(std::make_index_sequence<count>());
+		constexpr auto offset = offsets();
+		const auto end = offset[count - 1] + size[count - 1];
+		return (end + alignof(T) - 1) / alignof(T) * alignof(T) == sizeof(T);
+	}
+
+public:
+	static constexpr auto size = sizes(std::make_index_sequence<count>());
+	static constexpr auto offset = offsets();
+	static constexpr bool known = verify();
+
+	/*
+	 * For each field, finds the end of the run of fields starting there that
+	 * can be copied as a single block of memory, given which field types are
+	 * eligible. A field that can't be coalesced is a run of one.
+	 */
+	static consteval auto runs(const std::array<bool, count>& eligible) {
+		std::array<std::size_t, count> end{};
+
+		for(std::size_t i = 0; i < count; ++i) {
+			end[i] = i + 1;
+
+			if(!known || !eligible[i]) {
+				continue;
+			}
+
+			while(end[i] < count && eligible[end[i]]
+				&& offset[end[i]] == offset[end[i] - 1] + size[end[i] - 1]) {
+				++end[i];
+			}
+		}
+
+		return end;
+	}
+};
+
+} // impl
+
+/*
+ * Aggregates that can be serialised field by field without having to write
+ * a serialise function. POD types are excluded, as they're copied as a whole.
+ */
+template<typename T>
+concept field_serialisable = std::is_aggregate_v<T> && !std::is_array_v<T>
+	&& !pod<T> && !is_iterable<T>
+	&& impl::field_count<T> > 0 && impl::field_count<T> <= impl::max_aggregate_fields;
+
+} // hexi
@@ -6,16 +6,32 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <concepts>
+#include <iterator>
 #include <memory>
 #include <new>
 #include <thread>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define HEXI_HAS_MMAP
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HEXI_HAS_NUMA
+#endif
+
 #ifndef NDEBUG
 #define HEXI_DEBUG_ALLOCATORS
 #endif
@@ -34,11 +50,222 @@ concept gt_zero = size > 0;
 template<typename T, typename U>
 concept sizeof_gte = sizeof(T) >= sizeof(U);
 
+constexpr std::size_t page_size = 4096;
+constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+constexpr std::size_t round_up(std::size_t value, std::size_t multiple) {
+	return (value + multiple - 1) / multiple * multiple;
+}
+
+/*
+ * @return The NUMA node the calling thread is currently running on or -1
+ * if it cannot be determined.
+ */
+inline int current_numa_node() {
+#if defined(HEXI_HAS_NUMA) && defined(SYS_getcpu)
+	unsigned int cpu = 0, node = 0;
+
+	if(::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+		return static_cast<int>(node);
+	}
+#endif
+	return -1;
+}
+
+/*
+ * Sets a preferred node policy on a page aligned range that has not yet
+ * been touched. Preferred rather than strict binding is used so that an
+ * exhausted node results in remote memory rather than an OOM kill.
+ *
+ * @return True if the policy was applied.
+ */
+inline bool numa_bind(void* ptr, std::size_t length, int node) {
+#if defined(HEXI_HAS_NUMA) && defined(SYS_mbind)
+	constexpr int mpol_preferred = 1;
+	constexpr auto mask_bits = sizeof(unsigned long) * 8;
+
+	if(node < 0 || static_cast<std::size_t>(node) >= mask_bits) {
+		return false;
+	}
+
+	const unsigned long mask = 1ul << node;
+	return ::syscall(SYS_mbind, ptr, length, mpol_preferred, &mask, mask_bits + 1, 0) == 0;
+#else
+	return false;
+#endif
+}
+
+/*
+ * Slab embedded directly within the allocator object.
+ */
+template<std::size_t size, std::size_t alignment>
+class inline_slab_storage final {
+	alignas(alignment) std::array<char, size> storage_;
+
+public:
+	char* data() {
+		return storage_.data();
+	}
+
+	const char* data() const {
+		return storage_.data();
+	}
+
+	bool huge_pages() const {
+		return false;
+	}
+
+	// relies on first-touch placement
+	bool bind(int /*node*/) {
+		return false;
+	}
+};
+
+/*
+ * Slab obtained directly from the OS with anonymous mappings. If huge pages
+ * are requested, an explicit MAP_HUGETLB mapping is tried first and if no
+ * huge pages have been reserved, the slab falls back to a huge page aligned
+ * regular mapping with transparent huge pages requested via madvise.
+ *
+ * Platforms without mmap fall back to an aligned operator new.
+ */
+template<std::size_t size, std::size_t alignment, bool use_huge_pages>
+class mapped_slab_storage final {
+	static_assert(alignment <= page_size, "mapped slabs are page aligned at most");
+
+	static constexpr std::size_t map_size = use_huge_pages?
+		round_up(size, huge_page_size) : round_up(size, page_size);
+
+	char* storage_ = nullptr;
+	bool huge_ = false;
+
+#ifdef HEXI_HAS_MMAP
+	static char* map(std::size_t length, int flags = 0) {
+		auto ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+		                  MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+		return ptr == MAP_FAILED? nullptr : static_cast<char*>(ptr);
+	}
+
+	// over-map and trim so the slab starts on a huge page boundary
+	static char* map_aligned_thp() {
+		constexpr auto length = map_size + huge_page_size;
+		auto base = map(length);
+
+		if(!base) {
+			return nullptr;
+		}
+
+		const auto addr = reinterpret_cast<std::uintptr_t>(base);
+		const auto aligned = round_up(addr, huge_page_size);
+		const auto head = aligned - addr;
+		const auto tail = length - head - map_size;
+
+		if(head) {
+			::munmap(base, head);
+		}
+
+		if(tail) {
+			::munmap(base + head + map_size, tail);
+		}
+
+		auto slab = base + head;
+#ifdef MADV_HUGEPAGE
+		::madvise(slab, map_size, MADV_HUGEPAGE);
+#endif
+		return slab;
+	}
+#endif
+
+public:
+	mapped_slab_storage() {
+#ifdef HEXI_HAS_MMAP
+		if constexpr(use_huge_pages) {
+#ifdef MAP_HUGETLB
+			storage_ = map(map_size, MAP_HUGETLB);
+			huge_ = storage_ != nullptr;
+#endif
+			if(!storage_) {
+				storage_ = map_aligned_thp();
+			}
+		} else {
+			storage_ = map(map_size);
+		}
+
+		if(!storage_) {
+			throw std::bad_alloc();
+		}
+#else
+		storage_ = static_cast<char*>(
+			::operator new(map_size, std::align_val_t(alignment))
+		);
+#endif
+	}
+
+	mapped_slab_storage(const mapped_slab_storage&) = delete;
+	mapped_slab_storage& operator=(const mapped_slab_storage&) = delete;
+
+	~mapped_slab_storage() {
+#ifdef HEXI_HAS_MMAP
+		::munmap(storage_, map_size);
+#else
+		::operator delete(storage_, std::align_val_t(alignment));
+#endif
+	}
+
+	char* data() {
+		return storage_;
+	}
+
+	const char* data() const {
+		return storage_;
+	}
+
+	/**
+	 * @return True if the slab is backed by explicitly reserved huge pages.
+	 * Transparent huge pages are a best-effort request and are not reported.
+	 */
+	bool huge_pages() const {
+		return huge_;
+	}
+
+	/**
+	 * @brief Requests that the slab's pages be placed on the given NUMA node.
+	 * Must be called before the slab is first touched.
+	 * 
+	 * @param node The NUMA node.
+	 * 
+	 * @return True if the placement policy was applied.
+	 */
+	bool bind(int node) {
+#ifdef HEXI_HAS_MMAP
+		return numa_bind(storage_, map_size, node);
+#else
+		return false;
+#endif
+	}
+};
+
 } // impl
 
 struct no_validate_dealloc {};
 struct validate_dealloc : no_validate_dealloc {};
 
+struct natural_alignment {
+	static constexpr std::size_t alignment = 1;
+};
+
+struct cache_line_alignment : natural_alignment {
+	static constexpr std::size_t alignment = 64;
+};
+
+struct page_alignment : natural_alignment {
+	static constexpr std::size_t alignment = impl::page_size;
+};
+
+struct inline_slab {};
+struct mapped_slab : inline_slab {};
+struct huge_page_slab : inline_slab {};
+
 /**
  * Basic fixed-size block stack allocator that preallocates a slab of memory
  * capable of holding a compile-time determined number of elements.
@@ -52,44 +279,71 @@ struct validate_dealloc : no_validate_dealloc {};
  * the initial allocation correctly is important for maximum performance, so
  * it's better to be pessimistic. This is a server application and RAM is cheap. :)
  *
- * PagePolicy: 'lock' requests that the OS does not page out the memory slab to disk.
+ * The slab is carved up lazily. Blocks that have never been handed out are
+ * taken from a bump pointer, with the free list only holding blocks that
+ * have been returned, so untouched capacity costs nothing until it's needed.
+ * prefault() can be used to pay for faulting in the slab up front instead.
+ *
+ * Blocks in the slab carry no inline metadata. Whether a block came from
+ * the slab is determined by its address and any per-block bookkeeping lives
+ * in a side table, so the objects are packed at exactly the requested stride.
  *
  * ThreadPolicy: 'same_thread' triggers an assert if an allocated object
  * is deallocated from a different thread. Used by the TLS allocator, since
  * implementing the functionality there is messier (and slower).
+ *
+ * Other threads may hand blocks back with deallocate_remote(), which is
+ * thread-safe. Such blocks are reclaimed by the owning thread once its
+ * free list runs dry.
+ *
+ * AlignPolicy: 'cache_line_alignment' and 'page_alignment' round the block
+ * stride up to the given boundary so that no two blocks share a line/page.
+ *
+ * SlabPolicy: 'inline_slab' embeds the slab within the allocator, 'mapped_slab'
+ * requests it from the OS and 'huge_page_slab' additionally requests that
+ * it be backed by huge pages to reduce TLB pressure with large pools.
  */
 template<typename _ty, 
 	std::size_t _elements,
-	std::derived_from<no_validate_dealloc> ValidatePolicy = no_validate_dealloc>
+	std::derived_from<no_validate_dealloc> ValidatePolicy = no_validate_dealloc,
+	std::derived_from<natural_alignment> AlignPolicy = natural_alignment,
+	std::derived_from<inline_slab> SlabPolicy = inline_slab>
 requires impl::gt_zero<_elements> && impl::sizeof_gte<_ty, impl::free_block>
 class block_allocator {
-	using tid_type = std::conditional_t<
-		std::is_same_v<ValidatePolicy, validate_dealloc>, std::thread::id, std::monostate
+	static constexpr bool validate = std::is_same_v<ValidatePolicy, validate_dealloc>;
+
+	using tid_type = std::conditional_t<validate, std::thread::id, std::monostate>;
+
+public:
+	static constexpr std::size_t alignment = std::max(alignof(_ty), AlignPolicy::alignment);
+	static constexpr std::size_t block_size = impl::round_up(sizeof(_ty), alignment);
+	static constexpr std::size_t slab_size = block_size * _elements;
+
+private:
+	using slab_type = std::conditional_t<
+		std::is_same_v<SlabPolicy, inline_slab>,
+		impl::inline_slab_storage<slab_size, alignment>,
+		impl::mapped_slab_storage<slab_size, alignment, std::is_same_v<SlabPolicy, huge_page_slab>>
 	>;
 
-	struct mem_block {
-		_ty obj;
+	using side_table = std::conditional_t<
+		validate, std::array<std::thread::id, _elements>, std::monostate
+	>;
 
-		struct {
-			[[no_unique_address]] tid_type thread_id;
-			bool using_new;
-		} meta;
+	// only used when the slab has been exhausted
+	struct heap_block {
+		alignas(alignment) _ty obj;
+		block_allocator* owner;
+		[[no_unique_address]] tid_type thread_id;
 	};
 
-	static constexpr auto block_size = sizeof(mem_block);
-
 	impl::free_block* head_ = nullptr;
+	std::size_t bump_ = 0; // index of the first block never handed out
+	std::atomic<impl::free_block*> remote_head_ = nullptr;
+	int numa_node_ = -1;
 	[[no_unique_address]] tid_type thread_id_;
-	std::array<char, block_size * _elements> storage_;
-
-	void initialise_free_list() {
-		auto storage = storage_.data();
-
-		for(std::size_t i = 0; i < _elements; ++i) {
-			auto block = reinterpret_cast<impl::free_block*>(storage + (block_size * i));
-			push(block);
-		}
-	}
+	[[no_unique_address]] side_table owners_{};
+	slab_type slab_;
 
 	inline void push(impl::free_block* block) {
 		assert(block);
@@ -97,14 +351,72 @@ class block_allocator {
 		head_ = block;
 	}
 
-	[[nodiscard]] inline impl::free_block* pop() {
-		if(!head_) {
-			return nullptr;
+	[[nodiscard]] inline void* pop() {
+		if(head_) [[likely]] {
+			auto block = head_;
+			head_ = block->next;
+			return block;
+		}
+
+		if(bump_ < _elements) {
+			return slab_.data() + (block_size * bump_++);
+		}
+
+		return nullptr;
+	}
+
+	inline void validate_slab_block(const void* ptr) const {
+		if constexpr(validate) {
+			assert(owners_[slab_index(ptr)] == thread_id_
+				&& "thread policy violation or clobbered block");
+		}
+	}
+
+	// returns a block that has already been destroyed to the slab or heap
+	inline void release(void* ptr) {
+		if(owns(ptr)) [[likely]] {
+			validate_slab_block(ptr);
+#ifdef HEXI_DEBUG_ALLOCATORS
+			--storage_active_count;
+#endif
+			push(static_cast<impl::free_block*>(ptr));
+		} else {
+			auto block = static_cast<heap_block*>(ptr);
+			assert(block->owner == this && "block belongs to another allocator");
+
+			if constexpr(validate) {
+				assert(block->thread_id == thread_id_
+					&& "thread policy violation or clobbered block");
+			}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+			--new_active_count;
+#endif
+			::operator delete(block, std::align_val_t(alignof(heap_block)));
+		}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_deallocs;
+		--active_count;
+#endif
+	}
+
+	void drain_remote() {
+		auto block = remote_head_.exchange(nullptr, std::memory_order_acquire);
+
+		while(block) {
+			auto next = block->next;
+			release(block);
+			block = next;
+#ifdef HEXI_DEBUG_ALLOCATORS
+			++remote_frees;
+#endif
 		}
+	}
 
-		auto block = head_;
-		head_ = block->next;
-		return block;
+	inline std::size_t slab_index(const void* ptr) const {
+		const auto base = reinterpret_cast<std::uintptr_t>(slab_.data());
+		return (reinterpret_cast<std::uintptr_t>(ptr) - base) / block_size;
 	}
 
 public:
@@ -114,75 +426,271 @@ public:
 	std::size_t active_count = 0;
 	std::size_t total_allocs = 0;
 	std::size_t total_deallocs = 0;
+	std::size_t remote_frees = 0;
 #endif
 
-	block_allocator() requires std::same_as<ValidatePolicy, validate_dealloc>
-		: thread_id_(std::this_thread::get_id()) {
-		initialise_free_list();
+	/**
+	 * @param numa_node If not negative, the NUMA node the slab should be
+	 * placed on. Mapped slabs are bound to the node; inline slabs rely on
+	 * first-touch, which occurs on the constructing thread.
+	 */
+	explicit block_allocator(int numa_node = -1) requires validate
+		: numa_node_(numa_node), thread_id_(std::this_thread::get_id()) {
+		if(numa_node >= 0) {
+			slab_.bind(numa_node);
+		}
 	}
 
-	block_allocator() {
-		initialise_free_list();
+	explicit block_allocator(int numa_node = -1)
+		: numa_node_(numa_node) {
+		if(numa_node >= 0) {
+			slab_.bind(numa_node);
+		}
 	}
 
+	block_allocator(const block_allocator&) = delete;
+	block_allocator& operator=(const block_allocator&) = delete;
+
 	template<typename ...Args>
 	[[nodiscard]] inline _ty* allocate(Args&&... args) {
-		auto block = reinterpret_cast<mem_block*>(pop());
+		void* block = pop();
+
+		if(!block && remote_head_.load(std::memory_order_relaxed)) [[unlikely]] {
+			drain_remote();
+			block = pop();
+		}
 
 		if(block) [[likely]] {
 #ifdef HEXI_DEBUG_ALLOCATORS
 			++storage_active_count;
 #endif
-			block->meta.using_new = false;
+			if constexpr(validate) {
+				owners_[slab_index(block)] = thread_id_;
+			}
 		} else {
 #ifdef HEXI_DEBUG_ALLOCATORS
 			++new_active_count;
 #endif
-			block = new mem_block;
-			block->meta.using_new = true;
-		}
+			auto hblock = static_cast<heap_block*>(::operator new(
+				sizeof(heap_block), std::align_val_t(alignof(heap_block))
+			));
 
-		if constexpr(std::is_same_v<ValidatePolicy, validate_dealloc>) {
-			block->meta.thread_id = thread_id_;
+			hblock->owner = this;
+
+			if constexpr(validate) {
+				std::construct_at(&hblock->thread_id, thread_id_);
+			}
+
+			block = hblock;
 		}
 
 #ifdef HEXI_DEBUG_ALLOCATORS
 		++total_allocs;
 		++active_count;
 #endif
-		return new (&block->obj) _ty(std::forward<Args>(args)...);
+		return new (block) _ty(std::forward<Args>(args)...);
 	}
 
 	inline void deallocate(_ty* t) {
 		assert(t);
-		auto block = reinterpret_cast<mem_block*>(t);
+		t->~_ty();
+		release(t);
+	}
 
-		if constexpr(std::is_same_v<ValidatePolicy, validate_dealloc>) {
-			assert(block->meta.thread_id == thread_id_
-				&& "thread policy violation or clobbered block");
+	/**
+	 * @brief Allocates and default constructs a number of objects.
+	 * 
+	 * The run of blocks is detached from the free list in a single
+	 * operation, followed by a contiguous run of blocks from the untouched
+	 * part of the slab. Any shortfall is made up by the system allocator.
+	 * 
+	 * @param count The number of objects to allocate.
+	 * @param out Output iterator that receives a pointer to each object.
+	 * 
+	 * @return The output iterator, one past the last written element.
+	 */
+	template<std::output_iterator<_ty*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		if(!head_ && remote_head_.load(std::memory_order_relaxed)) [[unlikely]] {
+			drain_remote();
 		}
 
-		if(block->meta.using_new) [[unlikely]] {
-#ifdef HEXI_DEBUG_ALLOCATORS
-			--new_active_count;
-#endif
-			t->~_ty();
-			operator delete(block);
-		} else {
+		// find where the run ends and cut it from the list
+		auto run = head_;
+		auto cut = head_;
+		std::size_t taken = 0;
+
+		while(cut && taken < count) {
+			cut = cut->next;
+			++taken;
+		}
+
+		head_ = cut;
+
+		for(std::size_t i = 0; i < taken; ++i) {
+			auto next = run->next;
+
+			if constexpr(validate) {
+				owners_[slab_index(run)] = thread_id_;
+			}
+
+			*out++ = new (run) _ty();
+			run = next;
+		}
+
+		// then carve whatever remains from the untouched part of the slab
+		const auto carved = std::min(count - taken, _elements - bump_);
+		auto block = slab_.data() + (block_size * bump_);
+		bump_ += carved;
+
+		for(std::size_t i = 0; i < carved; ++i, block += block_size) {
+			if constexpr(validate) {
+				owners_[slab_index(block)] = thread_id_;
+			}
+
+			*out++ = new (block) _ty();
+		}
+
+		taken += carved;
+
 #ifdef HEXI_DEBUG_ALLOCATORS
-			--storage_active_count;
+		storage_active_count += taken;
+		total_allocs += taken;
+		active_count += taken;
 #endif
+
+		for(std::size_t i = taken; i < count; ++i) {
+			*out++ = allocate();
+		}
+
+		return out;
+	}
+
+	/**
+	 * @brief Deallocates and destructs a range of objects.
+	 * 
+	 * Blocks belonging to the slab are linked together and spliced onto
+	 * the free list in a single operation.
+	 * 
+	 * @param first Iterator to the first object pointer.
+	 * @param last Iterator one past the last object pointer.
+	 */
+	template<std::input_iterator InputIt>
+	requires std::convertible_to<std::iter_value_t<InputIt>, _ty*>
+	void deallocate_list(InputIt first, InputIt last) {
+		impl::free_block* run_head = nullptr;
+		impl::free_block* run_tail = nullptr;
+		[[maybe_unused]] std::size_t count = 0;
+
+		for(; first != last; ++first) {
+			_ty* t = *first;
+			assert(t);
+
+			if(!owns(t)) [[unlikely]] {
+				deallocate(t);
+				continue;
+			}
+
+			validate_slab_block(t);
 			t->~_ty();
-			push(reinterpret_cast<impl::free_block*>(t));
+
+			auto block = reinterpret_cast<impl::free_block*>(t);
+			block->next = run_head;
+			run_head = block;
+
+			if(!run_tail) {
+				run_tail = block;
+			}
+
+			++count;
+		}
+
+		if(run_tail) {
+			run_tail->next = head_;
+			head_ = run_head;
 		}
 
 #ifdef HEXI_DEBUG_ALLOCATORS
-		++total_deallocs;
-		--active_count;
+		storage_active_count -= count;
+		total_deallocs += count;
+		active_count -= count;
 #endif
 	}
 
+	/**
+	 * @brief Deallocates and destructs an object from a thread other than
+	 * the owning thread. The block is reclaimed by the owner at a later point.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate_remote(_ty* t) {
+		assert(t);
+		t->~_ty();
+
+		auto block = reinterpret_cast<impl::free_block*>(t);
+		block->next = remote_head_.load(std::memory_order_relaxed);
+
+		while(!remote_head_.compare_exchange_weak(block->next, block,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/**
+	 * @brief Touches every page of the slab that hasn't yet been used, so
+	 * that the cost of faulting them in is paid now rather than by later
+	 * allocations.
+	 */
+	void prefault() {
+		const auto storage = slab_.data();
+		const auto begin = bump_ * block_size;
+
+		for(auto offset = begin; offset < slab_size; offset += impl::page_size) {
+			*static_cast<volatile char*>(storage + offset) = 0;
+		}
+
+		if(begin < slab_size) {
+			*static_cast<volatile char*>(storage + slab_size - 1) = 0;
+		}
+	}
+
+	/**
+	 * @brief Determines whether a block was allocated from the slab
+	 * rather than the system allocator.
+	 * 
+	 * @param ptr Pointer to the block.
+	 * 
+	 * @return True if the block lies within the slab.
+	 */
+	inline bool owns(const void* ptr) const {
+		const auto base = reinterpret_cast<std::uintptr_t>(slab_.data());
+		const auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+		return addr >= base && addr < base + slab_size;
+	}
+
+	/**
+	 * @return The number of slab blocks that have never been handed out.
+	 */
+	std::size_t untouched() const {
+		return _elements - bump_;
+	}
+
+	/**
+	 * @return True if the slab is backed by explicitly reserved huge pages.
+	 */
+	bool huge_pages() const {
+		return slab_.huge_pages();
+	}
+
+	/**
+	 * @return The NUMA node the slab was placed on or -1 if the allocator
+	 * is not NUMA-aware or the node could not be determined.
+	 */
+	int numa_node() const {
+		return numa_node_;
+	}
+
 	~block_allocator() {
+		drain_remote();
+
 #ifdef HEXI_DEBUG_ALLOCATORS
 		assert(active_count == 0);
 #endif
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <iterator>
 #include <utility>
+#include <cstddef>
 
 namespace hexi {
 
@@ -20,6 +22,22 @@ struct default_allocator final {
 	inline void deallocate(T* t) const {
 		delete t;
 	}
+
+	template<std::output_iterator<T*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) const {
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = new T();
+		}
+
+		return out;
+	}
+
+	template<std::input_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) const {
+		for(; first != last; ++first) {
+			delete *first;
+		}
+	}
 };
 
 } // hexi
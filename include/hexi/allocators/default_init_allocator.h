@@ -0,0 +1,54 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hexi {
+
+/**
+ * Allocator adaptor that default-initialises rather than value-initialises
+ * elements constructed without arguments. For trivial types such as bytes,
+ * this means that resizing a container leaves the new elements uninitialised
+ * rather than zero filling them, which is wasted work when they're about to
+ * be overwritten anyway.
+ */
+template<typename T, typename A = std::allocator<T>>
+class default_init_allocator : public A {
+	using traits = std::allocator_traits<A>;
+
+public:
+	template<typename U>
+	struct rebind {
+		using other = default_init_allocator<
+			U, typename traits::template rebind_alloc<U>
+		>;
+	};
+
+	using A::A;
+
+	template<typename U>
+	void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+		::new(static_cast<void*>(ptr)) U;
+	}
+
+	template<typename U, typename... Args>
+	void construct(U* ptr, Args&&... args) {
+		traits::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+	}
+};
+
+/**
+ * std::vector that does not zero fill when grown.
+ */
+template<typename T>
+using uninit_vector = std::vector<T, default_init_allocator<T>>;
+
+} // hexi
@@ -0,0 +1,413 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef NDEBUG
+#define HEXI_DEBUG_ALLOCATORS
+#endif
+
+namespace hexi {
+
+namespace impl {
+
+template<std::size_t magazine_size>
+struct magazine {
+	std::uint32_t index;
+	std::atomic<std::uint32_t> next;
+	std::size_t count = 0;
+	std::array<void*, magazine_size> blocks;
+};
+
+/*
+ * Global store of magazines, shared by every thread. Full and empty
+ * magazines are kept on two Treiber stacks. Magazines are addressed by index
+ * rather than by pointer, so that the head of each stack can carry a tag
+ * alongside the index in a single 64-bit word, which avoids ABA without
+ * needing a double-width CAS. Magazines are never freed while the depot is
+ * alive, so reading the next link of a stale head is always safe.
+ */
+template<std::size_t magazine_size, std::size_t block_size, std::size_t block_align>
+class magazine_depot {
+public:
+	using magazine_type = magazine<magazine_size>;
+
+private:
+	static constexpr std::uint32_t chunk_size = 64;
+	static constexpr std::uint32_t max_chunks = 1024;
+	static constexpr std::uint32_t nil = UINT32_MAX;
+
+	std::array<std::atomic<magazine_type*>, max_chunks> chunks_{};
+	std::atomic<std::uint32_t> next_index_ = 0;
+	std::atomic<std::uint64_t> full_ = pack(nil, 0);
+	std::atomic<std::uint64_t> empty_ = pack(nil, 0);
+	std::atomic<std::size_t> full_count_ = 0;
+
+	static constexpr std::uint64_t pack(const std::uint32_t index, const std::uint32_t tag) {
+		return (static_cast<std::uint64_t>(tag) << 32) | index;
+	}
+
+	static constexpr std::uint32_t index_of(const std::uint64_t head) {
+		return static_cast<std::uint32_t>(head);
+	}
+
+	static constexpr std::uint32_t tag_of(const std::uint64_t head) {
+		return static_cast<std::uint32_t>(head >> 32);
+	}
+
+	magazine_type* get(const std::uint32_t index) const {
+		const auto chunk = chunks_[index / chunk_size].load(std::memory_order_acquire);
+		return chunk + (index % chunk_size);
+	}
+
+	void push(std::atomic<std::uint64_t>& head, magazine_type* mag) {
+		auto old = head.load(std::memory_order_relaxed);
+
+		do {
+			mag->next.store(index_of(old), std::memory_order_relaxed);
+		} while(!head.compare_exchange_weak(old, pack(mag->index, tag_of(old) + 1),
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	magazine_type* pop(std::atomic<std::uint64_t>& head) {
+		auto old = head.load(std::memory_order_acquire);
+
+		while(index_of(old) != nil) {
+			const auto mag = get(index_of(old));
+			const auto next = mag->next.load(std::memory_order_relaxed);
+
+			if(head.compare_exchange_weak(old, pack(next, tag_of(old) + 1),
+				std::memory_order_acquire, std::memory_order_acquire)) {
+				return mag;
+			}
+		}
+
+		return nullptr;
+	}
+
+	magazine_type* create() {
+		if(next_index_.load(std::memory_order_relaxed) >= chunk_size * max_chunks) {
+			return nullptr;
+		}
+
+		const auto index = next_index_.fetch_add(1, std::memory_order_relaxed);
+
+		if(index >= chunk_size * max_chunks) [[unlikely]] {
+			return nullptr;
+		}
+
+		auto& slot = chunks_[index / chunk_size];
+		auto chunk = slot.load(std::memory_order_acquire);
+
+		if(!chunk) {
+			auto fresh = new magazine_type[chunk_size];
+
+			if(slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+				chunk = fresh;
+			} else {
+				delete[] fresh;
+			}
+		}
+
+		auto mag = chunk + (index % chunk_size);
+		mag->index = index;
+		mag->count = 0;
+		return mag;
+	}
+
+public:
+#ifdef HEXI_DEBUG_ALLOCATORS
+	std::atomic<std::size_t> system_allocs = 0;
+	std::atomic<std::size_t> system_deallocs = 0;
+#endif
+
+	void* allocate_block() {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++system_allocs;
+#endif
+		return ::operator new(block_size, std::align_val_t(block_align));
+	}
+
+	void deallocate_block(void* block) {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++system_deallocs;
+#endif
+		::operator delete(block, std::align_val_t(block_align));
+	}
+
+	/*
+	 * Stores a magazine that holds blocks. Once the depot is holding its
+	 * limit, the blocks are returned to the system instead so that memory
+	 * released by one burst doesn't stay pinned forever.
+	 */
+	void push_full(magazine_type* mag, const std::size_t limit) {
+		if(full_count_.fetch_add(1, std::memory_order_relaxed) >= limit) {
+			full_count_.fetch_sub(1, std::memory_order_relaxed);
+
+			for(std::size_t i = 0; i < mag->count; ++i) {
+				deallocate_block(mag->blocks[i]);
+			}
+
+			mag->count = 0;
+			push(empty_, mag);
+			return;
+		}
+
+		push(full_, mag);
+	}
+
+	magazine_type* pop_full() {
+		auto mag = pop(full_);
+
+		if(mag) {
+			full_count_.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		return mag;
+	}
+
+	void push_empty(magazine_type* mag) {
+		assert(mag->count == 0);
+		push(empty_, mag);
+	}
+
+	magazine_type* pop_empty() {
+		if(auto mag = pop(empty_)) {
+			return mag;
+		}
+
+		return create();
+	}
+
+	/*
+	 * Returns a magazine that may be partially filled, such as when a
+	 * thread exits.
+	 */
+	void release(magazine_type* mag, const std::size_t limit) {
+		if(!mag) {
+			return;
+		}
+
+		if(mag->count) {
+			push_full(mag, limit);
+		} else {
+			push_empty(mag);
+		}
+	}
+
+	std::size_t full_count() const {
+		return full_count_.load(std::memory_order_relaxed);
+	}
+
+	~magazine_depot() {
+		while(auto mag = pop(full_)) {
+			for(std::size_t i = 0; i < mag->count; ++i) {
+				deallocate_block(mag->blocks[i]);
+			}
+		}
+
+		for(auto& chunk : chunks_) {
+			delete[] chunk.load(std::memory_order_relaxed);
+		}
+	}
+};
+
+} // impl
+
+/*
+ * Magazine allocator in the style of Bonwick's magazine layer, as used by
+ * tcmalloc and friends. Each thread caches blocks in two magazines of up to
+ * magazine_size blocks each and only touches the global depot once both
+ * are exhausted (allocation) or full (deallocation), exchanging a whole
+ * magazine at a time with lock-free operations.
+ * 
+ * Unlike tls_block_allocator, blocks don't belong to any particular thread.
+ * A block can be deallocated by any thread, at which point it joins that
+ * thread's cache, so memory balances out across threads rather than being
+ * stranded in the pool of a thread that allocated heavily once. When a
+ * thread exits, its magazines are handed to the depot, so blocks that are
+ * still outstanding remain valid and the cached ones can be reused by other
+ * threads.
+ * 
+ * Blocks are requested from the system allocator when the depot has none to
+ * give. The depot holds at most depot_limit full magazines, with anything
+ * beyond that being handed back to the system allocator.
+ * 
+ * All blocks must be deallocated before the depot is destroyed at exit.
+ */
+template<typename _ty,
+	std::size_t magazine_size = 64,
+	std::size_t depot_limit = 64>
+requires (magazine_size > 0)
+class depot_allocator final {
+	using depot_type = impl::magazine_depot<magazine_size, sizeof(_ty), alignof(_ty)>;
+	using magazine_type = typename depot_type::magazine_type;
+
+	struct thread_cache {
+		magazine_type* loaded = nullptr;
+		magazine_type* previous = nullptr;
+
+		~thread_cache() {
+			depot_.release(loaded, depot_limit);
+			depot_.release(previous, depot_limit);
+		}
+	};
+
+	static inline depot_type depot_;
+	static inline thread_local thread_cache cache_;
+
+	static void* acquire() {
+		auto& cache = cache_;
+
+		if(cache.loaded && cache.loaded->count) [[likely]] {
+			return cache.loaded->blocks[--cache.loaded->count];
+		}
+
+		if(cache.previous && cache.previous->count) {
+			std::swap(cache.loaded, cache.previous);
+			return cache.loaded->blocks[--cache.loaded->count];
+		}
+
+		// both magazines are empty, try to swap one for a full magazine
+		if(auto full = depot_.pop_full()) {
+			if(cache.previous) {
+				depot_.push_empty(cache.previous);
+			}
+
+			cache.previous = cache.loaded;
+			cache.loaded = full;
+			return cache.loaded->blocks[--cache.loaded->count];
+		}
+
+		return depot_.allocate_block();
+	}
+
+	static void store(void* block) {
+		auto& cache = cache_;
+
+		if(cache.loaded && cache.loaded->count < magazine_size) [[likely]] {
+			cache.loaded->blocks[cache.loaded->count++] = block;
+			return;
+		}
+
+		if(cache.previous && cache.previous->count < magazine_size) {
+			std::swap(cache.loaded, cache.previous);
+			cache.loaded->blocks[cache.loaded->count++] = block;
+			return;
+		}
+
+		// both magazines are full (or missing), try to swap one for an empty magazine
+		if(auto empty = depot_.pop_empty()) {
+			if(cache.previous) {
+				depot_.push_full(cache.previous, depot_limit);
+			}
+
+			cache.previous = cache.loaded;
+			cache.loaded = empty;
+			cache.loaded->blocks[cache.loaded->count++] = block;
+			return;
+		}
+
+		depot_.deallocate_block(block);
+	}
+
+public:
+#ifdef HEXI_DEBUG_ALLOCATORS
+	std::size_t total_allocs = 0;
+	std::size_t total_deallocs = 0;
+	std::size_t active_allocs = 0;
+#endif
+
+	/*
+	 * @brief Allocates and constructs an object.
+	 * 
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
+	 */
+	template<typename ...Args>
+	[[nodiscard]] inline _ty* allocate(Args&&... args) {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_allocs;
+		++active_allocs;
+#endif
+		return new (acquire()) _ty(std::forward<Args>(args)...);
+	}
+
+	/*
+	 * @brief Deallocates and destructs an object. May be called from
+	 * any thread.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate(_ty* t) {
+		assert(t);
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_deallocs;
+		--active_allocs;
+#endif
+		t->~_ty();
+		store(t);
+	}
+
+	/**
+	 * @brief Allocates and default constructs a number of objects.
+	 * 
+	 * @param count The number of objects to allocate.
+	 * @param out Output iterator that receives a pointer to each object.
+	 * 
+	 * @return The output iterator, one past the last written element.
+	 */
+	template<std::output_iterator<_ty*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = allocate();
+		}
+
+		return out;
+	}
+
+	/**
+	 * @brief Deallocates and destructs a range of objects.
+	 * 
+	 * @param first Iterator to the first object pointer.
+	 * @param last Iterator one past the last object pointer.
+	 */
+	template<std::input_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+		for(; first != last; ++first) {
+			deallocate(*first);
+		}
+	}
+
+	/**
+	 * @return The number of full magazines currently held by the depot.
+	 */
+	static std::size_t depot_size() {
+		return depot_.full_count();
+	}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+	static const depot_type& depot() {
+		return depot_;
+	}
+#endif
+
+	~depot_allocator() {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		assert(active_allocs == 0);
+#endif
+	}
+};
+
+} // hexi
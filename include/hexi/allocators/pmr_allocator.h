@@ -0,0 +1,71 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <cassert>
+
+namespace hexi {
+
+/*
+ * Block allocator that takes its memory from a std::pmr::memory_resource,
+ * allowing dynamic_buffer to share a resource with the rest of a program,
+ * such as a monotonic_buffer_resource that holds everything belonging to
+ * a single message or request. The resource must outlive any buffers using it.
+ * Two pmr_allocators compare equal if their resources do, which allows
+ * buffers sharing a resource to hand blocks to each other.
+ */
+template<typename _ty>
+class pmr_allocator final {
+	std::pmr::memory_resource* resource_;
+
+public:
+	pmr_allocator() noexcept
+		: resource_(std::pmr::get_default_resource()) {}
+
+	explicit pmr_allocator(std::pmr::memory_resource* resource) noexcept
+		: resource_(resource) {
+		assert(resource);
+	}
+
+	/**
+	 * @brief Allocates and constructs an object.
+	 * 
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
+	 */
+	template<typename ...Args>
+	[[nodiscard]] inline _ty* allocate(Args&&... args) {
+		auto memory = resource_->allocate(sizeof(_ty), alignof(_ty));
+		return new (memory) _ty(std::forward<Args>(args)...);
+	}
+
+	/**
+	 * @brief Deallocates and destructs an object.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate(_ty* t) {
+		assert(t);
+		t->~_ty();
+		resource_->deallocate(t, sizeof(_ty), alignof(_ty));
+	}
+
+	/**
+	 * @return The memory resource that objects are allocated from.
+	 */
+	std::pmr::memory_resource* resource() const {
+		return resource_;
+	}
+
+	bool operator==(const pmr_allocator& rhs) const {
+		return *resource_ == *rhs.resource_;
+	}
+};
+
+} // hexi
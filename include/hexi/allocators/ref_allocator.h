@@ -0,0 +1,59 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+namespace hexi {
+
+/*
+ * Refers to an allocator instance owned elsewhere, such as a pool or arena
+ * belonging to a worker or connection, so that it can be shared between
+ * many buffers. The referenced allocator must outlive any buffers using it.
+ * Two ref_allocators compare equal if they refer to the same instance,
+ * which allows buffers sharing an instance to hand blocks to each other.
+ */
+template<typename allocator_type>
+class ref_allocator final {
+	allocator_type* allocator_;
+
+public:
+	explicit ref_allocator(allocator_type& allocator)
+		: allocator_(&allocator) {}
+
+	template<typename ...Args>
+	[[nodiscard]] inline auto allocate(Args&&... args) {
+		return allocator_->allocate(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	inline void deallocate(T* t) {
+		allocator_->deallocate(t);
+	}
+
+	template<typename OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out)
+	requires requires(allocator_type& a) { a.allocate_n(count, out); } {
+		return allocator_->allocate_n(count, out);
+	}
+
+	template<typename InputIt>
+	void deallocate_list(InputIt first, InputIt last)
+	requires requires(allocator_type& a) { a.deallocate_list(first, last); } {
+		allocator_->deallocate_list(first, last);
+	}
+
+	allocator_type& get() const {
+		return *allocator_;
+	}
+
+	bool operator==(const ref_allocator&) const = default;
+};
+
+} // hexi
@@ -0,0 +1,375 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace hexi {
+
+namespace impl {
+
+constexpr std::size_t region_granularity = 16;
+constexpr std::size_t region_small_classes = 8; // 16 to 128 bytes, in steps of 16
+
+/*
+ * Above 128 bytes, each power of two range (2^k, 2^(k+1)] is split into
+ * four classes, spaced 2^(k-2) bytes apart
+ */
+constexpr std::size_t region_class_index(const std::size_t size) {
+	if(size <= region_small_classes * region_granularity) {
+		return (std::max<std::size_t>(size, 1) + region_granularity - 1) / region_granularity - 1;
+	}
+
+	const std::size_t k = std::bit_width(size - 1) - 1;
+	const std::size_t step = std::size_t(1) << (k - 2);
+	const auto offset = (size - (std::size_t(1) << k) + step - 1) / step;
+	return region_small_classes + (k - 7) * 4 + offset - 1;
+}
+
+constexpr std::size_t region_class_size(const std::size_t index) {
+	if(index < region_small_classes) {
+		return (index + 1) * region_granularity;
+	}
+
+	const auto k = 7 + (index - region_small_classes) / 4;
+	const auto offset = (index - region_small_classes) % 4 + 1;
+	return (std::size_t(1) << k) + offset * (std::size_t(1) << (k - 2));
+}
+
+} // impl
+
+/**
+ * Arena intended to be owned by something with a bounded lifetime, such as
+ * a connection. Memory is bump allocated from chunks requested from the
+ * system allocator and released in one go when the region is released or
+ * destroyed, rather than piece by piece.
+ * 
+ * Sizes are rounded up to one of a fixed set of classes, four per power of
+ * two, so no more than a quarter of a block is wasted to rounding, e.g. a
+ * block of slightly over 4KB takes 5KB. Deallocated memory is kept on a free
+ * list per class and reused for any size in that class while the region is
+ * alive, so a long-lived connection with varying allocation sizes, such as
+ * a growing vector, doesn't grow without bound. Allocations larger than the
+ * largest class or the chunk size are given their own memory by the system
+ * allocator and returned to it when they're deallocated.
+ * 
+ * Releasing the region is proportional to the number of chunks rather than
+ * the number of allocations, but it isn't free. Neither is tearing down the
+ * region's users, e.g. a dynamic_buffer still returns each of its blocks
+ * through deallocate(), which is cheap but not a no-op.
+ * 
+ * Anything allocated from the region must no longer be in use by the time
+ * it is released. A region is not thread-safe.
+ */
+class region final {
+	struct chunk {
+		chunk* next;
+	};
+
+	struct large_block {
+		large_block* prev;
+		large_block* next;
+	};
+
+	struct free_block {
+		free_block* next;
+	};
+
+	static constexpr std::size_t max_class_size = 256 * 1024;
+	static constexpr std::size_t class_count = impl::region_class_index(max_class_size) + 1;
+	static constexpr std::size_t max_align = 64;
+	static constexpr std::size_t header_size = max_align; // keeps chunk data aligned
+
+	std::size_t chunk_size_;
+	chunk* chunks_ = nullptr;
+	large_block* large_ = nullptr;
+	std::byte* bump_ = nullptr;
+	std::byte* end_ = nullptr;
+	std::array<free_block*, class_count> free_{};
+
+	static std::size_t class_size(const std::size_t index) {
+		return impl::region_class_size(index);
+	}
+
+	// blocks are aligned to the largest power of two that divides their class
+	static std::size_t class_align(const std::size_t index) {
+		const auto size = class_size(index);
+		return std::min(size & (~size + 1), max_align);
+	}
+
+	// returns class_count if the allocation is too large for any class
+	std::size_t find_class(const std::size_t size, const std::size_t align) const {
+		if(size > max_class_size) {
+			return class_count;
+		}
+
+		auto index = impl::region_class_index(std::max(size, align));
+
+		// over-aligned requests move up to the next class that's aligned for them
+		while(index < class_count && class_align(index) < align) {
+			++index;
+		}
+
+		if(index == class_count || class_size(index) > chunk_size_) {
+			return class_count;
+		}
+
+		return index;
+	}
+
+	std::byte* new_chunk(const std::size_t size) {
+		auto memory = static_cast<std::byte*>(::operator new(
+			header_size + size, std::align_val_t(max_align)
+		));
+
+		auto header = reinterpret_cast<chunk*>(memory);
+		header->next = chunks_;
+		chunks_ = header;
+		return memory + header_size;
+	}
+
+	void* allocate_large(const std::size_t size) {
+		auto memory = static_cast<std::byte*>(::operator new(
+			header_size + size, std::align_val_t(max_align)
+		));
+
+		auto header = reinterpret_cast<large_block*>(memory);
+		header->prev = nullptr;
+		header->next = large_;
+
+		if(large_) {
+			large_->prev = header;
+		}
+
+		large_ = header;
+		return memory + header_size;
+	}
+
+	void deallocate_large(void* ptr) {
+		auto header = reinterpret_cast<large_block*>(static_cast<std::byte*>(ptr) - header_size);
+
+		if(header->prev) {
+			header->prev->next = header->next;
+		} else {
+			large_ = header->next;
+		}
+
+		if(header->next) {
+			header->next->prev = header->prev;
+		}
+
+		::operator delete(header, std::align_val_t(max_align));
+	}
+
+	void* bump_allocate(const std::size_t bytes, const std::size_t alignment) {
+		auto bump = reinterpret_cast<std::uintptr_t>(bump_);
+		bump = (bump + alignment - 1) & ~(alignment - 1);
+
+		if(!bump_ || bump + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+			bump_ = new_chunk(chunk_size_);
+			end_ = bump_ + chunk_size_;
+			bump = reinterpret_cast<std::uintptr_t>(bump_);
+		}
+
+		auto memory = reinterpret_cast<std::byte*>(bump);
+		bump_ = memory + bytes;
+		return memory;
+	}
+
+public:
+	/**
+	 * @param chunk_size The number of bytes to request from the system
+	 * allocator at a time. Allocations that don't fit within a chunk are
+	 * made by the system allocator instead.
+	 */
+	explicit region(const std::size_t chunk_size = 64 * 1024)
+		: chunk_size_(chunk_size) {}
+
+	region(const region&) = delete;
+	region& operator=(const region&) = delete;
+
+	/**
+	 * @brief Allocates memory from the region.
+	 * 
+	 * @param size The number of bytes to allocate.
+	 * @param align The required alignment, which must not exceed 64.
+	 * 
+	 * @return Pointer to the allocated memory.
+	 */
+	[[nodiscard]] void* allocate(const std::size_t size, const std::size_t align = alignof(std::max_align_t)) {
+		assert(align <= max_align && "region alignment too large");
+		const auto index = find_class(size, align);
+
+		if(index == class_count) [[unlikely]] {
+			return allocate_large(size);
+		}
+
+		if(auto block = free_[index]) {
+			free_[index] = block->next;
+			return block;
+		}
+
+		return bump_allocate(class_size(index), class_align(index));
+	}
+
+	/**
+	 * @brief Returns memory to the region for reuse.
+	 * 
+	 * @param ptr Pointer to the memory.
+	 * @param size The size that was passed to allocate().
+	 * @param align The alignment that was passed to allocate().
+	 */
+	void deallocate(void* ptr, const std::size_t size, const std::size_t align = alignof(std::max_align_t)) {
+		assert(ptr);
+		const auto index = find_class(size, align);
+
+		if(index == class_count) [[unlikely]] {
+			deallocate_large(ptr);
+			return;
+		}
+
+		auto block = static_cast<free_block*>(ptr);
+		block->next = free_[index];
+		free_[index] = block;
+	}
+
+	/**
+	 * @brief Releases all memory held by the region back to the system.
+	 * Anything that was allocated from it becomes invalid.
+	 */
+	void release() {
+		while(chunks_) {
+			auto next = chunks_->next;
+			::operator delete(chunks_, std::align_val_t(max_align));
+			chunks_ = next;
+		}
+
+		while(large_) {
+			auto next = large_->next;
+			::operator delete(large_, std::align_val_t(max_align));
+			large_ = next;
+		}
+
+		bump_ = nullptr;
+		end_ = nullptr;
+		free_.fill(nullptr);
+	}
+
+	~region() {
+		release();
+	}
+};
+
+/**
+ * Block allocator that takes its memory from a region. Intended for use
+ * with dynamic_buffer, allowing every buffer belonging to a connection to
+ * share the connection's region.
+ * 
+ * Copies refer to the same region and compare equal, so blocks can be
+ * handed between buffers using the same region.
+ */
+template<typename T>
+class region_allocator final {
+	region* region_;
+
+public:
+	explicit region_allocator(region& region)
+		: region_(&region) {}
+
+	/**
+	 * @brief Allocates and constructs an object.
+	 * 
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
+	 */
+	template<typename ...Args>
+	[[nodiscard]] inline T* allocate(Args&&... args) {
+		auto memory = region_->allocate(sizeof(T), alignof(T));
+		return new (memory) T(std::forward<Args>(args)...);
+	}
+
+	/**
+	 * @brief Destructs an object and returns its memory to the region's
+	 * free list.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate(T* t) {
+		assert(t);
+		t->~T();
+		region_->deallocate(t, sizeof(T), alignof(T));
+	}
+
+	template<std::output_iterator<T*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = allocate();
+		}
+
+		return out;
+	}
+
+	template<std::input_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+		for(; first != last; ++first) {
+			deallocate(*first);
+		}
+	}
+
+	/**
+	 * @return The region that memory is allocated from.
+	 */
+	region& get() const {
+		return *region_;
+	}
+
+	bool operator==(const region_allocator&) const = default;
+};
+
+/**
+ * Standard library compatible allocator that takes its memory from a region,
+ * for containers that are read into and are tied to a connection's lifetime.
+ */
+template<typename T>
+class region_std_allocator {
+	template<typename U>
+	friend class region_std_allocator;
+
+	region* region_;
+
+public:
+	using value_type = T;
+
+	explicit region_std_allocator(region& region) noexcept
+		: region_(&region) {}
+
+	template<typename U>
+	region_std_allocator(const region_std_allocator<U>& rhs) noexcept
+		: region_(rhs.region_) {}
+
+	[[nodiscard]] T* allocate(const std::size_t count) {
+		return static_cast<T*>(region_->allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	void deallocate(T* ptr, const std::size_t count) noexcept {
+		region_->deallocate(ptr, sizeof(T) * count, alignof(T));
+	}
+
+	template<typename U>
+	bool operator==(const region_std_allocator<U>& rhs) const noexcept {
+		return region_ == rhs.region_;
+	}
+};
+
+} // hexi
@@ -7,8 +7,13 @@
 #pragma once
 
 #include <hexi/allocators/block_allocator.h>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -22,16 +27,108 @@ namespace hexi {
 struct safe_entrant {};
 struct no_ref_counting {};
 
+struct numa_unaware {};
+
 struct unsafe_entrant : safe_entrant {};
 struct ref_counting : no_ref_counting {};
+struct numa_local : numa_unaware {};
+
+/*
+ * NumaPolicy: 'numa_local' places each thread's slab on the NUMA node the
+ * thread is running on when its allocator is created. Mapped slabs are bound
+ * with mbind, inline slabs rely on first-touch. Blocks deallocated by a
+ * thread other than the one that allocated them are routed back to the
+ * owning allocator rather than being mixed into the local pool. Without
+ * NUMA support, the node is reported as -1 and only routing is performed.
+ * 
+ * To route frees, each block records the allocator it came from, which adds
+ * a pointer to the size of every block. The allocating thread's allocator
+ * must therefore outlive its blocks, so a thread must not exit (or release
+ * its allocator through thread_exit) while any of its blocks are still in
+ * use elsewhere. Debug builds assert on this.
+ */
 
 template<typename _ty,
 	std::size_t _elements,
 	std::derived_from<no_ref_counting> ref_count_policy = no_ref_counting,
-	std::derived_from<safe_entrant> entrant_policy = safe_entrant
+	std::derived_from<safe_entrant> entrant_policy = safe_entrant,
+	std::derived_from<natural_alignment> align_policy = natural_alignment,
+	std::derived_from<inline_slab> slab_policy = inline_slab,
+	std::derived_from<numa_unaware> numa_policy = numa_unaware
 >
 class tls_block_allocator final {
-	using allocator_type = block_allocator<_ty, _elements>;
+	static constexpr bool numa_aware = std::is_same_v<numa_policy, numa_local>;
+
+	// block with the allocator it came from, so a remote free can be routed
+	struct routed_block {
+		_ty obj;
+		void* owner = nullptr;
+
+		template<typename ...Args>
+		routed_block(Args&&... args)
+			: obj(std::forward<Args>(args)...) {}
+	};
+
+	using block_type = std::conditional_t<numa_aware, routed_block, _ty>;
+
+	using allocator_type = block_allocator<
+		block_type, _elements, no_validate_dealloc, align_policy, slab_policy
+	>;
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+	static constexpr bool track_owners = numa_aware;
+#else
+	static constexpr bool track_owners = false;
+#endif
+
+	// allocators of every live thread, only used to catch frees to dead ones
+	struct registry {
+		std::mutex lock;
+		std::vector<allocator_type*> allocators;
+	};
+
+	struct allocator_deleter {
+		void operator()(allocator_type* allocator) const {
+			if constexpr(track_owners) {
+				std::lock_guard guard(registry_.lock);
+				std::erase(registry_.allocators, allocator);
+			}
+
+			delete allocator;
+		}
+	};
+
+	using registry_type = std::conditional_t<track_owners, registry, std::monostate>;
+
+	/*
+	 * Records the owner of each block as it's written to the caller's
+	 * output iterator, so that allocate_n keeps its bulk path
+	 */
+	template<typename OutputIt>
+	struct routing_iterator {
+		using difference_type = std::ptrdiff_t;
+
+		OutputIt* out;
+		allocator_type* owner;
+
+		const routing_iterator& operator*() const {
+			return *this;
+		}
+
+		const routing_iterator& operator=(routed_block* block) const {
+			block->owner = owner;
+			*(*out)++ = &block->obj;
+			return *this;
+		}
+
+		routing_iterator& operator++() {
+			return *this;
+		}
+
+		routing_iterator operator++(int) {
+			return *this;
+		}
+	};
 
 	using ref_count = std::conditional_t<
 		std::is_same_v<ref_count_policy, ref_counting>, int, std::monostate
@@ -41,20 +138,52 @@ class tls_block_allocator final {
 		std::is_same_v<entrant_policy, unsafe_entrant>, allocator_type*, std::monostate
 	>;
 
-	static inline thread_local std::unique_ptr<allocator_type> allocator_;
+	static inline thread_local std::unique_ptr<allocator_type, allocator_deleter> allocator_;
+	static inline registry_type registry_;
 	static inline thread_local ref_count ref_count_{};
 
 	[[no_unique_address]] tls_handle_cache cached_handle_{};
 
+	static void create_allocator() {
+		if constexpr(numa_aware) {
+			allocator_.reset(new allocator_type(impl::current_numa_node()));
+		} else {
+			allocator_.reset(new allocator_type());
+		}
+
+		if constexpr(track_owners) {
+			std::lock_guard guard(registry_.lock);
+			registry_.allocators.emplace_back(allocator_.get());
+		}
+	}
+
 	// Compiler will optimise calls to this out when using unsafe_entrant
 	inline void initialise() {
 		if constexpr(std::is_same_v<entrant_policy, safe_entrant>) {
 			if(!allocator_) {
-				allocator_ = std::make_unique<allocator_type>();
+				create_allocator();
 			}
 		}
 	}
 
+	void deallocate_routed(_ty* t) {
+		auto block = reinterpret_cast<routed_block*>(t);
+		auto owner = static_cast<allocator_type*>(block->owner);
+
+		if(owner == allocator_handle()) [[likely]] {
+			owner->deallocate(block);
+			return;
+		}
+
+		if constexpr(track_owners) {
+			std::lock_guard guard(registry_.lock);
+			assert(std::ranges::find(registry_.allocators, owner) != registry_.allocators.end()
+				&& "block outlived the thread that allocated it");
+		}
+
+		owner->deallocate_remote(block);
+	}
+
 	inline allocator_type* allocator_handle() {
 		if constexpr(std::is_same_v<entrant_policy, unsafe_entrant>) {
 			return cached_handle_;
@@ -83,7 +212,7 @@ public:
 	 */
 	inline void thread_enter() {
 		if(!allocator_) {
-			allocator_ = std::make_unique<allocator_type>();
+			create_allocator();
 		}
 
 		if constexpr(std::is_same_v<entrant_policy, unsafe_entrant>) {
@@ -133,7 +262,15 @@ public:
 		++total_allocs;
 		++active_allocs;
 #endif
-		return allocator_handle()->allocate(std::forward<Args>(args)...);
+		auto handle = allocator_handle();
+
+		if constexpr(numa_aware) {
+			auto block = handle->allocate(std::forward<Args>(args)...);
+			block->owner = handle;
+			return &block->obj;
+		} else {
+			return handle->allocate(std::forward<Args>(args)...);
+		}
 	}
 
 	/*
@@ -148,7 +285,77 @@ public:
 		++total_deallocs;
 		--active_allocs;
 #endif
-		allocator_handle()->deallocate(t);
+		if constexpr(numa_aware) {
+			deallocate_routed(t);
+		} else {
+			allocator_handle()->deallocate(t);
+		}
+	}
+
+	/*
+	 * @brief Allocates and default constructs a number of objects.
+	 * 
+	 * @param count The number of objects to allocate.
+	 * @param out Output iterator that receives a pointer to each object.
+	 * 
+	 * @return The output iterator, one past the last written element.
+	 */
+	template<std::output_iterator<_ty*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		initialise();
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		total_allocs += count;
+		active_allocs += count;
+#endif
+		auto handle = allocator_handle();
+
+		if constexpr(numa_aware) {
+			handle->allocate_n(count, routing_iterator<OutputIt>{ &out, handle });
+			return out;
+		} else {
+			return handle->allocate_n(count, out);
+		}
+	}
+
+	/*
+	 * @brief Deallocates and destructs a range of objects.
+	 * 
+	 * @param first Iterator to the first object pointer.
+	 * @param last Iterator one past the last object pointer.
+	 */
+	template<std::forward_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		const auto count = static_cast<std::size_t>(std::distance(first, last));
+		total_deallocs += count;
+		active_allocs -= count;
+#endif
+		if constexpr(numa_aware) {
+			for(; first != last; ++first) {
+				deallocate_routed(*first);
+			}
+		} else {
+			allocator_handle()->deallocate_list(first, last);
+		}
+	}
+
+	/**
+	 * @return The NUMA node of the calling thread's slab or -1 if the
+	 * policy is not in use or the node could not be determined.
+	 */
+	int numa_node() {
+		initialise();
+		return allocator_handle()->numa_node();
+	}
+
+	/**
+	 * @brief Faults in the calling thread's slab up front, rather than
+	 * as blocks are first used.
+	 */
+	void prefault() {
+		initialise();
+		allocator_handle()->prefault();
 	}
 
 #ifdef HEXI_DEBUG_ALLOCATORS
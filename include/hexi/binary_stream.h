@@ -7,17 +7,24 @@
 #pragma once
 
 #include <hexi/shared.h>
+#include <hexi/aggregate.h>
 #include <hexi/concepts.h>
 #include <hexi/exception.h>
 #include <hexi/endian.h>
 #include <hexi/stream_adaptors.h>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <concepts>
+#include <memory_resource>
 #include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -57,6 +64,11 @@ public:
 	
 	static constexpr endianness byte_order{};
 
+	// true if arithmetic types are stored with the host's byte order
+	static constexpr bool native_order = std::is_same_v<endianness, endian::as_native_t>
+		|| (std::is_same_v<endianness, endian::as_little_t> && std::endian::native == std::endian::little)
+		|| (std::is_same_v<endianness, endian::as_big_t> && std::endian::native == std::endian::big);
+
 private:
 	using cond_size_type = std::conditional_t<writeable<buf_type>, size_type, std::monostate>;
 
@@ -65,6 +77,10 @@ private:
 	size_type total_read_ = 0;
 	stream_state state_ = stream_state::ok;
 	const size_type read_limit_;
+	std::pmr::memory_resource* resource_ = nullptr;
+
+	// number of packed values staged at a time
+	static constexpr std::size_t packed_batch = 64;
 
 	inline void enforce_read_bounds(const size_type read_size) {
 		if(read_size > buffer_.size()) [[unlikely]] {
@@ -120,6 +136,25 @@ private:
 		}
 	}
 
+	template<typename handle_type>
+	bool reserve_placeholder(const size_type length, handle_type& handle) {
+		HEXI_TRY {
+			if(state_ == stream_state::ok) [[likely]] {
+				handle = buffer_.reserve_placeholder(length);
+				total_write_ += length;
+				return true;
+			}
+		} HEXI_CATCH(...) {
+			state_ = stream_state::buff_write_err;
+
+			if constexpr(std::is_same_v<exceptions, allow_throw_t>) {
+				HEXI_THROW();
+			}
+		}
+
+		return false;
+	}
+
 	template<typename container_type>
 	void write_container(container_type& container) {
 		using cvalue_type = typename container_type::value_type;
@@ -153,13 +188,117 @@ private:
 			SAFE_READ(container.data(), bytes, void());
 		} else {
 			for(count_type i = 0; i < count; ++i) {
-				cvalue_type value;
+				auto value = impl::make_element(container, resource_);
 				*this >> value;
 				container.emplace_back(std::move(value));
 			}
 		}
 	}
 
+	// fields that are serialised as their object representation, bar byte order
+	template<typename T>
+	static constexpr bool coalescable = arithmetic<T>
+		|| (pod<T> && !has_shl_override<T, binary_stream> && !has_shr_override<T, binary_stream>
+			&& !has_serialise<T, binary_stream> && !has_deserialise<T, binary_stream>);
+
+	template<typename T>
+	static consteval auto field_runs() {
+		using layout = impl::aggregate_layout<T>;
+
+		return [&]<std::size_t... I>(std::index_sequence<I...>) {
+			return layout::runs({ coalescable<std::tuple_element_t<I, typename layout::types>>... });
+		}(std::make_index_sequence<layout::count>());
+	}
+
+	template<typename T, std::size_t first, std::size_t last>
+	static consteval size_type run_bytes() {
+		using layout = impl::aggregate_layout<T>;
+		return layout::offset[last - 1] + layout::size[last - 1] - layout::offset[first];
+	}
+
+	template<std::size_t index, typename T, typename fields_type>
+	void write_fields(const T& object, const fields_type& fields) {
+		if constexpr(index < std::tuple_size_v<fields_type>) {
+			constexpr auto end = field_runs<T>()[index];
+
+			if constexpr(end - index == 1) {
+				*this << std::get<index>(fields);
+			} else {
+				write_run<index, end>(object, fields);
+			}
+
+			write_fields<end>(object, fields);
+		}
+	}
+
+	template<std::size_t first, std::size_t last, typename T, typename fields_type>
+	void write_run(const T& object, const fields_type& fields) {
+		using layout = impl::aggregate_layout<T>;
+		constexpr auto bytes = run_bytes<T, first, last>();
+		const auto data = reinterpret_cast<const std::byte*>(&std::get<first>(fields));
+		assert(data == reinterpret_cast<const std::byte*>(&object) + layout::offset[first]);
+
+		if constexpr(native_order) {
+			write(data, bytes);
+		} else {
+			// stage the run so that it can still be written with a single call
+			std::array<std::byte, bytes> staged;
+
+			[&]<std::size_t... I>(std::index_sequence<I...>) {
+				([&] {
+					const auto& field = std::get<first + I>(fields);
+					auto dest = staged.data() + (layout::offset[first + I] - layout::offset[first]);
+
+					if constexpr(arithmetic<std::remove_cvref_t<decltype(field)>>) {
+						const auto converted = endian::storage_in(field, byte_order);
+						std::memcpy(dest, &converted, sizeof(converted));
+					} else {
+						std::memcpy(dest, &field, sizeof(field));
+					}
+				}(), ...);
+			}(std::make_index_sequence<last - first>());
+
+			write(staged.data(), bytes);
+		}
+	}
+
+	template<std::size_t index, typename T, typename fields_type>
+	void read_fields(T& object, const fields_type& fields) {
+		if constexpr(index < std::tuple_size_v<fields_type>) {
+			constexpr auto end = field_runs<T>()[index];
+
+			if constexpr(end - index == 1) {
+				*this >> std::get<index>(fields);
+			} else {
+				read_run<index, end>(object, fields);
+			}
+
+			read_fields<end>(object, fields);
+		}
+	}
+
+	template<std::size_t first, std::size_t last, typename T, typename fields_type>
+	void read_run(T& object, const fields_type& fields) {
+		using layout = impl::aggregate_layout<T>;
+		constexpr auto bytes = run_bytes<T, first, last>();
+		const auto data = reinterpret_cast<std::byte*>(&std::get<first>(fields));
+		assert(data == reinterpret_cast<std::byte*>(&object) + layout::offset[first]);
+
+		SAFE_READ(data, bytes, void());
+
+		if constexpr(!native_order) {
+			[&]<std::size_t... I>(std::index_sequence<I...>) {
+				([&] {
+					auto& field = std::get<first + I>(fields);
+
+					if constexpr(arithmetic<std::remove_cvref_t<decltype(field)>>) {
+						endian::storage_out(field, byte_order);
+					}
+				}(), ...);
+			}(std::make_index_sequence<last - first>());
+		}
+	}
+
 public:
 	explicit binary_stream(buf_type& source, size_type read_limit = 0)
 		: buffer_(source),
@@ -188,7 +327,8 @@ public:
 		  total_write_(rhs.total_write_),
 		  total_read_(rhs.total_read_),
 		  state_(rhs.state_),
-		  read_limit_(rhs.read_limit_) {
+		  read_limit_(rhs.read_limit_),
+		  resource_(rhs.resource_) {
 		rhs.total_read_ = static_cast<size_type>(-1);
 		rhs.state_ = stream_state::invalid_stream;
 	}
@@ -252,6 +392,34 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Serialises one or more values in a compact form, such as
+	 * quantised or half precision floats, with the default byte order.
+	 * 
+	 * @param adaptor A packing adaptor, such as hexi::quantised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<std::derived_from<packed_tag_t> packed_type>
+	binary_stream& operator<<(packed_type adaptor) requires writeable<buf_type> {
+		using wire_type = typename packed_type::wire_type;
+		std::array<wire_type, packed_batch> staged;
+		auto values = adaptor.values;
+
+		while(!values.empty()) {
+			const auto count = std::min(values.size(), staged.size());
+
+			for(std::size_t i = 0; i < count; ++i) {
+				staged[i] = endian::storage_in(adaptor.codec.encode(values[i]), byte_order);
+			}
+
+			write(staged.data(), static_cast<size_type>(count * sizeof(wire_type)));
+			values = values.subspan(count);
+		}
+
+		return *this;
+	}
+
 	/**
 	 * @brief Serialises an arithmetic type with the default byte order.
 	 * 
@@ -283,6 +451,26 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Serialises an aggregate that doesn't provide its own serialisation
+	 * functions, one field at a time. Runs of adjacent arithmetic and POD
+	 * fields with no padding between them are written as a single block.
+	 * 
+	 * @tparam T The aggregate type.
+	 * @param data Reference to the object to be serialised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<field_serialisable T>
+	requires (!has_serialise<T, binary_stream> && !has_shl_override<T, binary_stream>)
+	binary_stream& operator<<(const T& data) requires writeable<buf_type> {
+		impl::visit_fields(data, [&](const auto&... fields) {
+			write_fields<0>(data, std::tie(fields...));
+		});
+
+		return *this;
+	}
+
 	/**
 	 * @brief Serialises a string or string_view with a fixed-length prefix
 	 * 
@@ -311,7 +499,7 @@ public:
 	 * @return Reference to the current stream.
 	 */
 	template<typename T>
-	requires std::is_same_v<std::decay_t<T>, std::string>
+	requires std_string<std::decay_t<T>>
 	binary_stream& operator<<(null_terminated<T> adaptor) requires writeable<buf_type> {
 		assert(adaptor->find_first_of('\0') == adaptor->npos);
 		write(adaptor->data(), adaptor->size() + 1); // yes, the standard allows this
@@ -351,7 +539,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator<<(const std::string& string) requires writeable<buf_type> {
+	binary_stream& operator<<(const std_string auto& string) requires writeable<buf_type> {
 		return *this << prefixed(string);
 	}
 
@@ -485,6 +673,183 @@ public:
 		write(filled.data(), filled.size());
 	}
 
+	/**
+	 * @brief Handle to space reserved within the stream for a value that
+	 * isn't known until later, such as a length prefix.
+	 * 
+	 * @tparam T The type of the value.
+	 */
+	template<arithmetic T>
+	class slot {
+		using handle_type = typename buf_type::placeholder_type;
+
+		binary_stream* stream_ = nullptr;
+		handle_type handle_{};
+
+	public:
+		slot() = default;
+
+		slot(binary_stream* stream, handle_type handle)
+			: stream_(stream), handle_(handle) {}
+
+		/**
+		 * @brief Writes the value into the reserved space, using the stream's
+		 * byte order.
+		 * 
+		 * @param value The value to be written.
+		 */
+		void fill(const T value) {
+			if(!stream_) [[unlikely]] {
+				return;
+			}
+
+			const auto converted = endian::storage_in(value, byte_order);
+			stream_->buffer_.fill_placeholder(handle_, &converted, sizeof(converted));
+		}
+
+		/**
+		 * @return False if the space could not be reserved.
+		 */
+		bool valid() const {
+			return stream_ != nullptr;
+		}
+	};
+
+	/**
+	 * @brief Handle to space reserved within the stream for a varint that
+	 * isn't known until later. Enough space is reserved for the largest
+	 * possible encoding of T.
+	 * 
+	 * @tparam T The type of the value.
+	 */
+	template<std::unsigned_integral T>
+	class varint_slot {
+		using handle_type = typename buf_type::placeholder_type;
+
+		binary_stream* stream_ = nullptr;
+		handle_type handle_{};
+
+	public:
+		static constexpr size_type max_width = (sizeof(T) * 8 + 6) / 7;
+
+		varint_slot() = default;
+
+		varint_slot(binary_stream* stream, handle_type handle)
+			: stream_(stream), handle_(handle) {}
+
+		/**
+		 * @brief Writes the value into the reserved space. Continuation bytes
+		 * are used to pad the encoding out to the reserved width, which is
+		 * still a valid encoding of the value.
+		 * 
+		 * @param value The value to be written.
+		 */
+		void fill(T value) {
+			if(!stream_) [[unlikely]] {
+				return;
+			}
+
+			std::array<std::uint8_t, max_width> bytes;
+
+			for(size_type i = 0; i < max_width - 1; ++i) {
+				bytes[i] = (value & 0x7f) | 0x80;
+				value >>= 7;
+			}
+
+			bytes[max_width - 1] = static_cast<std::uint8_t>(value & 0x7f);
+			stream_->buffer_.fill_placeholder(handle_, bytes.data(), bytes.size());
+		}
+
+		/**
+		 * @brief Writes the value into the reserved space using the shortest
+		 * encoding and then shifts any data written after the slot back to
+		 * close the gap.
+		 * 
+		 * @note Only available for contiguous buffers. Any placeholders
+		 * reserved after this one must be filled first.
+		 * 
+		 * @param value The value to be written.
+		 */
+		void fill_compact(T value) requires placeholder_addressable<buf_type> {
+			if(!stream_) [[unlikely]] {
+				return;
+			}
+
+			std::array<std::uint8_t, max_width> bytes;
+			size_type width = 0;
+
+			while(value > 0x7f) {
+				bytes[width++] = (value & 0x7f) | 0x80;
+				value >>= 7;
+			}
+
+			bytes[width++] = static_cast<std::uint8_t>(value);
+
+			auto& buffer = stream_->buffer_;
+			const auto slot = buffer.placeholder_ptr(handle_);
+			const auto body = slot + max_width;
+			const auto body_size = static_cast<size_type>(buffer.write_ptr() - body);
+			const auto shift = max_width - width;
+
+			std::memcpy(slot, bytes.data(), width);
+
+			if(shift) {
+				std::memmove(slot + width, body, body_size * sizeof(value_type));
+				buffer.write_seek(buffer_seek::sk_backward, shift);
+				stream_->total_write_ -= shift;
+			}
+		}
+
+		/**
+		 * @return False if the space could not be reserved.
+		 */
+		bool valid() const {
+			return stream_ != nullptr;
+		}
+	};
+
+	/**
+	 * @brief Reserves space for a value to be filled in later, without
+	 * having to seek back to it.
+	 * 
+	 * @tparam T The type of the value.
+	 * 
+	 * @return A slot that can be used to fill in the value. If the
+	 * stream is in an error state, the slot will be invalid.
+	 */
+	template<arithmetic T>
+	[[nodiscard]] slot<T> placeholder()
+	requires writeable<buf_type> && placeholder_capable<buf_type> {
+		typename buf_type::placeholder_type handle{};
+
+		if(!reserve_placeholder(sizeof(T), handle)) {
+			return {};
+		}
+
+		return { this, handle };
+	}
+
+	/**
+	 * @brief Reserves space for a varint to be filled in later, without
+	 * having to seek back to it.
+	 * 
+	 * @tparam T The type of the value.
+	 * 
+	 * @return A slot that can be used to fill in the value. If the
+	 * stream is in an error state, the slot will be invalid.
+	 */
+	template<std::unsigned_integral T = std::uint32_t>
+	[[nodiscard]] varint_slot<T> placeholder_varint()
+	requires writeable<buf_type> && placeholder_capable<buf_type> {
+		typename buf_type::placeholder_type handle{};
+
+		if(!reserve_placeholder(varint_slot<T>::max_width, handle)) {
+			return {};
+		}
+
+		return { this, handle };
+	}
+
 	/*** Read ***/
 
 	/**
@@ -521,7 +886,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(prefixed<std::string> adaptor) {
+	template<std_string T>
+	binary_stream& operator>>(prefixed<T> adaptor) {
 		std::uint32_t size = 0;
 		*this >> endian::le(size);
 
@@ -572,7 +938,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(prefixed_varint<std::string> adaptor) {
+	template<std_string T>
+	binary_stream& operator>>(prefixed_varint<T> adaptor) {
 		const auto size = impl::varint_decode<size_type>(*this);
 
 		// if an error was triggered during decode
@@ -623,7 +990,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(null_terminated<std::string> adaptor) {
+	template<std_string T>
+	binary_stream& operator>>(null_terminated<T> adaptor) {
 		auto pos = buffer_.find_first_of(value_type(0));
 
 		if(pos == buf_type::npos) {
@@ -686,7 +1054,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(std::string& data) {
+	binary_stream& operator>>(std_string auto& data) {
 		return *this >> prefixed(data);
 	}
 
@@ -716,6 +1084,38 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Deserialises one or more values that were written with
+	 * a packing adaptor.
+	 * 
+	 * @param[out] adaptor A packing adaptor, such as hexi::quantised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<std::derived_from<packed_tag_t> packed_type>
+	binary_stream& operator>>(packed_type adaptor) {
+		static_assert(!std::is_const_v<typename packed_type::value_type>, "cannot read into const values");
+
+		using wire_type = typename packed_type::wire_type;
+		std::array<wire_type, packed_batch> staged;
+		auto values = adaptor.values;
+
+		while(!values.empty()) {
+			const auto count = std::min(values.size(), staged.size());
+			SAFE_READ(staged.data(), static_cast<size_type>(count * sizeof(wire_type)), *this);
+
+			for(std::size_t i = 0; i < count; ++i) {
+				auto value = staged[i];
+				endian::storage_out(value, byte_order);
+				values[i] = adaptor.codec.decode(value);
+			}
+
+			values = values.subspan(count);
+		}
+
+		return *this;
+	}
+
 	/**
 	 * @brief Deserialises an arithmetic point type with the default byte order.
 	 * 
@@ -747,13 +1147,34 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Deserialises an aggregate that doesn't provide its own serialisation
+	 * functions, one field at a time. Runs of adjacent arithmetic and POD
+	 * fields with no padding between them are read as a single block, with
+	 * a single bounds check.
+	 * 
+	 * @tparam T The aggregate type.
+	 * @param[out] data The object to hold the result.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<field_serialisable T>
+	requires (!has_deserialise<T, binary_stream> && !has_shr_override<T, binary_stream>)
+	binary_stream& operator>>(T& data) {
+		impl::visit_fields(data, [&](auto&... fields) {
+			read_fields<0>(data, std::tie(fields...));
+		});
+
+		return *this;
+	}
+
 	/**
 	 * @brief Deserialises an iterable container that was previously written
 	 * with a fixed-length prefix.
 	 * 
 	 * @tparam T The iterable container type.
 	 * @param[out] adaptor The container to hold the result.
-	 *
+	 * 
 	 * @return Reference to the current stream.
 	 */
 	template<is_iterable T>
@@ -833,7 +1254,7 @@ public:
 	 * 
 	 * @param dest The destination string.
 	 */
-	void get(std::string& dest) {
+	void get(std_string auto& dest) {
 		*this >> dest;
 	}
 
@@ -843,7 +1264,7 @@ public:
 	 * @param[out] dest The std::string to hold the result.
 	 * @param count The number of bytes to be read.
 	 */
-	void get(std::string& dest, size_type size) {
+	void get(std_string auto& dest, size_type size) {
 		STREAM_READ_BOUNDS_ENFORCE(size, void());
 
 		dest.resize_and_overwrite(size, [&](char* strbuf, size_type len) {
@@ -891,7 +1312,7 @@ public:
 
 	/**
 	 * @brief Skip over a number of bytes.
-	 *
+	 * 
 	 * Skips over a number of bytes from the stream. This should be used
 	 * if the stream holds data that you don't care about but don't want
 	 * to have to read it to another buffer to access data beyond it.
@@ -1046,6 +1467,30 @@ public:
 		return read_limit_;
 	}
 
+	/**
+	 * @brief Binds a memory resource to the stream. When deserialising into
+	 * a container that has no allocator of its own to hand down, such as a
+	 * std::vector<std::pmr::string>, its allocator-aware elements are
+	 * constructed with this resource.
+	 * 
+	 * Containers that do have an allocator, such as std::pmr::vector, always
+	 * pass it on to their elements, so a message tree read into pmr containers
+	 * lives entirely within the resource of the outermost container.
+	 * 
+	 * @param resource The resource to bind, or nullptr to use default
+	 * construction.
+	 */
+	void memory_resource(std::pmr::memory_resource* resource) {
+		resource_ = resource;
+	}
+
+	/**
+	 * @return The memory resource bound to the stream, if any.
+	 */
+	std::pmr::memory_resource* memory_resource() const {
+		return resource_;
+	}
+
 	/**
 	 * @brief Determine the maximum number of bytes that can be
 	 * safely read from this stream.
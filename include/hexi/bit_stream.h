@@ -0,0 +1,443 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/shared.h>
+#include <hexi/concepts.h>
+#include <hexi/exception.h>
+#include <hexi/endian.h>
+#include <hexi/stream_adaptors.h>
+#include <array>
+#include <concepts>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace hexi {
+
+namespace bit_order {
+
+struct order_tag {};
+struct msb_first_t final : order_tag {};
+struct lsb_first_t final : order_tag {};
+
+[[maybe_unused]] constexpr static msb_first_t msb_first {};
+[[maybe_unused]] constexpr static lsb_first_t lsb_first {};
+
+} // bit_order
+
+/**
+ * Stream for reading and writing values that aren't a whole number of bytes
+ * wide, such as flags and small enums, without having to pack them by hand.
+ * 
+ * Writes are collected in a 64-bit accumulator and written to the buffer a
+ * word at a time. Anything left in the accumulator is only written by flush(),
+ * which must be called before the buffer is used for anything else.
+ * 
+ * Reads only take as many bytes from the buffer as are needed to satisfy
+ * each request, so once the stream has been aligned, the rest of the buffer
+ * can be read as normal, such as by a binary_stream.
+ * 
+ * With msb_first, values are packed starting from the most significant bit of
+ * each byte, which is the usual network convention. With lsb_first, they're
+ * packed from the least significant bit.
+ */
+template<
+	byte_oriented buf_type,
+	std::derived_from<except_tag> exceptions = HEXI_EXCEPTION_TAG,
+	std::derived_from<bit_order::order_tag> order = bit_order::msb_first_t
+>
+class bit_stream final {
+public:
+	using size_type  = typename buf_type::size_type;
+	using value_type = typename buf_type::value_type;
+
+	static constexpr unsigned max_bits = 64;
+
+private:
+	static constexpr bool msb_first = std::is_same_v<order, bit_order::msb_first_t>;
+
+	buf_type& buffer_;
+	std::uint64_t write_acc_ = 0;
+	std::uint64_t read_acc_ = 0;
+	unsigned write_bits_ = 0;
+	unsigned read_bits_ = 0;
+	std::size_t total_write_ = 0;
+	std::size_t total_read_ = 0;
+	stream_state state_ = stream_state::ok;
+
+	static constexpr std::uint64_t mask(const unsigned count) {
+		return count >= max_bits? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+	}
+
+	void write(const void* data, const size_type size) {
+		HEXI_TRY {
+			if(state_ == stream_state::ok) [[likely]] {
+				buffer_.write(data, size);
+			}
+		} HEXI_CATCH(...) {
+			state_ = stream_state::buff_write_err;
+
+			if constexpr(std::is_same_v<exceptions, allow_throw_t>) {
+				HEXI_THROW();
+			}
+		}
+	}
+
+	void write_word() {
+		std::uint64_t word = 0;
+
+		if constexpr(msb_first) {
+			word = endian::native_to_big(write_acc_);
+		} else {
+			word = endian::native_to_little(write_acc_);
+		}
+
+		write(&word, sizeof(word));
+		write_acc_ = 0;
+		write_bits_ = 0;
+	}
+
+	/*
+	 * Reads enough whole bytes to hold at least count bits, where
+	 * count is no more than 32, so the accumulator can't overflow
+	 */
+	bool fill(const unsigned count) {
+		if(state_ != stream_state::ok) [[unlikely]] {
+			return false;
+		}
+
+		if(read_bits_ >= count) {
+			return true;
+		}
+
+		const auto bytes = (count - read_bits_ + 7) / 8;
+
+		if(bytes > buffer_.size()) [[unlikely]] {
+			state_ = stream_state::buff_limit_err;
+
+			if constexpr(std::is_same_v<exceptions, allow_throw_t>) {
+				HEXI_THROW(buffer_underrun(bytes, total_read_ / 8, buffer_.size()));
+			}
+
+			return false;
+		}
+
+		std::array<std::uint8_t, 8> data;
+		buffer_.read(data.data(), bytes);
+
+		for(std::size_t i = 0; i < bytes; ++i) {
+			if constexpr(msb_first) {
+				read_acc_ = (read_acc_ << 8) | data[i];
+			} else {
+				read_acc_ |= std::uint64_t(data[i]) << read_bits_;
+			}
+
+			read_bits_ += 8;
+		}
+
+		return true;
+	}
+
+	std::uint64_t read(const unsigned count) {
+		assert(count <= 32);
+
+		if(!fill(count)) [[unlikely]] {
+			return 0;
+		}
+
+		std::uint64_t value = 0;
+		read_bits_ -= count;
+
+		if constexpr(msb_first) {
+			value = (read_acc_ >> read_bits_) & mask(count);
+			read_acc_ &= mask(read_bits_);
+		} else {
+			value = read_acc_ & mask(count);
+			read_acc_ >>= count;
+		}
+
+		total_read_ += count;
+		return value;
+	}
+
+public:
+	explicit bit_stream(buf_type& source)
+		: buffer_(source) {}
+
+	explicit bit_stream(buf_type& source, exceptions)
+		: bit_stream(source) {}
+
+	explicit bit_stream(buf_type& source, order)
+		: bit_stream(source) {}
+
+	explicit bit_stream(buf_type& source, exceptions, order)
+		: bit_stream(source) {}
+
+	bit_stream(bit_stream&&) = delete;
+	bit_stream& operator=(bit_stream&&) = delete;
+	bit_stream& operator=(bit_stream&) = delete;
+	bit_stream(bit_stream&) = delete;
+
+	~bit_stream() {
+		assert((!write_bits_ || state_ != stream_state::ok) && "bit_stream destroyed without being flushed");
+	}
+
+	/*** Write ***/
+
+	/**
+	 * @brief Writes the low bits of a value.
+	 * 
+	 * @param value The value to be written. Any bits above count are ignored,
+	 * so negative values can be written and read back with get_bits<signed type>.
+	 * @param count The number of bits to write, up to 64.
+	 */
+	void put_bits(const std::integral auto value, const unsigned count) requires writeable<buf_type> {
+		assert(count <= max_bits);
+
+		const auto bits = static_cast<std::uint64_t>(value) & mask(count);
+		const auto space = max_bits - write_bits_;
+
+		if(count < space) {
+			if constexpr(msb_first) {
+				write_acc_ = (write_acc_ << count) | bits;
+			} else {
+				write_acc_ |= bits << write_bits_;
+			}
+
+			write_bits_ += count;
+		} else {
+			// fill the accumulator, write it out and carry the remainder
+			const auto remainder = count - space;
+
+			if constexpr(msb_first) {
+				write_acc_ = space == max_bits? bits >> remainder : (write_acc_ << space) | (bits >> remainder);
+				write_word();
+				write_acc_ = bits & mask(remainder);
+			} else {
+				write_acc_ |= bits << write_bits_;
+				write_word();
+				write_acc_ = space == max_bits? 0 : bits >> space;
+			}
+
+			write_bits_ = remainder;
+		}
+
+		total_write_ += count;
+	}
+
+	/**
+	 * @brief Writes a single bit.
+	 * 
+	 * @param value The value to be written.
+	 */
+	void put_bit(const bool value) requires writeable<buf_type> {
+		put_bits(value, 1);
+	}
+
+	/**
+	 * @brief Writes one or more values with a packing adaptor, using only
+	 * as many bits as the adaptor's codec requires, rather than rounding up
+	 * to whole bytes.
+	 * 
+	 * @param adaptor A packing adaptor, such as hexi::quantised.
+	 */
+	template<std::derived_from<packed_tag_t> packed_type>
+	void put(const packed_type& adaptor) requires writeable<buf_type> {
+		for(const auto& value : adaptor.values) {
+			put_bits(adaptor.codec.encode(value), packed_type::bits);
+		}
+	}
+
+	/**
+	 * @brief Pads the written bits with zeroes up to the next byte boundary.
+	 */
+	void align_write() requires writeable<buf_type> {
+		if(const auto partial = write_bits_ % 8) {
+			put_bits(0, 8 - partial);
+		}
+	}
+
+	/**
+	 * @brief Pads the written bits up to the next byte boundary and writes
+	 * anything remaining in the accumulator to the buffer.
+	 */
+	void flush() requires writeable<buf_type> {
+		align_write();
+
+		if(!write_bits_) {
+			return;
+		}
+
+		const auto bytes = write_bits_ / 8;
+		std::uint64_t word = 0;
+
+		if constexpr(msb_first) {
+			word = endian::native_to_big(write_acc_ << (max_bits - write_bits_));
+		} else {
+			word = endian::native_to_little(write_acc_);
+		}
+
+		write(&word, bytes);
+		write_acc_ = 0;
+		write_bits_ = 0;
+	}
+
+	/*** Read ***/
+
+	/**
+	 * @brief Reads a value that was written with put_bits.
+	 * 
+	 * @tparam T The type to read into. Signed types are sign extended
+	 * from the most significant of the bits read.
+	 * @param count The number of bits to read, up to 64.
+	 * 
+	 * @return The value read, or zero if there was an error.
+	 */
+	template<std::integral T = std::uint64_t>
+	T get_bits(const unsigned count) {
+		assert(count <= max_bits);
+		assert(count <= sizeof(T) * 8);
+
+		std::uint64_t value = 0;
+
+		if(count <= 32) {
+			value = read(count);
+		} else if constexpr(msb_first) {
+			value = read(count - 32) << 32;
+			value |= read(32);
+		} else {
+			value = read(32);
+			value |= read(count - 32) << 32;
+		}
+
+		if constexpr(std::is_signed_v<T>) {
+			if(count && count < max_bits) {
+				const auto sign = std::uint64_t(1) << (count - 1);
+				value = (value ^ sign) - sign;
+			}
+		}
+
+		return static_cast<T>(value);
+	}
+
+	/**
+	 * @brief Reads a single bit.
+	 * 
+	 * @return The value of the bit.
+	 */
+	bool get_bit() {
+		return read(1) != 0;
+	}
+
+	/**
+	 * @brief Reads one or more values that were written with put().
+	 * 
+	 * @param adaptor A packing adaptor, such as hexi::quantised.
+	 */
+	template<std::derived_from<packed_tag_t> packed_type>
+	void get(const packed_type& adaptor) {
+		static_assert(!std::is_const_v<typename packed_type::value_type>, "cannot read into const values");
+		using wire_type = typename packed_type::wire_type;
+
+		for(auto& value : adaptor.values) {
+			value = adaptor.codec.decode(get_bits<wire_type>(packed_type::bits));
+		}
+	}
+
+	/**
+	 * @brief Discards any bits remaining in the current byte, so that
+	 * the next read starts at a byte boundary.
+	 */
+	void align_read() {
+		total_read_ += read_bits_;
+		read_acc_ = 0;
+		read_bits_ = 0;
+	}
+
+	/**
+	 * @return The total number of bits written to the stream, including
+	 * any still held in the accumulator.
+	 */
+	std::size_t total_write() const requires writeable<buf_type> {
+		return total_write_;
+	}
+
+	/**
+	 * @return The total number of bits read from the stream.
+	 */
+	std::size_t total_read() const {
+		return total_read_;
+	}
+
+	/**
+	 * @return true if the next write starts at a byte boundary.
+	 */
+	bool write_aligned() const {
+		return !(write_bits_ % 8);
+	}
+
+	/**
+	 * @return true if the next read starts at a byte boundary.
+	 */
+	bool read_aligned() const {
+		return !read_bits_;
+	}
+
+	/**
+	 * @return Pointer to stream's underlying buffer.
+	 */
+	const buf_type* buffer() const {
+		return &buffer_;
+	}
+
+	/**
+	 * @return Pointer to stream's underlying buffer.
+	 */
+	buf_type* buffer() {
+		return &buffer_;
+	}
+
+	/**
+	 * @return The stream's state.
+	 */
+	stream_state state() const {
+		return state_;
+	}
+
+	/**
+	 * @brief Determine whether the stream is in a usable state.
+	 * 
+	 * @return true if no errors have occurred.
+	 */
+	bool good() const {
+		return state_ == stream_state::ok;
+	}
+
+	/**
+	 * @brief Resets the stream state back to a good state, allowing
+	 * it to be used for streaming operations again. Has no effect
+	 * if the stream has not errored.
+	 */
+	void clear_state() {
+		state_ = stream_state::ok;
+	}
+
+	operator bool() const {
+		return good();
+	}
+
+	/**
+	 * @brief Set the stream to an error state.
+	 */
+	void set_error_state() {
+		state_ = stream_state::user_defined_err;
+	}
+};
+
+} // hexi
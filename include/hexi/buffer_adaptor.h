@@ -9,6 +9,8 @@
 #include <hexi/shared.h>
 #include <hexi/concepts.h>
 #include <hexi/exception.h>
+#include <algorithm>
+#include <concepts>
 #include <ranges>
 #include <type_traits>
 #include <utility>
@@ -18,7 +20,49 @@
 
 namespace hexi {
 
-template<byte_oriented buf_type, bool space_optimise = true>
+struct no_compaction {};
+struct exact_growth {};
+
+/**
+ * Moves unread data to the front of the buffer before a write once the
+ * consumed prefix is at least 'threshold' bytes or at least 'ratio_percent'
+ * of the written region, whichever is reached first. This bounds memory use
+ * for streams that are rarely fully drained.
+ */
+template<std::size_t threshold = 65536, std::size_t ratio_percent = 50>
+requires (ratio_percent > 0 && ratio_percent <= 100)
+struct compact : no_compaction {
+	static constexpr std::size_t min_bytes = threshold;
+	static constexpr std::size_t ratio = ratio_percent;
+};
+
+/**
+ * Grows the underlying buffer's capacity by a factor of its current capacity
+ * rather than to the exact size required by a write, so that a stream of
+ * small writes does not reallocate the buffer on every call. The buffer's
+ * size is still only grown to the size required.
+ */
+template<std::size_t numerator = 2, std::size_t denominator = 1>
+requires (numerator > denominator && denominator > 0)
+struct geometric_growth : exact_growth {
+	static constexpr std::size_t num = numerator;
+	static constexpr std::size_t den = denominator;
+};
+
+/**
+ * CompactionPolicy: 'compact' moves unread data to the front of the buffer
+ * when enough of it has been consumed. Compaction only happens during writes,
+ * so pointers obtained from reads (e.g. view() and span()) remain valid
+ * until the next write, as they would if the buffer were to grow.
+ * 
+ * GrowthPolicy: 'geometric_growth' reserves capacity geometrically rather
+ * than to the exact size required.
+ */
+template<byte_oriented buf_type,
+	bool space_optimise = true,
+	std::derived_from<no_compaction> compaction = no_compaction,
+	std::derived_from<exact_growth> growth = exact_growth
+>
 requires std::ranges::contiguous_range<buf_type>
 class buffer_adaptor final {
 public:
@@ -28,12 +72,64 @@ public:
 	using contiguous  = is_contiguous;
 	using seeking     = supported;
 
+	/*
+	 * Logical offset of the reserved region, which remains valid if the
+	 * buffer is compacted or reallocated.
+	 */
+	using placeholder_type = size_type;
+
 	static constexpr auto npos { static_cast<size_type>(-1) };
 
 private:
 	buf_type& buffer_;
 	size_type read_;
 	size_type write_;
+	size_type discarded_ = 0; // bytes removed from the front by defragmenting
+
+	void compact_if_needed() {
+		if constexpr(!std::is_same_v<compaction, no_compaction>) {
+			if(!read_) {
+				return;
+			}
+
+			if(read_ >= compaction::min_bytes || read_ * 100 >= write_ * compaction::ratio) {
+				defragment();
+			}
+		}
+	}
+
+	void prepare_write(size_type length) {
+		compact_if_needed();
+		const auto min_req_size = write_ + length;
+
+		if(buffer_.size() < min_req_size) [[likely]] {
+			reserve_growth(min_req_size);
+
+			if constexpr(has_resize_overwrite<buf_type>) {
+				buffer_.resize_and_overwrite(min_req_size, [](char*, size_type size) {
+					return size;
+				});
+			} else if constexpr(has_resize<buf_type>) {
+				buffer_.resize(min_req_size);
+			} else {
+				HEXI_THROW(buffer_overflow(length, write_, free()));
+			}
+		}
+	}
+
+	/*
+	 * Only the capacity grows geometrically, the size is always exact so
+	 * that the container never holds more elements than have been written
+	 */
+	void reserve_growth(const size_type min_req_size) {
+		if constexpr(!std::is_same_v<growth, exact_growth> && has_reserve<buf_type>) {
+			const auto capacity = static_cast<size_type>(buffer_.capacity());
+
+			if(capacity < min_req_size) {
+				buffer_.reserve(std::max<size_type>(min_req_size, capacity / growth::den * growth::num));
+			}
+		}
+	}
 
 public:
 	buffer_adaptor(buf_type& buffer)
@@ -154,24 +250,50 @@ public:
 	 */
 	void write(const void* source, size_type length) {
 		assert(source && !region_overlap(source, length, buffer_.data(), buffer_.size()));
-		const auto min_req_size = write_ + length;
-
-		if(buffer_.size() < min_req_size) [[likely]] {
-			if constexpr(has_resize_overwrite<buf_type>) {
-				buffer_.resize_and_overwrite(min_req_size, [](char*, size_type size) {
-					return size;
-				});
-			} else if constexpr(has_resize<buf_type>) {
-				buffer_.resize(min_req_size);
-			} else {
-				HEXI_THROW(buffer_overflow(length, write_, free()));
-			}
-		}
-
+		prepare_write(length);
 		std::memcpy(write_ptr(), source, length);
 		write_ += length;
 	}
 
+	/**
+	 * @brief Reserves space at the write cursor to be filled in later.
+	 * 
+	 * @note The placeholder is invalidated by clear() or once its contents
+	 * have been read.
+	 * 
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
+	 */
+	placeholder_type reserve_placeholder(size_type length) {
+		prepare_write(length);
+		const auto offset = write_ + discarded_;
+		write_ += length;
+		return offset;
+	}
+
+	/**
+	 * @brief Writes data into previously reserved space.
+	 * 
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(placeholder_type placeholder, const void* source, size_type length) {
+		std::memcpy(placeholder_ptr(placeholder), source, length);
+	}
+
+	/**
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * 
+	 * @return Pointer to the start of the reserved space.
+	 */
+	auto placeholder_ptr(placeholder_type placeholder) {
+		assert(placeholder >= discarded_ + read_ && "placeholder has been read");
+		return buffer_.data() + (placeholder - discarded_);
+	}
+
 	/**
 	 * @brief Reserves a number of bytes within the container for future use.
 	 * 
@@ -355,6 +477,29 @@ public:
 		return buffer_.size() - write_;
 	}
 	
+	/**
+	 * @brief Moves any unread data to the front of the buffer, freeing space at the end.
+	 * If a move is performed, pointers obtained from read/write_ptr() will be invalidated.
+	 * 
+	 * @return True if additional space was made available.
+	 */
+	bool defragment() {
+		if(read_ == 0) {
+			return false;
+		}
+
+		const auto remaining = size();
+
+		if(remaining) {
+			std::memmove(buffer_.data(), read_ptr(), remaining * sizeof(value_type));
+		}
+
+		discarded_ += read_;
+		read_ = 0;
+		write_ = remaining;
+		return true;
+	}
+
 	/*
 	 * @brief Resets both the read and write cursors back to the beginning
 	 * of the buffer.
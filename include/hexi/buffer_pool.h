@@ -0,0 +1,139 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <cstddef>
+
+namespace hexi {
+
+/**
+ * Recycles whole buffer objects, for code that would otherwise create and
+ * destroy a buffer for every message.
+ * 
+ * Buffers are handed out as a unique_ptr whose deleter returns them to the
+ * pool. A returned buffer has its remaining data skipped rather than being
+ * cleared, so a dynamic_buffer keeps its last block linked and any spare
+ * blocks it holds (see spare_blocks), meaning that it comes back warm.
+ * Combined with tls_block_allocator, a hot message path can run without
+ * allocating at all.
+ * 
+ * A pool is not thread-safe and is intended to be used from a single thread,
+ * which also keeps buffers backed by tls_block_allocator on the thread that
+ * allocated their blocks. local() provides a pool per thread. The pool must
+ * outlive any buffers acquired from it.
+ * 
+ * @tparam buf_type The type of buffer to pool.
+ * @tparam max_pooled The maximum number of idle buffers to hold on to. Any
+ * buffers returned beyond this are destroyed.
+ */
+template<typename buf_type, std::size_t max_pooled = 32>
+requires (max_pooled > 0)
+class buffer_pool final {
+public:
+	class deleter {
+		buffer_pool* pool_ = nullptr;
+
+	public:
+		deleter() = default;
+		explicit deleter(buffer_pool* pool) : pool_(pool) {}
+
+		void operator()(buf_type* buffer) const {
+			pool_->release(buffer);
+		}
+	};
+
+	using size_type = std::size_t;
+	using pointer = std::unique_ptr<buf_type, deleter>;
+
+private:
+	std::array<buf_type*, max_pooled> idle_;
+	size_type count_ = 0;
+
+	void release(buf_type* buffer) {
+		if(count_ == max_pooled) {
+			delete buffer;
+			return;
+		}
+
+		if(!buffer->empty()) {
+			buffer->skip(buffer->size());
+		}
+
+		idle_[count_++] = buffer;
+	}
+
+public:
+	buffer_pool() = default;
+	buffer_pool(const buffer_pool&) = delete;
+	buffer_pool& operator=(const buffer_pool&) = delete;
+
+	~buffer_pool() {
+		shrink_to_fit();
+	}
+
+	/**
+	 * @brief Retrieves an idle buffer from the pool or creates a new one if
+	 * the pool is empty.
+	 * 
+	 * @return An empty buffer, which will be returned to the pool once released.
+	 */
+	[[nodiscard]] pointer acquire() {
+		if(count_) [[likely]] {
+			return pointer(idle_[--count_], deleter(this));
+		}
+
+		return pointer(new buf_type(), deleter(this));
+	}
+
+	/**
+	 * @brief Creates idle buffers up front, so that the first acquisitions
+	 * don't need to allocate.
+	 * 
+	 * @param count The number of idle buffers the pool should hold.
+	 */
+	void reserve(size_type count) {
+		if(count > max_pooled) {
+			count = max_pooled;
+		}
+
+		while(count_ < count) {
+			idle_[count_++] = new buf_type();
+		}
+	}
+
+	/**
+	 * @brief Destroys all idle buffers held by the pool.
+	 */
+	void shrink_to_fit() {
+		while(count_) {
+			delete idle_[--count_];
+		}
+	}
+
+	/**
+	 * @return The number of idle buffers held by the pool.
+	 */
+	size_type size() const {
+		return count_;
+	}
+
+	/**
+	 * @note Idle buffers using tls_block_allocator should be released with
+	 * shrink_to_fit() before the thread exits, as the order in which the
+	 * thread-local pool and allocator are destroyed is not guaranteed.
+	 * 
+	 * @return The pool belonging to the calling thread.
+	 */
+	static buffer_pool& local() {
+		static thread_local buffer_pool pool;
+		return pool;
+	}
+};
+
+} // hexi
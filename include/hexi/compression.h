@@ -0,0 +1,810 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/shared.h>
+#include <hexi/concepts.h>
+#include <hexi/endian.h>
+#include <hexi/exception.h>
+#include <hexi/allocators/default_init_allocator.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef HEXI_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HEXI_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace hexi {
+
+namespace compression {
+
+constexpr std::size_t default_block_size = 16384;
+
+/**
+ * Requirements for a codec used by compressing_buffer and decompressing_buffer.
+ * Each block is compressed independently of any other.
+ */
+template<typename codec_type>
+concept block_codec = requires(const codec_type& codec, const std::uint8_t* source,
+                               std::uint8_t* dest, std::size_t size) {
+	// the largest compressed size that size bytes of input can produce
+	{ codec.bound(size) } -> std::same_as<std::size_t>;
+
+	// returns the compressed size, or zero on failure
+	{ codec.compress(source, size, dest, size) } -> std::same_as<std::size_t>;
+
+	// true only if exactly the requested number of bytes were produced
+	{ codec.decompress(source, size, dest, size) } -> std::same_as<bool>;
+};
+
+/**
+ * Built-in LZ77 codec, using the same sequence layout as LZ4's block format.
+ * It favours speed over ratio, making it suitable for compressing data on the
+ * fly, and is safe to use on untrusted input.
+ */
+class fast_lz final {
+	static constexpr std::size_t min_match = 4;
+	static constexpr std::size_t max_offset = 65535;
+	static constexpr std::size_t last_literals = 5;
+	static constexpr std::size_t match_search_end = 12;
+	static constexpr unsigned hash_bits = 12;
+
+	static std::uint32_t load32(const std::uint8_t* data) {
+		std::uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static std::uint64_t load64(const std::uint8_t* data) {
+		std::uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static std::size_t hash(const std::uint32_t value) {
+		return (value * 2654435761u) >> (32 - hash_bits);
+	}
+
+	static std::size_t match_length(const std::uint8_t* match, const std::uint8_t* current,
+	                                const std::size_t limit) {
+		std::size_t length = min_match;
+
+		for(; length + 8 <= limit; length += 8) {
+			if(const auto diff = load64(match + length) ^ load64(current + length)) {
+				if constexpr(std::endian::native == std::endian::little) {
+					return length + std::countr_zero(diff) / 8;
+				} else {
+					return length + std::countl_zero(diff) / 8;
+				}
+			}
+		}
+
+		for(; length < limit && match[length] == current[length]; ++length);
+		return length;
+	}
+
+	static std::uint8_t* write_length(std::uint8_t* out, std::size_t length) {
+		for(; length >= 255; length -= 255) {
+			*out++ = 255;
+		}
+
+		*out++ = static_cast<std::uint8_t>(length);
+		return out;
+	}
+
+	static std::uint8_t* write_literals(std::uint8_t* out, const std::uint8_t* literals,
+	                                    const std::size_t count, const std::size_t match_code) {
+		*out++ = static_cast<std::uint8_t>((std::min<std::size_t>(count, 15) << 4)
+			| std::min<std::size_t>(match_code, 15));
+
+		if(count >= 15) {
+			out = write_length(out, count - 15);
+		}
+
+		std::memcpy(out, literals, count);
+		return out + count;
+	}
+
+	static bool read_length(const std::uint8_t* source, const std::size_t size,
+	                        std::size_t& in, std::size_t& length, const std::size_t limit) {
+		std::uint8_t byte = 0;
+
+		do {
+			if(in == size) {
+				return false;
+			}
+
+			byte = source[in++];
+			length += byte;
+
+			if(length > limit) {
+				return false;
+			}
+		} while(byte == 255);
+
+		return true;
+	}
+
+public:
+	std::size_t bound(const std::size_t size) const {
+		return size + size / 255 + 16;
+	}
+
+	std::size_t compress(const std::uint8_t* source, const std::size_t size,
+	                     std::uint8_t* dest, const std::size_t capacity) const {
+		if(capacity < bound(size)) {
+			return 0;
+		}
+
+		auto out = dest;
+		std::size_t anchor = 0;
+
+		if(size > match_search_end) {
+			std::array<std::uint32_t, 1u << hash_bits> table {};
+			const auto search_end = size - match_search_end;
+			const auto match_end = size - last_literals;
+			std::size_t pos = 1;
+
+			while(pos < search_end) {
+				const auto sequence = load32(source + pos);
+				auto& entry = table[hash(sequence)];
+				const std::size_t candidate = entry;
+				entry = static_cast<std::uint32_t>(pos);
+
+				if(pos - candidate > max_offset || load32(source + candidate) != sequence) {
+					// the longer it's been since the last match, the further ahead we step
+					pos += 1 + ((pos - anchor) >> 6);
+					continue;
+				}
+
+				const auto length = match_length(source + candidate, source + pos, match_end - pos);
+				const auto offset = pos - candidate;
+				out = write_literals(out, source + anchor, pos - anchor, length - min_match);
+				*out++ = static_cast<std::uint8_t>(offset);
+				*out++ = static_cast<std::uint8_t>(offset >> 8);
+
+				if(length - min_match >= 15) {
+					out = write_length(out, length - min_match - 15);
+				}
+
+				pos += length;
+				anchor = pos;
+			}
+		}
+
+		out = write_literals(out, source + anchor, size - anchor, 0);
+		return static_cast<std::size_t>(out - dest);
+	}
+
+	bool decompress(const std::uint8_t* source, const std::size_t size,
+	                std::uint8_t* dest, const std::size_t raw_size) const {
+		std::size_t in = 0, out = 0;
+
+		while(true) {
+			if(in == size) {
+				return false;
+			}
+
+			const auto token = source[in++];
+			std::size_t literals = token >> 4;
+
+			if(literals == 15 && !read_length(source, size, in, literals, raw_size)) {
+				return false;
+			}
+
+			if(literals > size - in || literals > raw_size - out) {
+				return false;
+			}
+
+			std::memcpy(dest + out, source + in, literals);
+			in += literals;
+			out += literals;
+
+			// the final sequence has no match
+			if(in == size) {
+				return out == raw_size;
+			}
+
+			if(size - in < 2) {
+				return false;
+			}
+
+			const std::size_t offset = source[in] | (source[in + 1] << 8);
+			in += 2;
+
+			if(!offset || offset > out) {
+				return false;
+			}
+
+			std::size_t length = token & 0x0f;
+
+			if(length == 15 && !read_length(source, size, in, length, raw_size)) {
+				return false;
+			}
+
+			length += min_match;
+
+			if(length > raw_size - out) {
+				return false;
+			}
+
+			const auto match = dest + out - offset;
+
+			if(offset >= length) {
+				std::memcpy(dest + out, match, length);
+			} else {
+				// overlapping matches repeat the most recent bytes
+				for(std::size_t i = 0; i < length; ++i) {
+					dest[out + i] = match[i];
+				}
+			}
+
+			out += length;
+		}
+	}
+};
+
+#ifdef HEXI_WITH_ZLIB
+/**
+ * zlib codec, for a better ratio at the expense of speed. Requires
+ * HEXI_WITH_ZLIB to be defined and the program to be linked with zlib.
+ */
+struct zlib final {
+	int level = Z_DEFAULT_COMPRESSION;
+
+	std::size_t bound(const std::size_t size) const {
+		return ::compressBound(static_cast<uLong>(size));
+	}
+
+	std::size_t compress(const std::uint8_t* source, const std::size_t size,
+	                     std::uint8_t* dest, const std::size_t capacity) const {
+		auto length = static_cast<uLongf>(capacity);
+
+		if(::compress2(dest, &length, source, static_cast<uLong>(size), level) != Z_OK) {
+			return 0;
+		}
+
+		return length;
+	}
+
+	bool decompress(const std::uint8_t* source, const std::size_t size,
+	                std::uint8_t* dest, const std::size_t raw_size) const {
+		auto length = static_cast<uLongf>(raw_size);
+		const auto ret = ::uncompress(dest, &length, source, static_cast<uLong>(size));
+		return ret == Z_OK && length == raw_size;
+	}
+};
+#endif
+
+#ifdef HEXI_WITH_ZSTD
+/**
+ * Zstandard codec. Requires HEXI_WITH_ZSTD to be defined and the program
+ * to be linked with libzstd.
+ */
+struct zstd final {
+	int level = ZSTD_CLEVEL_DEFAULT;
+
+	std::size_t bound(const std::size_t size) const {
+		return ZSTD_compressBound(size);
+	}
+
+	std::size_t compress(const std::uint8_t* source, const std::size_t size,
+	                     std::uint8_t* dest, const std::size_t capacity) const {
+		const auto ret = ZSTD_compress(dest, capacity, source, size, level);
+		return ZSTD_isError(ret)? 0 : ret;
+	}
+
+	bool decompress(const std::uint8_t* source, const std::size_t size,
+	                std::uint8_t* dest, const std::size_t raw_size) const {
+		const auto ret = ZSTD_decompress(dest, raw_size, source, size);
+		return !ZSTD_isError(ret) && ret == raw_size;
+	}
+};
+#endif
+
+namespace impl {
+
+/*
+ * Each block is preceded by its uncompressed size and its size as stored,
+ * both 32-bit little endian. The top bit of the stored size is set if the
+ * block didn't compress and was stored as is.
+ */
+constexpr std::size_t header_size = 8;
+constexpr std::uint32_t stored_raw = 0x80000000;
+
+struct block_header {
+	std::size_t raw_size;
+	std::size_t stored_size;
+	bool compressed;
+};
+
+inline void write_header(std::uint8_t* out, const std::size_t raw_size,
+                         const std::size_t stored_size, const bool compressed) {
+	const auto raw = endian::native_to_little(static_cast<std::uint32_t>(raw_size));
+	const auto stored = endian::native_to_little(
+		static_cast<std::uint32_t>(stored_size) | (compressed? 0 : stored_raw)
+	);
+
+	std::memcpy(out, &raw, sizeof(raw));
+	std::memcpy(out + sizeof(raw), &stored, sizeof(stored));
+}
+
+inline block_header read_header(const std::uint8_t* data) {
+	std::uint32_t raw, stored;
+	std::memcpy(&raw, data, sizeof(raw));
+	std::memcpy(&stored, data + sizeof(raw), sizeof(stored));
+	raw = endian::little_to_native(raw);
+	stored = endian::little_to_native(stored);
+
+	return {
+		.raw_size = raw,
+		.stored_size = stored & ~stored_raw,
+		.compressed = !(stored & stored_raw)
+	};
+}
+
+// blocks are only stored compressed if doing so made them smaller
+inline bool valid_header(const block_header& header, const std::size_t block_size) {
+	if(!header.raw_size || header.raw_size > block_size) {
+		return false;
+	}
+
+	if(header.compressed) {
+		return header.stored_size && header.stored_size < header.raw_size;
+	}
+
+	return header.stored_size == header.raw_size;
+}
+
+} // impl
+
+} // compression
+
+/**
+ * Write-only buffer that compresses everything written to it in fixed-size
+ * blocks, writing each compressed block to another buffer. This allows a
+ * binary_stream to serialise straight into compressed output, with only
+ * a single block of uncompressed data being held at any point.
+ * 
+ * A block is only compressed once it's full, so flush() must be called to
+ * compress and write out any partial block once writing is complete. Blocks
+ * that don't compress are stored as is.
+ * 
+ * The output can be read back with a decompressing_buffer using the same
+ * codec and block size.
+ */
+template<
+	writeable buf_type,
+	compression::block_codec codec_type = compression::fast_lz,
+	std::size_t block_sz = compression::default_block_size
+>
+class compressing_buffer final {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = std::size_t;
+	using value_type      = std::byte;
+	using contiguous      = is_non_contiguous;
+	using seeking         = unsupported;
+
+	static_assert(block_sz && block_sz < compression::impl::stored_raw);
+
+private:
+	buf_type& buffer_;
+	codec_type codec_;
+	uninit_vector<std::uint8_t> block_;
+	uninit_vector<std::uint8_t> output_;
+	size_type pending_ = 0;
+	size_type total_in_ = 0;
+	size_type total_out_ = 0;
+
+	void compress_block(const std::uint8_t* data, const size_type size) {
+		using namespace compression::impl;
+
+		const auto compressed = codec_.compress(
+			data, size, output_.data() + header_size, output_.size() - header_size
+		);
+
+		if(compressed && compressed < size) {
+			write_header(output_.data(), size, compressed, true);
+			buffer_.write(output_.data(), header_size + compressed);
+			total_out_ += header_size + compressed;
+		} else {
+			write_header(output_.data(), size, size, false);
+			buffer_.write(output_.data(), header_size);
+			buffer_.write(data, size);
+			total_out_ += header_size + size;
+		}
+	}
+
+	void compress_pending() {
+		// cleared first so a failed write doesn't leave the block to be written again
+		const auto size = std::exchange(pending_, 0);
+		compress_block(block_.data(), size);
+	}
+
+public:
+	/**
+	 * @brief Constructs a compressing_buffer.
+	 * 
+	 * @param buffer The buffer to write compressed blocks to.
+	 * @param codec The codec to compress blocks with.
+	 */
+	explicit compressing_buffer(buf_type& buffer, codec_type codec = {})
+		: buffer_(buffer),
+		  codec_(std::move(codec)),
+		  block_(block_sz),
+		  output_(compression::impl::header_size + codec_.bound(block_sz)) {}
+
+	compressing_buffer(const compressing_buffer&) = delete;
+	compressing_buffer& operator=(const compressing_buffer&) = delete;
+
+	~compressing_buffer() {
+		assert(!pending_ && "compressing_buffer destroyed without being flushed");
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container, compressing each
+	 * block as it's filled.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, size_type length) {
+		auto data = static_cast<const std::uint8_t*>(source);
+		total_in_ += length;
+
+		while(length) {
+			// whole blocks can be compressed without staging them first
+			if(!pending_ && length >= block_sz) {
+				compress_block(data, block_sz);
+				data += block_sz;
+				length -= block_sz;
+				continue;
+			}
+
+			const auto count = std::min(length, block_sz - pending_);
+			std::memcpy(block_.data() + pending_, data, count);
+			pending_ += count;
+			data += count;
+			length -= count;
+
+			if(pending_ == block_sz) {
+				compress_pending();
+			}
+		}
+	}
+
+	/**
+	 * @brief Compresses any partial block and writes it to the underlying buffer.
+	 */
+	void flush() {
+		if(pending_) {
+			compress_pending();
+		}
+	}
+
+	/**
+	 * @return The number of bytes written that have yet to be compressed.
+	 */
+	size_type size() const {
+		return pending_;
+	}
+
+	/**
+	 * @return True if there is no data waiting to be compressed.
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !pending_;
+	}
+
+	/**
+	 * @return The total number of uncompressed bytes written to the buffer.
+	 */
+	size_type total_in() const {
+		return total_in_;
+	}
+
+	/**
+	 * @return The total number of bytes written to the underlying buffer.
+	 */
+	size_type total_out() const {
+		return total_out_;
+	}
+
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	constexpr static bool can_write_seek() {
+		return false;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	buf_type* buffer() {
+		return &buffer_;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	const buf_type* buffer() const {
+		return &buffer_;
+	}
+};
+
+/**
+ * Read-only buffer that decompresses the output of a compressing_buffer as
+ * it's read. The compressed data may arrive in the underlying buffer in any
+ * number of pieces. Once a block has arrived in full, it counts towards
+ * size(), but it's only decompressed once reading reaches it, so only a
+ * single block of uncompressed data is held at any point.
+ * 
+ * Blocks are validated before being decompressed. If a corrupt block is found,
+ * the buffer enters an error state, error() returns true and size() returns
+ * zero from then on, so a stream reading from it fails with buff_limit_err
+ * and reports it according to its own error policy. If the corruption is only
+ * found by the read that reaches the block, the rest of that read is zeroed.
+ * 
+ * size() and empty() take any complete blocks from the underlying buffer,
+ * so unlike other buffers, they aren't const.
+ */
+template<
+	typename buf_type,
+	compression::block_codec codec_type = compression::fast_lz,
+	std::size_t block_sz = compression::default_block_size
+>
+class decompressing_buffer final {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = std::size_t;
+	using value_type      = std::byte;
+	using contiguous      = is_non_contiguous;
+	using seeking         = unsupported;
+
+private:
+	buf_type& buffer_;
+	codec_type codec_;
+	uninit_vector<std::uint8_t> block_;
+	uninit_vector<std::uint8_t> frames_;
+	size_type block_read_ = 0;
+	size_type block_size_ = 0;
+	size_type frames_read_ = 0;
+	size_type available_ = 0;
+	size_type total_read_ = 0;
+	bool error_ = false;
+
+	void fail() {
+		error_ = true;
+		available_ = 0;
+		block_read_ = 0;
+		block_size_ = 0;
+	}
+
+	/*
+	 * Moves any complete blocks out of the underlying buffer, so that their
+	 * uncompressed sizes can be included in size() without decompressing them
+	 */
+	void pull() {
+		using namespace compression::impl;
+
+		while(!error_ && buffer_.size() >= header_size) {
+			std::array<std::uint8_t, header_size> data;
+			buffer_.copy(data.data(), data.size());
+			const auto header = read_header(data.data());
+
+			if(!valid_header(header, block_sz)) {
+				fail();
+				return;
+			}
+
+			if(buffer_.size() - header_size < header.stored_size) {
+				return;
+			}
+
+			if(frames_read_) {
+				frames_.erase(frames_.begin(), frames_.begin() + frames_read_);
+				frames_read_ = 0;
+			}
+
+			const auto offset = frames_.size();
+			const auto length = header_size + header.stored_size;
+			frames_.resize(offset + length);
+			buffer_.read(frames_.data() + offset, length);
+			available_ += header.raw_size;
+		}
+	}
+
+	void decode_next() {
+		using namespace compression::impl;
+
+		const auto frame = frames_.data() + frames_read_;
+		const auto header = read_header(frame);
+		bool success = true;
+
+		if(header.compressed) {
+			success = codec_.decompress(
+				frame + header_size, header.stored_size, block_.data(), header.raw_size
+			);
+		} else {
+			std::memcpy(block_.data(), frame + header_size, header.raw_size);
+		}
+
+		if(!success) {
+			fail();
+			return;
+		}
+
+		frames_read_ += header_size + header.stored_size;
+		available_ -= header.raw_size;
+		block_read_ = 0;
+		block_size_ = header.raw_size;
+
+		total_read_ += header_size + header.stored_size;
+
+		if(frames_read_ == frames_.size()) {
+			frames_.clear();
+			frames_read_ = 0;
+		}
+	}
+
+	template<bool copy>
+	void consume(std::uint8_t* destination, size_type length) {
+		if(length > size()) {
+			HEXI_THROW(buffer_underrun(length, total_read_, size()));
+		}
+
+		while(length && !error_) {
+			if(block_read_ == block_size_) {
+				decode_next();
+				continue;
+			}
+
+			const auto count = std::min(length, block_size_ - block_read_);
+
+			if constexpr(copy) {
+				std::memcpy(destination, block_.data() + block_read_, count);
+				destination += count;
+			}
+
+			block_read_ += count;
+			length -= count;
+		}
+
+		if constexpr(copy) {
+			std::memset(destination, 0, length);
+		}
+	}
+
+public:
+	/**
+	 * @brief Constructs a decompressing_buffer.
+	 * 
+	 * @param buffer The buffer to read compressed blocks from.
+	 * @param codec The codec the blocks were compressed with.
+	 */
+	explicit decompressing_buffer(buf_type& buffer, codec_type codec = {})
+		: buffer_(buffer),
+		  codec_(std::move(codec)),
+		  block_(block_sz) {}
+
+	decompressing_buffer(const decompressing_buffer&) = delete;
+	decompressing_buffer& operator=(const decompressing_buffer&) = delete;
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) {
+		consume<true>(static_cast<std::uint8_t*>(destination), length);
+	}
+
+	/**
+	 * @brief Skip a requested number of bytes.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		consume<false>(nullptr, length);
+	}
+
+	/**
+	 * @brief Returns the amount of uncompressed data available to read,
+	 * including blocks that have arrived but have yet to be decompressed.
+	 * 
+	 * @return The number of bytes of data available to read.
+	 */
+	size_type size() {
+		pull();
+		return (block_size_ - block_read_) + available_;
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() {
+		return !size();
+	}
+
+	/**
+	 * @return The total number of compressed bytes decompressed so far.
+	 */
+	size_type total_read() const {
+		return total_read_;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	buf_type* buffer() {
+		return &buffer_;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	const buf_type* buffer() const {
+		return &buffer_;
+	}
+
+	/**
+	 * @return True if a corrupt block has been found.
+	 */
+	bool error() const {
+		return error_;
+	}
+
+	/**
+	 * @return True if no corrupt blocks have been found.
+	 */
+	operator bool() const {
+		return !error();
+	}
+};
+
+} // hexi
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include <hexi/shared.h>
 #include <hexi/stream_adaptors.h>
 #include <bit>
 #include <concepts>
 #include <ranges>
+#include <string>
 #include <type_traits>
 
 namespace hexi {
@@ -30,6 +32,20 @@ concept contiguous = requires(buf_type t) {
 	std::is_same_v<typename buf_type::contiguous, is_contiguous>;
 };
 
+template<typename buf_type>
+concept placeholder_capable = requires(buf_type t, typename buf_type::placeholder_type p,
+                                       const void* v, typename buf_type::size_type s) {
+	{ t.reserve_placeholder(s) } -> std::same_as<typename buf_type::placeholder_type>;
+	t.fill_placeholder(p, v, s);
+};
+
+template<typename buf_type>
+concept placeholder_addressable = placeholder_capable<buf_type>
+	&& requires(buf_type t, typename buf_type::placeholder_type p) {
+	t.placeholder_ptr(p);
+	t.write_ptr();
+};
+
 template<typename T>
 concept arithmetic = std::integral<T> || std::floating_point<T>;
 
@@ -96,6 +112,10 @@ concept is_iterable =
 		t.begin(); t.end();
 };
 
+template<typename T>
+concept std_string = is_iterable<T> && std::ranges::contiguous_range<T>
+	&& std::same_as<T, std::basic_string<char, std::char_traits<char>, typename T::allocator_type>>;
+
 template<typename T, typename U>
 concept memcpy_read =
 	pod<typename T::value_type> && std::ranges::contiguous_range<T>
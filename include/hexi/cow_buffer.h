@@ -0,0 +1,365 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/shared.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace hexi {
+
+/**
+ * Copy-on-write wrapper around another buffer type, allowing copies to share
+ * the same underlying buffer until one of them needs to modify it. Copying
+ * a cow_buffer only increments a reference count, which makes it cheap to
+ * clone a queued message, e.g. for retransmission.
+ * 
+ * Each instance has its own read cursor over the shared data, so reads and
+ * skips never trigger a copy. Only operations that modify the data, such as
+ * writes, give this instance its own copy of the buffer if it's currently
+ * shared. Once an instance is the sole owner, reads consume the underlying
+ * buffer in place.
+ * 
+ * Reading at an offset into a shared buffer requires that the buffer is
+ * either contiguous (read_ptr()) or provides a view over its blocks (blocks()).
+ * 
+ * Copies may be handed to and used by other threads, provided that each
+ * thread only uses its own instances. A single cow_buffer instance is not
+ * thread-safe.
+ */
+template<typename buf_type>
+class cow_buffer final {
+public:
+	using buffer_type  = buf_type;
+	using value_type   = typename buf_type::value_type;
+	using size_type    = typename buf_type::size_type;
+	using offset_type  = typename buf_type::offset_type;
+	using contiguous   = typename buf_type::contiguous;
+	using seeking      = typename buf_type::seeking;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	std::shared_ptr<buf_type> buffer_;
+	size_type read_ = 0; // bytes this instance has read from the shared buffer
+
+	bool sole_owner() const {
+		if(buffer_.use_count() > 1) {
+			return false;
+		}
+
+		/*
+		 * use_count() is a relaxed load, so pair it with the release made by
+		 * other instances releasing their reference, to ensure that their
+		 * reads of the buffer happen before this instance modifies it
+		 */
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+
+	// gives this instance sole ownership of the buffer before modifying it
+	buf_type& detach() {
+		if(!sole_owner()) {
+			buffer_ = std::make_shared<buf_type>(std::as_const(*buffer_));
+		}
+
+		if(read_) {
+			buffer_->skip(read_);
+			read_ = 0;
+		}
+
+		return *buffer_;
+	}
+
+	/*
+	 * Calls func with each span of the shared buffer's data, starting at
+	 * this instance's read cursor, until it returns false
+	 */
+	template<typename Func>
+	void visit(Func&& func) const {
+		auto offset = read_;
+
+		const auto visit_span = [&](const auto span) {
+			const auto bytes = std::as_bytes(span);
+
+			if(offset >= bytes.size()) {
+				offset -= bytes.size();
+				return true;
+			}
+
+			const auto data = reinterpret_cast<const value_type*>(bytes.data());
+			const auto result = func(std::span(data + offset, bytes.size() - offset));
+			offset = 0;
+			return result;
+		};
+
+		if constexpr(requires { buffer_->read_ptr(); }) {
+			visit_span(std::span(buffer_->read_ptr(), buffer_->size()));
+		} else {
+			for(const auto& block : buffer_->blocks()) {
+				if(!visit_span(block)) {
+					break;
+				}
+			}
+		}
+	}
+
+	void copy_shared(void* destination, const size_type length) const {
+		assert(length <= size() && "cow_buffer copy too large!");
+		auto dest = static_cast<value_type*>(destination);
+		auto remaining = length;
+
+		visit([&](const auto span) {
+			const auto count = std::min<size_type>(remaining, span.size());
+			std::memcpy(dest, span.data(), count);
+			dest += count;
+			remaining -= count;
+			return remaining != 0;
+		});
+	}
+
+public:
+	cow_buffer()
+		: buffer_(std::make_shared<buf_type>()) {}
+
+	/**
+	 * @brief Takes ownership of an existing buffer.
+	 * 
+	 * @param buffer The buffer to be shared.
+	 */
+	explicit cow_buffer(buf_type&& buffer)
+		: buffer_(std::make_shared<buf_type>(std::move(buffer))) {}
+
+	// a moved-from instance may only be assigned to or destroyed
+	cow_buffer(cow_buffer&&) noexcept = default;
+	cow_buffer& operator=(cow_buffer&&) noexcept = default;
+	cow_buffer(const cow_buffer&) = default;
+	cow_buffer& operator=(const cow_buffer&) = default;
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, const size_type length) {
+		if(sole_owner()) {
+			detach().read(destination, length);
+		} else {
+			copy_shared(destination, length);
+			read_ += length;
+		}
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, const size_type length) const {
+		if(read_) {
+			copy_shared(destination, length);
+		} else {
+			buffer_->copy(destination, length);
+		}
+	}
+
+	/**
+	 * @brief Skip the requested number of bytes.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		if(sole_owner()) {
+			detach().skip(length);
+		} else {
+			assert(length <= size() && "cow_buffer skip too large!");
+			read_ += length;
+		}
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, const size_type length) {
+		detach().write(source, length);
+	}
+
+	/**
+	 * @brief Reserves a number of bytes within the container for future use.
+	 * 
+	 * @param length The number of bytes that the container should reserve.
+	 */
+	void reserve(const size_type length) {
+		detach().reserve(length);
+	}
+
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking.
+	 */
+	void write_seek(const buffer_seek direction, const size_type offset) {
+		detach().write_seek(direction, offset);
+	}
+
+	/**
+	 * @brief Clears the container. A shared buffer is released rather than
+	 * copied.
+	 */
+	void clear() {
+		if(sole_owner()) {
+			buffer_->clear();
+		} else {
+			buffer_ = std::make_shared<buf_type>();
+		}
+
+		read_ = 0;
+	}
+
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(const value_type value) const {
+		if(!read_) {
+			return buffer_->find_first_of(value);
+		}
+
+		size_type index = 0;
+		auto position = npos;
+
+		visit([&](const auto span) {
+			if(const auto it = std::ranges::find(span, value); it != span.end()) {
+				position = index + static_cast<size_type>(it - span.begin());
+				return false;
+			}
+
+			index += span.size();
+			return true;
+		});
+
+		return position;
+	}
+
+	/**
+	 * @brief Returns the size of the container.
+	 * 
+	 * @return The number of bytes of data available to read within the container.
+	 */
+	size_type size() const {
+		return buffer_->size() - read_;
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container has no data to be read.
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !size();
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const size_type index) {
+		return detach()[index];
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const size_type index) const {
+		return std::as_const(*buffer_)[read_ + index];
+	}
+
+	/**
+	 * @brief Provides read-only access to the underlying buffer without
+	 * copying it, e.g. for use with buffer_sequence.
+	 * 
+	 * @note The first offset() bytes of the buffer have already been read
+	 * by this instance.
+	 * 
+	 * @return A reference to the underlying buffer.
+	 */
+	const buf_type& get() const {
+		return *buffer_;
+	}
+
+	/**
+	 * @return The number of bytes at the front of the underlying buffer that
+	 * this instance has read but that are retained for other instances.
+	 */
+	size_type offset() const {
+		return read_;
+	}
+
+	/**
+	 * @return True if the underlying buffer is shared with another cow_buffer.
+	 */
+	bool shared() const {
+		return buffer_.use_count() > 1;
+	}
+};
+
+} // hexi
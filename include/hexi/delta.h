@@ -0,0 +1,384 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/shared.h>
+#include <hexi/concepts.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HEXI_DELTA_SSE2
+	#include <emmintrin.h>
+#endif
+
+/**
+ * Delta encoding of a buffer against a baseline, such as the previous snapshot
+ * of an entity's state, so that only the bytes that changed need to be sent.
+ * 
+ * The delta is written to a stream as the size of the new buffer, followed by
+ * a list of changed runs, each being the number of unchanged bytes to skip, the
+ * length of the run and the run's bytes XORed with the baseline. The list is
+ * terminated by a run with a length of zero. All sizes are varints.
+ * 
+ * The baseline and the new buffer can be any mix of contiguous buffers and
+ * dynamic_buffers, and don't need to be the same size. A baseline that's shorter
+ * than the new buffer is treated as though it were padded with zeroes. Neither
+ * buffer is modified.
+ */
+namespace hexi::delta {
+
+namespace impl {
+
+constexpr std::size_t staging_size = 1024;
+
+// unchanged bytes within a run that it's cheaper to include than to split the run
+constexpr std::size_t min_gap = 3;
+
+inline constexpr std::array<std::uint8_t, staging_size> zero_block {};
+
+/*
+ * Returns the number of leading bytes that are the same in both inputs
+ */
+inline std::size_t mismatch(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t size) {
+	std::size_t i = 0;
+
+#ifdef HEXI_DELTA_SSE2
+	for(; i + 16 <= size; i += 16) {
+		const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+		const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+		const auto diff = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xffffu;
+
+		if(diff) {
+			return i + std::countr_zero(diff);
+		}
+	}
+#endif
+
+	for(; i + 8 <= size; i += 8) {
+		std::uint64_t a, b;
+		std::memcpy(&a, lhs + i, sizeof(a));
+		std::memcpy(&b, rhs + i, sizeof(b));
+
+		if(const auto diff = a ^ b) {
+			if constexpr(std::endian::native == std::endian::little) {
+				return i + std::countr_zero(diff) / 8;
+			} else {
+				return i + std::countl_zero(diff) / 8;
+			}
+		}
+	}
+
+	for(; i < size && lhs[i] == rhs[i]; ++i);
+	return i;
+}
+
+/*
+ * Returns the number of leading bytes that differ between both inputs
+ */
+inline std::size_t match(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t size) {
+	std::size_t i = 0;
+
+#ifdef HEXI_DELTA_SSE2
+	for(; i + 16 <= size; i += 16) {
+		const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+		const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+		const auto same = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+
+		if(same) {
+			return i + std::countr_zero(same);
+		}
+	}
+#endif
+
+	for(; i < size && lhs[i] != rhs[i]; ++i);
+	return i;
+}
+
+inline void xor_bytes(std::uint8_t* dest, const std::uint8_t* lhs,
+                      const std::uint8_t* rhs, const std::size_t size) {
+	for(std::size_t i = 0; i < size; ++i) {
+		dest[i] = lhs[i] ^ rhs[i];
+	}
+}
+
+template<typename buf_type>
+concept block_buffer = requires(const buf_type& buffer) {
+	{ buffer.blocks() } -> std::ranges::input_range;
+};
+
+template<typename buf_type>
+concept contiguous_buffer = requires(const buf_type& buffer) {
+	{ buffer.read_ptr() };
+	{ buffer.size() };
+};
+
+template<typename buf_type>
+concept readable_buffer = byte_oriented<buf_type>
+	&& (block_buffer<buf_type> || contiguous_buffer<buf_type>);
+
+template<readable_buffer buf_type>
+auto blocks(const buf_type& buffer) {
+	if constexpr(block_buffer<buf_type>) {
+		return buffer.blocks();
+	} else {
+		return std::array { std::span(buffer.read_ptr(), buffer.size()) };
+	}
+}
+
+/*
+ * Walks the blocks of a buffer without consuming them. Once the end of
+ * the buffer is reached, it continues to produce zeroes indefinitely.
+ */
+template<readable_buffer buf_type>
+class cursor final {
+	using range_type = decltype(blocks(std::declval<const buf_type&>()));
+
+	range_type range_;
+	std::ranges::iterator_t<const range_type> it_;
+	std::span<const std::uint8_t> block_;
+
+public:
+	explicit cursor(const buf_type& buffer)
+		: range_(blocks(buffer)),
+		  it_(std::ranges::begin(std::as_const(range_))) {}
+
+	cursor(const cursor&) = delete;
+	cursor& operator=(const cursor&) = delete;
+
+	std::span<const std::uint8_t> peek() {
+		while(block_.empty()) {
+			if(it_ == std::ranges::end(std::as_const(range_))) {
+				return zero_block;
+			}
+
+			const auto bytes = std::as_bytes(std::span(*it_));
+			block_ = { reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size() };
+			++it_;
+		}
+
+		return block_;
+	}
+
+	void advance(const std::size_t size) {
+		if(!block_.empty()) {
+			block_ = block_.subspan(size);
+		}
+	}
+};
+
+template<typename stream_type>
+class encoder final {
+	stream_type& stream_;
+	std::array<std::uint8_t, staging_size> staging_;
+	std::size_t run_ = 0;
+	std::size_t skip_ = 0;
+	std::size_t gap_ = 0;
+
+	void write_run() {
+		hexi::impl::varint_encode(stream_, skip_);
+		hexi::impl::varint_encode(stream_, run_);
+		stream_.put(staging_.data(), run_);
+		skip_ = 0;
+		run_ = 0;
+	}
+
+	void append_xor(const std::uint8_t* base, const std::uint8_t* current, std::size_t size) {
+		while(size) {
+			const auto count = std::min(size, staging_.size() - run_);
+			xor_bytes(staging_.data() + run_, base, current, count);
+			run_ += count;
+			base += count;
+			current += count;
+			size -= count;
+
+			if(run_ == staging_.size()) {
+				write_run();
+			}
+		}
+	}
+
+	void append_gap() {
+		append_xor(zero_block.data(), zero_block.data(), gap_);
+		gap_ = 0;
+	}
+
+public:
+	explicit encoder(stream_type& stream)
+		: stream_(stream) {}
+
+	void process(const std::uint8_t* base, const std::uint8_t* current, const std::size_t size) {
+		std::size_t i = 0;
+
+		while(i < size) {
+			if(!run_) {
+				// without a run to extend, a pending gap is just more bytes to skip
+				const auto same = mismatch(base + i, current + i, size - i);
+				skip_ += gap_ + same;
+				gap_ = 0;
+				i += same;
+
+				if(i == size) {
+					break;
+				}
+			}
+
+			if(const auto changed = match(base + i, current + i, size - i)) {
+				append_gap();
+				append_xor(base + i, current + i, changed);
+				i += changed;
+			}
+
+			const auto same = mismatch(base + i, current + i, size - i);
+			gap_ += same;
+			i += same;
+
+			if(gap_ >= min_gap) {
+				if(run_) {
+					write_run();
+				}
+
+				skip_ += gap_;
+				gap_ = 0;
+			}
+		}
+	}
+
+	void finish() {
+		if(run_) {
+			write_run();
+		}
+
+		hexi::impl::varint_encode(stream_, std::size_t(0));
+		hexi::impl::varint_encode(stream_, std::size_t(0));
+	}
+};
+
+template<typename buf_type, typename out_type>
+void copy_baseline(cursor<buf_type>& baseline, out_type& out, std::size_t size) {
+	while(size) {
+		const auto block = baseline.peek();
+		const auto count = std::min(size, block.size());
+		out.write(block.data(), count);
+		baseline.advance(count);
+		size -= count;
+	}
+}
+
+} // impl
+
+/**
+ * @brief Writes the differences between a baseline and a new buffer to a stream.
+ * 
+ * @param baseline The buffer to compare against, such as the last snapshot
+ * the receiver acknowledged.
+ * @param current The buffer to be encoded.
+ * @param stream The stream to write the delta to.
+ */
+template<impl::readable_buffer base_type, impl::readable_buffer current_type, typename stream_type>
+void encode(const base_type& baseline, const current_type& current, stream_type& stream) {
+	const std::size_t size = current.size();
+	hexi::impl::varint_encode(stream, size);
+
+	impl::cursor<base_type> base_cursor(baseline);
+	impl::cursor<current_type> current_cursor(current);
+	impl::encoder encoder(stream);
+
+	for(std::size_t remaining = size; remaining;) {
+		const auto base_block = base_cursor.peek();
+		const auto current_block = current_cursor.peek();
+		const auto count = std::min({ remaining, base_block.size(), current_block.size() });
+		encoder.process(base_block.data(), current_block.data(), count);
+		base_cursor.advance(count);
+		current_cursor.advance(count);
+		remaining -= count;
+	}
+
+	encoder.finish();
+}
+
+/**
+ * @brief Reconstructs a buffer from a baseline and a delta produced by encode.
+ * 
+ * If the delta is truncated, the stream's usual error handling applies. If it's
+ * malformed, the stream is put into an error state with set_error_state. In either
+ * case, the output may have been partially written.
+ * 
+ * @param baseline The same baseline that was used to encode the delta.
+ * @param stream The stream to read the delta from.
+ * @param out The buffer to write the reconstructed data to.
+ * @param max_size The largest reconstructed size to accept, to prevent a
+ * malicious delta from producing an unbounded amount of output.
+ */
+template<impl::readable_buffer base_type, typename stream_type, writeable out_type>
+void decode(const base_type& baseline, stream_type& stream, out_type& out,
+            const std::size_t max_size = std::numeric_limits<std::size_t>::max()) {
+	const auto size = hexi::impl::varint_decode<std::size_t>(stream);
+
+	if(!stream) {
+		return;
+	}
+
+	if(size > max_size) {
+		stream.set_error_state();
+		return;
+	}
+
+	impl::cursor<base_type> base_cursor(baseline);
+	std::array<std::uint8_t, impl::staging_size> staging;
+	std::size_t written = 0;
+
+	while(true) {
+		const auto skip = hexi::impl::varint_decode<std::size_t>(stream);
+		auto length = hexi::impl::varint_decode<std::size_t>(stream);
+
+		if(!stream) {
+			return;
+		}
+
+		if(!length) {
+			break;
+		}
+
+		if(skip > size - written || length > size - written - skip) {
+			stream.set_error_state();
+			return;
+		}
+
+		impl::copy_baseline(base_cursor, out, skip);
+		written += skip + length;
+
+		while(length) {
+			const auto block = base_cursor.peek();
+			const auto count = std::min({ length, block.size(), staging.size() });
+			stream.get(staging.data(), count);
+
+			if(!stream) {
+				return;
+			}
+
+			impl::xor_bytes(staging.data(), staging.data(), block.data(), count);
+			out.write(staging.data(), count);
+			base_cursor.advance(count);
+			length -= count;
+		}
+	}
+
+	impl::copy_baseline(base_cursor, out, size - written);
+}
+
+} // delta, hexi
+
+#undef HEXI_DELTA_SSE2
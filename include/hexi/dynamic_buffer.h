@@ -10,16 +10,23 @@
 #include <hexi/shared.h>
 #include <hexi/allocators/default_allocator.h>
 #include <hexi/impl/intrusive_storage.h>
+#include <algorithm>
+#include <array>
 #include <concepts>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <variant>
 #ifdef HEXI_BUFFER_DEBUG
-#include <algorithm>
 #include <vector>
 #endif
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <cassert>
 
 namespace hexi {
@@ -30,16 +37,51 @@ class buffer_sequence;
 template<decltype(auto) block_sz>
 concept int_gt_zero = std::integral<decltype(block_sz)> && block_sz > 0;
 
+template<typename allocator_type, typename T>
+concept bulk_allocator = requires(allocator_type a, T** out) {
+	a.allocate_n(std::size_t{}, out);
+	a.deallocate_list(out, out);
+};
+
+struct no_inline_block {};
+struct inline_block : no_inline_block {};
+
+struct no_spare_blocks {
+	static constexpr std::size_t spare_count = 0;
+};
+
+template<std::size_t count>
+struct spare_blocks : no_spare_blocks {
+	static constexpr std::size_t spare_count = count;
+};
+
+/**
+ * InlinePolicy: 'inline_block' embeds a single block of storage within the
+ * dynamic_buffer object itself. It is always used in preference to the
+ * allocator, so buffers that never hold more than block_sz bytes at a time
+ * will never need to allocate. Once the inline block has been drained and
+ * unlinked, it becomes available for reuse as any other block would.
+ * The trade-off is that the size of the dynamic_buffer object grows by
+ * roughly block_sz bytes and moving a buffer must copy the inline block.
+ * 
+ * SparePolicy: 'spare_blocks<count>' keeps up to count drained blocks on
+ * the buffer rather than returning them to the allocator, so that a buffer
+ * oscillating around a block boundary doesn't hit the allocator for every
+ * message. shrink_to_fit() hands any spare blocks back to the allocator.
+ */
 template<decltype(auto) block_sz,
 	byte_type storage_value_type = std::byte,
-	typename allocator = default_allocator<impl::intrusive_storage<block_sz, storage_value_type>>
+	typename allocator = default_allocator<impl::intrusive_storage<block_sz, storage_value_type>>,
+	std::derived_from<no_inline_block> inline_policy = no_inline_block,
+	std::derived_from<no_spare_blocks> spare_policy = no_spare_blocks
 >
 requires int_gt_zero<block_sz>
 class dynamic_buffer final : public pmc::buffer {
 public:
-	using storage_type = impl::intrusive_storage<block_sz, storage_value_type>;
+	// Determined by the allocator, allowing for singly-linked storage to be used
+	using storage_type = std::remove_pointer_t<decltype(std::declval<allocator&>().allocate())>;
 	using value_type   = storage_value_type;
-	using node_type    = impl::intrusive_node;
+	using node_type    = typename storage_type::node_type;
 	using size_type    = std::size_t;
 	using offset_type  = std::size_t;
 	using contiguous   = is_non_contiguous;
@@ -49,20 +91,113 @@ public:
 
 	using unique_storage = std::unique_ptr<storage_type, std::function<void(storage_type*)>>;
 
+	// block and offset at which a reserved region begins
+	struct placeholder_type {
+		node_type* node;
+		offset_type offset;
+	};
+
+	static_assert(std::is_same_v<typename storage_type::value_type, value_type>
+	              && sizeof(storage_type::storage) == block_sz * sizeof(value_type),
+	              "allocator storage type does not match the buffer");
+
 private:
+	static constexpr bool has_inline_block = std::is_same_v<inline_policy, inline_block>;
+	static constexpr size_type max_spares = spare_policy::spare_count;
+	static constexpr bool doubly_linked = std::is_same_v<node_type, impl::intrusive_node>;
+	static constexpr size_type bulk_batch = 32;
+
+	using inline_storage = std::conditional_t<has_inline_block, storage_type, std::monostate>;
+	using inline_flag = std::conditional_t<has_inline_block, bool, std::monostate>;
+	using tail_link = std::conditional_t<doubly_linked, std::monostate, node_type*>;
+
+	// drained blocks held for reuse, linked through their nodes
+	struct spare_list {
+		node_type* head = nullptr;
+		size_type count = 0;
+	};
+
+	using spare_storage = std::conditional_t<max_spares != 0, spare_list, std::monostate>;
+
 	node_type root_;
 	size_type size_;
+	size_type headroom_ = 0;
+	[[no_unique_address]] tail_link tail_{};
 	[[no_unique_address]] allocator allocator_;
+	[[no_unique_address]] inline_flag inline_free_{};
+	[[no_unique_address]] inline_storage inline_block_;
+	[[no_unique_address]] spare_storage spares_;
+
+	/*
+	 * The tail is the block that the write cursor is in, which is not
+	 * necessarily the last block in the list if a write seek has rewound
+	 * the cursor. For doubly-linked lists, the root's back pointer is used,
+	 * otherwise it needs tracking separately.
+	 */
+	inline node_type* tail() const {
+		if constexpr(doubly_linked) {
+			return root_.prev;
+		} else {
+			return tail_;
+		}
+	}
+
+	inline void set_tail(node_type* node) {
+		if constexpr(doubly_linked) {
+			root_.prev = node;
+		} else {
+			tail_ = node;
+		}
+	}
+
+	void reset_list() {
+		root_.next = &root_;
+		set_tail(&root_);
+	}
 
 	void link_tail_node(node_type* node) {
-		node->next = &root_;
-		node->prev = root_.prev;
-		root_.prev = root_.prev->next = node;
+		auto tail_node = tail();
+		node->next = tail_node->next;
+
+		if constexpr(doubly_linked) {
+			node->prev = tail_node;
+
+			if(node->next != &root_) {
+				node->next->prev = node;
+			}
+		}
+
+		tail_node->next = node;
+		set_tail(node);
 	}
 
-	void unlink_node(node_type* node) {
-		node->next->prev = node->prev;
-		node->prev->next = node->next;
+	void link_head_node(node_type* node) {
+		node->next = root_.next;
+
+		if constexpr(doubly_linked) {
+			node->prev = &root_;
+
+			if(node->next != &root_) {
+				node->next->prev = node;
+			}
+		}
+
+		root_.next = node;
+	}
+
+	void unlink_head() {
+		auto node = root_.next;
+		root_.next = node->next;
+
+		if constexpr(doubly_linked) {
+			if(node->next != &root_) {
+				node->next->prev = &root_;
+			}
+		}
+
+		if(tail() == node) {
+			set_tail(&root_);
+		}
 	}
 
 	inline storage_type* buffer_from_node(const node_type* node) const {
@@ -70,20 +205,98 @@ private:
 			- offsetof(storage_type, node));
 	}
 
-	void move(dynamic_buffer& rhs) noexcept {
+	/*
+	 * Blocks can only be handed between buffers if they'd be returned to
+	 * the same allocator. Allocators that can't be compared are assumed to
+	 * be interchangeable, as with the stateless and thread-local allocators.
+	 */
+	bool same_allocator(const dynamic_buffer& rhs) const {
+		if constexpr(std::equality_comparable<allocator>) {
+			return allocator_ == rhs.allocator_;
+		} else {
+			return true;
+		}
+	}
+
+	void move(dynamic_buffer& rhs) {
 		if(this == &rhs) { // self-assignment
 			return;
 		}
 
 		clear(); // clear our current blocks rather than swapping them
 
+		if(rhs.root_.next == &rhs.root_) {
+			return;
+		}
+
+		if(!same_allocator(rhs)) {
+			copy(rhs);
+			rhs.clear();
+			return;
+		}
+
 		size_ = rhs.size_;
-		root_ = rhs.root_;
-		root_.next->prev = &root_;
-		root_.prev->next = &root_;
+		root_.next = rhs.root_.next;
+		set_tail(rhs.tail() == &rhs.root_? &root_ : rhs.tail());
+
+		if constexpr(doubly_linked) {
+			root_.next->prev = &root_;
+		}
+
+		// blocks may follow the tail if the write cursor has been rewound
+		auto last = root_.next;
+
+		while(last->next != &rhs.root_) {
+			last = last->next;
+		}
+
+		last->next = &root_;
+
+		if constexpr(has_inline_block) {
+			if(!rhs.inline_free_) {
+				adopt_inline_block(rhs);
+			}
+		}
+
 		rhs.size_ = 0;
-		rhs.root_.next = &rhs.root_;
-		rhs.root_.prev = &rhs.root_;
+		rhs.reset_list();
+	}
+
+	/*
+	 * The inline block lives inside of the buffer object, so it can't be
+	 * handed over like allocated blocks can. Instead, its contents are copied
+	 * into our own inline block, which then takes its place in the list.
+	 */
+	void adopt_inline_block(dynamic_buffer& rhs) noexcept requires has_inline_block {
+		auto& block = inline_block_;
+		auto& rhs_block = rhs.inline_block_;
+		block.read_offset = rhs_block.read_offset;
+		block.write_offset = rhs_block.write_offset;
+		block.node = rhs_block.node;
+		std::memcpy(block.storage.data(), rhs_block.storage.data(), rhs_block.write_offset);
+
+		if constexpr(doubly_linked) {
+			block.node.prev->next = &block.node;
+
+			if(block.node.next != &root_) {
+				block.node.next->prev = &block.node;
+			}
+		} else {
+			auto prev = &root_;
+
+			while(prev->next != &rhs_block.node) {
+				prev = prev->next;
+			}
+
+			prev->next = &block.node;
+		}
+
+		if(tail() == &rhs_block.node) {
+			set_tail(&block.node);
+		}
+
+		inline_free_ = false;
+		rhs.inline_free_ = true;
 	}
 
 	void copy(const dynamic_buffer& rhs) {
@@ -92,17 +305,29 @@ private:
 		}
 
 		const node_type* head = rhs.root_.next;
-		root_.next = &root_;
-		root_.prev = &root_;
+		node_type* tail = &root_;
+		reset_list();
 		size_ = 0;
 
+		// only the used range of each block is copied, not its spare capacity
 		while(head != &rhs.root_) {
+			const auto source = rhs.buffer_from_node(head);
 			auto buffer = allocate();
-			*buffer = *buffer_from_node(head);
+			buffer->read_offset = source->read_offset;
+			buffer->write_offset = source->write_offset;
+			std::memcpy(buffer->read_ptr(), source->read_ptr(), source->size() * sizeof(value_type));
 			link_tail_node(&buffer->node);
-			size_ += buffer->write_offset;
+			size_ += buffer->size();
+
+			if(head == rhs.tail()) {
+				tail = &buffer->node;
+			}
+
 			head = head->next;
 		}
+
+		// blocks may follow the tail if the write cursor has been rewound
+		set_tail(tail);
 	}
 	
 #ifdef HEXI_BUFFER_DEBUG
@@ -135,43 +360,300 @@ private:
 		return (*buffer)[offset_index % block_sz];
 	}
 
-	size_type abs_seek_offset(size_type offset) {
-		if(offset < size_) {
-			return size_ - offset;
-		} else if(offset > size_) {
-			return offset - size_;
+	void rewind_write(size_type offset) {
+		auto tail = this->tail();
+
+		if constexpr(doubly_linked) {
+			while(true) {
+				auto buffer = buffer_from_node(tail);
+				const auto max_seek = buffer->size();
+
+				if(max_seek >= offset) {
+					buffer->write_seek(buffer_seek::sk_backward, offset);
+					break;
+				}
+
+				buffer->write_seek(buffer_seek::sk_backward, max_seek);
+				offset -= max_seek;
+				tail = tail->prev;
+			}
 		} else {
-			return 0;
+			// no back links, so the new tail has to be found from the head
+			const auto old_tail = tail;
+			auto position = size_;
+			tail = root_.next;
+
+			while(true) {
+				auto buffer = buffer_from_node(tail);
+
+				if(buffer->size() >= position) {
+					buffer->write_seek(buffer_seek::sk_absolute, buffer->read_offset + position);
+					break;
+				}
+
+				position -= buffer->size();
+				tail = tail->next;
+			}
+
+			// blocks between the new and old tail no longer hold any data
+			for(auto node = tail; node != old_tail;) {
+				node = node->next;
+				auto buffer = buffer_from_node(node);
+				buffer->write_seek(buffer_seek::sk_absolute, buffer->read_offset);
+			}
+		}
+
+		set_tail(tail);
+	}
+
+	void forward_write(size_type offset) {
+		auto tail = this->tail();
+
+		while(offset) {
+			auto buffer = buffer_from_node(tail);
+			const auto max_seek = buffer->free();
+
+			if(max_seek >= offset) {
+				buffer->write_seek(buffer_seek::sk_forward, offset);
+				break;
+			}
+
+			buffer->write_seek(buffer_seek::sk_forward, max_seek);
+			offset -= max_seek;
+			tail = tail->next;
 		}
+
+		set_tail(tail);
+	}
+
+	storage_type* take_spare() {
+		if constexpr(max_spares != 0) {
+			if(spares_.head) {
+				auto buffer = buffer_from_node(spares_.head);
+				spares_.head = spares_.head->next;
+				--spares_.count;
+				buffer->clear();
+				return buffer;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool store_spare(storage_type* buffer) {
+		if constexpr(max_spares != 0) {
+			if(spares_.count < max_spares) {
+				buffer->node.next = spares_.head;
+				spares_.head = &buffer->node;
+				++spares_.count;
+				return true;
+			}
+		}
+
+		return false;
 	}
 
 	[[nodiscard]] storage_type* allocate() {
+		if constexpr(has_inline_block) {
+			if(inline_free_) {
+				inline_free_ = false;
+				return &inline_block_;
+			}
+		}
+
+		if(auto buffer = take_spare()) {
+			return buffer;
+		}
+
 		return allocator_.allocate();
 	}
 
 	void deallocate(storage_type* buffer) {
+		if constexpr(has_inline_block) {
+			if(buffer == &inline_block_) {
+				inline_block_.clear();
+				inline_free_ = true;
+				return;
+			}
+		}
+
+		if(store_spare(buffer)) {
+			return;
+		}
+
 		allocator_.deallocate(buffer);
 	}
 
+	/*
+	 * Links enough new blocks after the tail to hold the given number of
+	 * bytes and makes the first of them the tail. Allocators with a bulk
+	 * interface are asked for the blocks in batches rather than one by one.
+	 * At least one block is always appended, even for zero length.
+	 */
+	storage_type* append_blocks(const size_type length) {
+		auto count = std::max<size_type>(1, (length + block_sz - 1) / block_sz);
+		auto first = allocate();
+
+		if(root_.next == &root_) {
+			apply_headroom(first);
+		}
+
+		link_tail_node(&first->node);
+		--count;
+
+		if constexpr(bulk_allocator<allocator, storage_type>) {
+			std::array<storage_type*, bulk_batch> blocks;
+
+			for(; count; --count) {
+				auto spare = take_spare();
+
+				if(!spare) {
+					break;
+				}
+
+				link_tail_node(&spare->node);
+			}
+
+			while(count) {
+				const auto batch = std::min(count, blocks.size());
+				allocator_.allocate_n(batch, blocks.data());
+
+				for(size_type i = 0; i < batch; ++i) {
+					link_tail_node(&blocks[i]->node);
+				}
+
+				count -= batch;
+			}
+		} else {
+			for(; count; --count) {
+				link_tail_node(&allocate()->node);
+			}
+		}
+
+		set_tail(&first->node);
+		return first;
+	}
+
+	void apply_headroom(storage_type* buffer) {
+		using storage_offset = typename storage_type::offset_type;
+		buffer->read_offset = static_cast<storage_offset>(headroom_);
+		buffer->write_offset = static_cast<storage_offset>(headroom_);
+	}
+
+	/*
+	 * Once the buffer has been drained, the remaining block is reset to its
+	 * starting offsets, so the headroom needs restoring for the next message.
+	 */
+	void restore_headroom() {
+		const auto head = root_.next;
+
+		if(headroom_ && !size_ && head != &root_ && head == tail()) {
+			apply_headroom(buffer_from_node(head));
+		}
+	}
+
+	void deallocate_chain(node_type* head) {
+		if constexpr(bulk_allocator<allocator, storage_type>) {
+			std::array<storage_type*, bulk_batch> blocks;
+			size_type count = 0;
+
+			while(head != &root_) {
+				auto buffer = buffer_from_node(head);
+				head = head->next;
+
+				if constexpr(has_inline_block) {
+					if(buffer == &inline_block_) {
+						deallocate(buffer);
+						continue;
+					}
+				}
+
+				if(store_spare(buffer)) {
+					continue;
+				}
+
+				blocks[count++] = buffer;
+
+				if(count == blocks.size()) {
+					allocator_.deallocate_list(blocks.begin(), blocks.end());
+					count = 0;
+				}
+			}
+
+			allocator_.deallocate_list(blocks.begin(), blocks.begin() + count);
+		} else {
+			while(head != &root_) {
+				auto next = head->next;
+				deallocate(buffer_from_node(head));
+				head = next;
+			}
+		}
+	}
+
 public:
 	dynamic_buffer()
-		: root_{ .next = &root_, .prev = &root_ },
-		  size_(0) {}
+		: dynamic_buffer(0, allocator()) {}
+
+	/**
+	 * @brief Constructs a buffer that leaves space at the front of its first
+	 * block, allowing for headers to be prepended without allocating.
+	 * 
+	 * @param headroom The number of bytes to leave free. Must be less than
+	 * the block size.
+	 */
+	explicit dynamic_buffer(const size_type headroom)
+		: dynamic_buffer(headroom, allocator()) {}
+
+	/**
+	 * @brief Constructs a buffer that uses the provided allocator instance,
+	 * such as a ref_allocator to a pool owned by a connection.
+	 * 
+	 * @param alloc The allocator to copy.
+	 */
+	explicit dynamic_buffer(const allocator& alloc)
+		: dynamic_buffer(0, alloc) {}
+
+	/**
+	 * @brief Constructs a buffer with headroom that uses the provided
+	 * allocator instance.
+	 * 
+	 * @param headroom The number of bytes to leave free. Must be less than
+	 * the block size.
+	 * @param alloc The allocator to copy.
+	 */
+	dynamic_buffer(const size_type headroom, const allocator& alloc)
+		: size_(0),
+		  headroom_(headroom),
+		  allocator_(alloc) {
+		assert(headroom < block_sz && "headroom must be less than the block size");
+		reset_list();
+
+		if constexpr(has_inline_block) {
+			inline_free_ = true;
+		}
+	}
 
 	~dynamic_buffer() {
 		clear();
+		shrink_to_fit();
 	}
 
-	dynamic_buffer& operator=(dynamic_buffer&& rhs) noexcept {
+	/*
+	 * The allocator is not propagated, so if it differs from rhs's, the
+	 * data is copied into blocks from our own allocator instead.
+	 */
+	dynamic_buffer& operator=(dynamic_buffer&& rhs) noexcept(!std::equality_comparable<allocator>) {
 		move(rhs);
 		return *this;
 	}
 
-	dynamic_buffer(dynamic_buffer&& rhs) noexcept {
+	dynamic_buffer(dynamic_buffer&& rhs) noexcept
+		: dynamic_buffer(rhs.headroom_, rhs.allocator_) {
 		move(rhs);
 	}
 
-	dynamic_buffer(const dynamic_buffer& rhs) {
+	dynamic_buffer(const dynamic_buffer& rhs)
+		: dynamic_buffer(rhs.headroom_, rhs.allocator_) {
 		copy(rhs);
 	}
 
@@ -211,11 +693,11 @@ public:
 			auto buffer = buffer_from_node(root_.next);
 			remaining -= buffer->read(
 				static_cast<value_type*>(destination) + length - remaining, remaining,
-				                         root_.next == root_.prev
+				                         root_.next == tail()
 			);
 
 			if(remaining) [[unlikely]] {
-				unlink_node(root_.next);
+				unlink_head();
 				deallocate(buffer);
 			} else {
 				break;
@@ -223,6 +705,7 @@ public:
 		}
 
 		size_ -= length;
+		restore_headroom();
 	}
 
 	/**
@@ -322,10 +805,10 @@ public:
 
 		while(true) {
 			auto buffer = buffer_from_node(root_.next);
-			remaining -= buffer->skip(remaining, root_.next == root_.prev);
+			remaining -= buffer->skip(remaining, root_.next == tail());
 
 			if(remaining) [[unlikely]] {
-				unlink_node(root_.next);
+				unlink_head();
 				deallocate(buffer);
 			} else {
 				break;
@@ -333,6 +816,7 @@ public:
 		}
 
 		size_ -= length;
+		restore_headroom();
 	}
 
 	/**
@@ -358,25 +842,32 @@ public:
 	 */
 	void write(const void* source, const size_type length) override {
 		size_type remaining = length;
-		node_type* tail = root_.prev;
+		node_type* tail = this->tail();
 
-		do {
+		while(true) {
 			storage_type* buffer;
 
 			if(tail != &root_) [[likely]] {
 				buffer = buffer_from_node(tail);
 			} else {
-				buffer = allocate();
-				link_tail_node(&buffer->node);
-				tail = root_.prev;
+				buffer = append_blocks(remaining);
+				tail = &buffer->node;
 			}
 
 			remaining -= buffer->write(
 				static_cast<const value_type*>(source) + length - remaining, remaining
 			);
 
+			if(!remaining) [[likely]] {
+				break;
+			}
+
 			tail = tail->next;
-		} while(remaining);
+
+			if(tail != &root_) {
+				set_tail(tail);
+			}
+		}
 
 		size_ += length;
 	}
@@ -388,26 +879,213 @@ public:
 	 */
 	void reserve(const size_type length) override {
 		size_type remaining = length;
-		node_type* tail = root_.prev;
+		node_type* tail = this->tail();
 
-		do {
+		while(true) {
 			storage_type* buffer;
 
 			if(tail == &root_) [[unlikely]] {
-				buffer = allocate();
-				link_tail_node(&buffer->node);
-				tail = root_.prev;
+				buffer = append_blocks(remaining);
+				tail = &buffer->node;
 			} else {
 				buffer = buffer_from_node(tail);
 			}
 
 			remaining -= buffer->advance_write(remaining);
+
+			if(!remaining) {
+				break;
+			}
+
 			tail = tail->next;
-		} while(remaining);
+
+			if(tail != &root_) {
+				set_tail(tail);
+			}
+		}
 
 		size_ += length;
 	}
 
+	/**
+	 * @brief Write provided data to the front of the container, ahead of
+	 * any data that has not yet been read.
+	 * 
+	 * The headroom in the first block is used first, with new blocks being
+	 * linked ahead of it if that isn't enough. Existing data is never moved,
+	 * so the cost is proportional to the length of the prepended data.
+	 * 
+	 * @note The source buffer must not overlap with any of the underlying buffers
+	 * being used by the dynamic buffer.
+	 * 
+	 * @param source Pointer to the data to be prepended.
+	 * @param length Number of bytes to prepend from the source.
+	 */
+	void prepend(const void* source, const size_type length) {
+		if(root_.next == &root_) {
+			write(source, length);
+			return;
+		}
+
+		using storage_offset = typename storage_type::offset_type;
+		auto src = static_cast<const value_type*>(source);
+		auto remaining = length;
+
+		// fill backwards from the end of the source
+		auto head = buffer_from_node(root_.next);
+		const auto count = std::min<size_type>(remaining, head->read_offset);
+		head->read_offset -= static_cast<storage_offset>(count);
+		remaining -= count;
+		std::memcpy(head->storage.data() + head->read_offset, src + remaining, count);
+
+		while(remaining) {
+			auto buffer = allocate();
+			const auto block_count = std::min<size_type>(remaining, block_sz);
+			buffer->read_offset = static_cast<storage_offset>(block_sz - block_count);
+			buffer->write_offset = static_cast<storage_offset>(block_sz);
+			remaining -= block_count;
+			std::memcpy(buffer->storage.data() + buffer->read_offset, src + remaining, block_count);
+			link_head_node(&buffer->node);
+		}
+
+		size_ += length;
+	}
+
+	/**
+	 * @brief Moves all of the data in another buffer to the end of this
+	 * one, leaving the other buffer empty.
+	 * 
+	 * Where possible, the other buffer's blocks are linked directly onto the
+	 * end of the list, rather than copying. That requires that both buffers
+	 * use the same allocator, that this buffer's final block is full (or that
+	 * it has no blocks) and that the data in the other buffer starts at the
+	 * beginning of its first block. Otherwise, the data is copied.
+	 * 
+	 * @param rhs The buffer to take the data from.
+	 */
+	void splice(dynamic_buffer& rhs) {
+		if(this == &rhs || rhs.root_.next == &rhs.root_) {
+			return;
+		}
+
+		const auto tail = this->tail();
+		const auto first = rhs.root_.next;
+		const auto last = rhs.tail();
+		bool linkable = same_allocator(rhs)
+			&& last != &rhs.root_
+			&& last->next == &rhs.root_
+			&& tail->next == &root_
+			&& (tail == &root_ || (!buffer_from_node(tail)->free()
+				&& !buffer_from_node(first)->read_offset));
+
+		if constexpr(has_inline_block) {
+			linkable = linkable && rhs.inline_free_;
+		}
+
+		if(!linkable) {
+			for(auto node = first; node != &rhs.root_; node = node->next) {
+				const auto buffer = rhs.buffer_from_node(node);
+
+				if(buffer->size()) {
+					write(buffer->read_ptr(), buffer->size());
+				}
+			}
+
+			rhs.clear();
+			return;
+		}
+
+		tail->next = first;
+
+		if constexpr(doubly_linked) {
+			first->prev = tail;
+		}
+
+		last->next = &root_;
+		set_tail(last);
+		size_ += rhs.size_;
+		rhs.size_ = 0;
+		rhs.reset_list();
+	}
+
+	/**
+	 * @brief Retrieves the amount of space at the front of the container
+	 * that can be prepended to without allocating.
+	 * 
+	 * @return The number of bytes of headroom available.
+	 */
+	size_type headroom() const {
+		if(root_.next == &root_) {
+			return headroom_;
+		}
+
+		return buffer_from_node(root_.next)->read_offset;
+	}
+
+	/**
+	 * @brief Reserves space at the write cursor to be filled in later. The
+	 * position is recorded directly, so filling it does not need to seek.
+	 * 
+	 * @note The placeholder is invalidated by clear(), a write seek that
+	 * rewinds over it or once its contents have been read.
+	 * 
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
+	 */
+	placeholder_type reserve_placeholder(const size_type length) {
+		const auto tail = this->tail();
+		auto node = tail;
+		offset_type offset = 0;
+
+		if(node != &root_ && buffer_from_node(node)->free()) {
+			offset = buffer_from_node(node)->write_offset;
+		} else {
+			// begins in the following block, which may not exist yet
+			node = node->next;
+
+			if(node != &root_) {
+				offset = buffer_from_node(node)->write_offset;
+			}
+		}
+
+		reserve(length);
+
+		if(node == &root_) {
+			node = tail->next;
+			offset = buffer_from_node(node)->read_offset;
+		}
+
+		return { node, offset };
+	}
+
+	/**
+	 * @brief Writes data into previously reserved space.
+	 * 
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(const placeholder_type& placeholder, const void* source, size_type length) {
+		auto src = static_cast<const value_type*>(source);
+		auto node = placeholder.node;
+		auto offset = placeholder.offset;
+
+		while(length) {
+			auto buffer = buffer_from_node(node);
+			const auto count = std::min<size_type>(length, block_sz - offset);
+			std::memcpy(buffer->storage.data() + offset, src, count);
+			src += count;
+			length -= count;
+			node = node->next;
+
+			if(node != &root_) {
+				offset = buffer_from_node(node)->read_offset;
+			}
+		}
+	}
+
 	/**
 	 * @brief Returns the size of the container.
 	 * 
@@ -425,11 +1103,11 @@ public:
 	 * be deallocated by the caller.
 	 */
 	storage_type* back() const {
-		if(root_.prev == &root_) {
+		if(tail() == &root_) {
 			return nullptr;
 		}
 
-		return buffer_from_node(root_.prev);
+		return buffer_from_node(tail());
 	}
 
 	/**
@@ -459,7 +1137,7 @@ public:
 	auto pop_front() {
 		auto buffer = buffer_from_node(root_.next);
 		size_ -= buffer->size();
-		unlink_node(root_.next);
+		unlink_head();
 		return unique_storage(buffer, [&](auto ptr) {
 			deallocate(ptr);
 		});
@@ -484,7 +1162,7 @@ public:
 	 * @param size The number of bytes by which the write cursor to advance the cursor.
 	 */
 	void advance_write(const size_type size) {
-		auto buffer = buffer_from_node(root_.prev);
+		auto buffer = buffer_from_node(tail());
 		const auto actual = buffer->advance_write(size);
 		assert(size <= block_sz && actual <= size &&
 		       "Attempted to advance write cursor out of bounds!");
@@ -511,62 +1189,62 @@ public:
 	 * when using absolute seeking.
 	 */
 	void write_seek(const buffer_seek direction, size_type offset) override {
-		// nothing to do in this case
-		if(direction == buffer_seek::sk_absolute && offset == size_) {
-			return;
-		}
-
-		auto tail = root_.prev;
-
 		switch(direction) {
 			case buffer_seek::sk_backward:
 				size_ -= offset;
+				rewind_write(offset);
 				break;
 			case buffer_seek::sk_forward:
 				size_ += offset;
+				forward_write(offset);
 				break;
 			case buffer_seek::sk_absolute:
-				size_ = offset;
-				offset = abs_seek_offset(offset);
+				if(offset < size_) {
+					write_seek(buffer_seek::sk_backward, size_ - offset);
+				} else if(offset > size_) {
+					write_seek(buffer_seek::sk_forward, offset - size_);
+				}
 				break;
 		}
-
-		const bool rewind
-			= (direction == buffer_seek::sk_backward
-			   || (direction == buffer_seek::sk_absolute && offset < size_));
-
-		while(offset) {
-			auto buffer = buffer_from_node(tail);
-			const auto max_seek = rewind? buffer->size() : buffer->free();
-
-			if(max_seek >= offset) {
-				buffer->write_seek(direction, offset);
-				offset = 0;
-			} else {
-				buffer->write_seek(direction, max_seek);
-				offset -= max_seek;
-				tail = rewind? tail->prev : tail->next;
-			}
-		}
-
-		root_.prev = tail;
 	}
 
 	/**
 	 * @brief Clears the container.
+	 * 
+	 * @note Blocks may be kept as spares, depending on the spare policy.
 	 */
 	void clear() {
-		node_type* head = root_.next;
+		deallocate_chain(root_.next);
+		reset_list();
+		size_ = 0;
+	}
 
-		while(head != &root_) {
-			auto next = head->next;
-			deallocate(buffer_from_node(head));
-			head = next;
+	/**
+	 * @brief Returns any spare blocks held by the container to the allocator.
+	 */
+	void shrink_to_fit() {
+		if constexpr(max_spares != 0) {
+			while(spares_.head) {
+				auto node = spares_.head;
+				spares_.head = node->next;
+				allocator_.deallocate(buffer_from_node(node));
+			}
+
+			spares_.count = 0;
 		}
+	}
 
-		root_.next = &root_;
-		root_.prev = &root_;
-		size_ = 0;
+	/**
+	 * @brief Retrieves the number of drained blocks being held for reuse.
+	 * 
+	 * @return The number of spare blocks.
+	 */
+	size_type spare_count() const {
+		if constexpr(max_spares != 0) {
+			return spares_.count;
+		} else {
+			return 0;
+		}
 	}
 
 	/**
@@ -621,7 +1299,7 @@ public:
 
 		// not calculating based on block size & size as it
 		// wouldn't play nice with seeking or manual push/pop
-		while(node->next != root_.prev->next) {
+		while(node->next != tail()->next) {
 			++count;
 			node = node->next;
 		}
@@ -629,6 +1307,53 @@ public:
 		return count;
 	}
 
+	/**
+	 * Read-only iterator over the data held by each of the buffer's blocks,
+	 * allowing the data to be processed in place without consuming it.
+	 */
+	class block_iterator {
+		const dynamic_buffer* buffer_ = nullptr;
+		const node_type* node_ = nullptr;
+
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using value_type = std::span<const storage_value_type>;
+		using difference_type = std::ptrdiff_t;
+
+		block_iterator() = default;
+
+		block_iterator(const dynamic_buffer* buffer, const node_type* node)
+			: buffer_(buffer), node_(node) {}
+
+		value_type operator*() const {
+			return buffer_->buffer_from_node(node_)->read_data();
+		}
+
+		block_iterator& operator++() {
+			node_ = node_->next;
+			return *this;
+		}
+
+		block_iterator operator++(int) {
+			auto current = *this;
+			node_ = node_->next;
+			return current;
+		}
+
+		bool operator==(const block_iterator& rhs) const {
+			return node_ == rhs.node_;
+		}
+	};
+
+	/**
+	 * @brief Provides a view over the readable data in each block, in order.
+	 * 
+	 * @return Range of spans, one per block.
+	 */
+	std::ranges::subrange<block_iterator> blocks() const {
+		return { block_iterator(this, root_.next), block_iterator(this, &root_) };
+	}
+
 	/**
 	 * @brief Attempts to locate the provided value within the container.
 	 * 
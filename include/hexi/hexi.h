@@ -6,21 +6,35 @@
 
 #pragma once
 
+#include <hexi/aggregate.h>
 #include <hexi/binary_stream.h>
+#include <hexi/bit_stream.h>
 #include <hexi/buffer_adaptor.h>
+#include <hexi/buffer_pool.h>
 #include <hexi/buffer_sequence.h>
+#include <hexi/compression.h>
 #include <hexi/concepts.h>
+#include <hexi/cow_buffer.h>
+#include <hexi/delta.h>
 #include <hexi/dynamic_buffer.h>
 #include <hexi/dynamic_tls_buffer.h>
 #include <hexi/exception.h>
 #include <hexi/endian.h>
 #include <hexi/file_buffer.h>
 #include <hexi/shared.h>
+#include <hexi/ring_buffer.h>
+#include <hexi/spsc_buffer.h>
 #include <hexi/static_buffer.h>
 #include <hexi/null_buffer.h>
+#include <hexi/quantise.h>
 #include <hexi/stream_adaptors.h>
 #include <hexi/allocators/block_allocator.h>
 #include <hexi/allocators/default_allocator.h>
+#include <hexi/allocators/default_init_allocator.h>
+#include <hexi/allocators/depot_allocator.h>
+#include <hexi/allocators/pmr_allocator.h>
+#include <hexi/allocators/ref_allocator.h>
+#include <hexi/allocators/region_allocator.h>
 #include <hexi/allocators/tls_block_allocator.h>
 #include <hexi/impl/intrusive_storage.h>
 #include <hexi/pmc/binary_stream.h>
@@ -19,6 +19,7 @@
 #include <cassert>
 #include <cstring>
 #include <cstddef>
+#include <cstdint>
 
 namespace hexi::impl {
 
@@ -27,14 +28,41 @@ struct intrusive_node {
 	intrusive_node* prev;
 };
 
-template<std::size_t block_size, byte_type storage_type = std::byte>
+/*
+ * For containers that only ever append to the back and remove from
+ * the front, the back pointer is dead weight. Saves a pointer per block.
+ */
+struct intrusive_slist_node {
+	intrusive_slist_node* next;
+};
+
+template<typename T>
+concept intrusive_link = std::same_as<T, intrusive_node> || std::same_as<T, intrusive_slist_node>;
+
+// The smallest unsigned type that can represent every offset in [0, block_size]
+template<std::size_t block_size>
+using compact_offset_t = std::conditional_t<block_size <= UINT8_MAX, std::uint8_t,
+	std::conditional_t<block_size <= UINT16_MAX, std::uint16_t,
+	std::conditional_t<block_size <= UINT32_MAX, std::uint32_t, std::size_t>>>;
+
+/*
+ * The header is the link node followed by the read and write offsets, which
+ * are narrowed to compact_offset_t, the smallest type able to hold any offset
+ * within the block. The storage is a byte array, so it follows the offsets
+ * without padding, e.g. a singly-linked block of up to 255 bytes has a header
+ * of a pointer and two bytes.
+ */
+template<std::size_t block_size,
+	byte_type storage_type = std::byte,
+	intrusive_link link_type = intrusive_node>
 struct intrusive_storage final {
 	using value_type = storage_type;
-	using offset_type = std::remove_const_t<decltype(block_size)>;
+	using offset_type = compact_offset_t<block_size>;
+	using node_type = link_type;
 
+	node_type node {};
 	offset_type read_offset = 0;
 	offset_type write_offset = 0;
-	intrusive_node node {};
 	std::array<value_type, block_size> storage;
 
 	/**
@@ -185,7 +213,7 @@ struct intrusive_storage final {
 	void write_seek(const buffer_seek direction, const std::size_t offset) {
 		switch(direction) {
 			case buffer_seek::sk_absolute:
-				write_offset = offset;
+				write_offset = static_cast<offset_type>(offset);
 				break;
 			case buffer_seek::sk_backward:
 				write_offset -= static_cast<offset_type>(offset);
@@ -313,4 +341,7 @@ struct intrusive_storage final {
 	}
 };
 
+template<std::size_t block_size, byte_type storage_type = std::byte>
+using intrusive_slist_storage = intrusive_storage<block_size, storage_type, intrusive_slist_node>;
+
 } // impl, hexi
@@ -21,6 +21,8 @@ public:
 	using contiguous      = is_contiguous;
 	using seeking         = unsupported;
 
+	struct placeholder_type {};
+
 	void write(const auto& /*elem*/) {}
 	void write(const void* /*source*/, size_type /*length*/) override {};
 	void read(auto* /*elem*/) {}
@@ -31,6 +33,8 @@ public:
 	size_type size() const override{ return 0; };
 	[[nodiscard]] bool empty() const override { return true; };
 	bool can_write_seek() const override { return false; }
+	placeholder_type reserve_placeholder(size_type /*length*/) { return {}; }
+	void fill_placeholder(placeholder_type, const void* /*source*/, size_type /*length*/) {}
 
 	void write_seek(const buffer_seek /*direction*/, const std::size_t /*offset*/) override {
 		HEXI_THROW(exception("Don't do this on a null_buffer")); 
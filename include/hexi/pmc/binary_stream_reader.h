@@ -90,7 +90,7 @@ class binary_stream_reader : virtual public stream_base {
 			SAFE_READ(container.data(), bytes, void());
 		} else {
 			for(count_type i = 0; i < count; ++i) {
-				cvalue_type value;
+				auto value = impl::make_element(container, nullptr);
 				*this >> value;
 				container.emplace_back(std::move(value));
 			}
@@ -157,7 +157,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(prefixed<std::string> adaptor) {
+	template<std_string T>
+	binary_stream_reader& operator>>(prefixed<T> adaptor) {
 		std::uint32_t size = 0;
 		*this >> endian::le(size);
 
@@ -183,7 +184,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(prefixed_varint<std::string> adaptor) {
+	template<std_string T>
+	binary_stream_reader& operator>>(prefixed_varint<T> adaptor) {
 		const auto size = impl::varint_decode<std::size_t>(*this);
 
 		// if an error was triggered during decode, we shouldn't reach here
@@ -209,7 +211,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(null_terminated<std::string> adaptor) {
+	template<std_string T>
+	binary_stream_reader& operator>>(null_terminated<T> adaptor) {
 		auto pos = buffer_.find_first_of(std::byte{0});
 
 		if(pos == buffer_.npos) {
@@ -241,7 +244,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(std::string& data) {
+	binary_stream_reader& operator>>(std_string auto& data) {
 		return *this >> prefixed(data);
 	}
 
@@ -344,7 +347,7 @@ public:
 	 * 
 	 * @param dest The destination string.
 	 */
-	void get(std::string& dest) {
+	void get(std_string auto& dest) {
 		*this >> dest;
 	}
 
@@ -354,7 +357,7 @@ public:
 	 * @param[out] dest The std::string to hold the result.
 	 * @param count The number of bytes to be read.
 	 */
-	void get(std::string& dest, std::size_t size) {
+	void get(std_string auto& dest, std::size_t size) {
 		STREAM_READ_BOUNDS_ENFORCE(size, void());
 
 		dest.resize_and_overwrite(size, [&](char* strbuf, std::size_t len) {
@@ -168,7 +168,7 @@ public:
 	 * @return Reference to the current stream.
 	 */
 	template<typename T>
-	requires std::is_same_v<std::decay_t<T>, std::string>
+	requires std_string<std::decay_t<T>>
 	binary_stream_writer& operator<<(null_terminated<T> adaptor) {
 		assert(adaptor->find_first_of('\0') == adaptor->npos);
 		write(adaptor->data(), adaptor->size() + 1); // yes, the standard allows this
@@ -208,7 +208,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_writer& operator<<(const std::string& string) {
+	binary_stream_writer& operator<<(const std_string auto& string) {
 		return *this << prefixed(string);
 	}
 
@@ -0,0 +1,459 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/stream_adaptors.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace hexi {
+
+namespace impl {
+
+template<unsigned bits>
+using uint_least = std::conditional_t<bits <= 8, std::uint8_t,
+	std::conditional_t<bits <= 16, std::uint16_t,
+	std::conditional_t<bits <= 32, std::uint32_t, std::uint64_t>>>;
+
+template<typename T>
+constexpr T sign_not_zero(const T value) {
+	return value < T(0)? T(-1) : T(1);
+}
+
+// clamps to [0, 1], mapping NaN to zero
+template<typename T>
+constexpr T saturate(const T value) {
+	return value > T(0)? (value < T(1)? value : T(1)) : T(0);
+}
+
+} // impl
+
+/*
+ * Codecs convert a value to and from a compact wire representation.
+ * They're used through the adaptors further down rather than directly.
+ * 
+ * Each provides a value_type, an unsigned or signed integral wire_type,
+ * the number of significant bits in the wire value (for bit_stream) and
+ * encode/decode functions.
+ */
+namespace codec {
+
+template<std::floating_point T, unsigned bits_>
+class quantise final {
+	static_assert(bits_ > 0 && bits_ <= std::numeric_limits<T>::digits,
+		"quantised values must fit within the type's mantissa");
+
+	static constexpr T steps = T((std::uint64_t(1) << bits_) - 1);
+
+	T min_, scale_, step_;
+
+public:
+	using value_type = T;
+	using wire_type = impl::uint_least<bits_>;
+	static constexpr unsigned bits = bits_;
+
+	constexpr quantise(const T min, const T max)
+		: min_(min), scale_(steps / (max - min)), step_((max - min) / steps) {
+		assert(max > min);
+	}
+
+	constexpr wire_type encode(const T value) const {
+		auto scaled = (value - min_) * scale_;
+		scaled = scaled > T(0)? scaled : T(0); // NaN ends up at the minimum
+		scaled = scaled < steps? scaled : steps;
+
+		/*
+		 * Rounded without adding 0.5 first, as at the full width of the
+		 * mantissa, steps + 0.5 isn't representable and would round up
+		 * to a value that doesn't fit in the wire bits
+		 */
+		auto whole = static_cast<wire_type>(scaled);
+
+		if(scaled - T(whole) >= T(0.5)) {
+			++whole;
+		}
+
+		return whole;
+	}
+
+	constexpr T decode(const wire_type value) const {
+		return min_ + T(value) * step_;
+	}
+};
+
+template<std::floating_point T, unsigned fraction, std::integral wire>
+class fixed_point final {
+	static_assert(sizeof(wire) <= sizeof(std::uint32_t), "wire type must be 32 bits or fewer");
+	static_assert(fraction < sizeof(wire) * 8, "too many fractional bits for wire type");
+
+	static constexpr double scale = double(std::uint64_t(1) << fraction);
+	static constexpr double lowest = std::numeric_limits<wire>::lowest();
+	static constexpr double highest = std::numeric_limits<wire>::max();
+
+public:
+	using value_type = T;
+	using wire_type = wire;
+	static constexpr unsigned bits = sizeof(wire) * 8;
+
+	constexpr wire_type encode(const T value) const {
+		auto scaled = double(value) * scale;
+		scaled = scaled > lowest? scaled : lowest;
+		scaled = scaled < highest? scaled : highest;
+		return static_cast<wire_type>(scaled + (scaled < 0.0? -0.5 : 0.5));
+	}
+
+	constexpr T decode(const wire_type value) const {
+		return T(double(value) / scale);
+	}
+};
+
+/*
+ * IEEE 754 binary16, rounding to nearest even. Values beyond the
+ * range of a half become infinity and NaNs are preserved.
+ */
+template<std::floating_point T>
+class half final {
+public:
+	using value_type = T;
+	using wire_type = std::uint16_t;
+	static constexpr unsigned bits = 16;
+
+	constexpr wire_type encode(const T value) const {
+		constexpr std::uint32_t infinity = 255u << 23;
+		constexpr std::uint32_t max = (127u + 16u) << 23;
+		constexpr std::uint32_t min_normal = 113u << 23;
+		constexpr std::uint32_t denormal_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		auto input = std::bit_cast<std::uint32_t>(static_cast<float>(value));
+		const auto sign = input & 0x80000000u;
+		input ^= sign;
+		std::uint32_t output = 0;
+
+		if(input >= max) {
+			output = input > infinity? 0x7e00u : 0x7c00u;
+		} else if(input < min_normal) {
+			// let the FPU handle the rounding of subnormals
+			const auto magic = std::bit_cast<float>(denormal_magic);
+			output = std::bit_cast<std::uint32_t>(std::bit_cast<float>(input) + magic) - denormal_magic;
+		} else {
+			const auto odd = (input >> 13) & 1u;
+			input += ((15u - 127u) << 23) + 0xfffu + odd;
+			output = input >> 13;
+		}
+
+		return static_cast<wire_type>(output | (sign >> 16));
+	}
+
+	constexpr T decode(const wire_type value) const {
+		constexpr std::uint32_t shifted_exponent = 0x7c00u << 13;
+		constexpr std::uint32_t magic = 113u << 23;
+
+		auto output = std::uint32_t(value & 0x7fffu) << 13;
+		const auto exponent = output & shifted_exponent;
+		output += (127u - 15u) << 23;
+
+		if(exponent == shifted_exponent) {
+			output += (128u - 16u) << 23; // infinity or NaN
+		} else if(exponent == 0) {
+			output += 1u << 23;
+			output = std::bit_cast<std::uint32_t>(std::bit_cast<float>(output) - std::bit_cast<float>(magic));
+		}
+
+		output |= std::uint32_t(value & 0x8000u) << 16;
+		return static_cast<T>(std::bit_cast<float>(output));
+	}
+};
+
+/*
+ * The upper half of an IEEE 754 binary32, rounding to nearest even.
+ * Keeps the full range of a float at the cost of precision.
+ */
+template<std::floating_point T>
+class bfloat16 final {
+public:
+	using value_type = T;
+	using wire_type = std::uint16_t;
+	static constexpr unsigned bits = 16;
+
+	constexpr wire_type encode(const T value) const {
+		auto input = std::bit_cast<std::uint32_t>(static_cast<float>(value));
+
+		if((input & 0x7fffffffu) > 0x7f800000u) {
+			return static_cast<wire_type>((input >> 16) | 0x40u); // keep NaNs quiet
+		}
+
+		input += 0x7fffu + ((input >> 16) & 1u);
+		return static_cast<wire_type>(input >> 16);
+	}
+
+	constexpr T decode(const wire_type value) const {
+		return static_cast<T>(std::bit_cast<float>(std::uint32_t(value) << 16));
+	}
+};
+
+/*
+ * Unit vectors mapped onto an octahedron and unfolded onto a square,
+ * giving two components of the given number of bits each. The decoded
+ * vector is normalised.
+ */
+template<unsigned bits_per_component>
+class octahedral final {
+	static_assert(bits_per_component > 1 && bits_per_component <= 16);
+
+	static constexpr float steps = float((1u << bits_per_component) - 1);
+
+public:
+	using value_type = std::array<float, 3>;
+	using wire_type = impl::uint_least<bits_per_component * 2>;
+	static constexpr unsigned bits = bits_per_component * 2;
+
+	constexpr wire_type encode(const value_type& value) const {
+		const auto [x, y, z] = value;
+		const auto length = std::abs(x) + std::abs(y) + std::abs(z);
+		auto u = length > 0.0f? x / length : 0.0f;
+		auto v = length > 0.0f? y / length : 0.0f;
+
+		if(z < 0.0f) {
+			const auto fold_u = (1.0f - std::abs(v)) * impl::sign_not_zero(u);
+			v = (1.0f - std::abs(u)) * impl::sign_not_zero(v);
+			u = fold_u;
+		}
+
+		const auto qu = static_cast<wire_type>(impl::saturate(u * 0.5f + 0.5f) * steps + 0.5f);
+		const auto qv = static_cast<wire_type>(impl::saturate(v * 0.5f + 0.5f) * steps + 0.5f);
+		return static_cast<wire_type>(qu | (wire_type(qv) << bits_per_component));
+	}
+
+	constexpr value_type decode(const wire_type value) const {
+		constexpr auto mask = (std::uint32_t(1) << bits_per_component) - 1;
+		auto x = float(value & mask) / steps * 2.0f - 1.0f;
+		auto y = float((value >> bits_per_component) & mask) / steps * 2.0f - 1.0f;
+		const auto z = 1.0f - std::abs(x) - std::abs(y);
+
+		if(z < 0.0f) {
+			const auto fold_x = (1.0f - std::abs(y)) * impl::sign_not_zero(x);
+			y = (1.0f - std::abs(x)) * impl::sign_not_zero(y);
+			x = fold_x;
+		}
+
+		const auto length = std::sqrt(x * x + y * y + z * z);
+		return { x / length, y / length, z / length };
+	}
+};
+
+/*
+ * Unit quaternions as the index of the largest component, which is
+ * reconstructed on decode, and the other three components with the given
+ * number of bits each. q and -q are the same rotation, so the sign is
+ * flipped to make the largest component positive.
+ */
+template<unsigned bits_per_component>
+class smallest_three final {
+	static_assert(bits_per_component > 1 && bits_per_component <= 20);
+
+	static constexpr float range = 0.70710678118f; // 1 / sqrt(2)
+	static constexpr float steps = float((1u << bits_per_component) - 1);
+
+public:
+	using value_type = std::array<float, 4>;
+	using wire_type = impl::uint_least<2 + bits_per_component * 3>;
+	static constexpr unsigned bits = 2 + bits_per_component * 3;
+
+	constexpr wire_type encode(const value_type& value) const {
+		std::size_t largest = 0;
+
+		for(std::size_t i = 1; i < value.size(); ++i) {
+			if(std::abs(value[i]) > std::abs(value[largest])) {
+				largest = i;
+			}
+		}
+
+		const auto sign = value[largest] < 0.0f? -1.0f : 1.0f;
+		wire_type output = static_cast<wire_type>(largest);
+		unsigned shift = 2;
+
+		for(std::size_t i = 0; i < value.size(); ++i) {
+			if(i == largest) {
+				continue;
+			}
+
+			const auto normalised = impl::saturate((value[i] * sign + range) / (2.0f * range));
+			output |= static_cast<wire_type>(normalised * steps + 0.5f) << shift;
+			shift += bits_per_component;
+		}
+
+		return output;
+	}
+
+	constexpr value_type decode(const wire_type value) const {
+		constexpr auto mask = (std::uint32_t(1) << bits_per_component) - 1;
+		const auto largest = static_cast<std::size_t>(value & 0x03u);
+		value_type output{};
+		float sum = 0.0f;
+		unsigned shift = 2;
+
+		for(std::size_t i = 0; i < output.size(); ++i) {
+			if(i == largest) {
+				continue;
+			}
+
+			const auto component = float((value >> shift) & mask) / steps * (2.0f * range) - range;
+			output[i] = component;
+			sum += component * component;
+			shift += bits_per_component;
+		}
+
+		output[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+		return output;
+	}
+};
+
+} // codec
+
+/*
+ * Stream adaptor that applies a codec to a single value or to a contiguous
+ * range of values. Values are encoded in batches, so the conversions over a
+ * range are amenable to vectorisation, and are written with the stream's
+ * byte order.
+ */
+template<typename codec_type, typename T>
+class packed final : public packed_tag_t {
+public:
+	using value_type = T;
+	using wire_type = typename codec_type::wire_type;
+	static constexpr unsigned bits = codec_type::bits;
+
+	std::span<T> values;
+	codec_type codec;
+
+	packed(std::span<T> values, codec_type codec)
+		: values(values), codec(codec) {}
+};
+
+namespace impl {
+
+template<typename T, typename value_type>
+concept packable = std::same_as<std::remove_const_t<T>, value_type>
+	|| (std::ranges::contiguous_range<T>
+		&& std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<T>>, value_type>);
+
+template<typename T>
+struct packed_value {
+	using type = T;
+};
+
+template<std::ranges::range T>
+struct packed_value<T> {
+	using type = std::ranges::range_value_t<T>;
+};
+
+template<typename T>
+using packed_value_t = std::remove_const_t<typename packed_value<T>::type>;
+
+template<typename codec_type, typename T>
+auto make_packed(T& value, codec_type codec) {
+	if constexpr(std::same_as<std::remove_const_t<T>, typename codec_type::value_type>) {
+		return packed<codec_type, T>(std::span<T>(&value, 1), codec);
+	} else {
+		using element = std::remove_reference_t<std::ranges::range_reference_t<T>>;
+		return packed<codec_type, element>(std::span<element>(value), codec);
+	}
+}
+
+} // impl
+
+/**
+ * @brief Maps a floating point value within a known range onto an
+ * unsigned integer of the given number of bits.
+ * 
+ * @tparam bits The number of bits to quantise to.
+ * @param value The value, or a contiguous range of values.
+ * @param min The lowest value that can be represented.
+ * @param max The highest value that can be represented.
+ * 
+ * @note Values outside of the range are clamped.
+ */
+template<unsigned bits, typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto quantised(T& value, const std::type_identity_t<value_type> min, const std::type_identity_t<value_type> max) {
+	return impl::make_packed(value, codec::quantise<value_type, bits>(min, max));
+}
+
+/**
+ * @brief Stores a floating point value as a fixed point integer.
+ * 
+ * @tparam fraction The number of fractional bits.
+ * @tparam wire_type The integral type to store the value as.
+ * @param value The value, or a contiguous range of values.
+ * 
+ * @note Values outside of the range of the wire type are clamped.
+ */
+template<unsigned fraction, std::integral wire_type = std::int32_t,
+         typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto fixed_point(T& value) {
+	return impl::make_packed(value, codec::fixed_point<value_type, fraction, wire_type>());
+}
+
+/**
+ * @brief Stores a floating point value as an IEEE 754 half.
+ * 
+ * @param value The value, or a contiguous range of values.
+ */
+template<typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto half_float(T& value) {
+	return impl::make_packed(value, codec::half<value_type>());
+}
+
+/**
+ * @brief Stores a floating point value as a bfloat16.
+ * 
+ * @param value The value, or a contiguous range of values.
+ */
+template<typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto bfloat16(T& value) {
+	return impl::make_packed(value, codec::bfloat16<value_type>());
+}
+
+/**
+ * @brief Stores a unit vector with octahedral encoding.
+ * 
+ * @tparam bits The number of bits for each of the two encoded components.
+ * @param value A std::array<float, 3>, or a contiguous range of them.
+ */
+template<unsigned bits, typename T>
+requires impl::packable<T, std::array<float, 3>>
+auto octahedral(T& value) {
+	return impl::make_packed(value, codec::octahedral<bits>());
+}
+
+/**
+ * @brief Stores a unit quaternion as its three smallest components.
+ * 
+ * @tparam bits The number of bits for each of the three encoded components.
+ * @param value A std::array<float, 4> holding x, y, z and w, or a contiguous
+ * range of them.
+ */
+template<unsigned bits, typename T>
+requires impl::packable<T, std::array<float, 4>>
+auto smallest_three(T& value) {
+	return impl::make_packed(value, codec::smallest_three<bits>());
+}
+
+} // hexi
@@ -0,0 +1,513 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+#pragma once
+
+#include <hexi/exception.h>
+#include <hexi/shared.h>
+#include <hexi/concepts.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HEXI_HAS_MIRRORED_MAPPING
+#endif
+
+namespace hexi {
+
+/**
+ * Fixed-capacity circular buffer that maps the same physical memory twice,
+ * back to back, in the virtual address space. Any region that wraps around
+ * the end of the buffer is therefore still contiguous in memory, so reads
+ * and writes never need to be split and view()/span() deserialisation works
+ * on a buffer that is continuously being recycled.
+ *
+ * The capacity must be a multiple of the system's page size, otherwise
+ * construction will fail. Only available on POSIX systems; construction
+ * fails elsewhere.
+ */
+template<std::size_t buf_size, byte_type storage_type = std::byte>
+requires (buf_size > 0)
+class ring_buffer final {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = size_type;
+	using value_type      = storage_type;
+	using contiguous      = is_contiguous;
+	using seeking         = supported;
+
+	// offset of the reserved region within the first mapping
+	using placeholder_type = size_type;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	value_type* buffer_ = nullptr;
+	size_type read_ = 0; // always within [0, buf_size)
+	size_type size_ = 0;
+
+#ifdef HEXI_HAS_MIRRORED_MAPPING
+	static int create_shared_memory() {
+#if defined(__linux__)
+		return ::memfd_create("hexi::ring_buffer", MFD_CLOEXEC);
+#else
+		static std::atomic<unsigned int> counter;
+		const auto name = "/hexi-ring-" + std::to_string(::getpid())
+			+ "-" + std::to_string(counter++);
+
+		const auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+		if(fd != -1) {
+			::shm_unlink(name.c_str());
+		}
+
+		return fd;
+#endif
+	}
+
+	static value_type* map_mirrored() {
+		const auto page_size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+
+		if(buf_size % page_size) {
+			HEXI_THROW(exception("ring_buffer size must be a multiple of the page size"));
+		}
+
+		const auto fd = create_shared_memory();
+
+		if(fd == -1) {
+			HEXI_THROW(exception("ring_buffer could not create shared memory"));
+		}
+
+		if(::ftruncate(fd, buf_size) == -1) {
+			::close(fd);
+			HEXI_THROW(exception("ring_buffer could not size shared memory"));
+		}
+
+		// reserve enough address space for both views, then map over it
+		auto base = static_cast<char*>(::mmap(nullptr, buf_size * 2, PROT_NONE,
+		                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+		if(base == MAP_FAILED) {
+			::close(fd);
+			HEXI_THROW(exception("ring_buffer could not reserve address space"));
+		}
+
+		auto first = ::mmap(base, buf_size, PROT_READ | PROT_WRITE,
+		                    MAP_SHARED | MAP_FIXED, fd, 0);
+
+		auto second = ::mmap(base + buf_size, buf_size, PROT_READ | PROT_WRITE,
+		                     MAP_SHARED | MAP_FIXED, fd, 0);
+
+		::close(fd);
+
+		if(first == MAP_FAILED || second == MAP_FAILED) {
+			::munmap(base, buf_size * 2);
+			HEXI_THROW(exception("ring_buffer could not map mirrored views"));
+		}
+
+		return reinterpret_cast<value_type*>(base);
+	}
+
+	static void unmap(value_type* buffer) {
+		if(buffer) {
+			::munmap(buffer, buf_size * 2);
+		}
+	}
+#else
+	static value_type* map_mirrored() {
+		HEXI_THROW(exception("ring_buffer is not supported on this platform"));
+		return nullptr;
+	}
+
+	static void unmap(value_type*) {}
+#endif
+
+public:
+	ring_buffer()
+		: buffer_(map_mirrored()) {}
+
+	ring_buffer(ring_buffer&& rhs) noexcept
+		: buffer_(std::exchange(rhs.buffer_, nullptr)),
+		  read_(std::exchange(rhs.read_, 0)),
+		  size_(std::exchange(rhs.size_, 0)) {}
+
+	ring_buffer& operator=(ring_buffer&& rhs) noexcept {
+		if(this != &rhs) {
+			unmap(buffer_);
+			buffer_ = std::exchange(rhs.buffer_, nullptr);
+			read_ = std::exchange(rhs.read_, 0);
+			size_ = std::exchange(rhs.size_, 0);
+		}
+
+		return *this;
+	}
+
+	ring_buffer(const ring_buffer&) = delete;
+	ring_buffer& operator=(const ring_buffer&) = delete;
+
+	~ring_buffer() {
+		unmap(buffer_);
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) {
+		copy(destination, length);
+		skip(length);
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @note The destination buffer address must not belong to the ring_buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, size_type length) const {
+		assert(!impl::region_overlap(buffer_, buf_size * 2, destination, length));
+
+		if(length > size()) {
+			HEXI_THROW(buffer_underrun(length, read_, size()));
+		}
+
+		std::memcpy(destination, read_ptr(), length);
+	}
+
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(value_type val) const noexcept {
+		const auto data = read_ptr();
+		const auto it = std::find(data, data + size_, val);
+		return it == data + size_? npos : static_cast<size_type>(it - data);
+	}
+
+	/**
+	 * @brief Skip over a number of bytes.
+	 * 
+	 * Skips over a number of bytes from the container. This should be used
+	 * if the container holds data that you don't care about but don't want
+	 * to have to read it to another buffer to access data beyond it.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		assert(length <= size_);
+		read_ += length;
+		size_ -= length;
+
+		if(read_ >= buf_size) {
+			read_ -= buf_size;
+		}
+
+		// not required for correctness but keeps the cursors in one view
+		if(!size_) {
+			read_ = 0;
+		}
+	}
+
+	/**
+	 * @brief Advances the write cursor.
+	 * 
+	 * @param size The number of bytes by which to advance the write cursor.
+	 */
+	void advance_write(size_type bytes) {
+		assert(free() >= bytes);
+		size_ += bytes;
+	}
+
+	/**
+	 * @brief Clears the container.
+	 */
+	void clear() {
+		read_ = size_ = 0;
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const size_type index) {
+		return read_ptr()[index];
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const size_type index) const {
+		return read_ptr()[index];
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !size_;
+	}
+
+	/**
+	 * @return Whether the container is full and cannot be further written to.
+	 */
+	bool full() const {
+		return size_ == capacity();
+	}
+
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	constexpr static bool can_write_seek() {
+		return std::is_same_v<seeking, supported>;
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container.
+	 * 
+	 * @note The source buffer address must not belong to the ring_buffer.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, size_type length) {
+		assert(!impl::region_overlap(source, length, buffer_, buf_size * 2));
+
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, size_, free()));
+		}
+
+		std::memcpy(write_ptr(), source, length);
+		size_ += length;
+	}
+
+	/**
+	 * @brief Reserves space at the write cursor to be filled in later.
+	 * 
+	 * @note The placeholder is invalidated once its contents have been read.
+	 * 
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
+	 */
+	placeholder_type reserve_placeholder(size_type length) {
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, size_, free()));
+		}
+
+		const auto offset = (read_ + size_) % buf_size;
+		size_ += length;
+		return offset;
+	}
+
+	/**
+	 * @brief Writes data into previously reserved space.
+	 * 
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(placeholder_type placeholder, const void* source, size_type length) {
+		std::memcpy(placeholder_ptr(placeholder), source, length);
+	}
+
+	/**
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * 
+	 * @return Pointer to the start of the reserved space, which is
+	 * contiguous even if it wraps around.
+	 */
+	value_type* placeholder_ptr(placeholder_type placeholder) {
+		// relative to the read cursor, so it's in the same view as write_ptr()
+		return buffer_ + read_ + ((placeholder + buf_size - read_) % buf_size);
+	}
+
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking. Absolute offsets are relative to the read cursor,
+	 * since the start of the underlying storage has no fixed meaning.
+	 */
+	void write_seek(const buffer_seek direction, const size_type offset) {
+		switch(direction) {
+			case buffer_seek::sk_backward:
+				size_ -= offset;
+				break;
+			case buffer_seek::sk_forward:
+				size_ += offset;
+				break;
+			case buffer_seek::sk_absolute:
+				size_ = offset;
+		}
+
+		assert(size_ <= capacity());
+	}
+
+	/**
+	 * @return An iterator to the beginning of data available for reading.
+	 */
+	auto begin() {
+		return read_ptr();
+	}
+
+	/**
+	 * @return An iterator to the beginning of data available for reading.
+	 */
+	auto begin() const {
+		return read_ptr();
+	}
+
+	/**
+	 * @return An iterator to the end of data available for reading.
+	 */
+	auto end() {
+		return write_ptr();
+	}
+
+	/**
+	 * @return An iterator to the end of data available for reading.
+	 */
+	auto end() const {
+		return write_ptr();
+	}
+
+	/**
+	 * @brief Overall capacity of the container.
+	 * 
+	 * @return The container's total size in bytes.
+	 */
+	constexpr static size_type capacity() {
+		return buf_size;
+	}
+
+	/**
+	 * @brief Returns the size of the container.
+	 * 
+	 * @return The number of bytes of data available to read within the container.
+	 */
+	size_type size() const {
+		return size_;
+	}
+
+	/**
+	 * @brief The amount of free space.
+	 * 
+	 * @return The number of bytes that can be written, which are always
+	 * contiguous from write_ptr().
+	 */
+	size_type free() const {
+		return buf_size - size_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	const value_type* data() const {
+		return read_ptr();
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	value_type* data() {
+		return read_ptr();
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	const value_type* read_ptr() const {
+		return buffer_ + read_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	value_type* read_ptr() {
+		return buffer_ + read_;
+	}
+
+	/**
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
+	 */
+	const value_type* write_ptr() const {
+		return buffer_ + read_ + size_;
+	}
+
+	/**
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
+	 */
+	value_type* write_ptr() {
+		return buffer_ + read_ + size_;
+	}
+};
+
+} // hexi
@@ -10,6 +10,8 @@
 #include <array>
 #include <bit>
 #include <concepts>
+#include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <cstddef>
 #include <cstdint>
@@ -91,8 +93,12 @@ constexpr auto varint_decode(stream_type& stream) -> size_type {
 	do {
 		byte = 0; // clear in case an error occurs
 		stream.get(&byte, 1);
-		value |= (static_cast<size_type>(byte & 0x7f) << shift);
-		shift += 7;
+
+		// excess continuation bytes in corrupt input are ignored rather than overflowing
+		if(shift < static_cast<int>(sizeof(size_type) * 8)) {
+			value |= (static_cast<size_type>(byte & 0x7f) << shift);
+			shift += 7;
+		}
 	} while(byte & 0x80);
 
 	return value;
@@ -114,6 +120,33 @@ constexpr auto varint_encode(stream_type& stream, size_type value) -> size_type
 	return ++written;
 }
 
+template<typename container_type>
+concept allocator_propagating = requires(const container_type& c) { c.get_allocator(); }
+	&& std::uses_allocator_v<typename container_type::value_type, typename container_type::allocator_type>;
+
+/*
+ * Constructs an element that's about to be read into a container. Elements
+ * that are allocator-aware are given the container's allocator, so nested
+ * containers share its memory resource. Containers that have no allocator
+ * to hand down fall back to the provided resource, if any.
+ */
+template<typename container_type>
+auto make_element(const container_type& container, std::pmr::memory_resource* resource) {
+	using value_type = typename container_type::value_type;
+
+	if constexpr(allocator_propagating<container_type>) {
+		return std::make_obj_using_allocator<value_type>(container.get_allocator());
+	} else if constexpr(std::uses_allocator_v<value_type, std::pmr::polymorphic_allocator<>>) {
+		if(resource) {
+			return std::make_obj_using_allocator<value_type>(std::pmr::polymorphic_allocator<>(resource));
+		}
+
+		return value_type();
+	} else {
+		return value_type();
+	}
+}
+
 template<decltype(auto) size>
 static constexpr auto generate_filled(const std::uint8_t value) {
 	std::array<std::uint8_t, size> target{};
@@ -0,0 +1,347 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#pragma once
+
+#include <hexi/shared.h>
+#include <hexi/concepts.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace hexi {
+
+namespace impl {
+
+template<decltype(auto) block_sz, byte_type value_type>
+struct spsc_block {
+	std::atomic<spsc_block*> next = nullptr;
+	std::array<value_type, block_sz> storage;
+};
+
+} // impl
+
+/**
+ * Unbounded single-producer, single-consumer byte queue, intended for handing
+ * a stream of data from one thread to another without a lock.
+ *
+ * Data is stored in a linked list of fixed-size blocks. The producer thread
+ * may call write() and the consumer thread may call read(), copy(), skip() and
+ * find_first_of(). size() and empty() may be called from either side, with
+ * the consumer seeing at least as much data as the producer has published.
+ *
+ * Each side owns its own cursor and publishes the running total of bytes it
+ * has processed with release semantics, so the other side only ever sees
+ * fully written data. Blocks drained by the consumer are handed back to the
+ * producer for reuse, so a steady-state stream does not allocate.
+ *
+ * Write seeking is not supported, since data is visible to the consumer
+ * as soon as it has been written.
+ */
+template<decltype(auto) block_sz, byte_type storage_value_type = std::byte>
+requires (block_sz > 0)
+class spsc_buffer final {
+public:
+	using value_type   = storage_value_type;
+	using size_type    = std::size_t;
+	using offset_type  = std::size_t;
+	using contiguous   = is_non_contiguous;
+	using seeking      = unsupported;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	using block = impl::spsc_block<block_sz, value_type>;
+
+	// avoids the producer and consumer cursors sharing a cache line
+	static constexpr std::size_t cache_line = 64;
+
+	struct alignas(cache_line) producer_state {
+		block* tail;
+		size_type offset = 0;
+		block* spare = nullptr; // producer-local list of recycled blocks
+		std::atomic<size_type> total = 0;
+	};
+
+	struct alignas(cache_line) consumer_state {
+		block* head;
+		size_type offset = 0;
+		std::atomic<size_type> total = 0;
+	};
+
+	producer_state producer_;
+	consumer_state consumer_;
+
+	// blocks drained by the consumer, waiting to be collected by the producer
+	alignas(cache_line) std::atomic<block*> recycled_ = nullptr;
+
+	// producer only
+	block* next_block() {
+		if(!producer_.spare) {
+			producer_.spare = recycled_.exchange(nullptr, std::memory_order_acquire);
+		}
+
+		if(auto spare = producer_.spare) {
+			producer_.spare = spare->next.load(std::memory_order_relaxed);
+			spare->next.store(nullptr, std::memory_order_relaxed);
+			return spare;
+		}
+
+		return new block();
+	}
+
+	// consumer only
+	void recycle(block* drained) {
+		auto head = recycled_.load(std::memory_order_relaxed);
+
+		do {
+			drained->next.store(head, std::memory_order_relaxed);
+		} while(!recycled_.compare_exchange_weak(head, drained,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	static void free_list(block* head) {
+		while(head) {
+			auto next = head->next.load(std::memory_order_relaxed);
+			delete head;
+			head = next;
+		}
+	}
+
+	/*
+	 * Advances the consumer past a fully drained block. Only called once it's
+	 * known that more data is available, which guarantees the producer has
+	 * already linked the next block.
+	 */
+	void advance_head() {
+		if(consumer_.offset != block_sz) {
+			return;
+		}
+
+		auto drained = consumer_.head;
+		consumer_.head = drained->next.load(std::memory_order_acquire);
+		consumer_.offset = 0;
+		assert(consumer_.head && "spsc_buffer block not linked");
+		recycle(drained);
+	}
+
+	template<typename func>
+	void consume(size_type length, func&& handler) {
+		assert(length <= size() && "SPSC buffer read too large!");
+		size_type remaining = length;
+
+		while(remaining) {
+			advance_head();
+			const auto count = std::min(remaining, block_sz - consumer_.offset);
+			handler(consumer_.head->storage.data() + consumer_.offset, length - remaining, count);
+			consumer_.offset += count;
+			remaining -= count;
+		}
+
+		const auto total = consumer_.total.load(std::memory_order_relaxed);
+		consumer_.total.store(total + length, std::memory_order_release);
+	}
+
+public:
+	spsc_buffer() {
+		auto initial = new block();
+		producer_.tail = initial;
+		consumer_.head = initial;
+	}
+
+	spsc_buffer(const spsc_buffer&) = delete;
+	spsc_buffer& operator=(const spsc_buffer&) = delete;
+
+	~spsc_buffer() {
+		free_list(consumer_.head);
+		free_list(producer_.spare);
+		free_list(recycled_.load(std::memory_order_acquire));
+	}
+
+	/**
+	 * @brief Write data to the container. Producer only.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container. Producer only.
+	 * 
+	 * @note The written data becomes visible to the consumer once
+	 * the call has returned.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, const size_type length) {
+		auto src = static_cast<const value_type*>(source);
+		size_type remaining = length;
+
+		while(remaining) {
+			if(producer_.offset == block_sz) {
+				auto next = next_block();
+				producer_.tail->next.store(next, std::memory_order_release);
+				producer_.tail = next;
+				producer_.offset = 0;
+			}
+
+			const auto count = std::min(remaining, block_sz - producer_.offset);
+			std::memcpy(producer_.tail->storage.data() + producer_.offset, src, count);
+			producer_.offset += count;
+			src += count;
+			remaining -= count;
+		}
+
+		const auto total = producer_.total.load(std::memory_order_relaxed);
+		producer_.total.store(total + length, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer. Consumer only.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer. Consumer only.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, const size_type length) {
+		auto dest = static_cast<value_type*>(destination);
+
+		consume(length, [&](const value_type* data, size_type offset, size_type count) {
+			std::memcpy(dest + offset, data, count);
+		});
+	}
+
+	/**
+	 * @brief Skip the requested number of bytes. Consumer only.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		consume(length, [](const value_type*, size_type, size_type) {});
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor. Consumer only.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor. Consumer only.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, const size_type length) const {
+		assert(length <= size() && "SPSC buffer copy too large!");
+		auto dest = static_cast<value_type*>(destination);
+		auto head = consumer_.head;
+		auto offset = consumer_.offset;
+		size_type remaining = length;
+
+		while(remaining) {
+			if(offset == block_sz) {
+				head = head->next.load(std::memory_order_acquire);
+				offset = 0;
+			}
+
+			const auto count = std::min(remaining, block_sz - offset);
+			std::memcpy(dest + length - remaining, head->storage.data() + offset, count);
+			offset += count;
+			remaining -= count;
+		}
+	}
+
+	/**
+	 * @brief Attempts to locate the provided value within the data that
+	 * is currently available to the consumer. Consumer only.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(const value_type value) const {
+		const auto available = size();
+		auto head = consumer_.head;
+		auto offset = consumer_.offset;
+		size_type index = 0;
+
+		while(index < available) {
+			if(offset == block_sz) {
+				head = head->next.load(std::memory_order_acquire);
+				offset = 0;
+			}
+
+			const auto count = std::min(available - index, block_sz - offset);
+			const auto begin = head->storage.data() + offset;
+			const auto it = std::find(begin, begin + count, value);
+
+			if(it != begin + count) {
+				return index + (it - begin);
+			}
+
+			offset += count;
+			index += count;
+		}
+
+		return npos;
+	}
+
+	/**
+	 * @brief Returns the amount of data published by the producer that
+	 * has not yet been consumed.
+	 * 
+	 * @return The number of bytes of data available to read.
+	 */
+	size_type size() const {
+		const auto read = consumer_.total.load(std::memory_order_acquire);
+		const auto written = producer_.total.load(std::memory_order_acquire);
+		return written - read;
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container has no data to be read.
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !size();
+	}
+
+	/**
+	 * @brief Retrieves the container's block size.
+	 * 
+	 * @return The block size.
+	 */
+	constexpr static size_type block_size() {
+		return block_sz;
+	}
+};
+
+} // hexi
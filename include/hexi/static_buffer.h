@@ -31,6 +31,9 @@ public:
 	using contiguous      = is_contiguous;
 	using seeking         = supported;
 
+	// offset of the reserved region within the underlying storage
+	using placeholder_type = size_type;
+
 	static constexpr auto npos { static_cast<size_type>(-1) };
 	
 	static_buffer() = default;
@@ -265,6 +268,47 @@ public:
 		write_ += length;
 	}
 
+	/**
+	 * @brief Reserves space at the write cursor to be filled in later.
+	 * 
+	 * @note The placeholder is invalidated by defragment() or once its
+	 * contents have been read.
+	 * 
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
+	 */
+	placeholder_type reserve_placeholder(size_type length) {
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, write_, free()));
+		}
+
+		const auto offset = write_;
+		write_ += length;
+		return offset;
+	}
+
+	/**
+	 * @brief Writes data into previously reserved space.
+	 * 
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(placeholder_type placeholder, const void* source, size_type length) {
+		std::memcpy(placeholder_ptr(placeholder), source, length);
+	}
+
+	/**
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * 
+	 * @return Pointer to the start of the reserved space.
+	 */
+	value_type* placeholder_ptr(placeholder_type placeholder) {
+		return buffer_.data() + placeholder;
+	}
+
 	/**
 	 * @brief Performs write seeking within the container.
 	 * 
@@ -10,6 +10,9 @@
 
 namespace hexi {
 
+// base of adaptors that pack values into a compact form, see quantise.h
+struct packed_tag_t {};
+
 template<typename stream_type>
 class stream_read_adaptor final {
 	stream_type& _stream;
@@ -6,7 +6,16 @@
 
 #pragma once
 
-// #include <hexi/binary_stream.h>
+// #include <hexi/aggregate.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/concepts.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -28,6 +37,8 @@
 #include <array>
 #include <bit>
 #include <concepts>
+#include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <cstddef>
 #include <cstdint>
@@ -109,8 +120,12 @@ constexpr auto varint_decode(stream_type& stream) -> size_type {
 	do {
 		byte = 0; // clear in case an error occurs
 		stream.get(&byte, 1);
-		value |= (static_cast<size_type>(byte & 0x7f) << shift);
-		shift += 7;
+
+		// excess continuation bytes in corrupt input are ignored rather than overflowing
+		if(shift < static_cast<int>(sizeof(size_type) * 8)) {
+			value |= (static_cast<size_type>(byte & 0x7f) << shift);
+			shift += 7;
+		}
 	} while(byte & 0x80);
 
 	return value;
@@ -132,6 +147,33 @@ constexpr auto varint_encode(stream_type& stream, size_type value) -> size_type
 	return ++written;
 }
 
+template<typename container_type>
+concept allocator_propagating = requires(const container_type& c) { c.get_allocator(); }
+	&& std::uses_allocator_v<typename container_type::value_type, typename container_type::allocator_type>;
+
+/*
+ * Constructs an element that's about to be read into a container. Elements
+ * that are allocator-aware are given the container's allocator, so nested
+ * containers share its memory resource. Containers that have no allocator
+ * to hand down fall back to the provided resource, if any.
+ */
+template<typename container_type>
+auto make_element(const container_type& container, std::pmr::memory_resource* resource) {
+	using value_type = typename container_type::value_type;
+
+	if constexpr(allocator_propagating<container_type>) {
+		return std::make_obj_using_allocator<value_type>(container.get_allocator());
+	} else if constexpr(std::uses_allocator_v<value_type, std::pmr::polymorphic_allocator<>>) {
+		if(resource) {
+			return std::make_obj_using_allocator<value_type>(std::pmr::polymorphic_allocator<>(resource));
+		}
+
+		return value_type();
+	} else {
+		return value_type();
+	}
+}
+
 template<decltype(auto) size>
 static constexpr auto generate_filled(const std::uint8_t value) {
 	std::array<std::uint8_t, size> target{};
@@ -154,15 +196,6 @@ static inline bool region_overlap(const void* src, std::size_t src_len,
 
 } // hexi
 
-// #include <hexi/concepts.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
-
-
-
 // #include <hexi/stream_adaptors.h>
 //  _               _ 
 // | |__   _____  _(_)
@@ -176,6 +209,9 @@ static inline bool region_overlap(const void* src, std::size_t src_len,
 
 namespace hexi {
 
+// base of adaptors that pack values into a compact form, see quantise.h
+struct packed_tag_t {};
+
 template<typename stream_type>
 class stream_read_adaptor final {
 	stream_type& _stream;
@@ -226,6 +262,7 @@ public:
 #include <bit>
 #include <concepts>
 #include <ranges>
+#include <string>
 #include <type_traits>
 
 namespace hexi {
@@ -246,6 +283,20 @@ concept contiguous = requires(buf_type t) {
 	std::is_same_v<typename buf_type::contiguous, is_contiguous>;
 };
 
+template<typename buf_type>
+concept placeholder_capable = requires(buf_type t, typename buf_type::placeholder_type p,
+                                       const void* v, typename buf_type::size_type s) {
+	{ t.reserve_placeholder(s) } -> std::same_as<typename buf_type::placeholder_type>;
+	t.fill_placeholder(p, v, s);
+};
+
+template<typename buf_type>
+concept placeholder_addressable = placeholder_capable<buf_type>
+	&& requires(buf_type t, typename buf_type::placeholder_type p) {
+	t.placeholder_ptr(p);
+	t.write_ptr();
+};
+
 template<typename T>
 concept arithmetic = std::integral<T> || std::floating_point<T>;
 
@@ -312,6 +363,10 @@ concept is_iterable =
 		t.begin(); t.end();
 };
 
+template<typename T>
+concept std_string = is_iterable<T> && std::ranges::contiguous_range<T>
+	&& std::same_as<T, std::basic_string<char, std::char_traits<char>, typename T::allocator_type>>;
+
 template<typename T, typename U>
 concept memcpy_read =
 	pod<typename T::value_type> && std::ranges::contiguous_range<T>
@@ -326,6 +381,261 @@ concept memcpy_write =
 
 } // hexi
 
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace hexi {
+
+namespace impl {
+
+constexpr std::size_t max_aggregate_fields = 32;
+
+// converts to anything, used to probe how many initialisers an aggregate takes
+struct any_field {
+	template<typename T>
+	operator T() const;
+};
+
+/*
+ * Counts the fields of an aggregate by finding the largest number of
+ * initialisers it can be brace-initialised with. Built-in array members are
+ * brace-elided and would be counted once per element, so aren't supported.
+ * std::array should be used instead.
+ */
+template<typename T, typename... Fields>
+consteval std::size_t count_fields() {
+	if constexpr(sizeof...(Fields) > max_aggregate_fields) {
+		return sizeof...(Fields);
+	} else if constexpr(requires { T { Fields{}..., any_field{} }; }) {
+		return count_fields<T, Fields..., any_field>();
+	} else {
+		return sizeof...(Fields);
+	}
+}
+
+template<typename T>
+constexpr std::size_t field_count = count_fields<T>();
+
+/*
+ * Calls func with a reference to each field of the aggregate, in declaration order.
+ */
+template<typename T, typename Func>
+constexpr decltype(auto) visit_fields(T& object, Func&& func) {
+	constexpr auto count = field_count<std::remove_const_t<T>>;
+	static_assert(count > 0 && count <= max_aggregate_fields, "unsupported aggregate");
+
+	if constexpr(count == 1) {
+		auto& [f0] = object;
+		return func(f0);
+	} else if constexpr(count == 2) {
+		auto& [f0, f1] = object;
+		return func(f0, f1);
+	} else if constexpr(count == 3) {
+		auto& [f0, f1, f2] = object;
+		return func(f0, f1, f2);
+	} else if constexpr(count == 4) {
+		auto& [f0, f1, f2, f3] = object;
+		return func(f0, f1, f2, f3);
+	} else if constexpr(count == 5) {
+		auto& [f0, f1, f2, f3, f4] = object;
+		return func(f0, f1, f2, f3, f4);
+	} else if constexpr(count == 6) {
+		auto& [f0, f1, f2, f3, f4, f5] = object;
+		return func(f0, f1, f2, f3, f4, f5);
+	} else if constexpr(count == 7) {
+		auto& [f0, f1, f2, f3, f4, f5, f6] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6);
+	} else if constexpr(count == 8) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7);
+	} else if constexpr(count == 9) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+	} else if constexpr(count == 10) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+	} else if constexpr(count == 11) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+	} else if constexpr(count == 12) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+	} else if constexpr(count == 13) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+	} else if constexpr(count == 14) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+	} else if constexpr(count == 15) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+	} else if constexpr(count == 16) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+	} else if constexpr(count == 17) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16);
+	} else if constexpr(count == 18) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17);
+	} else if constexpr(count == 19) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18);
+	} else if constexpr(count == 20) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19);
+	} else if constexpr(count == 21) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20);
+	} else if constexpr(count == 22) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21);
+	} else if constexpr(count == 23) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22);
+	} else if constexpr(count == 24) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23);
+	} else if constexpr(count == 25) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24);
+	} else if constexpr(count == 26) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25);
+	} else if constexpr(count == 27) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26);
+	} else if constexpr(count == 28) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27);
+	} else if constexpr(count == 29) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28);
+	} else if constexpr(count == 30) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29);
+	} else if constexpr(count == 31) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30);
+	} else if constexpr(count == 32) {
+		auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31] = object;
+		return func(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31);
+	}
+}
+
+struct field_types {
+	template<typename... Fields>
+	constexpr auto operator()(Fields&...) const {
+		return std::type_identity<std::tuple<std::remove_cvref_t<Fields>...>>{};
+	}
+};
+
+/*
+ * Works out where each field of an aggregate sits in memory from the sizes
+ * and alignments of the field types, which is how every mainstream ABI lays
+ * out a class with no bases. If the result doesn't add up to the size of the
+ * aggregate, the layout is flagged as unknown and no assumptions are made.
+ */
+template<typename T>
+struct aggregate_layout {
+	using types = typename decltype(visit_fields(std::declval<T&>(), field_types{}))::type;
+
+	static constexpr std::size_t count = std::tuple_size_v<types>;
+
+private:
+	template<std::size_t... I>
+	static consteval auto sizes(std::index_sequence<I...>) {
+		return std::array<std::size_t, count> { sizeof(std::tuple_element_t<I, types>)... };
+	}
+
+	template<std::size_t... I>
+	static consteval auto alignments(std::index_sequence<I...>) {
+		return std::array<std::size_t, count> { alignof(std::tuple_element_t<I, types>)... };
+	}
+
+	static consteval auto offsets() {
+		const auto size = sizes(std::make_index_sequence<count>());
+		const auto align = alignments(std::make_index_sequence<count>());
+		std::array<std::size_t, count> result{};
+		std::size_t offset = 0;
+
+		for(std::size_t i = 0; i < count; ++i) {
+			offset = (offset + align[i] - 1) / align[i] * align[i];
+			result[i] = offset;
+			offset += size[i];
+		}
+
+		return result;
+	}
+
+	static consteval bool verify() {
+		constexpr auto size = sizes(std::make_index_sequence<count>());
+		constexpr auto offset = offsets();
+		const auto end = offset[count - 1] + size[count - 1];
+		return (end + alignof(T) - 1) / alignof(T) * alignof(T) == sizeof(T);
+	}
+
+public:
+	static constexpr auto size = sizes(std::make_index_sequence<count>());
+	static constexpr auto offset = offsets();
+	static constexpr bool known = verify();
+
+	/*
+	 * For each field, finds the end of the run of fields starting there that
+	 * can be copied as a single block of memory, given which field types are
+	 * eligible. A field that can't be coalesced is a run of one.
+	 */
+	static consteval auto runs(const std::array<bool, count>& eligible) {
+		std::array<std::size_t, count> end{};
+
+		for(std::size_t i = 0; i < count; ++i) {
+			end[i] = i + 1;
+
+			if(!known || !eligible[i]) {
+				continue;
+			}
+
+			while(end[i] < count && eligible[end[i]]
+				&& offset[end[i]] == offset[end[i] - 1] + size[end[i] - 1]) {
+				++end[i];
+			}
+		}
+
+		return end;
+	}
+};
+
+} // impl
+
+/*
+ * Aggregates that can be serialised field by field without having to write
+ * a serialise function. POD types are excluded, as they're copied as a whole.
+ */
+template<typename T>
+concept field_serialisable = std::is_aggregate_v<T> && !std::is_array_v<T>
+	&& !pod<T> && !is_iterable<T>
+	&& impl::field_count<T> > 0 && impl::field_count<T> <= impl::max_aggregate_fields;
+
+} // hexi
+
+// #include <hexi/binary_stream.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/shared.h>
+
+// #include <hexi/aggregate.h>
+
+// #include <hexi/concepts.h>
+
 // #include <hexi/exception.h>
 //  _               _ 
 // | |__   _____  _(_)
@@ -574,13 +884,19 @@ inline void storage_out(arithmetic auto& value, as_big_t) {
 } // endian, hexi
 // #include <hexi/stream_adaptors.h>
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <concepts>
+#include <memory_resource>
 #include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -620,6 +936,11 @@ public:
 	
 	static constexpr endianness byte_order{};
 
+	// true if arithmetic types are stored with the host's byte order
+	static constexpr bool native_order = std::is_same_v<endianness, endian::as_native_t>
+		|| (std::is_same_v<endianness, endian::as_little_t> && std::endian::native == std::endian::little)
+		|| (std::is_same_v<endianness, endian::as_big_t> && std::endian::native == std::endian::big);
+
 private:
 	using cond_size_type = std::conditional_t<writeable<buf_type>, size_type, std::monostate>;
 
@@ -628,6 +949,10 @@ private:
 	size_type total_read_ = 0;
 	stream_state state_ = stream_state::ok;
 	const size_type read_limit_;
+	std::pmr::memory_resource* resource_ = nullptr;
+
+	// number of packed values staged at a time
+	static constexpr std::size_t packed_batch = 64;
 
 	inline void enforce_read_bounds(const size_type read_size) {
 		if(read_size > buffer_.size()) [[unlikely]] {
@@ -683,6 +1008,25 @@ private:
 		}
 	}
 
+	template<typename handle_type>
+	bool reserve_placeholder(const size_type length, handle_type& handle) {
+		HEXI_TRY {
+			if(state_ == stream_state::ok) [[likely]] {
+				handle = buffer_.reserve_placeholder(length);
+				total_write_ += length;
+				return true;
+			}
+		} HEXI_CATCH(...) {
+			state_ = stream_state::buff_write_err;
+
+			if constexpr(std::is_same_v<exceptions, allow_throw_t>) {
+				HEXI_THROW();
+			}
+		}
+
+		return false;
+	}
+
 	template<typename container_type>
 	void write_container(container_type& container) {
 		using cvalue_type = typename container_type::value_type;
@@ -716,13 +1060,117 @@ private:
 			SAFE_READ(container.data(), bytes, void());
 		} else {
 			for(count_type i = 0; i < count; ++i) {
-				cvalue_type value;
+				auto value = impl::make_element(container, resource_);
 				*this >> value;
 				container.emplace_back(std::move(value));
 			}
 		}
 	}
 
+	// fields that are serialised as their object representation, bar byte order
+	template<typename T>
+	static constexpr bool coalescable = arithmetic<T>
+		|| (pod<T> && !has_shl_override<T, binary_stream> && !has_shr_override<T, binary_stream>
+			&& !has_serialise<T, binary_stream> && !has_deserialise<T, binary_stream>);
+
+	template<typename T>
+	static consteval auto field_runs() {
+		using layout = impl::aggregate_layout<T>;
+
+		return [&]<std::size_t... I>(std::index_sequence<I...>) {
+			return layout::runs({ coalescable<std::tuple_element_t<I, typename layout::types>>... });
+		}(std::make_index_sequence<layout::count>());
+	}
+
+	template<typename T, std::size_t first, std::size_t last>
+	static consteval size_type run_bytes() {
+		using layout = impl::aggregate_layout<T>;
+		return layout::offset[last - 1] + layout::size[last - 1] - layout::offset[first];
+	}
+
+	template<std::size_t index, typename T, typename fields_type>
+	void write_fields(const T& object, const fields_type& fields) {
+		if constexpr(index < std::tuple_size_v<fields_type>) {
+			constexpr auto end = field_runs<T>()[index];
+
+			if constexpr(end - index == 1) {
+				*this << std::get<index>(fields);
+			} else {
+				write_run<index, end>(object, fields);
+			}
+
+			write_fields<end>(object, fields);
+		}
+	}
+
+	template<std::size_t first, std::size_t last, typename T, typename fields_type>
+	void write_run(const T& object, const fields_type& fields) {
+		using layout = impl::aggregate_layout<T>;
+		constexpr auto bytes = run_bytes<T, first, last>();
+		const auto data = reinterpret_cast<const std::byte*>(&std::get<first>(fields));
+		assert(data == reinterpret_cast<const std::byte*>(&object) + layout::offset[first]);
+
+		if constexpr(native_order) {
+			write(data, bytes);
+		} else {
+			// stage the run so that it can still be written with a single call
+			std::array<std::byte, bytes> staged;
+
+			[&]<std::size_t... I>(std::index_sequence<I...>) {
+				([&] {
+					const auto& field = std::get<first + I>(fields);
+					auto dest = staged.data() + (layout::offset[first + I] - layout::offset[first]);
+
+					if constexpr(arithmetic<std::remove_cvref_t<decltype(field)>>) {
+						const auto converted = endian::storage_in(field, byte_order);
+						std::memcpy(dest, &converted, sizeof(converted));
+					} else {
+						std::memcpy(dest, &field, sizeof(field));
+					}
+				}(), ...);
+			}(std::make_index_sequence<last - first>());
+
+			write(staged.data(), bytes);
+		}
+	}
+
+	template<std::size_t index, typename T, typename fields_type>
+	void read_fields(T& object, const fields_type& fields) {
+		if constexpr(index < std::tuple_size_v<fields_type>) {
+			constexpr auto end = field_runs<T>()[index];
+
+			if constexpr(end - index == 1) {
+				*this >> std::get<index>(fields);
+			} else {
+				read_run<index, end>(object, fields);
+			}
+
+			read_fields<end>(object, fields);
+		}
+	}
+
+	template<std::size_t first, std::size_t last, typename T, typename fields_type>
+	void read_run(T& object, const fields_type& fields) {
+		using layout = impl::aggregate_layout<T>;
+		constexpr auto bytes = run_bytes<T, first, last>();
+		const auto data = reinterpret_cast<std::byte*>(&std::get<first>(fields));
+		assert(data == reinterpret_cast<std::byte*>(&object) + layout::offset[first]);
+
+		SAFE_READ(data, bytes, void());
+
+		if constexpr(!native_order) {
+			[&]<std::size_t... I>(std::index_sequence<I...>) {
+				([&] {
+					auto& field = std::get<first + I>(fields);
+
+					if constexpr(arithmetic<std::remove_cvref_t<decltype(field)>>) {
+						endian::storage_out(field, byte_order);
+					}
+				}(), ...);
+			}(std::make_index_sequence<last - first>());
+		}
+	}
+
 public:
 	explicit binary_stream(buf_type& source, size_type read_limit = 0)
 		: buffer_(source),
@@ -751,7 +1199,8 @@ public:
 		  total_write_(rhs.total_write_),
 		  total_read_(rhs.total_read_),
 		  state_(rhs.state_),
-		  read_limit_(rhs.read_limit_) {
+		  read_limit_(rhs.read_limit_),
+		  resource_(rhs.resource_) {
 		rhs.total_read_ = static_cast<size_type>(-1);
 		rhs.state_ = stream_state::invalid_stream;
 	}
@@ -815,6 +1264,34 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Serialises one or more values in a compact form, such as
+	 * quantised or half precision floats, with the default byte order.
+	 * 
+	 * @param adaptor A packing adaptor, such as hexi::quantised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<std::derived_from<packed_tag_t> packed_type>
+	binary_stream& operator<<(packed_type adaptor) requires writeable<buf_type> {
+		using wire_type = typename packed_type::wire_type;
+		std::array<wire_type, packed_batch> staged;
+		auto values = adaptor.values;
+
+		while(!values.empty()) {
+			const auto count = std::min(values.size(), staged.size());
+
+			for(std::size_t i = 0; i < count; ++i) {
+				staged[i] = endian::storage_in(adaptor.codec.encode(values[i]), byte_order);
+			}
+
+			write(staged.data(), static_cast<size_type>(count * sizeof(wire_type)));
+			values = values.subspan(count);
+		}
+
+		return *this;
+	}
+
 	/**
 	 * @brief Serialises an arithmetic type with the default byte order.
 	 * 
@@ -846,6 +1323,26 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Serialises an aggregate that doesn't provide its own serialisation
+	 * functions, one field at a time. Runs of adjacent arithmetic and POD
+	 * fields with no padding between them are written as a single block.
+	 * 
+	 * @tparam T The aggregate type.
+	 * @param data Reference to the object to be serialised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<field_serialisable T>
+	requires (!has_serialise<T, binary_stream> && !has_shl_override<T, binary_stream>)
+	binary_stream& operator<<(const T& data) requires writeable<buf_type> {
+		impl::visit_fields(data, [&](const auto&... fields) {
+			write_fields<0>(data, std::tie(fields...));
+		});
+
+		return *this;
+	}
+
 	/**
 	 * @brief Serialises a string or string_view with a fixed-length prefix
 	 * 
@@ -874,7 +1371,7 @@ public:
 	 * @return Reference to the current stream.
 	 */
 	template<typename T>
-	requires std::is_same_v<std::decay_t<T>, std::string>
+	requires std_string<std::decay_t<T>>
 	binary_stream& operator<<(null_terminated<T> adaptor) requires writeable<buf_type> {
 		assert(adaptor->find_first_of('\0') == adaptor->npos);
 		write(adaptor->data(), adaptor->size() + 1); // yes, the standard allows this
@@ -914,7 +1411,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator<<(const std::string& string) requires writeable<buf_type> {
+	binary_stream& operator<<(const std_string auto& string) requires writeable<buf_type> {
 		return *this << prefixed(string);
 	}
 
@@ -1048,66 +1545,244 @@ public:
 		write(filled.data(), filled.size());
 	}
 
-	/*** Read ***/
-
 	/**
-	 * @brief Deserialises an object that provides a deserialise function:
-	 * void serialise(auto& stream);
+	 * @brief Handle to space reserved within the stream for a value that
+	 * isn't known until later, such as a length prefix.
 	 * 
-	 * @param[out] object The object to be deserialised.
+	 * @tparam T The type of the value.
 	 */
-	void deserialise(auto& object) {
-		stream_read_adaptor adaptor(*this);
-		object.serialise(adaptor);
-	}
+	template<arithmetic T>
+	class slot {
+		using handle_type = typename buf_type::placeholder_type;
 
-	/**
-	 * @brief Deserialises an object that provides a deserialise function:
-	 * void serialise(auto& stream);
-	 * 
-	 * @param[out] data The object to be serialised.
-	 * 
-	 * @return Reference to the current stream.
-	 */
-	template<typename T>
-	requires has_deserialise<T, binary_stream>
-	binary_stream& operator>>(T& data) {
-		deserialise(data);
-		return *this;
-	}
+		binary_stream* stream_ = nullptr;
+		handle_type handle_{};
+
+	public:
+		slot() = default;
+
+		slot(binary_stream* stream, handle_type handle)
+			: stream_(stream), handle_(handle) {}
+
+		/**
+		 * @brief Writes the value into the reserved space, using the stream's
+		 * byte order.
+		 * 
+		 * @param value The value to be written.
+		 */
+		void fill(const T value) {
+			if(!stream_) [[unlikely]] {
+				return;
+			}
+
+			const auto converted = endian::storage_in(value, byte_order);
+			stream_->buffer_.fill_placeholder(handle_, &converted, sizeof(converted));
+		}
+
+		/**
+		 * @return False if the space could not be reserved.
+		 */
+		bool valid() const {
+			return stream_ != nullptr;
+		}
+	};
 
 	/**
-	 * @brief Deserialises a string that was previously written with a
-	 * fixed-length prefix.
-	 * 
-	 * @param[out] adaptor std::string to hold the result.
+	 * @brief Handle to space reserved within the stream for a varint that
+	 * isn't known until later. Enough space is reserved for the largest
+	 * possible encoding of T.
 	 * 
-	 * @return Reference to the current stream.
+	 * @tparam T The type of the value.
 	 */
-	binary_stream& operator>>(prefixed<std::string> adaptor) {
-		std::uint32_t size = 0;
-		*this >> endian::le(size);
+	template<std::unsigned_integral T>
+	class varint_slot {
+		using handle_type = typename buf_type::placeholder_type;
 
-		if(state_ != stream_state::ok) {
-			return *this;
-		}
+		binary_stream* stream_ = nullptr;
+		handle_type handle_{};
 
-		STREAM_READ_BOUNDS_ENFORCE(size, *this);
+	public:
+		static constexpr size_type max_width = (sizeof(T) * 8 + 6) / 7;
 
-		adaptor->resize_and_overwrite(size, [&](char* strbuf, std::size_t size) {
-			buffer_.read(strbuf, size);
-			return size;
-		});
+		varint_slot() = default;
 
-		return *this;
-	}
+		varint_slot(binary_stream* stream, handle_type handle)
+			: stream_(stream), handle_(handle) {}
 
-	/**
-	 * @brief Deserialises a string that was previously written with a
-	 * fixed-length prefix.
-	 * 
-	 * @param[out] adaptor std::string_view to hold the result.
-	 * 
+		/**
+		 * @brief Writes the value into the reserved space. Continuation bytes
+		 * are used to pad the encoding out to the reserved width, which is
+		 * still a valid encoding of the value.
+		 * 
+		 * @param value The value to be written.
+		 */
+		void fill(T value) {
+			if(!stream_) [[unlikely]] {
+				return;
+			}
+
+			std::array<std::uint8_t, max_width> bytes;
+
+			for(size_type i = 0; i < max_width - 1; ++i) {
+				bytes[i] = (value & 0x7f) | 0x80;
+				value >>= 7;
+			}
+
+			bytes[max_width - 1] = static_cast<std::uint8_t>(value & 0x7f);
+			stream_->buffer_.fill_placeholder(handle_, bytes.data(), bytes.size());
+		}
+
+		/**
+		 * @brief Writes the value into the reserved space using the shortest
+		 * encoding and then shifts any data written after the slot back to
+		 * close the gap.
+		 * 
+		 * @note Only available for contiguous buffers. Any placeholders
+		 * reserved after this one must be filled first.
+		 * 
+		 * @param value The value to be written.
+		 */
+		void fill_compact(T value) requires placeholder_addressable<buf_type> {
+			if(!stream_) [[unlikely]] {
+				return;
+			}
+
+			std::array<std::uint8_t, max_width> bytes;
+			size_type width = 0;
+
+			while(value > 0x7f) {
+				bytes[width++] = (value & 0x7f) | 0x80;
+				value >>= 7;
+			}
+
+			bytes[width++] = static_cast<std::uint8_t>(value);
+
+			auto& buffer = stream_->buffer_;
+			const auto slot = buffer.placeholder_ptr(handle_);
+			const auto body = slot + max_width;
+			const auto body_size = static_cast<size_type>(buffer.write_ptr() - body);
+			const auto shift = max_width - width;
+
+			std::memcpy(slot, bytes.data(), width);
+
+			if(shift) {
+				std::memmove(slot + width, body, body_size * sizeof(value_type));
+				buffer.write_seek(buffer_seek::sk_backward, shift);
+				stream_->total_write_ -= shift;
+			}
+		}
+
+		/**
+		 * @return False if the space could not be reserved.
+		 */
+		bool valid() const {
+			return stream_ != nullptr;
+		}
+	};
+
+	/**
+	 * @brief Reserves space for a value to be filled in later, without
+	 * having to seek back to it.
+	 * 
+	 * @tparam T The type of the value.
+	 * 
+	 * @return A slot that can be used to fill in the value. If the
+	 * stream is in an error state, the slot will be invalid.
+	 */
+	template<arithmetic T>
+	[[nodiscard]] slot<T> placeholder()
+	requires writeable<buf_type> && placeholder_capable<buf_type> {
+		typename buf_type::placeholder_type handle{};
+
+		if(!reserve_placeholder(sizeof(T), handle)) {
+			return {};
+		}
+
+		return { this, handle };
+	}
+
+	/**
+	 * @brief Reserves space for a varint to be filled in later, without
+	 * having to seek back to it.
+	 * 
+	 * @tparam T The type of the value.
+	 * 
+	 * @return A slot that can be used to fill in the value. If the
+	 * stream is in an error state, the slot will be invalid.
+	 */
+	template<std::unsigned_integral T = std::uint32_t>
+	[[nodiscard]] varint_slot<T> placeholder_varint()
+	requires writeable<buf_type> && placeholder_capable<buf_type> {
+		typename buf_type::placeholder_type handle{};
+
+		if(!reserve_placeholder(varint_slot<T>::max_width, handle)) {
+			return {};
+		}
+
+		return { this, handle };
+	}
+
+	/*** Read ***/
+
+	/**
+	 * @brief Deserialises an object that provides a deserialise function:
+	 * void serialise(auto& stream);
+	 * 
+	 * @param[out] object The object to be deserialised.
+	 */
+	void deserialise(auto& object) {
+		stream_read_adaptor adaptor(*this);
+		object.serialise(adaptor);
+	}
+
+	/**
+	 * @brief Deserialises an object that provides a deserialise function:
+	 * void serialise(auto& stream);
+	 * 
+	 * @param[out] data The object to be serialised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<typename T>
+	requires has_deserialise<T, binary_stream>
+	binary_stream& operator>>(T& data) {
+		deserialise(data);
+		return *this;
+	}
+
+	/**
+	 * @brief Deserialises a string that was previously written with a
+	 * fixed-length prefix.
+	 * 
+	 * @param[out] adaptor std::string to hold the result.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<std_string T>
+	binary_stream& operator>>(prefixed<T> adaptor) {
+		std::uint32_t size = 0;
+		*this >> endian::le(size);
+
+		if(state_ != stream_state::ok) {
+			return *this;
+		}
+
+		STREAM_READ_BOUNDS_ENFORCE(size, *this);
+
+		adaptor->resize_and_overwrite(size, [&](char* strbuf, std::size_t size) {
+			buffer_.read(strbuf, size);
+			return size;
+		});
+
+		return *this;
+	}
+
+	/**
+	 * @brief Deserialises a string that was previously written with a
+	 * fixed-length prefix.
+	 * 
+	 * @param[out] adaptor std::string_view to hold the result.
+	 * 
 	 * @note The string_view's lifetime is tied to that of the underlying
 	 * buffer. You should not make any further writes to the buffer
 	 * unless you know it will not cause the data to be overwritten or
@@ -1135,7 +1810,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(prefixed_varint<std::string> adaptor) {
+	template<std_string T>
+	binary_stream& operator>>(prefixed_varint<T> adaptor) {
 		const auto size = impl::varint_decode<size_type>(*this);
 
 		// if an error was triggered during decode
@@ -1186,7 +1862,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(null_terminated<std::string> adaptor) {
+	template<std_string T>
+	binary_stream& operator>>(null_terminated<T> adaptor) {
 		auto pos = buffer_.find_first_of(value_type(0));
 
 		if(pos == buf_type::npos) {
@@ -1249,7 +1926,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream& operator>>(std::string& data) {
+	binary_stream& operator>>(std_string auto& data) {
 		return *this >> prefixed(data);
 	}
 
@@ -1279,6 +1956,38 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Deserialises one or more values that were written with
+	 * a packing adaptor.
+	 * 
+	 * @param[out] adaptor A packing adaptor, such as hexi::quantised.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<std::derived_from<packed_tag_t> packed_type>
+	binary_stream& operator>>(packed_type adaptor) {
+		static_assert(!std::is_const_v<typename packed_type::value_type>, "cannot read into const values");
+
+		using wire_type = typename packed_type::wire_type;
+		std::array<wire_type, packed_batch> staged;
+		auto values = adaptor.values;
+
+		while(!values.empty()) {
+			const auto count = std::min(values.size(), staged.size());
+			SAFE_READ(staged.data(), static_cast<size_type>(count * sizeof(wire_type)), *this);
+
+			for(std::size_t i = 0; i < count; ++i) {
+				auto value = staged[i];
+				endian::storage_out(value, byte_order);
+				values[i] = adaptor.codec.decode(value);
+			}
+
+			values = values.subspan(count);
+		}
+
+		return *this;
+	}
+
 	/**
 	 * @brief Deserialises an arithmetic point type with the default byte order.
 	 * 
@@ -1310,13 +2019,34 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Deserialises an aggregate that doesn't provide its own serialisation
+	 * functions, one field at a time. Runs of adjacent arithmetic and POD
+	 * fields with no padding between them are read as a single block, with
+	 * a single bounds check.
+	 * 
+	 * @tparam T The aggregate type.
+	 * @param[out] data The object to hold the result.
+	 * 
+	 * @return Reference to the current stream.
+	 */
+	template<field_serialisable T>
+	requires (!has_deserialise<T, binary_stream> && !has_shr_override<T, binary_stream>)
+	binary_stream& operator>>(T& data) {
+		impl::visit_fields(data, [&](auto&... fields) {
+			read_fields<0>(data, std::tie(fields...));
+		});
+
+		return *this;
+	}
+
 	/**
 	 * @brief Deserialises an iterable container that was previously written
 	 * with a fixed-length prefix.
 	 * 
 	 * @tparam T The iterable container type.
 	 * @param[out] adaptor The container to hold the result.
-	 *
+	 * 
 	 * @return Reference to the current stream.
 	 */
 	template<is_iterable T>
@@ -1396,7 +2126,7 @@ public:
 	 * 
 	 * @param dest The destination string.
 	 */
-	void get(std::string& dest) {
+	void get(std_string auto& dest) {
 		*this >> dest;
 	}
 
@@ -1406,7 +2136,7 @@ public:
 	 * @param[out] dest The std::string to hold the result.
 	 * @param count The number of bytes to be read.
 	 */
-	void get(std::string& dest, size_type size) {
+	void get(std_string auto& dest, size_type size) {
 		STREAM_READ_BOUNDS_ENFORCE(size, void());
 
 		dest.resize_and_overwrite(size, [&](char* strbuf, size_type len) {
@@ -1454,7 +2184,7 @@ public:
 
 	/**
 	 * @brief Skip over a number of bytes.
-	 *
+	 * 
 	 * Skips over a number of bytes from the stream. This should be used
 	 * if the stream holds data that you don't care about but don't want
 	 * to have to read it to another buffer to access data beyond it.
@@ -1609,6 +2339,30 @@ public:
 		return read_limit_;
 	}
 
+	/**
+	 * @brief Binds a memory resource to the stream. When deserialising into
+	 * a container that has no allocator of its own to hand down, such as a
+	 * std::vector<std::pmr::string>, its allocator-aware elements are
+	 * constructed with this resource.
+	 * 
+	 * Containers that do have an allocator, such as std::pmr::vector, always
+	 * pass it on to their elements, so a message tree read into pmr containers
+	 * lives entirely within the resource of the outermost container.
+	 * 
+	 * @param resource The resource to bind, or nullptr to use default
+	 * construction.
+	 */
+	void memory_resource(std::pmr::memory_resource* resource) {
+		resource_ = resource;
+	}
+
+	/**
+	 * @return The memory resource bound to the stream, if any.
+	 */
+	std::pmr::memory_resource* memory_resource() const {
+		return resource_;
+	}
+
 	/**
 	 * @brief Determine the maximum number of bytes that can be
 	 * safely read from this stream.
@@ -1663,7 +2417,7 @@ public:
 
 } // hexi
 
-// #include <hexi/buffer_adaptor.h>
+// #include <hexi/bit_stream.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -1678,374 +2432,1110 @@ public:
 
 // #include <hexi/exception.h>
 
-#include <ranges>
+// #include <hexi/endian.h>
+
+// #include <hexi/stream_adaptors.h>
+
+#include <array>
+#include <concepts>
 #include <type_traits>
-#include <utility>
 #include <cassert>
 #include <cstddef>
-#include <cstring>
+#include <cstdint>
 
 namespace hexi {
 
-template<byte_oriented buf_type, bool space_optimise = true>
-requires std::ranges::contiguous_range<buf_type>
-class buffer_adaptor final {
-public:
-	using value_type  = typename buf_type::value_type;
-	using size_type   = typename buf_type::size_type;
-	using offset_type = typename buf_type::size_type;
-	using contiguous  = is_contiguous;
-	using seeking     = supported;
+namespace bit_order {
 
-	static constexpr auto npos { static_cast<size_type>(-1) };
+struct order_tag {};
+struct msb_first_t final : order_tag {};
+struct lsb_first_t final : order_tag {};
 
-private:
-	buf_type& buffer_;
-	size_type read_;
-	size_type write_;
+[[maybe_unused]] constexpr static msb_first_t msb_first {};
+[[maybe_unused]] constexpr static lsb_first_t lsb_first {};
+
+} // bit_order
 
+/**
+ * Stream for reading and writing values that aren't a whole number of bytes
+ * wide, such as flags and small enums, without having to pack them by hand.
+ * 
+ * Writes are collected in a 64-bit accumulator and written to the buffer a
+ * word at a time. Anything left in the accumulator is only written by flush(),
+ * which must be called before the buffer is used for anything else.
+ * 
+ * Reads only take as many bytes from the buffer as are needed to satisfy
+ * each request, so once the stream has been aligned, the rest of the buffer
+ * can be read as normal, such as by a binary_stream.
+ * 
+ * With msb_first, values are packed starting from the most significant bit of
+ * each byte, which is the usual network convention. With lsb_first, they're
+ * packed from the least significant bit.
+ */
+template<
+	byte_oriented buf_type,
+	std::derived_from<except_tag> exceptions = HEXI_EXCEPTION_TAG,
+	std::derived_from<bit_order::order_tag> order = bit_order::msb_first_t
+>
+class bit_stream final {
 public:
-	buffer_adaptor(buf_type& buffer)
-		: buffer_(buffer),
-		  read_(0),
-		  write_(buffer.size()) {}
+	using size_type  = typename buf_type::size_type;
+	using value_type = typename buf_type::value_type;
 
-	buffer_adaptor(buf_type& buffer, init_empty_t)
-		: buffer_(buffer),
-		  read_(0),
-		  write_(0) {}
+	static constexpr unsigned max_bits = 64;
 
-	buffer_adaptor(buffer_adaptor&& rhs) = delete;
-	buffer_adaptor& operator=(buffer_adaptor&&) = delete;
-	buffer_adaptor& operator=(const buffer_adaptor&) = delete;
-	buffer_adaptor(const buffer_adaptor&) = delete;
+private:
+	static constexpr bool msb_first = std::is_same_v<order, bit_order::msb_first_t>;
 
-	/**
-	 * @brief Reads a number of bytes to the provided buffer.
-	 * 
-	 * @note The destination buffer must not overlap with the underlying buffer
-	 * being used by the buffer_adaptor.
-	 * 
-	 * @tparam T The destination type.
-	 * @param[out] destination The buffer to copy the data to.
-	 */
-	template<typename T>
-	void read(T* destination) {
-		read(destination, sizeof(T));
+	buf_type& buffer_;
+	std::uint64_t write_acc_ = 0;
+	std::uint64_t read_acc_ = 0;
+	unsigned write_bits_ = 0;
+	unsigned read_bits_ = 0;
+	std::size_t total_write_ = 0;
+	std::size_t total_read_ = 0;
+	stream_state state_ = stream_state::ok;
+
+	static constexpr std::uint64_t mask(const unsigned count) {
+		return count >= max_bits? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
 	}
 
-	/**
-	 * @brief Reads a number of bytes to the provided buffer.
-	 * 
-	 * @note The destination buffer must not overlap with the underlying buffer
-	 * being used by the buffer_adaptor.
-	 * 
-	 * @param[out] destination The buffer to copy the data to.
-	 * @param length The number of bytes to read into the buffer.
-	 */
-	void read(void* destination, size_type length) {
-		assert(destination);
-		copy(destination, length);
-		read_ += length;
+	void write(const void* data, const size_type size) {
+		HEXI_TRY {
+			if(state_ == stream_state::ok) [[likely]] {
+				buffer_.write(data, size);
+			}
+		} HEXI_CATCH(...) {
+			state_ = stream_state::buff_write_err;
 
-		if constexpr(space_optimise) {
-			if(read_ == write_) {
-				read_ = write_ = 0;
+			if constexpr(std::is_same_v<exceptions, allow_throw_t>) {
+				HEXI_THROW();
 			}
 		}
 	}
 
-	/**
-	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the read cursor.
-	 * 
-	 * @param[out] destination The buffer to copy the data to.
-	 */
-	template<typename T>
-	void copy(T* destination) const {
-		copy(destination, sizeof(T));
+	void write_word() {
+		std::uint64_t word = 0;
+
+		if constexpr(msb_first) {
+			word = endian::native_to_big(write_acc_);
+		} else {
+			word = endian::native_to_little(write_acc_);
+		}
+
+		write(&word, sizeof(word));
+		write_acc_ = 0;
+		write_bits_ = 0;
 	}
 
-	/**
-	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the read cursor.
-	 * 
-	 * @note The destination buffer must not overlap with the underlying buffer
-	 * being used by the buffer_adaptor.
-	 * 
-	 * @param[out] destination The buffer to copy the data to.
-	 * @param length The number of bytes to copy.
+	/*
+	 * Reads enough whole bytes to hold at least count bits, where
+	 * count is no more than 32, so the accumulator can't overflow
 	 */
-	void copy(void* destination, size_type length) const {
-		assert(destination && !region_overlap(buffer_.data(), buffer_.size(), destination, length));
-		std::memcpy(destination, read_ptr(), length);
-	}
+	bool fill(const unsigned count) {
+		if(state_ != stream_state::ok) [[unlikely]] {
+			return false;
+		}
 
-	/**
-	 * @brief Skip over a number of bytes.
-	 * 
-	 * Skips over a number of bytes from the container. This should be used
-	 * if the container holds data that you don't care about but don't want
-	 * to have to read it to another buffer to access data beyond it.
-	 * 
-	 * @param length The number of bytes to skip.
-	 */
-	void skip(size_type length) {
-		read_ += length;
+		if(read_bits_ >= count) {
+			return true;
+		}
 
-		if constexpr(space_optimise) {
-			if(read_ == write_) {
-				read_ = write_ = 0;
+		const auto bytes = (count - read_bits_ + 7) / 8;
+
+		if(bytes > buffer_.size()) [[unlikely]] {
+			state_ = stream_state::buff_limit_err;
+
+			if constexpr(std::is_same_v<exceptions, allow_throw_t>) {
+				HEXI_THROW(buffer_underrun(bytes, total_read_ / 8, buffer_.size()));
 			}
-		}
-	}
 
-	/**
-	 * @brief Write data to the container.
-	 * 
-	 * @note The source buffer must not overlap with the underlying buffer
-	 * being used by the buffer_adaptor.
-	 * 
-	 * @param source Pointer to the data to be written.
-	 */
-	void write(const auto& source) {
-		write(&source, sizeof(source));
-	}
+			return false;
+		}
 
-	/**
-	 * @brief Write provided data to the container.
-	 * 
-	 * @note The source buffer must not overlap with the underlying buffer
-	 * being used by the buffer_adaptor.
-	 * 
-	 * @param source Pointer to the data to be written.
-	 * @param length Number of bytes to write from the source.
-	 */
-	void write(const void* source, size_type length) {
-		assert(source && !region_overlap(source, length, buffer_.data(), buffer_.size()));
-		const auto min_req_size = write_ + length;
+		std::array<std::uint8_t, 8> data;
+		buffer_.read(data.data(), bytes);
 
-		if(buffer_.size() < min_req_size) [[likely]] {
-			if constexpr(has_resize_overwrite<buf_type>) {
-				buffer_.resize_and_overwrite(min_req_size, [](char*, size_type size) {
-					return size;
-				});
-			} else if constexpr(has_resize<buf_type>) {
-				buffer_.resize(min_req_size);
+		for(std::size_t i = 0; i < bytes; ++i) {
+			if constexpr(msb_first) {
+				read_acc_ = (read_acc_ << 8) | data[i];
 			} else {
-				HEXI_THROW(buffer_overflow(length, write_, free()));
+				read_acc_ |= std::uint64_t(data[i]) << read_bits_;
 			}
+
+			read_bits_ += 8;
 		}
 
-		std::memcpy(write_ptr(), source, length);
-		write_ += length;
+		return true;
 	}
 
-	/**
-	 * @brief Reserves a number of bytes within the container for future use.
-	 * 
-	 * @note This is a non-binding request, meaning the buffer may not reserve
-	 * any additional space, such as in the case where it is not supported.
-	 *
-	 * @param length The number of bytes that the container should reserve.
-	 */
-	void reserve(const size_type length) {
-		if constexpr(has_reserve<buf_type>) {
-			buffer_.reserve(length);
+	std::uint64_t read(const unsigned count) {
+		assert(count <= 32);
+
+		if(!fill(count)) [[unlikely]] {
+			return 0;
+		}
+
+		std::uint64_t value = 0;
+		read_bits_ -= count;
+
+		if constexpr(msb_first) {
+			value = (read_acc_ >> read_bits_) & mask(count);
+			read_acc_ &= mask(read_bits_);
+		} else {
+			value = read_acc_ & mask(count);
+			read_acc_ >>= count;
 		}
+
+		total_read_ += count;
+		return value;
+	}
+
+public:
+	explicit bit_stream(buf_type& source)
+		: buffer_(source) {}
+
+	explicit bit_stream(buf_type& source, exceptions)
+		: bit_stream(source) {}
+
+	explicit bit_stream(buf_type& source, order)
+		: bit_stream(source) {}
+
+	explicit bit_stream(buf_type& source, exceptions, order)
+		: bit_stream(source) {}
+
+	bit_stream(bit_stream&&) = delete;
+	bit_stream& operator=(bit_stream&&) = delete;
+	bit_stream& operator=(bit_stream&) = delete;
+	bit_stream(bit_stream&) = delete;
+
+	~bit_stream() {
+		assert((!write_bits_ || state_ != stream_state::ok) && "bit_stream destroyed without being flushed");
 	}
 
+	/*** Write ***/
+
 	/**
-	 * @brief Attempts to locate the provided value within the container.
+	 * @brief Writes the low bits of a value.
 	 * 
-	 * @param value The value to locate.
-	 * 
-	 * @return The position of value or npos if not found.
+	 * @param value The value to be written. Any bits above count are ignored,
+	 * so negative values can be written and read back with get_bits<signed type>.
+	 * @param count The number of bits to write, up to 64.
 	 */
-	size_type find_first_of(value_type val) const {
-		const auto data = read_ptr();
+	void put_bits(const std::integral auto value, const unsigned count) requires writeable<buf_type> {
+		assert(count <= max_bits);
 
-		for(size_type i = 0, j = size(); i < j; ++i) {
-			if(data[i] == val) {
-				return i;
+		const auto bits = static_cast<std::uint64_t>(value) & mask(count);
+		const auto space = max_bits - write_bits_;
+
+		if(count < space) {
+			if constexpr(msb_first) {
+				write_acc_ = (write_acc_ << count) | bits;
+			} else {
+				write_acc_ |= bits << write_bits_;
+			}
+
+			write_bits_ += count;
+		} else {
+			// fill the accumulator, write it out and carry the remainder
+			const auto remainder = count - space;
+
+			if constexpr(msb_first) {
+				write_acc_ = space == max_bits? bits >> remainder : (write_acc_ << space) | (bits >> remainder);
+				write_word();
+				write_acc_ = bits & mask(remainder);
+			} else {
+				write_acc_ |= bits << write_bits_;
+				write_word();
+				write_acc_ = space == max_bits? 0 : bits >> space;
 			}
+
+			write_bits_ = remainder;
 		}
 
-		return npos;
+		total_write_ += count;
 	}
-	
+
 	/**
-	 * @brief Returns the size of the container.
+	 * @brief Writes a single bit.
 	 * 
-	 * @return The number of bytes of data available to read within the container.
+	 * @param value The value to be written.
 	 */
-	size_type size() const {
-		return write_ - read_;
+	void put_bit(const bool value) requires writeable<buf_type> {
+		put_bits(value, 1);
 	}
 
 	/**
-	 * @brief Whether the container is empty.
+	 * @brief Writes one or more values with a packing adaptor, using only
+	 * as many bits as the adaptor's codec requires, rather than rounding up
+	 * to whole bytes.
 	 * 
-	 * @return Returns true if the container is empty (has no data to be read).
+	 * @param adaptor A packing adaptor, such as hexi::quantised.
 	 */
-	[[nodiscard]]
-	bool empty() const {
-		return read_ == write_;
+	template<std::derived_from<packed_tag_t> packed_type>
+	void put(const packed_type& adaptor) requires writeable<buf_type> {
+		for(const auto& value : adaptor.values) {
+			put_bits(adaptor.codec.encode(value), packed_type::bits);
+		}
 	}
 
 	/**
-	 * @brief Retrieves a reference to the specified index within the container.
-	 * 
-	 * @param index The index within the container.
-	 * 
-	 * @return A reference to the value at the specified index.
+	 * @brief Pads the written bits with zeroes up to the next byte boundary.
 	 */
-	value_type& operator[](const size_type index) {
-		return read_ptr()[index];
+	void align_write() requires writeable<buf_type> {
+		if(const auto partial = write_bits_ % 8) {
+			put_bits(0, 8 - partial);
+		}
 	}
 
 	/**
-	 * @brief Retrieves a reference to the specified index within the container.
+	 * @brief Pads the written bits up to the next byte boundary and writes
+	 * anything remaining in the accumulator to the buffer.
+	 */
+	void flush() requires writeable<buf_type> {
+		align_write();
+
+		if(!write_bits_) {
+			return;
+		}
+
+		const auto bytes = write_bits_ / 8;
+		std::uint64_t word = 0;
+
+		if constexpr(msb_first) {
+			word = endian::native_to_big(write_acc_ << (max_bits - write_bits_));
+		} else {
+			word = endian::native_to_little(write_acc_);
+		}
+
+		write(&word, bytes);
+		write_acc_ = 0;
+		write_bits_ = 0;
+	}
+
+	/*** Read ***/
+
+	/**
+	 * @brief Reads a value that was written with put_bits.
 	 * 
-	 * @param index The index within the container.
+	 * @tparam T The type to read into. Signed types are sign extended
+	 * from the most significant of the bits read.
+	 * @param count The number of bits to read, up to 64.
 	 * 
-	 * @return A reference to the value at the specified index.
+	 * @return The value read, or zero if there was an error.
 	 */
-	const value_type& operator[](const size_type index) const {
-		return read_ptr()[index];
+	template<std::integral T = std::uint64_t>
+	T get_bits(const unsigned count) {
+		assert(count <= max_bits);
+		assert(count <= sizeof(T) * 8);
+
+		std::uint64_t value = 0;
+
+		if(count <= 32) {
+			value = read(count);
+		} else if constexpr(msb_first) {
+			value = read(count - 32) << 32;
+			value |= read(32);
+		} else {
+			value = read(32);
+			value |= read(count - 32) << 32;
+		}
+
+		if constexpr(std::is_signed_v<T>) {
+			if(count && count < max_bits) {
+				const auto sign = std::uint64_t(1) << (count - 1);
+				value = (value ^ sign) - sign;
+			}
+		}
+
+		return static_cast<T>(value);
 	}
 
 	/**
-	 * @brief Determine whether the adaptor supports write seeking.
-	 * 
-	 * This is determined at compile-time and does not need to be checked at
-	 * run-time.
+	 * @brief Reads a single bit.
 	 * 
-	 * @return True if write seeking is supported, otherwise false.
+	 * @return The value of the bit.
 	 */
-	constexpr static bool can_write_seek() {
-		return std::is_same_v<seeking, supported>;
+	bool get_bit() {
+		return read(1) != 0;
 	}
 
 	/**
-	 * @brief Performs write seeking within the container.
+	 * @brief Reads one or more values that were written with put().
 	 * 
-	 * @param direction Specify whether to seek in a given direction or to absolute seek.
-	 * @param offset The offset relative to the seek direction or the absolute value
-	 * when using absolute seeking.
+	 * @param adaptor A packing adaptor, such as hexi::quantised.
 	 */
-	void write_seek(const buffer_seek direction, const offset_type offset) {
-		switch(direction) {
-			case buffer_seek::sk_backward:
-				write_ -= offset;
-				break;
-			case buffer_seek::sk_forward:
-				write_ += offset;
-				break;
-			case buffer_seek::sk_absolute:
-				write_ = offset;
+	template<std::derived_from<packed_tag_t> packed_type>
+	void get(const packed_type& adaptor) {
+		static_assert(!std::is_const_v<typename packed_type::value_type>, "cannot read into const values");
+		using wire_type = typename packed_type::wire_type;
+
+		for(auto& value : adaptor.values) {
+			value = adaptor.codec.decode(get_bits<wire_type>(packed_type::bits));
 		}
 	}
 
 	/**
-	 * @return Pointer to the data available for reading.
+	 * @brief Discards any bits remaining in the current byte, so that
+	 * the next read starts at a byte boundary.
 	 */
-	auto read_ptr() const {
-		return buffer_.data() + read_;
+	void align_read() {
+		total_read_ += read_bits_;
+		read_acc_ = 0;
+		read_bits_ = 0;
 	}
 
 	/**
-	 * @return Pointer to the data available for reading.
+	 * @return The total number of bits written to the stream, including
+	 * any still held in the accumulator.
 	 */
-	auto read_ptr() {
-		return buffer_.data() + read_;
+	std::size_t total_write() const requires writeable<buf_type> {
+		return total_write_;
 	}
 
 	/**
-	 * @return Pointer to the location within the buffer where the next write
-	 * will be made.
+	 * @return The total number of bits read from the stream.
 	 */
-	auto write_ptr() const {
-		return buffer_.data() + write_;
+	std::size_t total_read() const {
+		return total_read_;
 	}
 
 	/**
-	 * @return Pointer to the location within the buffer where the next write
-	 * will be made.
+	 * @return true if the next write starts at a byte boundary.
 	 */
-	auto write_ptr() {
-		return buffer_.data() + write_;
+	bool write_aligned() const {
+		return !(write_bits_ % 8);
 	}
 
 	/**
-	 * @return Pointer to the data available for reading.
+	 * @return true if the next read starts at a byte boundary.
 	 */
-	auto data() const {
-		return buffer_.data() + read_;
+	bool read_aligned() const {
+		return !read_bits_;
 	}
 
 	/**
-	 * @return Pointer to the data available for reading.
+	 * @return Pointer to stream's underlying buffer.
 	 */
-	auto data() {
-		return buffer_.data() + read_;
+	const buf_type* buffer() const {
+		return &buffer_;
 	}
 
 	/**
-	 * @return Pointer to the underlying storage.
+	 * @return Pointer to stream's underlying buffer.
 	 */
-	auto storage() const {
-		return buffer_.data();
+	buf_type* buffer() {
+		return &buffer_;
 	}
 
 	/**
-	 * @return Pointer to the underlying storage.
+	 * @return The stream's state.
 	 */
-	auto storage() {
-		return buffer_.data();
+	stream_state state() const {
+		return state_;
 	}
 
 	/**
-	 * @brief Advances the write cursor.
+	 * @brief Determine whether the stream is in a usable state.
 	 * 
-	 * @param size The number of bytes by which to advance the write cursor.
+	 * @return true if no errors have occurred.
 	 */
-	void advance_write(size_type bytes) {
-		assert(buffer_.size() >= (write_ + bytes));
-		write_ += bytes;
+	bool good() const {
+		return state_ == stream_state::ok;
 	}
 
 	/**
-	 * @brief The amount of space left in the container.
-	 * 
-	 * @return The number of free bytes.
+	 * @brief Resets the stream state back to a good state, allowing
+	 * it to be used for streaming operations again. Has no effect
+	 * if the stream has not errored.
 	 */
-	auto free() const {
-		return buffer_.size() - write_;
+	void clear_state() {
+		state_ = stream_state::ok;
 	}
-	
-	/*
-	 * @brief Resets both the read and write cursors back to the beginning
-	 * of the buffer.
-	 * 
-	 * @note The underlying buffer will not be cleared but should be treated
-	 * as thought it has been.
+
+	operator bool() const {
+		return good();
+	}
+
+	/**
+	 * @brief Set the stream to an error state.
 	 */
-	void clear() {
-		read_ = write_ = 0;
+	void set_error_state() {
+		state_ = stream_state::user_defined_err;
 	}
 };
 
 } // hexi
 
-// #include <hexi/buffer_sequence.h>
+// #include <hexi/buffer_adaptor.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
 // | | | |  __/>  <| | Version 1.3.5
 // |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
-#if defined HEXI_WITH_ASIO || defined HEXI_WITH_BOOST_ASIO
+
+
+// #include <hexi/shared.h>
+
+// #include <hexi/concepts.h>
+
+// #include <hexi/exception.h>
+
+#include <algorithm>
+#include <concepts>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace hexi {
+
+struct no_compaction {};
+struct exact_growth {};
+
+/**
+ * Moves unread data to the front of the buffer before a write once the
+ * consumed prefix is at least 'threshold' bytes or at least 'ratio_percent'
+ * of the written region, whichever is reached first. This bounds memory use
+ * for streams that are rarely fully drained.
+ */
+template<std::size_t threshold = 65536, std::size_t ratio_percent = 50>
+requires (ratio_percent > 0 && ratio_percent <= 100)
+struct compact : no_compaction {
+	static constexpr std::size_t min_bytes = threshold;
+	static constexpr std::size_t ratio = ratio_percent;
+};
+
+/**
+ * Grows the underlying buffer's capacity by a factor of its current capacity
+ * rather than to the exact size required by a write, so that a stream of
+ * small writes does not reallocate the buffer on every call. The buffer's
+ * size is still only grown to the size required.
+ */
+template<std::size_t numerator = 2, std::size_t denominator = 1>
+requires (numerator > denominator && denominator > 0)
+struct geometric_growth : exact_growth {
+	static constexpr std::size_t num = numerator;
+	static constexpr std::size_t den = denominator;
+};
+
+/**
+ * CompactionPolicy: 'compact' moves unread data to the front of the buffer
+ * when enough of it has been consumed. Compaction only happens during writes,
+ * so pointers obtained from reads (e.g. view() and span()) remain valid
+ * until the next write, as they would if the buffer were to grow.
+ * 
+ * GrowthPolicy: 'geometric_growth' reserves capacity geometrically rather
+ * than to the exact size required.
+ */
+template<byte_oriented buf_type,
+	bool space_optimise = true,
+	std::derived_from<no_compaction> compaction = no_compaction,
+	std::derived_from<exact_growth> growth = exact_growth
+>
+requires std::ranges::contiguous_range<buf_type>
+class buffer_adaptor final {
+public:
+	using value_type  = typename buf_type::value_type;
+	using size_type   = typename buf_type::size_type;
+	using offset_type = typename buf_type::size_type;
+	using contiguous  = is_contiguous;
+	using seeking     = supported;
+
+	/*
+	 * Logical offset of the reserved region, which remains valid if the
+	 * buffer is compacted or reallocated.
+	 */
+	using placeholder_type = size_type;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	buf_type& buffer_;
+	size_type read_;
+	size_type write_;
+	size_type discarded_ = 0; // bytes removed from the front by defragmenting
+
+	void compact_if_needed() {
+		if constexpr(!std::is_same_v<compaction, no_compaction>) {
+			if(!read_) {
+				return;
+			}
+
+			if(read_ >= compaction::min_bytes || read_ * 100 >= write_ * compaction::ratio) {
+				defragment();
+			}
+		}
+	}
+
+	void prepare_write(size_type length) {
+		compact_if_needed();
+		const auto min_req_size = write_ + length;
+
+		if(buffer_.size() < min_req_size) [[likely]] {
+			reserve_growth(min_req_size);
+
+			if constexpr(has_resize_overwrite<buf_type>) {
+				buffer_.resize_and_overwrite(min_req_size, [](char*, size_type size) {
+					return size;
+				});
+			} else if constexpr(has_resize<buf_type>) {
+				buffer_.resize(min_req_size);
+			} else {
+				HEXI_THROW(buffer_overflow(length, write_, free()));
+			}
+		}
+	}
+
+	/*
+	 * Only the capacity grows geometrically, the size is always exact so
+	 * that the container never holds more elements than have been written
+	 */
+	void reserve_growth(const size_type min_req_size) {
+		if constexpr(!std::is_same_v<growth, exact_growth> && has_reserve<buf_type>) {
+			const auto capacity = static_cast<size_type>(buffer_.capacity());
+
+			if(capacity < min_req_size) {
+				buffer_.reserve(std::max<size_type>(min_req_size, capacity / growth::den * growth::num));
+			}
+		}
+	}
+
+public:
+	buffer_adaptor(buf_type& buffer)
+		: buffer_(buffer),
+		  read_(0),
+		  write_(buffer.size()) {}
+
+	buffer_adaptor(buf_type& buffer, init_empty_t)
+		: buffer_(buffer),
+		  read_(0),
+		  write_(0) {}
+
+	buffer_adaptor(buffer_adaptor&& rhs) = delete;
+	buffer_adaptor& operator=(buffer_adaptor&&) = delete;
+	buffer_adaptor& operator=(const buffer_adaptor&) = delete;
+	buffer_adaptor(const buffer_adaptor&) = delete;
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @note The destination buffer must not overlap with the underlying buffer
+	 * being used by the buffer_adaptor.
+	 * 
+	 * @tparam T The destination type.
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @note The destination buffer must not overlap with the underlying buffer
+	 * being used by the buffer_adaptor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) {
+		assert(destination);
+		copy(destination, length);
+		read_ += length;
+
+		if constexpr(space_optimise) {
+			if(read_ == write_) {
+				read_ = write_ = 0;
+			}
+		}
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @note The destination buffer must not overlap with the underlying buffer
+	 * being used by the buffer_adaptor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, size_type length) const {
+		assert(destination && !region_overlap(buffer_.data(), buffer_.size(), destination, length));
+		std::memcpy(destination, read_ptr(), length);
+	}
+
+	/**
+	 * @brief Skip over a number of bytes.
+	 * 
+	 * Skips over a number of bytes from the container. This should be used
+	 * if the container holds data that you don't care about but don't want
+	 * to have to read it to another buffer to access data beyond it.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(size_type length) {
+		read_ += length;
+
+		if constexpr(space_optimise) {
+			if(read_ == write_) {
+				read_ = write_ = 0;
+			}
+		}
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @note The source buffer must not overlap with the underlying buffer
+	 * being used by the buffer_adaptor.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container.
+	 * 
+	 * @note The source buffer must not overlap with the underlying buffer
+	 * being used by the buffer_adaptor.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, size_type length) {
+		assert(source && !region_overlap(source, length, buffer_.data(), buffer_.size()));
+		prepare_write(length);
+		std::memcpy(write_ptr(), source, length);
+		write_ += length;
+	}
+
+	/**
+	 * @brief Reserves space at the write cursor to be filled in later.
+	 * 
+	 * @note The placeholder is invalidated by clear() or once its contents
+	 * have been read.
+	 * 
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
+	 */
+	placeholder_type reserve_placeholder(size_type length) {
+		prepare_write(length);
+		const auto offset = write_ + discarded_;
+		write_ += length;
+		return offset;
+	}
+
+	/**
+	 * @brief Writes data into previously reserved space.
+	 * 
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(placeholder_type placeholder, const void* source, size_type length) {
+		std::memcpy(placeholder_ptr(placeholder), source, length);
+	}
+
+	/**
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * 
+	 * @return Pointer to the start of the reserved space.
+	 */
+	auto placeholder_ptr(placeholder_type placeholder) {
+		assert(placeholder >= discarded_ + read_ && "placeholder has been read");
+		return buffer_.data() + (placeholder - discarded_);
+	}
+
+	/**
+	 * @brief Reserves a number of bytes within the container for future use.
+	 * 
+	 * @note This is a non-binding request, meaning the buffer may not reserve
+	 * any additional space, such as in the case where it is not supported.
+	 *
+	 * @param length The number of bytes that the container should reserve.
+	 */
+	void reserve(const size_type length) {
+		if constexpr(has_reserve<buf_type>) {
+			buffer_.reserve(length);
+		}
+	}
+
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(value_type val) const {
+		const auto data = read_ptr();
+
+		for(size_type i = 0, j = size(); i < j; ++i) {
+			if(data[i] == val) {
+				return i;
+			}
+		}
+
+		return npos;
+	}
+	
+	/**
+	 * @brief Returns the size of the container.
+	 * 
+	 * @return The number of bytes of data available to read within the container.
+	 */
+	size_type size() const {
+		return write_ - read_;
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return read_ == write_;
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const size_type index) {
+		return read_ptr()[index];
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const size_type index) const {
+		return read_ptr()[index];
+	}
+
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	constexpr static bool can_write_seek() {
+		return std::is_same_v<seeking, supported>;
+	}
+
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking.
+	 */
+	void write_seek(const buffer_seek direction, const offset_type offset) {
+		switch(direction) {
+			case buffer_seek::sk_backward:
+				write_ -= offset;
+				break;
+			case buffer_seek::sk_forward:
+				write_ += offset;
+				break;
+			case buffer_seek::sk_absolute:
+				write_ = offset;
+		}
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	auto read_ptr() const {
+		return buffer_.data() + read_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	auto read_ptr() {
+		return buffer_.data() + read_;
+	}
+
+	/**
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
+	 */
+	auto write_ptr() const {
+		return buffer_.data() + write_;
+	}
+
+	/**
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
+	 */
+	auto write_ptr() {
+		return buffer_.data() + write_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	auto data() const {
+		return buffer_.data() + read_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	auto data() {
+		return buffer_.data() + read_;
+	}
+
+	/**
+	 * @return Pointer to the underlying storage.
+	 */
+	auto storage() const {
+		return buffer_.data();
+	}
+
+	/**
+	 * @return Pointer to the underlying storage.
+	 */
+	auto storage() {
+		return buffer_.data();
+	}
+
+	/**
+	 * @brief Advances the write cursor.
+	 * 
+	 * @param size The number of bytes by which to advance the write cursor.
+	 */
+	void advance_write(size_type bytes) {
+		assert(buffer_.size() >= (write_ + bytes));
+		write_ += bytes;
+	}
+
+	/**
+	 * @brief The amount of space left in the container.
+	 * 
+	 * @return The number of free bytes.
+	 */
+	auto free() const {
+		return buffer_.size() - write_;
+	}
+	
+	/**
+	 * @brief Moves any unread data to the front of the buffer, freeing space at the end.
+	 * If a move is performed, pointers obtained from read/write_ptr() will be invalidated.
+	 * 
+	 * @return True if additional space was made available.
+	 */
+	bool defragment() {
+		if(read_ == 0) {
+			return false;
+		}
+
+		const auto remaining = size();
+
+		if(remaining) {
+			std::memmove(buffer_.data(), read_ptr(), remaining * sizeof(value_type));
+		}
+
+		discarded_ += read_;
+		read_ = 0;
+		write_ = remaining;
+		return true;
+	}
+
+	/*
+	 * @brief Resets both the read and write cursors back to the beginning
+	 * of the buffer.
+	 * 
+	 * @note The underlying buffer will not be cleared but should be treated
+	 * as thought it has been.
+	 */
+	void clear() {
+		read_ = write_ = 0;
+	}
+};
+
+} // hexi
+
+// #include <hexi/buffer_pool.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+#include <array>
+#include <memory>
+#include <cstddef>
+
+namespace hexi {
+
+/**
+ * Recycles whole buffer objects, for code that would otherwise create and
+ * destroy a buffer for every message.
+ * 
+ * Buffers are handed out as a unique_ptr whose deleter returns them to the
+ * pool. A returned buffer has its remaining data skipped rather than being
+ * cleared, so a dynamic_buffer keeps its last block linked and any spare
+ * blocks it holds (see spare_blocks), meaning that it comes back warm.
+ * Combined with tls_block_allocator, a hot message path can run without
+ * allocating at all.
+ * 
+ * A pool is not thread-safe and is intended to be used from a single thread,
+ * which also keeps buffers backed by tls_block_allocator on the thread that
+ * allocated their blocks. local() provides a pool per thread. The pool must
+ * outlive any buffers acquired from it.
+ * 
+ * @tparam buf_type The type of buffer to pool.
+ * @tparam max_pooled The maximum number of idle buffers to hold on to. Any
+ * buffers returned beyond this are destroyed.
+ */
+template<typename buf_type, std::size_t max_pooled = 32>
+requires (max_pooled > 0)
+class buffer_pool final {
+public:
+	class deleter {
+		buffer_pool* pool_ = nullptr;
+
+	public:
+		deleter() = default;
+		explicit deleter(buffer_pool* pool) : pool_(pool) {}
+
+		void operator()(buf_type* buffer) const {
+			pool_->release(buffer);
+		}
+	};
+
+	using size_type = std::size_t;
+	using pointer = std::unique_ptr<buf_type, deleter>;
+
+private:
+	std::array<buf_type*, max_pooled> idle_;
+	size_type count_ = 0;
+
+	void release(buf_type* buffer) {
+		if(count_ == max_pooled) {
+			delete buffer;
+			return;
+		}
+
+		if(!buffer->empty()) {
+			buffer->skip(buffer->size());
+		}
+
+		idle_[count_++] = buffer;
+	}
+
+public:
+	buffer_pool() = default;
+	buffer_pool(const buffer_pool&) = delete;
+	buffer_pool& operator=(const buffer_pool&) = delete;
+
+	~buffer_pool() {
+		shrink_to_fit();
+	}
+
+	/**
+	 * @brief Retrieves an idle buffer from the pool or creates a new one if
+	 * the pool is empty.
+	 * 
+	 * @return An empty buffer, which will be returned to the pool once released.
+	 */
+	[[nodiscard]] pointer acquire() {
+		if(count_) [[likely]] {
+			return pointer(idle_[--count_], deleter(this));
+		}
+
+		return pointer(new buf_type(), deleter(this));
+	}
+
+	/**
+	 * @brief Creates idle buffers up front, so that the first acquisitions
+	 * don't need to allocate.
+	 * 
+	 * @param count The number of idle buffers the pool should hold.
+	 */
+	void reserve(size_type count) {
+		if(count > max_pooled) {
+			count = max_pooled;
+		}
+
+		while(count_ < count) {
+			idle_[count_++] = new buf_type();
+		}
+	}
+
+	/**
+	 * @brief Destroys all idle buffers held by the pool.
+	 */
+	void shrink_to_fit() {
+		while(count_) {
+			delete idle_[--count_];
+		}
+	}
+
+	/**
+	 * @return The number of idle buffers held by the pool.
+	 */
+	size_type size() const {
+		return count_;
+	}
+
+	/**
+	 * @note Idle buffers using tls_block_allocator should be released with
+	 * shrink_to_fit() before the thread exits, as the order in which the
+	 * thread-local pool and allocator are destroyed is not guaranteed.
+	 * 
+	 * @return The pool belonging to the calling thread.
+	 */
+	static buffer_pool& local() {
+		static thread_local buffer_pool pool;
+		return pool;
+	}
+};
+
+} // hexi
+
+// #include <hexi/buffer_sequence.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#if defined HEXI_WITH_ASIO || defined HEXI_WITH_BOOST_ASIO
 
 #ifdef HEXI_WITH_ASIO
 #include <asio/buffer.hpp>
@@ -2053,107 +3543,5080 @@ public:
 #include <boost/asio/buffer.hpp>
 #endif
 
-#ifdef HEXI_BUFFER_DEBUG
-#include <span>
+#ifdef HEXI_BUFFER_DEBUG
+#include <span>
+#endif
+
+namespace hexi {
+
+#ifdef HEXI_WITH_BOOST_ASIO
+namespace asio = boost::asio;
+#endif
+
+template<typename buffer_type>
+class buffer_sequence {
+	const buffer_type& buffer_;
+
+public:
+	buffer_sequence(const buffer_type& buffer)
+		: buffer_(buffer) { }
+
+	class const_iterator {
+		using node = typename buffer_type::node_type;
+
+	public:
+		const_iterator(const buffer_type& buffer, const node* curr_node)
+			: buffer_(buffer),
+			  curr_node_(curr_node) {}
+
+		const_iterator& operator++() {
+			curr_node_ = curr_node_->next;
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const_iterator current(*this);
+			curr_node_ = curr_node_->next;
+			return current;
+		}
+
+		asio::const_buffer operator*() const {
+			const auto buffer = buffer_.buffer_from_node(curr_node_);
+			return buffer->read_data();
+		}
+
+		bool operator==(const const_iterator& rhs) const {
+			return curr_node_ == rhs.curr_node_;
+		}
+
+		bool operator!=(const const_iterator& rhs) const {
+			return curr_node_ != rhs.curr_node_;
+		}
+
+		const_iterator& operator=(const_iterator&) = delete;
+
+	#ifdef HEXI_BUFFER_DEBUG
+		std::span<const char> get_buffer() {
+			auto buffer = buffer_.buffer_from_node(curr_node_);
+			return {
+				reinterpret_cast<const char*>(buffer->read_ptr()), buffer->size()
+			};
+		}
+	#endif
+
+	private:
+		const buffer_type& buffer_;
+		const node* curr_node_;
+	};
+
+const_iterator begin() const {
+	return const_iterator(buffer_, buffer_.root_.next);
+}
+
+const_iterator end() const {
+	return const_iterator(buffer_, &buffer_.root_);
+}
+
+friend class const_iterator;
+};
+
+} // hexi
+
+#endif // #if defined HEXI_WITH_ASIO || defined HEXI_WITH_BOOST_ASIO
+// #include <hexi/compression.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/shared.h>
+
+// #include <hexi/concepts.h>
+
+// #include <hexi/endian.h>
+
+// #include <hexi/exception.h>
+
+// #include <hexi/allocators/default_init_allocator.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hexi {
+
+/**
+ * Allocator adaptor that default-initialises rather than value-initialises
+ * elements constructed without arguments. For trivial types such as bytes,
+ * this means that resizing a container leaves the new elements uninitialised
+ * rather than zero filling them, which is wasted work when they're about to
+ * be overwritten anyway.
+ */
+template<typename T, typename A = std::allocator<T>>
+class default_init_allocator : public A {
+	using traits = std::allocator_traits<A>;
+
+public:
+	template<typename U>
+	struct rebind {
+		using other = default_init_allocator<
+			U, typename traits::template rebind_alloc<U>
+		>;
+	};
+
+	using A::A;
+
+	template<typename U>
+	void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+		::new(static_cast<void*>(ptr)) U;
+	}
+
+	template<typename U, typename... Args>
+	void construct(U* ptr, Args&&... args) {
+		traits::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+	}
+};
+
+/**
+ * std::vector that does not zero fill when grown.
+ */
+template<typename T>
+using uninit_vector = std::vector<T, default_init_allocator<T>>;
+
+} // hexi
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef HEXI_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HEXI_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace hexi {
+
+namespace compression {
+
+constexpr std::size_t default_block_size = 16384;
+
+/**
+ * Requirements for a codec used by compressing_buffer and decompressing_buffer.
+ * Each block is compressed independently of any other.
+ */
+template<typename codec_type>
+concept block_codec = requires(const codec_type& codec, const std::uint8_t* source,
+                               std::uint8_t* dest, std::size_t size) {
+	// the largest compressed size that size bytes of input can produce
+	{ codec.bound(size) } -> std::same_as<std::size_t>;
+
+	// returns the compressed size, or zero on failure
+	{ codec.compress(source, size, dest, size) } -> std::same_as<std::size_t>;
+
+	// true only if exactly the requested number of bytes were produced
+	{ codec.decompress(source, size, dest, size) } -> std::same_as<bool>;
+};
+
+/**
+ * Built-in LZ77 codec, using the same sequence layout as LZ4's block format.
+ * It favours speed over ratio, making it suitable for compressing data on the
+ * fly, and is safe to use on untrusted input.
+ */
+class fast_lz final {
+	static constexpr std::size_t min_match = 4;
+	static constexpr std::size_t max_offset = 65535;
+	static constexpr std::size_t last_literals = 5;
+	static constexpr std::size_t match_search_end = 12;
+	static constexpr unsigned hash_bits = 12;
+
+	static std::uint32_t load32(const std::uint8_t* data) {
+		std::uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static std::uint64_t load64(const std::uint8_t* data) {
+		std::uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static std::size_t hash(const std::uint32_t value) {
+		return (value * 2654435761u) >> (32 - hash_bits);
+	}
+
+	static std::size_t match_length(const std::uint8_t* match, const std::uint8_t* current,
+	                                const std::size_t limit) {
+		std::size_t length = min_match;
+
+		for(; length + 8 <= limit; length += 8) {
+			if(const auto diff = load64(match + length) ^ load64(current + length)) {
+				if constexpr(std::endian::native == std::endian::little) {
+					return length + std::countr_zero(diff) / 8;
+				} else {
+					return length + std::countl_zero(diff) / 8;
+				}
+			}
+		}
+
+		for(; length < limit && match[length] == current[length]; ++length);
+		return length;
+	}
+
+	static std::uint8_t* write_length(std::uint8_t* out, std::size_t length) {
+		for(; length >= 255; length -= 255) {
+			*out++ = 255;
+		}
+
+		*out++ = static_cast<std::uint8_t>(length);
+		return out;
+	}
+
+	static std::uint8_t* write_literals(std::uint8_t* out, const std::uint8_t* literals,
+	                                    const std::size_t count, const std::size_t match_code) {
+		*out++ = static_cast<std::uint8_t>((std::min<std::size_t>(count, 15) << 4)
+			| std::min<std::size_t>(match_code, 15));
+
+		if(count >= 15) {
+			out = write_length(out, count - 15);
+		}
+
+		std::memcpy(out, literals, count);
+		return out + count;
+	}
+
+	static bool read_length(const std::uint8_t* source, const std::size_t size,
+	                        std::size_t& in, std::size_t& length, const std::size_t limit) {
+		std::uint8_t byte = 0;
+
+		do {
+			if(in == size) {
+				return false;
+			}
+
+			byte = source[in++];
+			length += byte;
+
+			if(length > limit) {
+				return false;
+			}
+		} while(byte == 255);
+
+		return true;
+	}
+
+public:
+	std::size_t bound(const std::size_t size) const {
+		return size + size / 255 + 16;
+	}
+
+	std::size_t compress(const std::uint8_t* source, const std::size_t size,
+	                     std::uint8_t* dest, const std::size_t capacity) const {
+		if(capacity < bound(size)) {
+			return 0;
+		}
+
+		auto out = dest;
+		std::size_t anchor = 0;
+
+		if(size > match_search_end) {
+			std::array<std::uint32_t, 1u << hash_bits> table {};
+			const auto search_end = size - match_search_end;
+			const auto match_end = size - last_literals;
+			std::size_t pos = 1;
+
+			while(pos < search_end) {
+				const auto sequence = load32(source + pos);
+				auto& entry = table[hash(sequence)];
+				const std::size_t candidate = entry;
+				entry = static_cast<std::uint32_t>(pos);
+
+				if(pos - candidate > max_offset || load32(source + candidate) != sequence) {
+					// the longer it's been since the last match, the further ahead we step
+					pos += 1 + ((pos - anchor) >> 6);
+					continue;
+				}
+
+				const auto length = match_length(source + candidate, source + pos, match_end - pos);
+				const auto offset = pos - candidate;
+				out = write_literals(out, source + anchor, pos - anchor, length - min_match);
+				*out++ = static_cast<std::uint8_t>(offset);
+				*out++ = static_cast<std::uint8_t>(offset >> 8);
+
+				if(length - min_match >= 15) {
+					out = write_length(out, length - min_match - 15);
+				}
+
+				pos += length;
+				anchor = pos;
+			}
+		}
+
+		out = write_literals(out, source + anchor, size - anchor, 0);
+		return static_cast<std::size_t>(out - dest);
+	}
+
+	bool decompress(const std::uint8_t* source, const std::size_t size,
+	                std::uint8_t* dest, const std::size_t raw_size) const {
+		std::size_t in = 0, out = 0;
+
+		while(true) {
+			if(in == size) {
+				return false;
+			}
+
+			const auto token = source[in++];
+			std::size_t literals = token >> 4;
+
+			if(literals == 15 && !read_length(source, size, in, literals, raw_size)) {
+				return false;
+			}
+
+			if(literals > size - in || literals > raw_size - out) {
+				return false;
+			}
+
+			std::memcpy(dest + out, source + in, literals);
+			in += literals;
+			out += literals;
+
+			// the final sequence has no match
+			if(in == size) {
+				return out == raw_size;
+			}
+
+			if(size - in < 2) {
+				return false;
+			}
+
+			const std::size_t offset = source[in] | (source[in + 1] << 8);
+			in += 2;
+
+			if(!offset || offset > out) {
+				return false;
+			}
+
+			std::size_t length = token & 0x0f;
+
+			if(length == 15 && !read_length(source, size, in, length, raw_size)) {
+				return false;
+			}
+
+			length += min_match;
+
+			if(length > raw_size - out) {
+				return false;
+			}
+
+			const auto match = dest + out - offset;
+
+			if(offset >= length) {
+				std::memcpy(dest + out, match, length);
+			} else {
+				// overlapping matches repeat the most recent bytes
+				for(std::size_t i = 0; i < length; ++i) {
+					dest[out + i] = match[i];
+				}
+			}
+
+			out += length;
+		}
+	}
+};
+
+#ifdef HEXI_WITH_ZLIB
+/**
+ * zlib codec, for a better ratio at the expense of speed. Requires
+ * HEXI_WITH_ZLIB to be defined and the program to be linked with zlib.
+ */
+struct zlib final {
+	int level = Z_DEFAULT_COMPRESSION;
+
+	std::size_t bound(const std::size_t size) const {
+		return ::compressBound(static_cast<uLong>(size));
+	}
+
+	std::size_t compress(const std::uint8_t* source, const std::size_t size,
+	                     std::uint8_t* dest, const std::size_t capacity) const {
+		auto length = static_cast<uLongf>(capacity);
+
+		if(::compress2(dest, &length, source, static_cast<uLong>(size), level) != Z_OK) {
+			return 0;
+		}
+
+		return length;
+	}
+
+	bool decompress(const std::uint8_t* source, const std::size_t size,
+	                std::uint8_t* dest, const std::size_t raw_size) const {
+		auto length = static_cast<uLongf>(raw_size);
+		const auto ret = ::uncompress(dest, &length, source, static_cast<uLong>(size));
+		return ret == Z_OK && length == raw_size;
+	}
+};
+#endif
+
+#ifdef HEXI_WITH_ZSTD
+/**
+ * Zstandard codec. Requires HEXI_WITH_ZSTD to be defined and the program
+ * to be linked with libzstd.
+ */
+struct zstd final {
+	int level = ZSTD_CLEVEL_DEFAULT;
+
+	std::size_t bound(const std::size_t size) const {
+		return ZSTD_compressBound(size);
+	}
+
+	std::size_t compress(const std::uint8_t* source, const std::size_t size,
+	                     std::uint8_t* dest, const std::size_t capacity) const {
+		const auto ret = ZSTD_compress(dest, capacity, source, size, level);
+		return ZSTD_isError(ret)? 0 : ret;
+	}
+
+	bool decompress(const std::uint8_t* source, const std::size_t size,
+	                std::uint8_t* dest, const std::size_t raw_size) const {
+		const auto ret = ZSTD_decompress(dest, raw_size, source, size);
+		return !ZSTD_isError(ret) && ret == raw_size;
+	}
+};
+#endif
+
+namespace impl {
+
+/*
+ * Each block is preceded by its uncompressed size and its size as stored,
+ * both 32-bit little endian. The top bit of the stored size is set if the
+ * block didn't compress and was stored as is.
+ */
+constexpr std::size_t header_size = 8;
+constexpr std::uint32_t stored_raw = 0x80000000;
+
+struct block_header {
+	std::size_t raw_size;
+	std::size_t stored_size;
+	bool compressed;
+};
+
+inline void write_header(std::uint8_t* out, const std::size_t raw_size,
+                         const std::size_t stored_size, const bool compressed) {
+	const auto raw = endian::native_to_little(static_cast<std::uint32_t>(raw_size));
+	const auto stored = endian::native_to_little(
+		static_cast<std::uint32_t>(stored_size) | (compressed? 0 : stored_raw)
+	);
+
+	std::memcpy(out, &raw, sizeof(raw));
+	std::memcpy(out + sizeof(raw), &stored, sizeof(stored));
+}
+
+inline block_header read_header(const std::uint8_t* data) {
+	std::uint32_t raw, stored;
+	std::memcpy(&raw, data, sizeof(raw));
+	std::memcpy(&stored, data + sizeof(raw), sizeof(stored));
+	raw = endian::little_to_native(raw);
+	stored = endian::little_to_native(stored);
+
+	return {
+		.raw_size = raw,
+		.stored_size = stored & ~stored_raw,
+		.compressed = !(stored & stored_raw)
+	};
+}
+
+// blocks are only stored compressed if doing so made them smaller
+inline bool valid_header(const block_header& header, const std::size_t block_size) {
+	if(!header.raw_size || header.raw_size > block_size) {
+		return false;
+	}
+
+	if(header.compressed) {
+		return header.stored_size && header.stored_size < header.raw_size;
+	}
+
+	return header.stored_size == header.raw_size;
+}
+
+} // impl
+
+} // compression
+
+/**
+ * Write-only buffer that compresses everything written to it in fixed-size
+ * blocks, writing each compressed block to another buffer. This allows a
+ * binary_stream to serialise straight into compressed output, with only
+ * a single block of uncompressed data being held at any point.
+ * 
+ * A block is only compressed once it's full, so flush() must be called to
+ * compress and write out any partial block once writing is complete. Blocks
+ * that don't compress are stored as is.
+ * 
+ * The output can be read back with a decompressing_buffer using the same
+ * codec and block size.
+ */
+template<
+	writeable buf_type,
+	compression::block_codec codec_type = compression::fast_lz,
+	std::size_t block_sz = compression::default_block_size
+>
+class compressing_buffer final {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = std::size_t;
+	using value_type      = std::byte;
+	using contiguous      = is_non_contiguous;
+	using seeking         = unsupported;
+
+	static_assert(block_sz && block_sz < compression::impl::stored_raw);
+
+private:
+	buf_type& buffer_;
+	codec_type codec_;
+	uninit_vector<std::uint8_t> block_;
+	uninit_vector<std::uint8_t> output_;
+	size_type pending_ = 0;
+	size_type total_in_ = 0;
+	size_type total_out_ = 0;
+
+	void compress_block(const std::uint8_t* data, const size_type size) {
+		using namespace compression::impl;
+
+		const auto compressed = codec_.compress(
+			data, size, output_.data() + header_size, output_.size() - header_size
+		);
+
+		if(compressed && compressed < size) {
+			write_header(output_.data(), size, compressed, true);
+			buffer_.write(output_.data(), header_size + compressed);
+			total_out_ += header_size + compressed;
+		} else {
+			write_header(output_.data(), size, size, false);
+			buffer_.write(output_.data(), header_size);
+			buffer_.write(data, size);
+			total_out_ += header_size + size;
+		}
+	}
+
+	void compress_pending() {
+		// cleared first so a failed write doesn't leave the block to be written again
+		const auto size = std::exchange(pending_, 0);
+		compress_block(block_.data(), size);
+	}
+
+public:
+	/**
+	 * @brief Constructs a compressing_buffer.
+	 * 
+	 * @param buffer The buffer to write compressed blocks to.
+	 * @param codec The codec to compress blocks with.
+	 */
+	explicit compressing_buffer(buf_type& buffer, codec_type codec = {})
+		: buffer_(buffer),
+		  codec_(std::move(codec)),
+		  block_(block_sz),
+		  output_(compression::impl::header_size + codec_.bound(block_sz)) {}
+
+	compressing_buffer(const compressing_buffer&) = delete;
+	compressing_buffer& operator=(const compressing_buffer&) = delete;
+
+	~compressing_buffer() {
+		assert(!pending_ && "compressing_buffer destroyed without being flushed");
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container, compressing each
+	 * block as it's filled.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, size_type length) {
+		auto data = static_cast<const std::uint8_t*>(source);
+		total_in_ += length;
+
+		while(length) {
+			// whole blocks can be compressed without staging them first
+			if(!pending_ && length >= block_sz) {
+				compress_block(data, block_sz);
+				data += block_sz;
+				length -= block_sz;
+				continue;
+			}
+
+			const auto count = std::min(length, block_sz - pending_);
+			std::memcpy(block_.data() + pending_, data, count);
+			pending_ += count;
+			data += count;
+			length -= count;
+
+			if(pending_ == block_sz) {
+				compress_pending();
+			}
+		}
+	}
+
+	/**
+	 * @brief Compresses any partial block and writes it to the underlying buffer.
+	 */
+	void flush() {
+		if(pending_) {
+			compress_pending();
+		}
+	}
+
+	/**
+	 * @return The number of bytes written that have yet to be compressed.
+	 */
+	size_type size() const {
+		return pending_;
+	}
+
+	/**
+	 * @return True if there is no data waiting to be compressed.
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !pending_;
+	}
+
+	/**
+	 * @return The total number of uncompressed bytes written to the buffer.
+	 */
+	size_type total_in() const {
+		return total_in_;
+	}
+
+	/**
+	 * @return The total number of bytes written to the underlying buffer.
+	 */
+	size_type total_out() const {
+		return total_out_;
+	}
+
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	constexpr static bool can_write_seek() {
+		return false;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	buf_type* buffer() {
+		return &buffer_;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	const buf_type* buffer() const {
+		return &buffer_;
+	}
+};
+
+/**
+ * Read-only buffer that decompresses the output of a compressing_buffer as
+ * it's read. The compressed data may arrive in the underlying buffer in any
+ * number of pieces. Once a block has arrived in full, it counts towards
+ * size(), but it's only decompressed once reading reaches it, so only a
+ * single block of uncompressed data is held at any point.
+ * 
+ * Blocks are validated before being decompressed. If a corrupt block is found,
+ * the buffer enters an error state, error() returns true and size() returns
+ * zero from then on, so a stream reading from it fails with buff_limit_err
+ * and reports it according to its own error policy. If the corruption is only
+ * found by the read that reaches the block, the rest of that read is zeroed.
+ * 
+ * size() and empty() take any complete blocks from the underlying buffer,
+ * so unlike other buffers, they aren't const.
+ */
+template<
+	typename buf_type,
+	compression::block_codec codec_type = compression::fast_lz,
+	std::size_t block_sz = compression::default_block_size
+>
+class decompressing_buffer final {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = std::size_t;
+	using value_type      = std::byte;
+	using contiguous      = is_non_contiguous;
+	using seeking         = unsupported;
+
+private:
+	buf_type& buffer_;
+	codec_type codec_;
+	uninit_vector<std::uint8_t> block_;
+	uninit_vector<std::uint8_t> frames_;
+	size_type block_read_ = 0;
+	size_type block_size_ = 0;
+	size_type frames_read_ = 0;
+	size_type available_ = 0;
+	size_type total_read_ = 0;
+	bool error_ = false;
+
+	void fail() {
+		error_ = true;
+		available_ = 0;
+		block_read_ = 0;
+		block_size_ = 0;
+	}
+
+	/*
+	 * Moves any complete blocks out of the underlying buffer, so that their
+	 * uncompressed sizes can be included in size() without decompressing them
+	 */
+	void pull() {
+		using namespace compression::impl;
+
+		while(!error_ && buffer_.size() >= header_size) {
+			std::array<std::uint8_t, header_size> data;
+			buffer_.copy(data.data(), data.size());
+			const auto header = read_header(data.data());
+
+			if(!valid_header(header, block_sz)) {
+				fail();
+				return;
+			}
+
+			if(buffer_.size() - header_size < header.stored_size) {
+				return;
+			}
+
+			if(frames_read_) {
+				frames_.erase(frames_.begin(), frames_.begin() + frames_read_);
+				frames_read_ = 0;
+			}
+
+			const auto offset = frames_.size();
+			const auto length = header_size + header.stored_size;
+			frames_.resize(offset + length);
+			buffer_.read(frames_.data() + offset, length);
+			available_ += header.raw_size;
+		}
+	}
+
+	void decode_next() {
+		using namespace compression::impl;
+
+		const auto frame = frames_.data() + frames_read_;
+		const auto header = read_header(frame);
+		bool success = true;
+
+		if(header.compressed) {
+			success = codec_.decompress(
+				frame + header_size, header.stored_size, block_.data(), header.raw_size
+			);
+		} else {
+			std::memcpy(block_.data(), frame + header_size, header.raw_size);
+		}
+
+		if(!success) {
+			fail();
+			return;
+		}
+
+		frames_read_ += header_size + header.stored_size;
+		available_ -= header.raw_size;
+		block_read_ = 0;
+		block_size_ = header.raw_size;
+
+		total_read_ += header_size + header.stored_size;
+
+		if(frames_read_ == frames_.size()) {
+			frames_.clear();
+			frames_read_ = 0;
+		}
+	}
+
+	template<bool copy>
+	void consume(std::uint8_t* destination, size_type length) {
+		if(length > size()) {
+			HEXI_THROW(buffer_underrun(length, total_read_, size()));
+		}
+
+		while(length && !error_) {
+			if(block_read_ == block_size_) {
+				decode_next();
+				continue;
+			}
+
+			const auto count = std::min(length, block_size_ - block_read_);
+
+			if constexpr(copy) {
+				std::memcpy(destination, block_.data() + block_read_, count);
+				destination += count;
+			}
+
+			block_read_ += count;
+			length -= count;
+		}
+
+		if constexpr(copy) {
+			std::memset(destination, 0, length);
+		}
+	}
+
+public:
+	/**
+	 * @brief Constructs a decompressing_buffer.
+	 * 
+	 * @param buffer The buffer to read compressed blocks from.
+	 * @param codec The codec the blocks were compressed with.
+	 */
+	explicit decompressing_buffer(buf_type& buffer, codec_type codec = {})
+		: buffer_(buffer),
+		  codec_(std::move(codec)),
+		  block_(block_sz) {}
+
+	decompressing_buffer(const decompressing_buffer&) = delete;
+	decompressing_buffer& operator=(const decompressing_buffer&) = delete;
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) {
+		consume<true>(static_cast<std::uint8_t*>(destination), length);
+	}
+
+	/**
+	 * @brief Skip a requested number of bytes.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		consume<false>(nullptr, length);
+	}
+
+	/**
+	 * @brief Returns the amount of uncompressed data available to read,
+	 * including blocks that have arrived but have yet to be decompressed.
+	 * 
+	 * @return The number of bytes of data available to read.
+	 */
+	size_type size() {
+		pull();
+		return (block_size_ - block_read_) + available_;
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() {
+		return !size();
+	}
+
+	/**
+	 * @return The total number of compressed bytes decompressed so far.
+	 */
+	size_type total_read() const {
+		return total_read_;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	buf_type* buffer() {
+		return &buffer_;
+	}
+
+	/**
+	 * @return Pointer to the underlying buffer.
+	 */
+	const buf_type* buffer() const {
+		return &buffer_;
+	}
+
+	/**
+	 * @return True if a corrupt block has been found.
+	 */
+	bool error() const {
+		return error_;
+	}
+
+	/**
+	 * @return True if no corrupt blocks have been found.
+	 */
+	operator bool() const {
+		return !error();
+	}
+};
+
+} // hexi
+
+// #include <hexi/concepts.h>
+
+// #include <hexi/cow_buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/shared.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace hexi {
+
+/**
+ * Copy-on-write wrapper around another buffer type, allowing copies to share
+ * the same underlying buffer until one of them needs to modify it. Copying
+ * a cow_buffer only increments a reference count, which makes it cheap to
+ * clone a queued message, e.g. for retransmission.
+ * 
+ * Each instance has its own read cursor over the shared data, so reads and
+ * skips never trigger a copy. Only operations that modify the data, such as
+ * writes, give this instance its own copy of the buffer if it's currently
+ * shared. Once an instance is the sole owner, reads consume the underlying
+ * buffer in place.
+ * 
+ * Reading at an offset into a shared buffer requires that the buffer is
+ * either contiguous (read_ptr()) or provides a view over its blocks (blocks()).
+ * 
+ * Copies may be handed to and used by other threads, provided that each
+ * thread only uses its own instances. A single cow_buffer instance is not
+ * thread-safe.
+ */
+template<typename buf_type>
+class cow_buffer final {
+public:
+	using buffer_type  = buf_type;
+	using value_type   = typename buf_type::value_type;
+	using size_type    = typename buf_type::size_type;
+	using offset_type  = typename buf_type::offset_type;
+	using contiguous   = typename buf_type::contiguous;
+	using seeking      = typename buf_type::seeking;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	std::shared_ptr<buf_type> buffer_;
+	size_type read_ = 0; // bytes this instance has read from the shared buffer
+
+	bool sole_owner() const {
+		if(buffer_.use_count() > 1) {
+			return false;
+		}
+
+		/*
+		 * use_count() is a relaxed load, so pair it with the release made by
+		 * other instances releasing their reference, to ensure that their
+		 * reads of the buffer happen before this instance modifies it
+		 */
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+
+	// gives this instance sole ownership of the buffer before modifying it
+	buf_type& detach() {
+		if(!sole_owner()) {
+			buffer_ = std::make_shared<buf_type>(std::as_const(*buffer_));
+		}
+
+		if(read_) {
+			buffer_->skip(read_);
+			read_ = 0;
+		}
+
+		return *buffer_;
+	}
+
+	/*
+	 * Calls func with each span of the shared buffer's data, starting at
+	 * this instance's read cursor, until it returns false
+	 */
+	template<typename Func>
+	void visit(Func&& func) const {
+		auto offset = read_;
+
+		const auto visit_span = [&](const auto span) {
+			const auto bytes = std::as_bytes(span);
+
+			if(offset >= bytes.size()) {
+				offset -= bytes.size();
+				return true;
+			}
+
+			const auto data = reinterpret_cast<const value_type*>(bytes.data());
+			const auto result = func(std::span(data + offset, bytes.size() - offset));
+			offset = 0;
+			return result;
+		};
+
+		if constexpr(requires { buffer_->read_ptr(); }) {
+			visit_span(std::span(buffer_->read_ptr(), buffer_->size()));
+		} else {
+			for(const auto& block : buffer_->blocks()) {
+				if(!visit_span(block)) {
+					break;
+				}
+			}
+		}
+	}
+
+	void copy_shared(void* destination, const size_type length) const {
+		assert(length <= size() && "cow_buffer copy too large!");
+		auto dest = static_cast<value_type*>(destination);
+		auto remaining = length;
+
+		visit([&](const auto span) {
+			const auto count = std::min<size_type>(remaining, span.size());
+			std::memcpy(dest, span.data(), count);
+			dest += count;
+			remaining -= count;
+			return remaining != 0;
+		});
+	}
+
+public:
+	cow_buffer()
+		: buffer_(std::make_shared<buf_type>()) {}
+
+	/**
+	 * @brief Takes ownership of an existing buffer.
+	 * 
+	 * @param buffer The buffer to be shared.
+	 */
+	explicit cow_buffer(buf_type&& buffer)
+		: buffer_(std::make_shared<buf_type>(std::move(buffer))) {}
+
+	// a moved-from instance may only be assigned to or destroyed
+	cow_buffer(cow_buffer&&) noexcept = default;
+	cow_buffer& operator=(cow_buffer&&) noexcept = default;
+	cow_buffer(const cow_buffer&) = default;
+	cow_buffer& operator=(const cow_buffer&) = default;
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, const size_type length) {
+		if(sole_owner()) {
+			detach().read(destination, length);
+		} else {
+			copy_shared(destination, length);
+			read_ += length;
+		}
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, const size_type length) const {
+		if(read_) {
+			copy_shared(destination, length);
+		} else {
+			buffer_->copy(destination, length);
+		}
+	}
+
+	/**
+	 * @brief Skip the requested number of bytes.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		if(sole_owner()) {
+			detach().skip(length);
+		} else {
+			assert(length <= size() && "cow_buffer skip too large!");
+			read_ += length;
+		}
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, const size_type length) {
+		detach().write(source, length);
+	}
+
+	/**
+	 * @brief Reserves a number of bytes within the container for future use.
+	 * 
+	 * @param length The number of bytes that the container should reserve.
+	 */
+	void reserve(const size_type length) {
+		detach().reserve(length);
+	}
+
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking.
+	 */
+	void write_seek(const buffer_seek direction, const size_type offset) {
+		detach().write_seek(direction, offset);
+	}
+
+	/**
+	 * @brief Clears the container. A shared buffer is released rather than
+	 * copied.
+	 */
+	void clear() {
+		if(sole_owner()) {
+			buffer_->clear();
+		} else {
+			buffer_ = std::make_shared<buf_type>();
+		}
+
+		read_ = 0;
+	}
+
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(const value_type value) const {
+		if(!read_) {
+			return buffer_->find_first_of(value);
+		}
+
+		size_type index = 0;
+		auto position = npos;
+
+		visit([&](const auto span) {
+			if(const auto it = std::ranges::find(span, value); it != span.end()) {
+				position = index + static_cast<size_type>(it - span.begin());
+				return false;
+			}
+
+			index += span.size();
+			return true;
+		});
+
+		return position;
+	}
+
+	/**
+	 * @brief Returns the size of the container.
+	 * 
+	 * @return The number of bytes of data available to read within the container.
+	 */
+	size_type size() const {
+		return buffer_->size() - read_;
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container has no data to be read.
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !size();
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const size_type index) {
+		return detach()[index];
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const size_type index) const {
+		return std::as_const(*buffer_)[read_ + index];
+	}
+
+	/**
+	 * @brief Provides read-only access to the underlying buffer without
+	 * copying it, e.g. for use with buffer_sequence.
+	 * 
+	 * @note The first offset() bytes of the buffer have already been read
+	 * by this instance.
+	 * 
+	 * @return A reference to the underlying buffer.
+	 */
+	const buf_type& get() const {
+		return *buffer_;
+	}
+
+	/**
+	 * @return The number of bytes at the front of the underlying buffer that
+	 * this instance has read but that are retained for other instances.
+	 */
+	size_type offset() const {
+		return read_;
+	}
+
+	/**
+	 * @return True if the underlying buffer is shared with another cow_buffer.
+	 */
+	bool shared() const {
+		return buffer_.use_count() > 1;
+	}
+};
+
+} // hexi
+
+// #include <hexi/delta.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/shared.h>
+
+// #include <hexi/concepts.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HEXI_DELTA_SSE2
+	#include <emmintrin.h>
+#endif
+
+/**
+ * Delta encoding of a buffer against a baseline, such as the previous snapshot
+ * of an entity's state, so that only the bytes that changed need to be sent.
+ * 
+ * The delta is written to a stream as the size of the new buffer, followed by
+ * a list of changed runs, each being the number of unchanged bytes to skip, the
+ * length of the run and the run's bytes XORed with the baseline. The list is
+ * terminated by a run with a length of zero. All sizes are varints.
+ * 
+ * The baseline and the new buffer can be any mix of contiguous buffers and
+ * dynamic_buffers, and don't need to be the same size. A baseline that's shorter
+ * than the new buffer is treated as though it were padded with zeroes. Neither
+ * buffer is modified.
+ */
+namespace hexi::delta {
+
+namespace impl {
+
+constexpr std::size_t staging_size = 1024;
+
+// unchanged bytes within a run that it's cheaper to include than to split the run
+constexpr std::size_t min_gap = 3;
+
+inline constexpr std::array<std::uint8_t, staging_size> zero_block {};
+
+/*
+ * Returns the number of leading bytes that are the same in both inputs
+ */
+inline std::size_t mismatch(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t size) {
+	std::size_t i = 0;
+
+#ifdef HEXI_DELTA_SSE2
+	for(; i + 16 <= size; i += 16) {
+		const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+		const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+		const auto diff = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xffffu;
+
+		if(diff) {
+			return i + std::countr_zero(diff);
+		}
+	}
+#endif
+
+	for(; i + 8 <= size; i += 8) {
+		std::uint64_t a, b;
+		std::memcpy(&a, lhs + i, sizeof(a));
+		std::memcpy(&b, rhs + i, sizeof(b));
+
+		if(const auto diff = a ^ b) {
+			if constexpr(std::endian::native == std::endian::little) {
+				return i + std::countr_zero(diff) / 8;
+			} else {
+				return i + std::countl_zero(diff) / 8;
+			}
+		}
+	}
+
+	for(; i < size && lhs[i] == rhs[i]; ++i);
+	return i;
+}
+
+/*
+ * Returns the number of leading bytes that differ between both inputs
+ */
+inline std::size_t match(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t size) {
+	std::size_t i = 0;
+
+#ifdef HEXI_DELTA_SSE2
+	for(; i + 16 <= size; i += 16) {
+		const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+		const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+		const auto same = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+
+		if(same) {
+			return i + std::countr_zero(same);
+		}
+	}
+#endif
+
+	for(; i < size && lhs[i] != rhs[i]; ++i);
+	return i;
+}
+
+inline void xor_bytes(std::uint8_t* dest, const std::uint8_t* lhs,
+                      const std::uint8_t* rhs, const std::size_t size) {
+	for(std::size_t i = 0; i < size; ++i) {
+		dest[i] = lhs[i] ^ rhs[i];
+	}
+}
+
+template<typename buf_type>
+concept block_buffer = requires(const buf_type& buffer) {
+	{ buffer.blocks() } -> std::ranges::input_range;
+};
+
+template<typename buf_type>
+concept contiguous_buffer = requires(const buf_type& buffer) {
+	{ buffer.read_ptr() };
+	{ buffer.size() };
+};
+
+template<typename buf_type>
+concept readable_buffer = byte_oriented<buf_type>
+	&& (block_buffer<buf_type> || contiguous_buffer<buf_type>);
+
+template<readable_buffer buf_type>
+auto blocks(const buf_type& buffer) {
+	if constexpr(block_buffer<buf_type>) {
+		return buffer.blocks();
+	} else {
+		return std::array { std::span(buffer.read_ptr(), buffer.size()) };
+	}
+}
+
+/*
+ * Walks the blocks of a buffer without consuming them. Once the end of
+ * the buffer is reached, it continues to produce zeroes indefinitely.
+ */
+template<readable_buffer buf_type>
+class cursor final {
+	using range_type = decltype(blocks(std::declval<const buf_type&>()));
+
+	range_type range_;
+	std::ranges::iterator_t<const range_type> it_;
+	std::span<const std::uint8_t> block_;
+
+public:
+	explicit cursor(const buf_type& buffer)
+		: range_(blocks(buffer)),
+		  it_(std::ranges::begin(std::as_const(range_))) {}
+
+	cursor(const cursor&) = delete;
+	cursor& operator=(const cursor&) = delete;
+
+	std::span<const std::uint8_t> peek() {
+		while(block_.empty()) {
+			if(it_ == std::ranges::end(std::as_const(range_))) {
+				return zero_block;
+			}
+
+			const auto bytes = std::as_bytes(std::span(*it_));
+			block_ = { reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size() };
+			++it_;
+		}
+
+		return block_;
+	}
+
+	void advance(const std::size_t size) {
+		if(!block_.empty()) {
+			block_ = block_.subspan(size);
+		}
+	}
+};
+
+template<typename stream_type>
+class encoder final {
+	stream_type& stream_;
+	std::array<std::uint8_t, staging_size> staging_;
+	std::size_t run_ = 0;
+	std::size_t skip_ = 0;
+	std::size_t gap_ = 0;
+
+	void write_run() {
+		hexi::impl::varint_encode(stream_, skip_);
+		hexi::impl::varint_encode(stream_, run_);
+		stream_.put(staging_.data(), run_);
+		skip_ = 0;
+		run_ = 0;
+	}
+
+	void append_xor(const std::uint8_t* base, const std::uint8_t* current, std::size_t size) {
+		while(size) {
+			const auto count = std::min(size, staging_.size() - run_);
+			xor_bytes(staging_.data() + run_, base, current, count);
+			run_ += count;
+			base += count;
+			current += count;
+			size -= count;
+
+			if(run_ == staging_.size()) {
+				write_run();
+			}
+		}
+	}
+
+	void append_gap() {
+		append_xor(zero_block.data(), zero_block.data(), gap_);
+		gap_ = 0;
+	}
+
+public:
+	explicit encoder(stream_type& stream)
+		: stream_(stream) {}
+
+	void process(const std::uint8_t* base, const std::uint8_t* current, const std::size_t size) {
+		std::size_t i = 0;
+
+		while(i < size) {
+			if(!run_) {
+				// without a run to extend, a pending gap is just more bytes to skip
+				const auto same = mismatch(base + i, current + i, size - i);
+				skip_ += gap_ + same;
+				gap_ = 0;
+				i += same;
+
+				if(i == size) {
+					break;
+				}
+			}
+
+			if(const auto changed = match(base + i, current + i, size - i)) {
+				append_gap();
+				append_xor(base + i, current + i, changed);
+				i += changed;
+			}
+
+			const auto same = mismatch(base + i, current + i, size - i);
+			gap_ += same;
+			i += same;
+
+			if(gap_ >= min_gap) {
+				if(run_) {
+					write_run();
+				}
+
+				skip_ += gap_;
+				gap_ = 0;
+			}
+		}
+	}
+
+	void finish() {
+		if(run_) {
+			write_run();
+		}
+
+		hexi::impl::varint_encode(stream_, std::size_t(0));
+		hexi::impl::varint_encode(stream_, std::size_t(0));
+	}
+};
+
+template<typename buf_type, typename out_type>
+void copy_baseline(cursor<buf_type>& baseline, out_type& out, std::size_t size) {
+	while(size) {
+		const auto block = baseline.peek();
+		const auto count = std::min(size, block.size());
+		out.write(block.data(), count);
+		baseline.advance(count);
+		size -= count;
+	}
+}
+
+} // impl
+
+/**
+ * @brief Writes the differences between a baseline and a new buffer to a stream.
+ * 
+ * @param baseline The buffer to compare against, such as the last snapshot
+ * the receiver acknowledged.
+ * @param current The buffer to be encoded.
+ * @param stream The stream to write the delta to.
+ */
+template<impl::readable_buffer base_type, impl::readable_buffer current_type, typename stream_type>
+void encode(const base_type& baseline, const current_type& current, stream_type& stream) {
+	const std::size_t size = current.size();
+	hexi::impl::varint_encode(stream, size);
+
+	impl::cursor<base_type> base_cursor(baseline);
+	impl::cursor<current_type> current_cursor(current);
+	impl::encoder encoder(stream);
+
+	for(std::size_t remaining = size; remaining;) {
+		const auto base_block = base_cursor.peek();
+		const auto current_block = current_cursor.peek();
+		const auto count = std::min({ remaining, base_block.size(), current_block.size() });
+		encoder.process(base_block.data(), current_block.data(), count);
+		base_cursor.advance(count);
+		current_cursor.advance(count);
+		remaining -= count;
+	}
+
+	encoder.finish();
+}
+
+/**
+ * @brief Reconstructs a buffer from a baseline and a delta produced by encode.
+ * 
+ * If the delta is truncated, the stream's usual error handling applies. If it's
+ * malformed, the stream is put into an error state with set_error_state. In either
+ * case, the output may have been partially written.
+ * 
+ * @param baseline The same baseline that was used to encode the delta.
+ * @param stream The stream to read the delta from.
+ * @param out The buffer to write the reconstructed data to.
+ * @param max_size The largest reconstructed size to accept, to prevent a
+ * malicious delta from producing an unbounded amount of output.
+ */
+template<impl::readable_buffer base_type, typename stream_type, writeable out_type>
+void decode(const base_type& baseline, stream_type& stream, out_type& out,
+            const std::size_t max_size = std::numeric_limits<std::size_t>::max()) {
+	const auto size = hexi::impl::varint_decode<std::size_t>(stream);
+
+	if(!stream) {
+		return;
+	}
+
+	if(size > max_size) {
+		stream.set_error_state();
+		return;
+	}
+
+	impl::cursor<base_type> base_cursor(baseline);
+	std::array<std::uint8_t, impl::staging_size> staging;
+	std::size_t written = 0;
+
+	while(true) {
+		const auto skip = hexi::impl::varint_decode<std::size_t>(stream);
+		auto length = hexi::impl::varint_decode<std::size_t>(stream);
+
+		if(!stream) {
+			return;
+		}
+
+		if(!length) {
+			break;
+		}
+
+		if(skip > size - written || length > size - written - skip) {
+			stream.set_error_state();
+			return;
+		}
+
+		impl::copy_baseline(base_cursor, out, skip);
+		written += skip + length;
+
+		while(length) {
+			const auto block = base_cursor.peek();
+			const auto count = std::min({ length, block.size(), staging.size() });
+			stream.get(staging.data(), count);
+
+			if(!stream) {
+				return;
+			}
+
+			impl::xor_bytes(staging.data(), staging.data(), block.data(), count);
+			out.write(staging.data(), count);
+			base_cursor.advance(count);
+			length -= count;
+		}
+	}
+
+	impl::copy_baseline(base_cursor, out, size - written);
+}
+
+} // delta, hexi
+
+#undef HEXI_DELTA_SSE2
+
+// #include <hexi/dynamic_buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/pmc/buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/pmc/buffer_read.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/pmc/buffer_base.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+#include <cstddef>
+
+namespace hexi::pmc {
+
+class buffer_base {
+protected:
+	std::size_t read_ = 0;
+	std::size_t write_ = 0;
+
+public:
+	virtual std::size_t size() const = 0;
+	virtual bool empty() const = 0;
+	virtual ~buffer_base() = default;
+};
+
+} // pmc, hexi
+
+#include <cstddef>
+
+namespace hexi::pmc {
+
+class buffer_read : virtual public buffer_base {
+public:
+	using value_type = std::byte;
+
+	static constexpr auto npos { static_cast<std::size_t>(-1) };
+
+	virtual ~buffer_read() = default;
+	virtual void read(void* destination, std::size_t length) = 0;
+	virtual void copy(void* destination, std::size_t length) const = 0;
+	virtual	void skip(std::size_t length) = 0;
+	virtual const std::byte& operator[](const std::size_t index) const = 0;
+	virtual std::size_t find_first_of(std::byte val) const = 0;
+};
+
+} // pmc, hexi
+
+// #include <hexi/pmc/buffer_write.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/pmc/buffer_base.h>
+
+// #include <hexi/shared.h>
+
+#include <cstddef>
+
+namespace hexi::pmc {
+
+class buffer_write : virtual public buffer_base {
+public:
+	using value_type = std::byte;
+
+	virtual ~buffer_write() = default;
+	virtual void write(const void* source, std::size_t length) = 0;
+	virtual void reserve(std::size_t length) = 0;
+	virtual bool can_write_seek() const = 0;
+	virtual void write_seek(buffer_seek direction, std::size_t offset) = 0;
+};
+
+} // pmc, hexi
+
+
+namespace hexi::pmc {
+
+class buffer : public buffer_read, public buffer_write {
+public:
+	using value_type = std::byte;
+
+	using buffer_read::operator[];
+
+	virtual std::byte& operator[](const std::size_t index) = 0;
+	virtual ~buffer() = default;
+};
+
+} // pmc, hexi
+
+// #include <hexi/shared.h>
+
+// #include <hexi/allocators/default_allocator.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+namespace hexi {
+
+template<typename T>
+struct default_allocator final {
+	template<typename ...Args>
+	[[nodiscard]] inline T* allocate(Args&&... args) const {
+		return new T(std::forward<Args>(args)...);
+	}
+
+	inline void deallocate(T* t) const {
+		delete t;
+	}
+
+	template<std::output_iterator<T*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) const {
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = new T();
+		}
+
+		return out;
+	}
+
+	template<std::input_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) const {
+		for(; first != last; ++first) {
+			delete *first;
+		}
+	}
+};
+
+} // hexi
+
+// #include <hexi/impl/intrusive_storage.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+#if _MSC_VER
+#pragma warning(disable : 4996)
+#endif
+
+// #include <hexi/shared.h>
+
+// #include <hexi/concepts.h>
+
+#include <array>
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <cassert>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace hexi::impl {
+
+struct intrusive_node {
+	intrusive_node* next;
+	intrusive_node* prev;
+};
+
+/*
+ * For containers that only ever append to the back and remove from
+ * the front, the back pointer is dead weight. Saves a pointer per block.
+ */
+struct intrusive_slist_node {
+	intrusive_slist_node* next;
+};
+
+template<typename T>
+concept intrusive_link = std::same_as<T, intrusive_node> || std::same_as<T, intrusive_slist_node>;
+
+// The smallest unsigned type that can represent every offset in [0, block_size]
+template<std::size_t block_size>
+using compact_offset_t = std::conditional_t<block_size <= UINT8_MAX, std::uint8_t,
+	std::conditional_t<block_size <= UINT16_MAX, std::uint16_t,
+	std::conditional_t<block_size <= UINT32_MAX, std::uint32_t, std::size_t>>>;
+
+/*
+ * The header is the link node followed by the read and write offsets, which
+ * are narrowed to compact_offset_t, the smallest type able to hold any offset
+ * within the block. The storage is a byte array, so it follows the offsets
+ * without padding, e.g. a singly-linked block of up to 255 bytes has a header
+ * of a pointer and two bytes.
+ */
+template<std::size_t block_size,
+	byte_type storage_type = std::byte,
+	intrusive_link link_type = intrusive_node>
+struct intrusive_storage final {
+	using value_type = storage_type;
+	using offset_type = compact_offset_t<block_size>;
+	using node_type = link_type;
+
+	node_type node {};
+	offset_type read_offset = 0;
+	offset_type write_offset = 0;
+	std::array<value_type, block_size> storage;
+
+	/**
+	 * @brief Clear the container.
+	 * 
+	 * Resets the read and write offsets, does not explicitly
+	 * erase the data contained within the buffer but should
+	 * be treated as such.
+	 */
+	void clear() {
+		read_offset = 0;
+		write_offset = 0;
+	}
+
+	/**
+	 * @brief Write provided data to the container.
+	 * 
+	 * If the container size is lower than requested number of bytes,
+	 * the request will be capped at the number of bytes available.
+	 * 
+	 * @note The source buffer must not overlap with the underlying buffer.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 * 
+	 * @return The number of bytes copied, which may be less than requested.
+	 */
+	std::size_t write(const auto source, std::size_t length) {
+		assert(!region_overlap(source, length, storage.data(), storage.size()));
+		std::size_t write_len = block_size - write_offset;
+
+		if(write_len > length) {
+			write_len = length;
+		}
+
+		std::memcpy(storage.data() + write_offset, source, write_len);
+		write_offset += static_cast<offset_type>(write_len);
+		return write_len;
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without
+	 * advancing the read cursor.
+	 * 
+	 * If the container size is lower than requested number of bytes,
+	 * the request will be capped at the number of bytes available.
+	 * 
+	 * @note The destination buffer must not overlap with the underlying buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 * 
+	 * @return The number of bytes copied, which may be less than requested.
+	 */
+	std::size_t copy(auto destination, const std::size_t length) const {
+		assert(!region_overlap(storage.data(), storage.size(), destination, length));
+		std::size_t read_len = block_size - read_offset;
+
+		if(read_len > length) {
+			read_len = length;
+		}
+
+		std::memcpy(destination, storage.data() + read_offset, read_len);
+		return read_len;
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * If the container size is lower than requested number of bytes,
+	 * the request will be capped at the number of bytes available.
+	 * 
+	 * @note The destination buffer must not overlap with the underlying buffer.
+	 * 
+	 * @param length The number of bytes to skip.
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param allow_optimise Whether the buffer can reuse its space where possible.
+	 * 
+	 * @return The number of bytes read, which may be less than requested.
+	 */
+	std::size_t read(auto destination, const std::size_t length, const bool allow_optimise = false) {
+		std::size_t read_len = copy(destination, length);
+		read_offset += static_cast<offset_type>(read_len);
+
+		if(read_offset == write_offset && allow_optimise) {
+			clear();
+		}
+
+		return read_len;
+	}
+
+	/**
+	 * @brief Skip over a number of bytes.
+	 *
+	 * Skips over a number of bytes in the container. This should be used
+	 * if the container holds data that you don't care about but don't want
+	 * to have to read it to another buffer to access data beyond it.
+	 * 
+	 * If the container size is lower than requested number of bytes,
+	 * the request will be capped at the number of bytes available.
+	 * 
+	 * @param length The number of bytes to skip.
+	 * @param allow_optimise Whether the buffer can reuse its space where possible.
+	 * 
+	 * @return The number of bytes skipped, which may be less than requested.
+	 */
+	std::size_t skip(const std::size_t length, const bool allow_optimise = false) {
+		std::size_t skip_len = block_size - read_offset;
+
+		if(skip_len > length) {
+			skip_len = length;
+		}
+
+		read_offset += static_cast<offset_type>(skip_len);
+
+		if(read_offset == write_offset && allow_optimise) {
+			clear();
+		}
+
+		return skip_len;
+	}
+
+	/**
+	 * @brief Returns the size of the container.
+	 * 
+	 * @return The number of bytes available to read within the container.
+	 */
+	std::size_t size() const {
+		return write_offset - read_offset;
+	}
+
+	/**
+	 * @brief The amount of free space.
+	 * 
+	 * @return The number of bytes of free space within the container.
+	 */
+	std::size_t free() const {
+		return block_size - write_offset;
+	}
+
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking.
+	 */
+	void write_seek(const buffer_seek direction, const std::size_t offset) {
+		switch(direction) {
+			case buffer_seek::sk_absolute:
+				write_offset = static_cast<offset_type>(offset);
+				break;
+			case buffer_seek::sk_backward:
+				write_offset -= static_cast<offset_type>(offset);
+				break;
+			case buffer_seek::sk_forward:
+				write_offset += static_cast<offset_type>(offset);
+				break;
+		}
+	}
+
+	/**
+	 * @brief Advances the write cursor.
+	 * 
+	 * If the requested number of bytes exceeds the free space, the
+	 * request will be capped at the amount of free space.
+	 * 
+	 * @param size The number of bytes by which to advance the write cursor.
+	 * 
+	 * @return The number of bytes the write cursor was advanced by, which
+	 * may be less than requested.
+	 */
+	std::size_t advance_write(std::size_t size) {
+		const auto remaining = free();
+
+		if(remaining < size) {
+			size = remaining;
+		}
+
+		write_offset += static_cast<offset_type>(size);
+		return size;
+	}
+
+	/**
+	 * @brief Retrieve a pointer to the readable portion of the buffer.
+	 * 
+	 * @return Pointer to the readable portion of the buffer.
+	 */
+	const value_type* read_ptr() const {
+		return storage.data() + read_offset;
+	}
+
+	/**
+	 * @brief Retrieve a pointer to the readable portion of the buffer.
+	 * 
+	 * @return Pointer to the readable portion of the buffer.
+	 */
+	value_type* read_ptr() {
+		return storage.data() + read_offset;
+	}
+
+	/**
+	 * @brief Retrieve a pointer to the writeable portion of the buffer.
+	 * 
+	 * @return Pointer to the writeable portion of the buffer.
+	 */
+	const value_type* write_ptr () const {
+		return storage.data() + write_offset;
+	}
+
+	/**
+	 * @brief Retrieve a pointer to the writeable portion of the buffer.
+	 * 
+	 * @return Pointer to the writeable portion of the buffer.
+	 */
+	value_type* write_ptr() {
+		return storage.data() + write_offset;
+	}
+
+	/**
+	 * @brief Retrieve a span to the readable portion of the buffer.
+	 * 
+	 * @return Span to the readable portion of the buffer.
+	 */
+	std::span<const value_type> read_data() const {
+		return { storage.data() + read_offset, size() };
+	}
+
+	/**
+	 * @brief Retrieve a span to the readable portion of the buffer.
+	 * 
+	 * @return Span to the readable portion of the buffer.
+	 */
+	std::span<value_type> read_data() {
+		return { storage.data() + read_offset, size() } ;
+	}
+
+	/**
+	 * @brief Retrieve a span to the writeable portion of the buffer.
+	 * 
+	 * @return Span to the writeable portion of the buffer.
+	 */
+	std::span<const value_type> write_data() const {
+		return { storage.data() + write_offset, free() } ;
+	}
+
+	/**
+	 * @brief Retrieve a span to the writeable portion of the buffer.
+	 * 
+	 * @return Span to the writeable portion of the buffer.
+	 */
+	std::span<value_type> write_data() {
+		return { storage.data() + write_offset, free() } ;
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const std::size_t index) {
+		return *(storage.data() + index);
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const std::size_t index) const {
+		return *(storage.data() + index);
+	}
+};
+
+template<std::size_t block_size, byte_type storage_type = std::byte>
+using intrusive_slist_storage = intrusive_storage<block_size, storage_type, intrusive_slist_node>;
+
+} // impl, hexi
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#ifdef HEXI_BUFFER_DEBUG
+#include <vector>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace hexi {
+
+template<typename buffer_type>
+class buffer_sequence;
+
+template<decltype(auto) block_sz>
+concept int_gt_zero = std::integral<decltype(block_sz)> && block_sz > 0;
+
+template<typename allocator_type, typename T>
+concept bulk_allocator = requires(allocator_type a, T** out) {
+	a.allocate_n(std::size_t{}, out);
+	a.deallocate_list(out, out);
+};
+
+struct no_inline_block {};
+struct inline_block : no_inline_block {};
+
+struct no_spare_blocks {
+	static constexpr std::size_t spare_count = 0;
+};
+
+template<std::size_t count>
+struct spare_blocks : no_spare_blocks {
+	static constexpr std::size_t spare_count = count;
+};
+
+/**
+ * InlinePolicy: 'inline_block' embeds a single block of storage within the
+ * dynamic_buffer object itself. It is always used in preference to the
+ * allocator, so buffers that never hold more than block_sz bytes at a time
+ * will never need to allocate. Once the inline block has been drained and
+ * unlinked, it becomes available for reuse as any other block would.
+ * The trade-off is that the size of the dynamic_buffer object grows by
+ * roughly block_sz bytes and moving a buffer must copy the inline block.
+ * 
+ * SparePolicy: 'spare_blocks<count>' keeps up to count drained blocks on
+ * the buffer rather than returning them to the allocator, so that a buffer
+ * oscillating around a block boundary doesn't hit the allocator for every
+ * message. shrink_to_fit() hands any spare blocks back to the allocator.
+ */
+template<decltype(auto) block_sz,
+	byte_type storage_value_type = std::byte,
+	typename allocator = default_allocator<impl::intrusive_storage<block_sz, storage_value_type>>,
+	std::derived_from<no_inline_block> inline_policy = no_inline_block,
+	std::derived_from<no_spare_blocks> spare_policy = no_spare_blocks
+>
+requires int_gt_zero<block_sz>
+class dynamic_buffer final : public pmc::buffer {
+public:
+	// Determined by the allocator, allowing for singly-linked storage to be used
+	using storage_type = std::remove_pointer_t<decltype(std::declval<allocator&>().allocate())>;
+	using value_type   = storage_value_type;
+	using node_type    = typename storage_type::node_type;
+	using size_type    = std::size_t;
+	using offset_type  = std::size_t;
+	using contiguous   = is_non_contiguous;
+	using seeking      = supported;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+	using unique_storage = std::unique_ptr<storage_type, std::function<void(storage_type*)>>;
+
+	// block and offset at which a reserved region begins
+	struct placeholder_type {
+		node_type* node;
+		offset_type offset;
+	};
+
+	static_assert(std::is_same_v<typename storage_type::value_type, value_type>
+	              && sizeof(storage_type::storage) == block_sz * sizeof(value_type),
+	              "allocator storage type does not match the buffer");
+
+private:
+	static constexpr bool has_inline_block = std::is_same_v<inline_policy, inline_block>;
+	static constexpr size_type max_spares = spare_policy::spare_count;
+	static constexpr bool doubly_linked = std::is_same_v<node_type, impl::intrusive_node>;
+	static constexpr size_type bulk_batch = 32;
+
+	using inline_storage = std::conditional_t<has_inline_block, storage_type, std::monostate>;
+	using inline_flag = std::conditional_t<has_inline_block, bool, std::monostate>;
+	using tail_link = std::conditional_t<doubly_linked, std::monostate, node_type*>;
+
+	// drained blocks held for reuse, linked through their nodes
+	struct spare_list {
+		node_type* head = nullptr;
+		size_type count = 0;
+	};
+
+	using spare_storage = std::conditional_t<max_spares != 0, spare_list, std::monostate>;
+
+	node_type root_;
+	size_type size_;
+	size_type headroom_ = 0;
+	[[no_unique_address]] tail_link tail_{};
+	[[no_unique_address]] allocator allocator_;
+	[[no_unique_address]] inline_flag inline_free_{};
+	[[no_unique_address]] inline_storage inline_block_;
+	[[no_unique_address]] spare_storage spares_;
+
+	/*
+	 * The tail is the block that the write cursor is in, which is not
+	 * necessarily the last block in the list if a write seek has rewound
+	 * the cursor. For doubly-linked lists, the root's back pointer is used,
+	 * otherwise it needs tracking separately.
+	 */
+	inline node_type* tail() const {
+		if constexpr(doubly_linked) {
+			return root_.prev;
+		} else {
+			return tail_;
+		}
+	}
+
+	inline void set_tail(node_type* node) {
+		if constexpr(doubly_linked) {
+			root_.prev = node;
+		} else {
+			tail_ = node;
+		}
+	}
+
+	void reset_list() {
+		root_.next = &root_;
+		set_tail(&root_);
+	}
+
+	void link_tail_node(node_type* node) {
+		auto tail_node = tail();
+		node->next = tail_node->next;
+
+		if constexpr(doubly_linked) {
+			node->prev = tail_node;
+
+			if(node->next != &root_) {
+				node->next->prev = node;
+			}
+		}
+
+		tail_node->next = node;
+		set_tail(node);
+	}
+
+	void link_head_node(node_type* node) {
+		node->next = root_.next;
+
+		if constexpr(doubly_linked) {
+			node->prev = &root_;
+
+			if(node->next != &root_) {
+				node->next->prev = node;
+			}
+		}
+
+		root_.next = node;
+	}
+
+	void unlink_head() {
+		auto node = root_.next;
+		root_.next = node->next;
+
+		if constexpr(doubly_linked) {
+			if(node->next != &root_) {
+				node->next->prev = &root_;
+			}
+		}
+
+		if(tail() == node) {
+			set_tail(&root_);
+		}
+	}
+
+	inline storage_type* buffer_from_node(const node_type* node) const {
+		return reinterpret_cast<storage_type*>(std::uintptr_t(node)
+			- offsetof(storage_type, node));
+	}
+
+	/*
+	 * Blocks can only be handed between buffers if they'd be returned to
+	 * the same allocator. Allocators that can't be compared are assumed to
+	 * be interchangeable, as with the stateless and thread-local allocators.
+	 */
+	bool same_allocator(const dynamic_buffer& rhs) const {
+		if constexpr(std::equality_comparable<allocator>) {
+			return allocator_ == rhs.allocator_;
+		} else {
+			return true;
+		}
+	}
+
+	void move(dynamic_buffer& rhs) {
+		if(this == &rhs) { // self-assignment
+			return;
+		}
+
+		clear(); // clear our current blocks rather than swapping them
+
+		if(rhs.root_.next == &rhs.root_) {
+			return;
+		}
+
+		if(!same_allocator(rhs)) {
+			copy(rhs);
+			rhs.clear();
+			return;
+		}
+
+		size_ = rhs.size_;
+		root_.next = rhs.root_.next;
+		set_tail(rhs.tail() == &rhs.root_? &root_ : rhs.tail());
+
+		if constexpr(doubly_linked) {
+			root_.next->prev = &root_;
+		}
+
+		// blocks may follow the tail if the write cursor has been rewound
+		auto last = root_.next;
+
+		while(last->next != &rhs.root_) {
+			last = last->next;
+		}
+
+		last->next = &root_;
+
+		if constexpr(has_inline_block) {
+			if(!rhs.inline_free_) {
+				adopt_inline_block(rhs);
+			}
+		}
+
+		rhs.size_ = 0;
+		rhs.reset_list();
+	}
+
+	/*
+	 * The inline block lives inside of the buffer object, so it can't be
+	 * handed over like allocated blocks can. Instead, its contents are copied
+	 * into our own inline block, which then takes its place in the list.
+	 */
+	void adopt_inline_block(dynamic_buffer& rhs) noexcept requires has_inline_block {
+		auto& block = inline_block_;
+		auto& rhs_block = rhs.inline_block_;
+		block.read_offset = rhs_block.read_offset;
+		block.write_offset = rhs_block.write_offset;
+		block.node = rhs_block.node;
+		std::memcpy(block.storage.data(), rhs_block.storage.data(), rhs_block.write_offset);
+
+		if constexpr(doubly_linked) {
+			block.node.prev->next = &block.node;
+
+			if(block.node.next != &root_) {
+				block.node.next->prev = &block.node;
+			}
+		} else {
+			auto prev = &root_;
+
+			while(prev->next != &rhs_block.node) {
+				prev = prev->next;
+			}
+
+			prev->next = &block.node;
+		}
+
+		if(tail() == &rhs_block.node) {
+			set_tail(&block.node);
+		}
+
+		inline_free_ = false;
+		rhs.inline_free_ = true;
+	}
+
+	void copy(const dynamic_buffer& rhs) {
+		if(this == &rhs) { // self-assignment
+			return;
+		}
+
+		const node_type* head = rhs.root_.next;
+		node_type* tail = &root_;
+		reset_list();
+		size_ = 0;
+
+		// only the used range of each block is copied, not its spare capacity
+		while(head != &rhs.root_) {
+			const auto source = rhs.buffer_from_node(head);
+			auto buffer = allocate();
+			buffer->read_offset = source->read_offset;
+			buffer->write_offset = source->write_offset;
+			std::memcpy(buffer->read_ptr(), source->read_ptr(), source->size() * sizeof(value_type));
+			link_tail_node(&buffer->node);
+			size_ += buffer->size();
+
+			if(head == rhs.tail()) {
+				tail = &buffer->node;
+			}
+
+			head = head->next;
+		}
+
+		// blocks may follow the tail if the write cursor has been rewound
+		set_tail(tail);
+	}
+	
+#ifdef HEXI_BUFFER_DEBUG
+	void offset_buffers(std::vector<storage_type*>& buffers, size_type offset) {
+		std::erase_if(buffers, [&](auto block) {
+			if(block->size() > offset) {
+				block->read_offset += offset;
+				block->write_offset -= offset;
+				return false;
+			} else {
+				return true;
+			}
+		});
+	}
+#endif
+
+	value_type& byte_at_index(const size_type index) const {
+		assert(index < size_ && "buffer subscript index out of range");
+
+		auto head = root_.next;
+		auto buffer = buffer_from_node(head);
+		const auto offset_index = index + buffer->read_offset;
+		const auto node_index = offset_index / block_sz;
+
+		for(size_type i = 0; i < node_index; ++i) {
+			head = head->next;
+		}
+
+		buffer = buffer_from_node(head);
+		return (*buffer)[offset_index % block_sz];
+	}
+
+	void rewind_write(size_type offset) {
+		auto tail = this->tail();
+
+		if constexpr(doubly_linked) {
+			while(true) {
+				auto buffer = buffer_from_node(tail);
+				const auto max_seek = buffer->size();
+
+				if(max_seek >= offset) {
+					buffer->write_seek(buffer_seek::sk_backward, offset);
+					break;
+				}
+
+				buffer->write_seek(buffer_seek::sk_backward, max_seek);
+				offset -= max_seek;
+				tail = tail->prev;
+			}
+		} else {
+			// no back links, so the new tail has to be found from the head
+			const auto old_tail = tail;
+			auto position = size_;
+			tail = root_.next;
+
+			while(true) {
+				auto buffer = buffer_from_node(tail);
+
+				if(buffer->size() >= position) {
+					buffer->write_seek(buffer_seek::sk_absolute, buffer->read_offset + position);
+					break;
+				}
+
+				position -= buffer->size();
+				tail = tail->next;
+			}
+
+			// blocks between the new and old tail no longer hold any data
+			for(auto node = tail; node != old_tail;) {
+				node = node->next;
+				auto buffer = buffer_from_node(node);
+				buffer->write_seek(buffer_seek::sk_absolute, buffer->read_offset);
+			}
+		}
+
+		set_tail(tail);
+	}
+
+	void forward_write(size_type offset) {
+		auto tail = this->tail();
+
+		while(offset) {
+			auto buffer = buffer_from_node(tail);
+			const auto max_seek = buffer->free();
+
+			if(max_seek >= offset) {
+				buffer->write_seek(buffer_seek::sk_forward, offset);
+				break;
+			}
+
+			buffer->write_seek(buffer_seek::sk_forward, max_seek);
+			offset -= max_seek;
+			tail = tail->next;
+		}
+
+		set_tail(tail);
+	}
+
+	storage_type* take_spare() {
+		if constexpr(max_spares != 0) {
+			if(spares_.head) {
+				auto buffer = buffer_from_node(spares_.head);
+				spares_.head = spares_.head->next;
+				--spares_.count;
+				buffer->clear();
+				return buffer;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool store_spare(storage_type* buffer) {
+		if constexpr(max_spares != 0) {
+			if(spares_.count < max_spares) {
+				buffer->node.next = spares_.head;
+				spares_.head = &buffer->node;
+				++spares_.count;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	[[nodiscard]] storage_type* allocate() {
+		if constexpr(has_inline_block) {
+			if(inline_free_) {
+				inline_free_ = false;
+				return &inline_block_;
+			}
+		}
+
+		if(auto buffer = take_spare()) {
+			return buffer;
+		}
+
+		return allocator_.allocate();
+	}
+
+	void deallocate(storage_type* buffer) {
+		if constexpr(has_inline_block) {
+			if(buffer == &inline_block_) {
+				inline_block_.clear();
+				inline_free_ = true;
+				return;
+			}
+		}
+
+		if(store_spare(buffer)) {
+			return;
+		}
+
+		allocator_.deallocate(buffer);
+	}
+
+	/*
+	 * Links enough new blocks after the tail to hold the given number of
+	 * bytes and makes the first of them the tail. Allocators with a bulk
+	 * interface are asked for the blocks in batches rather than one by one.
+	 * At least one block is always appended, even for zero length.
+	 */
+	storage_type* append_blocks(const size_type length) {
+		auto count = std::max<size_type>(1, (length + block_sz - 1) / block_sz);
+		auto first = allocate();
+
+		if(root_.next == &root_) {
+			apply_headroom(first);
+		}
+
+		link_tail_node(&first->node);
+		--count;
+
+		if constexpr(bulk_allocator<allocator, storage_type>) {
+			std::array<storage_type*, bulk_batch> blocks;
+
+			for(; count; --count) {
+				auto spare = take_spare();
+
+				if(!spare) {
+					break;
+				}
+
+				link_tail_node(&spare->node);
+			}
+
+			while(count) {
+				const auto batch = std::min(count, blocks.size());
+				allocator_.allocate_n(batch, blocks.data());
+
+				for(size_type i = 0; i < batch; ++i) {
+					link_tail_node(&blocks[i]->node);
+				}
+
+				count -= batch;
+			}
+		} else {
+			for(; count; --count) {
+				link_tail_node(&allocate()->node);
+			}
+		}
+
+		set_tail(&first->node);
+		return first;
+	}
+
+	void apply_headroom(storage_type* buffer) {
+		using storage_offset = typename storage_type::offset_type;
+		buffer->read_offset = static_cast<storage_offset>(headroom_);
+		buffer->write_offset = static_cast<storage_offset>(headroom_);
+	}
+
+	/*
+	 * Once the buffer has been drained, the remaining block is reset to its
+	 * starting offsets, so the headroom needs restoring for the next message.
+	 */
+	void restore_headroom() {
+		const auto head = root_.next;
+
+		if(headroom_ && !size_ && head != &root_ && head == tail()) {
+			apply_headroom(buffer_from_node(head));
+		}
+	}
+
+	void deallocate_chain(node_type* head) {
+		if constexpr(bulk_allocator<allocator, storage_type>) {
+			std::array<storage_type*, bulk_batch> blocks;
+			size_type count = 0;
+
+			while(head != &root_) {
+				auto buffer = buffer_from_node(head);
+				head = head->next;
+
+				if constexpr(has_inline_block) {
+					if(buffer == &inline_block_) {
+						deallocate(buffer);
+						continue;
+					}
+				}
+
+				if(store_spare(buffer)) {
+					continue;
+				}
+
+				blocks[count++] = buffer;
+
+				if(count == blocks.size()) {
+					allocator_.deallocate_list(blocks.begin(), blocks.end());
+					count = 0;
+				}
+			}
+
+			allocator_.deallocate_list(blocks.begin(), blocks.begin() + count);
+		} else {
+			while(head != &root_) {
+				auto next = head->next;
+				deallocate(buffer_from_node(head));
+				head = next;
+			}
+		}
+	}
+
+public:
+	dynamic_buffer()
+		: dynamic_buffer(0, allocator()) {}
+
+	/**
+	 * @brief Constructs a buffer that leaves space at the front of its first
+	 * block, allowing for headers to be prepended without allocating.
+	 * 
+	 * @param headroom The number of bytes to leave free. Must be less than
+	 * the block size.
+	 */
+	explicit dynamic_buffer(const size_type headroom)
+		: dynamic_buffer(headroom, allocator()) {}
+
+	/**
+	 * @brief Constructs a buffer that uses the provided allocator instance,
+	 * such as a ref_allocator to a pool owned by a connection.
+	 * 
+	 * @param alloc The allocator to copy.
+	 */
+	explicit dynamic_buffer(const allocator& alloc)
+		: dynamic_buffer(0, alloc) {}
+
+	/**
+	 * @brief Constructs a buffer with headroom that uses the provided
+	 * allocator instance.
+	 * 
+	 * @param headroom The number of bytes to leave free. Must be less than
+	 * the block size.
+	 * @param alloc The allocator to copy.
+	 */
+	dynamic_buffer(const size_type headroom, const allocator& alloc)
+		: size_(0),
+		  headroom_(headroom),
+		  allocator_(alloc) {
+		assert(headroom < block_sz && "headroom must be less than the block size");
+		reset_list();
+
+		if constexpr(has_inline_block) {
+			inline_free_ = true;
+		}
+	}
+
+	~dynamic_buffer() {
+		clear();
+		shrink_to_fit();
+	}
+
+	/*
+	 * The allocator is not propagated, so if it differs from rhs's, the
+	 * data is copied into blocks from our own allocator instead.
+	 */
+	dynamic_buffer& operator=(dynamic_buffer&& rhs) noexcept(!std::equality_comparable<allocator>) {
+		move(rhs);
+		return *this;
+	}
+
+	dynamic_buffer(dynamic_buffer&& rhs) noexcept
+		: dynamic_buffer(rhs.headroom_, rhs.allocator_) {
+		move(rhs);
+	}
+
+	dynamic_buffer(const dynamic_buffer& rhs)
+		: dynamic_buffer(rhs.headroom_, rhs.allocator_) {
+		copy(rhs);
+	}
+
+	dynamic_buffer& operator=(const dynamic_buffer& rhs) {
+		clear();
+		copy(rhs);
+		return *this;
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @note The destination buffer must not overlap with any of the underlying
+	 * buffers being used by the dynamic buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @note The destination buffer must not overlap with any of the underlying
+	 * buffers being used by the dynamic buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) override {
+		assert(length <= size_ && "Chained buffer read too large!");
+		size_type remaining = length;
+
+		while(true) {
+			auto buffer = buffer_from_node(root_.next);
+			remaining -= buffer->read(
+				static_cast<value_type*>(destination) + length - remaining, remaining,
+				                         root_.next == tail()
+			);
+
+			if(remaining) [[unlikely]] {
+				unlink_head();
+				deallocate(buffer);
+			} else {
+				break;
+			}
+		}
+
+		size_ -= length;
+		restore_headroom();
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the container's read cursor.
+	 * 
+	 * @note The source buffer must not overlap with any of the underlying
+	 * buffers being used by the dynamic buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the container's read cursor.
+	 * 
+	 * @note The destination buffer must not overlap with any of the underlying
+	 * buffers being used by the dynamic buffer.
+	 * 
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, const size_type length) const override {
+		assert(length <= size_ && "Chained buffer copy too large!");
+		size_type remaining = length;
+		auto head = root_.next;
+
+		while(true) {
+			const auto buffer = buffer_from_node(head);
+			remaining -= buffer->copy(
+				static_cast<value_type*>(destination) + length - remaining, remaining
+			);
+
+			if(remaining) [[unlikely]] {
+				head = head->next;
+			} else {
+				break;
+			}
+		}
+	}
+
+#ifdef HEXI_BUFFER_DEBUG
+	/**
+	 * @brief Retrives underlying buffers owned by the dynamic buffer.
+	 *
+	 * @param length Limit returned buffers to those holding up to the requested amount
+	 * of data.
+	 * @param offset The offset to start at.
+	 * 
+	 * @return Container of pointers to the underlying buffers holding the range of data
+	 * requested by length and offset.
+	 */
+	std::vector<storage_type*> fetch_buffers(const size_type length, const size_type offset = 0) {
+		size_type total = length + offset;
+		assert(total <= size_ && "Chained buffer fetch too large!");
+		std::vector<storage_type*> buffers;
+		auto head = root_.next;
+
+		while(total) {
+			auto buffer = buffer_from_node(head);
+			size_type read_size = block_sz - buffer->read_offset;
+			
+			// guard against overflow - buffer may have more content than requested
+			if(read_size > total) {
+				read_size = total;
+			}
+
+			buffers.emplace_back(buffer);
+			total -= read_size;
+			head = head->next;
+		}
+
+		if(offset) {
+			offset_buffers(buffers, offset);
+		}
+
+		return buffers;
+	}
+#endif
+
+	/**
+	 * @brief Skip the requested number of bytes.
+	 *
+	 * Skips over a number of bytes from the container. This should be used
+	 * if the container holds data that you don't care about but don't want
+	 * to have to read it to another buffer to access data beyond it.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) override {
+		assert(length <= size_ && "Chained buffer skip too large!");
+		size_type remaining = length;
+
+		while(true) {
+			auto buffer = buffer_from_node(root_.next);
+			remaining -= buffer->skip(remaining, root_.next == tail());
+
+			if(remaining) [[unlikely]] {
+				unlink_head();
+				deallocate(buffer);
+			} else {
+				break;
+			}
+		}
+
+		size_ -= length;
+		restore_headroom();
+	}
+
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @note The source buffer must not overlap with any of the underlying buffers
+	 * being used by the dynamic buffer.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
+
+	/**
+	 * @brief Write provided data to the container.
+	 * 
+	 * @note The source buffer must not overlap with any of the underlying buffers
+	 * being used by the dynamic buffer.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, const size_type length) override {
+		size_type remaining = length;
+		node_type* tail = this->tail();
+
+		while(true) {
+			storage_type* buffer;
+
+			if(tail != &root_) [[likely]] {
+				buffer = buffer_from_node(tail);
+			} else {
+				buffer = append_blocks(remaining);
+				tail = &buffer->node;
+			}
+
+			remaining -= buffer->write(
+				static_cast<const value_type*>(source) + length - remaining, remaining
+			);
+
+			if(!remaining) [[likely]] {
+				break;
+			}
+
+			tail = tail->next;
+
+			if(tail != &root_) {
+				set_tail(tail);
+			}
+		}
+
+		size_ += length;
+	}
+
+	/**
+	 * @brief Reserves a number of bytes within the container for future use.
+	 * 
+	 * @param length The number of bytes that the container should reserve.
+	 */
+	void reserve(const size_type length) override {
+		size_type remaining = length;
+		node_type* tail = this->tail();
+
+		while(true) {
+			storage_type* buffer;
+
+			if(tail == &root_) [[unlikely]] {
+				buffer = append_blocks(remaining);
+				tail = &buffer->node;
+			} else {
+				buffer = buffer_from_node(tail);
+			}
+
+			remaining -= buffer->advance_write(remaining);
+
+			if(!remaining) {
+				break;
+			}
+
+			tail = tail->next;
+
+			if(tail != &root_) {
+				set_tail(tail);
+			}
+		}
+
+		size_ += length;
+	}
+
+	/**
+	 * @brief Write provided data to the front of the container, ahead of
+	 * any data that has not yet been read.
+	 * 
+	 * The headroom in the first block is used first, with new blocks being
+	 * linked ahead of it if that isn't enough. Existing data is never moved,
+	 * so the cost is proportional to the length of the prepended data.
+	 * 
+	 * @note The source buffer must not overlap with any of the underlying buffers
+	 * being used by the dynamic buffer.
+	 * 
+	 * @param source Pointer to the data to be prepended.
+	 * @param length Number of bytes to prepend from the source.
+	 */
+	void prepend(const void* source, const size_type length) {
+		if(root_.next == &root_) {
+			write(source, length);
+			return;
+		}
+
+		using storage_offset = typename storage_type::offset_type;
+		auto src = static_cast<const value_type*>(source);
+		auto remaining = length;
+
+		// fill backwards from the end of the source
+		auto head = buffer_from_node(root_.next);
+		const auto count = std::min<size_type>(remaining, head->read_offset);
+		head->read_offset -= static_cast<storage_offset>(count);
+		remaining -= count;
+		std::memcpy(head->storage.data() + head->read_offset, src + remaining, count);
+
+		while(remaining) {
+			auto buffer = allocate();
+			const auto block_count = std::min<size_type>(remaining, block_sz);
+			buffer->read_offset = static_cast<storage_offset>(block_sz - block_count);
+			buffer->write_offset = static_cast<storage_offset>(block_sz);
+			remaining -= block_count;
+			std::memcpy(buffer->storage.data() + buffer->read_offset, src + remaining, block_count);
+			link_head_node(&buffer->node);
+		}
+
+		size_ += length;
+	}
+
+	/**
+	 * @brief Moves all of the data in another buffer to the end of this
+	 * one, leaving the other buffer empty.
+	 * 
+	 * Where possible, the other buffer's blocks are linked directly onto the
+	 * end of the list, rather than copying. That requires that both buffers
+	 * use the same allocator, that this buffer's final block is full (or that
+	 * it has no blocks) and that the data in the other buffer starts at the
+	 * beginning of its first block. Otherwise, the data is copied.
+	 * 
+	 * @param rhs The buffer to take the data from.
+	 */
+	void splice(dynamic_buffer& rhs) {
+		if(this == &rhs || rhs.root_.next == &rhs.root_) {
+			return;
+		}
+
+		const auto tail = this->tail();
+		const auto first = rhs.root_.next;
+		const auto last = rhs.tail();
+		bool linkable = same_allocator(rhs)
+			&& last != &rhs.root_
+			&& last->next == &rhs.root_
+			&& tail->next == &root_
+			&& (tail == &root_ || (!buffer_from_node(tail)->free()
+				&& !buffer_from_node(first)->read_offset));
+
+		if constexpr(has_inline_block) {
+			linkable = linkable && rhs.inline_free_;
+		}
+
+		if(!linkable) {
+			for(auto node = first; node != &rhs.root_; node = node->next) {
+				const auto buffer = rhs.buffer_from_node(node);
+
+				if(buffer->size()) {
+					write(buffer->read_ptr(), buffer->size());
+				}
+			}
+
+			rhs.clear();
+			return;
+		}
+
+		tail->next = first;
+
+		if constexpr(doubly_linked) {
+			first->prev = tail;
+		}
+
+		last->next = &root_;
+		set_tail(last);
+		size_ += rhs.size_;
+		rhs.size_ = 0;
+		rhs.reset_list();
+	}
+
+	/**
+	 * @brief Retrieves the amount of space at the front of the container
+	 * that can be prepended to without allocating.
+	 * 
+	 * @return The number of bytes of headroom available.
+	 */
+	size_type headroom() const {
+		if(root_.next == &root_) {
+			return headroom_;
+		}
+
+		return buffer_from_node(root_.next)->read_offset;
+	}
+
+	/**
+	 * @brief Reserves space at the write cursor to be filled in later. The
+	 * position is recorded directly, so filling it does not need to seek.
+	 * 
+	 * @note The placeholder is invalidated by clear(), a write seek that
+	 * rewinds over it or once its contents have been read.
+	 * 
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
+	 */
+	placeholder_type reserve_placeholder(const size_type length) {
+		const auto tail = this->tail();
+		auto node = tail;
+		offset_type offset = 0;
+
+		if(node != &root_ && buffer_from_node(node)->free()) {
+			offset = buffer_from_node(node)->write_offset;
+		} else {
+			// begins in the following block, which may not exist yet
+			node = node->next;
+
+			if(node != &root_) {
+				offset = buffer_from_node(node)->write_offset;
+			}
+		}
+
+		reserve(length);
+
+		if(node == &root_) {
+			node = tail->next;
+			offset = buffer_from_node(node)->read_offset;
+		}
+
+		return { node, offset };
+	}
+
+	/**
+	 * @brief Writes data into previously reserved space.
+	 * 
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(const placeholder_type& placeholder, const void* source, size_type length) {
+		auto src = static_cast<const value_type*>(source);
+		auto node = placeholder.node;
+		auto offset = placeholder.offset;
+
+		while(length) {
+			auto buffer = buffer_from_node(node);
+			const auto count = std::min<size_type>(length, block_sz - offset);
+			std::memcpy(buffer->storage.data() + offset, src, count);
+			src += count;
+			length -= count;
+			node = node->next;
+
+			if(node != &root_) {
+				offset = buffer_from_node(node)->read_offset;
+			}
+		}
+	}
+
+	/**
+	 * @brief Returns the size of the container.
+	 * 
+	 * @return The number of bytes of data available to read within the container.
+	 */
+	size_type size() const override {
+		return size_;
+	}
+
+	/**
+	 * @brief Retrieves the last buffer in the container's list.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 * @note The container retains ownership over the buffer, so it must not
+	 * be deallocated by the caller.
+	 */
+	storage_type* back() const {
+		if(tail() == &root_) {
+			return nullptr;
+		}
+
+		return buffer_from_node(tail());
+	}
+
+	/**
+	 * @brief Retrieves the buffer's block sized.
+	 * 
+	 * @param index The index within the buffer.
+	 * @return A reference to the value at the specified index.
+	 */
+	storage_type* front() const {
+		if(root_.next == &root_) {
+			return nullptr;
+		}
+
+		return buffer_from_node(root_.next);
+	}
+
+	/**
+	 * @brief Removes the first buffer from the container.
+	 * 
+	 * @return A pointer to the popped buffer.
+	 * 
+	 * @note Removing the buffer from the container also transfers ownership.
+	 * Therefore, the caller assumes responsibility for deallocating the buffer
+	 * when it is no longer required. Alternatively, it can be pushed back into
+	 * the container to transfer ownership back.
+	 */
+	auto pop_front() {
+		auto buffer = buffer_from_node(root_.next);
+		size_ -= buffer->size();
+		unlink_head();
+		return unique_storage(buffer, [&](auto ptr) {
+			deallocate(ptr);
+		});
+	}
+
+	/**
+	 * @brief Attaches additional storage to the container.
+	 * 
+	 * @param buffer The block to add to the container.
+	 * 
+	 * @note Once pushed, the container is assumed to have ownership over the buffer.
+	 * The buffer storage must have been allocated by the same allocator as the container.
+	 */
+	void push_back(storage_type* buffer) {
+		link_tail_node(&buffer->node);
+		size_ += buffer->write_offset;
+	}
+
+	/**
+	 * @brief Advances the write cursor.
+	 * 
+	 * @param size The number of bytes by which the write cursor to advance the cursor.
+	 */
+	void advance_write(const size_type size) {
+		auto buffer = buffer_from_node(tail());
+		const auto actual = buffer->advance_write(size);
+		assert(size <= block_sz && actual <= size &&
+		       "Attempted to advance write cursor out of bounds!");
+		size_ += size;
+	}
+
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	bool can_write_seek() const override {
+		return std::is_same_v<seeking, supported>;
+	}
+
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking.
+	 */
+	void write_seek(const buffer_seek direction, size_type offset) override {
+		switch(direction) {
+			case buffer_seek::sk_backward:
+				size_ -= offset;
+				rewind_write(offset);
+				break;
+			case buffer_seek::sk_forward:
+				size_ += offset;
+				forward_write(offset);
+				break;
+			case buffer_seek::sk_absolute:
+				if(offset < size_) {
+					write_seek(buffer_seek::sk_backward, size_ - offset);
+				} else if(offset > size_) {
+					write_seek(buffer_seek::sk_forward, offset - size_);
+				}
+				break;
+		}
+	}
+
+	/**
+	 * @brief Clears the container.
+	 * 
+	 * @note Blocks may be kept as spares, depending on the spare policy.
+	 */
+	void clear() {
+		deallocate_chain(root_.next);
+		reset_list();
+		size_ = 0;
+	}
+
+	/**
+	 * @brief Returns any spare blocks held by the container to the allocator.
+	 */
+	void shrink_to_fit() {
+		if constexpr(max_spares != 0) {
+			while(spares_.head) {
+				auto node = spares_.head;
+				spares_.head = node->next;
+				allocator_.deallocate(buffer_from_node(node));
+			}
+
+			spares_.count = 0;
+		}
+	}
+
+	/**
+	 * @brief Retrieves the number of drained blocks being held for reuse.
+	 * 
+	 * @return The number of spare blocks.
+	 */
+	size_type spare_count() const {
+		if constexpr(max_spares != 0) {
+			return spares_.count;
+		} else {
+			return 0;
+		}
+	}
+
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() const override {
+		return !size_;
+	}
+
+	/**
+	 * @brief Retrieves the container's block size.
+	 * 
+	 * @return The block size.
+	 */
+	constexpr static size_type block_size() {
+		return block_sz;
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const size_type index) override {
+		return byte_at_index(index);
+	}
+
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const size_type index) const override {
+		return byte_at_index(index);
+	}
+
+	/**
+	 * @brief Retrieves the number of allocated blocks currently being used by the container.
+	 * 
+	 * @return The number of allocated blocks.
+	 */
+	size_type block_count() const {
+		auto node = &root_;
+		size_type count = 0;
+
+		// not calculating based on block size & size as it
+		// wouldn't play nice with seeking or manual push/pop
+		while(node->next != tail()->next) {
+			++count;
+			node = node->next;
+		}
+
+		return count;
+	}
+
+	/**
+	 * Read-only iterator over the data held by each of the buffer's blocks,
+	 * allowing the data to be processed in place without consuming it.
+	 */
+	class block_iterator {
+		const dynamic_buffer* buffer_ = nullptr;
+		const node_type* node_ = nullptr;
+
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using value_type = std::span<const storage_value_type>;
+		using difference_type = std::ptrdiff_t;
+
+		block_iterator() = default;
+
+		block_iterator(const dynamic_buffer* buffer, const node_type* node)
+			: buffer_(buffer), node_(node) {}
+
+		value_type operator*() const {
+			return buffer_->buffer_from_node(node_)->read_data();
+		}
+
+		block_iterator& operator++() {
+			node_ = node_->next;
+			return *this;
+		}
+
+		block_iterator operator++(int) {
+			auto current = *this;
+			node_ = node_->next;
+			return current;
+		}
+
+		bool operator==(const block_iterator& rhs) const {
+			return node_ == rhs.node_;
+		}
+	};
+
+	/**
+	 * @brief Provides a view over the readable data in each block, in order.
+	 * 
+	 * @return Range of spans, one per block.
+	 */
+	std::ranges::subrange<block_iterator> blocks() const {
+		return { block_iterator(this, root_.next), block_iterator(this, &root_) };
+	}
+
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(value_type value) const override {
+		size_type index = 0;
+		auto head = root_.next;
+
+		while(head != &root_) {
+			const auto buffer = buffer_from_node(head);
+			const auto data = buffer->read_data();
+			
+			for(const auto& byte : data) {
+				if(byte == value) {
+					return index;
+				}
+
+				++index;
+			}
+
+			head = head->next;
+		}
+
+		return npos;
+	}
+
+	/**
+	 * @brief Retrieves the container's allocator.
+	 * 
+	 * @return The memory allocator.
+	 */
+	auto& get_allocator() {
+		return allocator_;
+	}
+
+	/**
+	 * @brief Retrieves the container's allocator.
+	 * 
+	 * @return The memory allocator.
+	 */
+	auto& get_allocator() const {
+		return allocator_;
+	}
+
+	template<typename buffer_type>
+	friend class buffer_sequence;
+};
+
+} // hexi
+
+// #include <hexi/dynamic_tls_buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/dynamic_buffer.h>
+
+// #include <hexi/allocators/tls_block_allocator.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/allocators/block_allocator.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define HEXI_HAS_MMAP
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HEXI_HAS_NUMA
+#endif
+
+#ifndef NDEBUG
+#define HEXI_DEBUG_ALLOCATORS
+#endif
+
+namespace hexi {
+
+namespace impl {
+
+struct free_block {
+	free_block* next;
+};
+
+template<decltype(auto) size>
+concept gt_zero = size > 0;
+
+template<typename T, typename U>
+concept sizeof_gte = sizeof(T) >= sizeof(U);
+
+constexpr std::size_t page_size = 4096;
+constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+constexpr std::size_t round_up(std::size_t value, std::size_t multiple) {
+	return (value + multiple - 1) / multiple * multiple;
+}
+
+/*
+ * @return The NUMA node the calling thread is currently running on or -1
+ * if it cannot be determined.
+ */
+inline int current_numa_node() {
+#if defined(HEXI_HAS_NUMA) && defined(SYS_getcpu)
+	unsigned int cpu = 0, node = 0;
+
+	if(::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+		return static_cast<int>(node);
+	}
+#endif
+	return -1;
+}
+
+/*
+ * Sets a preferred node policy on a page aligned range that has not yet
+ * been touched. Preferred rather than strict binding is used so that an
+ * exhausted node results in remote memory rather than an OOM kill.
+ *
+ * @return True if the policy was applied.
+ */
+inline bool numa_bind(void* ptr, std::size_t length, int node) {
+#if defined(HEXI_HAS_NUMA) && defined(SYS_mbind)
+	constexpr int mpol_preferred = 1;
+	constexpr auto mask_bits = sizeof(unsigned long) * 8;
+
+	if(node < 0 || static_cast<std::size_t>(node) >= mask_bits) {
+		return false;
+	}
+
+	const unsigned long mask = 1ul << node;
+	return ::syscall(SYS_mbind, ptr, length, mpol_preferred, &mask, mask_bits + 1, 0) == 0;
+#else
+	return false;
+#endif
+}
+
+/*
+ * Slab embedded directly within the allocator object.
+ */
+template<std::size_t size, std::size_t alignment>
+class inline_slab_storage final {
+	alignas(alignment) std::array<char, size> storage_;
+
+public:
+	char* data() {
+		return storage_.data();
+	}
+
+	const char* data() const {
+		return storage_.data();
+	}
+
+	bool huge_pages() const {
+		return false;
+	}
+
+	// relies on first-touch placement
+	bool bind(int /*node*/) {
+		return false;
+	}
+};
+
+/*
+ * Slab obtained directly from the OS with anonymous mappings. If huge pages
+ * are requested, an explicit MAP_HUGETLB mapping is tried first and if no
+ * huge pages have been reserved, the slab falls back to a huge page aligned
+ * regular mapping with transparent huge pages requested via madvise.
+ *
+ * Platforms without mmap fall back to an aligned operator new.
+ */
+template<std::size_t size, std::size_t alignment, bool use_huge_pages>
+class mapped_slab_storage final {
+	static_assert(alignment <= page_size, "mapped slabs are page aligned at most");
+
+	static constexpr std::size_t map_size = use_huge_pages?
+		round_up(size, huge_page_size) : round_up(size, page_size);
+
+	char* storage_ = nullptr;
+	bool huge_ = false;
+
+#ifdef HEXI_HAS_MMAP
+	static char* map(std::size_t length, int flags = 0) {
+		auto ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+		                  MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+		return ptr == MAP_FAILED? nullptr : static_cast<char*>(ptr);
+	}
+
+	// over-map and trim so the slab starts on a huge page boundary
+	static char* map_aligned_thp() {
+		constexpr auto length = map_size + huge_page_size;
+		auto base = map(length);
+
+		if(!base) {
+			return nullptr;
+		}
+
+		const auto addr = reinterpret_cast<std::uintptr_t>(base);
+		const auto aligned = round_up(addr, huge_page_size);
+		const auto head = aligned - addr;
+		const auto tail = length - head - map_size;
+
+		if(head) {
+			::munmap(base, head);
+		}
+
+		if(tail) {
+			::munmap(base + head + map_size, tail);
+		}
+
+		auto slab = base + head;
+#ifdef MADV_HUGEPAGE
+		::madvise(slab, map_size, MADV_HUGEPAGE);
+#endif
+		return slab;
+	}
+#endif
+
+public:
+	mapped_slab_storage() {
+#ifdef HEXI_HAS_MMAP
+		if constexpr(use_huge_pages) {
+#ifdef MAP_HUGETLB
+			storage_ = map(map_size, MAP_HUGETLB);
+			huge_ = storage_ != nullptr;
+#endif
+			if(!storage_) {
+				storage_ = map_aligned_thp();
+			}
+		} else {
+			storage_ = map(map_size);
+		}
+
+		if(!storage_) {
+			throw std::bad_alloc();
+		}
+#else
+		storage_ = static_cast<char*>(
+			::operator new(map_size, std::align_val_t(alignment))
+		);
+#endif
+	}
+
+	mapped_slab_storage(const mapped_slab_storage&) = delete;
+	mapped_slab_storage& operator=(const mapped_slab_storage&) = delete;
+
+	~mapped_slab_storage() {
+#ifdef HEXI_HAS_MMAP
+		::munmap(storage_, map_size);
+#else
+		::operator delete(storage_, std::align_val_t(alignment));
+#endif
+	}
+
+	char* data() {
+		return storage_;
+	}
+
+	const char* data() const {
+		return storage_;
+	}
+
+	/**
+	 * @return True if the slab is backed by explicitly reserved huge pages.
+	 * Transparent huge pages are a best-effort request and are not reported.
+	 */
+	bool huge_pages() const {
+		return huge_;
+	}
+
+	/**
+	 * @brief Requests that the slab's pages be placed on the given NUMA node.
+	 * Must be called before the slab is first touched.
+	 * 
+	 * @param node The NUMA node.
+	 * 
+	 * @return True if the placement policy was applied.
+	 */
+	bool bind(int node) {
+#ifdef HEXI_HAS_MMAP
+		return numa_bind(storage_, map_size, node);
+#else
+		return false;
+#endif
+	}
+};
+
+} // impl
+
+struct no_validate_dealloc {};
+struct validate_dealloc : no_validate_dealloc {};
+
+struct natural_alignment {
+	static constexpr std::size_t alignment = 1;
+};
+
+struct cache_line_alignment : natural_alignment {
+	static constexpr std::size_t alignment = 64;
+};
+
+struct page_alignment : natural_alignment {
+	static constexpr std::size_t alignment = impl::page_size;
+};
+
+struct inline_slab {};
+struct mapped_slab : inline_slab {};
+struct huge_page_slab : inline_slab {};
+
+/**
+ * Basic fixed-size block stack allocator that preallocates a slab of memory
+ * capable of holding a compile-time determined number of elements.
+ * When constructed, a linked list of chunks is built within the slab and
+ * each allocation request will take the head node. Since the allocations
+ * are fixed-size, the list does not need to be traversed for a suitable
+ * size. Deallocations place the chunk as the new head (LIFO).
+ *
+ * If the preallocated slab runs out of chunks, it will fall back to using the
+ * system allocator rather than allocating additional slabs. This means sizing
+ * the initial allocation correctly is important for maximum performance, so
+ * it's better to be pessimistic. This is a server application and RAM is cheap. :)
+ *
+ * The slab is carved up lazily. Blocks that have never been handed out are
+ * taken from a bump pointer, with the free list only holding blocks that
+ * have been returned, so untouched capacity costs nothing until it's needed.
+ * prefault() can be used to pay for faulting in the slab up front instead.
+ *
+ * Blocks in the slab carry no inline metadata. Whether a block came from
+ * the slab is determined by its address and any per-block bookkeeping lives
+ * in a side table, so the objects are packed at exactly the requested stride.
+ *
+ * ThreadPolicy: 'same_thread' triggers an assert if an allocated object
+ * is deallocated from a different thread. Used by the TLS allocator, since
+ * implementing the functionality there is messier (and slower).
+ *
+ * Other threads may hand blocks back with deallocate_remote(), which is
+ * thread-safe. Such blocks are reclaimed by the owning thread once its
+ * free list runs dry.
+ *
+ * AlignPolicy: 'cache_line_alignment' and 'page_alignment' round the block
+ * stride up to the given boundary so that no two blocks share a line/page.
+ *
+ * SlabPolicy: 'inline_slab' embeds the slab within the allocator, 'mapped_slab'
+ * requests it from the OS and 'huge_page_slab' additionally requests that
+ * it be backed by huge pages to reduce TLB pressure with large pools.
+ */
+template<typename _ty, 
+	std::size_t _elements,
+	std::derived_from<no_validate_dealloc> ValidatePolicy = no_validate_dealloc,
+	std::derived_from<natural_alignment> AlignPolicy = natural_alignment,
+	std::derived_from<inline_slab> SlabPolicy = inline_slab>
+requires impl::gt_zero<_elements> && impl::sizeof_gte<_ty, impl::free_block>
+class block_allocator {
+	static constexpr bool validate = std::is_same_v<ValidatePolicy, validate_dealloc>;
+
+	using tid_type = std::conditional_t<validate, std::thread::id, std::monostate>;
+
+public:
+	static constexpr std::size_t alignment = std::max(alignof(_ty), AlignPolicy::alignment);
+	static constexpr std::size_t block_size = impl::round_up(sizeof(_ty), alignment);
+	static constexpr std::size_t slab_size = block_size * _elements;
+
+private:
+	using slab_type = std::conditional_t<
+		std::is_same_v<SlabPolicy, inline_slab>,
+		impl::inline_slab_storage<slab_size, alignment>,
+		impl::mapped_slab_storage<slab_size, alignment, std::is_same_v<SlabPolicy, huge_page_slab>>
+	>;
+
+	using side_table = std::conditional_t<
+		validate, std::array<std::thread::id, _elements>, std::monostate
+	>;
+
+	// only used when the slab has been exhausted
+	struct heap_block {
+		alignas(alignment) _ty obj;
+		block_allocator* owner;
+		[[no_unique_address]] tid_type thread_id;
+	};
+
+	impl::free_block* head_ = nullptr;
+	std::size_t bump_ = 0; // index of the first block never handed out
+	std::atomic<impl::free_block*> remote_head_ = nullptr;
+	int numa_node_ = -1;
+	[[no_unique_address]] tid_type thread_id_;
+	[[no_unique_address]] side_table owners_{};
+	slab_type slab_;
+
+	inline void push(impl::free_block* block) {
+		assert(block);
+		block->next = head_;
+		head_ = block;
+	}
+
+	[[nodiscard]] inline void* pop() {
+		if(head_) [[likely]] {
+			auto block = head_;
+			head_ = block->next;
+			return block;
+		}
+
+		if(bump_ < _elements) {
+			return slab_.data() + (block_size * bump_++);
+		}
+
+		return nullptr;
+	}
+
+	inline void validate_slab_block(const void* ptr) const {
+		if constexpr(validate) {
+			assert(owners_[slab_index(ptr)] == thread_id_
+				&& "thread policy violation or clobbered block");
+		}
+	}
+
+	// returns a block that has already been destroyed to the slab or heap
+	inline void release(void* ptr) {
+		if(owns(ptr)) [[likely]] {
+			validate_slab_block(ptr);
+#ifdef HEXI_DEBUG_ALLOCATORS
+			--storage_active_count;
+#endif
+			push(static_cast<impl::free_block*>(ptr));
+		} else {
+			auto block = static_cast<heap_block*>(ptr);
+			assert(block->owner == this && "block belongs to another allocator");
+
+			if constexpr(validate) {
+				assert(block->thread_id == thread_id_
+					&& "thread policy violation or clobbered block");
+			}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+			--new_active_count;
+#endif
+			::operator delete(block, std::align_val_t(alignof(heap_block)));
+		}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_deallocs;
+		--active_count;
+#endif
+	}
+
+	void drain_remote() {
+		auto block = remote_head_.exchange(nullptr, std::memory_order_acquire);
+
+		while(block) {
+			auto next = block->next;
+			release(block);
+			block = next;
+#ifdef HEXI_DEBUG_ALLOCATORS
+			++remote_frees;
+#endif
+		}
+	}
+
+	inline std::size_t slab_index(const void* ptr) const {
+		const auto base = reinterpret_cast<std::uintptr_t>(slab_.data());
+		return (reinterpret_cast<std::uintptr_t>(ptr) - base) / block_size;
+	}
+
+public:
+#ifdef HEXI_DEBUG_ALLOCATORS
+	std::size_t storage_active_count = 0;
+	std::size_t new_active_count = 0;
+	std::size_t active_count = 0;
+	std::size_t total_allocs = 0;
+	std::size_t total_deallocs = 0;
+	std::size_t remote_frees = 0;
+#endif
+
+	/**
+	 * @param numa_node If not negative, the NUMA node the slab should be
+	 * placed on. Mapped slabs are bound to the node; inline slabs rely on
+	 * first-touch, which occurs on the constructing thread.
+	 */
+	explicit block_allocator(int numa_node = -1) requires validate
+		: numa_node_(numa_node), thread_id_(std::this_thread::get_id()) {
+		if(numa_node >= 0) {
+			slab_.bind(numa_node);
+		}
+	}
+
+	explicit block_allocator(int numa_node = -1)
+		: numa_node_(numa_node) {
+		if(numa_node >= 0) {
+			slab_.bind(numa_node);
+		}
+	}
+
+	block_allocator(const block_allocator&) = delete;
+	block_allocator& operator=(const block_allocator&) = delete;
+
+	template<typename ...Args>
+	[[nodiscard]] inline _ty* allocate(Args&&... args) {
+		void* block = pop();
+
+		if(!block && remote_head_.load(std::memory_order_relaxed)) [[unlikely]] {
+			drain_remote();
+			block = pop();
+		}
+
+		if(block) [[likely]] {
+#ifdef HEXI_DEBUG_ALLOCATORS
+			++storage_active_count;
+#endif
+			if constexpr(validate) {
+				owners_[slab_index(block)] = thread_id_;
+			}
+		} else {
+#ifdef HEXI_DEBUG_ALLOCATORS
+			++new_active_count;
+#endif
+			auto hblock = static_cast<heap_block*>(::operator new(
+				sizeof(heap_block), std::align_val_t(alignof(heap_block))
+			));
+
+			hblock->owner = this;
+
+			if constexpr(validate) {
+				std::construct_at(&hblock->thread_id, thread_id_);
+			}
+
+			block = hblock;
+		}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_allocs;
+		++active_count;
+#endif
+		return new (block) _ty(std::forward<Args>(args)...);
+	}
+
+	inline void deallocate(_ty* t) {
+		assert(t);
+		t->~_ty();
+		release(t);
+	}
+
+	/**
+	 * @brief Allocates and default constructs a number of objects.
+	 * 
+	 * The run of blocks is detached from the free list in a single
+	 * operation, followed by a contiguous run of blocks from the untouched
+	 * part of the slab. Any shortfall is made up by the system allocator.
+	 * 
+	 * @param count The number of objects to allocate.
+	 * @param out Output iterator that receives a pointer to each object.
+	 * 
+	 * @return The output iterator, one past the last written element.
+	 */
+	template<std::output_iterator<_ty*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		if(!head_ && remote_head_.load(std::memory_order_relaxed)) [[unlikely]] {
+			drain_remote();
+		}
+
+		// find where the run ends and cut it from the list
+		auto run = head_;
+		auto cut = head_;
+		std::size_t taken = 0;
+
+		while(cut && taken < count) {
+			cut = cut->next;
+			++taken;
+		}
+
+		head_ = cut;
+
+		for(std::size_t i = 0; i < taken; ++i) {
+			auto next = run->next;
+
+			if constexpr(validate) {
+				owners_[slab_index(run)] = thread_id_;
+			}
+
+			*out++ = new (run) _ty();
+			run = next;
+		}
+
+		// then carve whatever remains from the untouched part of the slab
+		const auto carved = std::min(count - taken, _elements - bump_);
+		auto block = slab_.data() + (block_size * bump_);
+		bump_ += carved;
+
+		for(std::size_t i = 0; i < carved; ++i, block += block_size) {
+			if constexpr(validate) {
+				owners_[slab_index(block)] = thread_id_;
+			}
+
+			*out++ = new (block) _ty();
+		}
+
+		taken += carved;
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		storage_active_count += taken;
+		total_allocs += taken;
+		active_count += taken;
+#endif
+
+		for(std::size_t i = taken; i < count; ++i) {
+			*out++ = allocate();
+		}
+
+		return out;
+	}
+
+	/**
+	 * @brief Deallocates and destructs a range of objects.
+	 * 
+	 * Blocks belonging to the slab are linked together and spliced onto
+	 * the free list in a single operation.
+	 * 
+	 * @param first Iterator to the first object pointer.
+	 * @param last Iterator one past the last object pointer.
+	 */
+	template<std::input_iterator InputIt>
+	requires std::convertible_to<std::iter_value_t<InputIt>, _ty*>
+	void deallocate_list(InputIt first, InputIt last) {
+		impl::free_block* run_head = nullptr;
+		impl::free_block* run_tail = nullptr;
+		[[maybe_unused]] std::size_t count = 0;
+
+		for(; first != last; ++first) {
+			_ty* t = *first;
+			assert(t);
+
+			if(!owns(t)) [[unlikely]] {
+				deallocate(t);
+				continue;
+			}
+
+			validate_slab_block(t);
+			t->~_ty();
+
+			auto block = reinterpret_cast<impl::free_block*>(t);
+			block->next = run_head;
+			run_head = block;
+
+			if(!run_tail) {
+				run_tail = block;
+			}
+
+			++count;
+		}
+
+		if(run_tail) {
+			run_tail->next = head_;
+			head_ = run_head;
+		}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		storage_active_count -= count;
+		total_deallocs += count;
+		active_count -= count;
+#endif
+	}
+
+	/**
+	 * @brief Deallocates and destructs an object from a thread other than
+	 * the owning thread. The block is reclaimed by the owner at a later point.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate_remote(_ty* t) {
+		assert(t);
+		t->~_ty();
+
+		auto block = reinterpret_cast<impl::free_block*>(t);
+		block->next = remote_head_.load(std::memory_order_relaxed);
+
+		while(!remote_head_.compare_exchange_weak(block->next, block,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/**
+	 * @brief Touches every page of the slab that hasn't yet been used, so
+	 * that the cost of faulting them in is paid now rather than by later
+	 * allocations.
+	 */
+	void prefault() {
+		const auto storage = slab_.data();
+		const auto begin = bump_ * block_size;
+
+		for(auto offset = begin; offset < slab_size; offset += impl::page_size) {
+			*static_cast<volatile char*>(storage + offset) = 0;
+		}
+
+		if(begin < slab_size) {
+			*static_cast<volatile char*>(storage + slab_size - 1) = 0;
+		}
+	}
+
+	/**
+	 * @brief Determines whether a block was allocated from the slab
+	 * rather than the system allocator.
+	 * 
+	 * @param ptr Pointer to the block.
+	 * 
+	 * @return True if the block lies within the slab.
+	 */
+	inline bool owns(const void* ptr) const {
+		const auto base = reinterpret_cast<std::uintptr_t>(slab_.data());
+		const auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+		return addr >= base && addr < base + slab_size;
+	}
+
+	/**
+	 * @return The number of slab blocks that have never been handed out.
+	 */
+	std::size_t untouched() const {
+		return _elements - bump_;
+	}
+
+	/**
+	 * @return True if the slab is backed by explicitly reserved huge pages.
+	 */
+	bool huge_pages() const {
+		return slab_.huge_pages();
+	}
+
+	/**
+	 * @return The NUMA node the slab was placed on or -1 if the allocator
+	 * is not NUMA-aware or the node could not be determined.
+	 */
+	int numa_node() const {
+		return numa_node_;
+	}
+
+	~block_allocator() {
+		drain_remote();
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		assert(active_count == 0);
+#endif
+	}
+};
+
+} // hexi
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef NDEBUG
+#define HEXI_DEBUG_ALLOCATORS
+#endif
+
+namespace hexi {
+
+struct safe_entrant {};
+struct no_ref_counting {};
+
+struct numa_unaware {};
+
+struct unsafe_entrant : safe_entrant {};
+struct ref_counting : no_ref_counting {};
+struct numa_local : numa_unaware {};
+
+/*
+ * NumaPolicy: 'numa_local' places each thread's slab on the NUMA node the
+ * thread is running on when its allocator is created. Mapped slabs are bound
+ * with mbind, inline slabs rely on first-touch. Blocks deallocated by a
+ * thread other than the one that allocated them are routed back to the
+ * owning allocator rather than being mixed into the local pool. Without
+ * NUMA support, the node is reported as -1 and only routing is performed.
+ * 
+ * To route frees, each block records the allocator it came from, which adds
+ * a pointer to the size of every block. The allocating thread's allocator
+ * must therefore outlive its blocks, so a thread must not exit (or release
+ * its allocator through thread_exit) while any of its blocks are still in
+ * use elsewhere. Debug builds assert on this.
+ */
+
+template<typename _ty,
+	std::size_t _elements,
+	std::derived_from<no_ref_counting> ref_count_policy = no_ref_counting,
+	std::derived_from<safe_entrant> entrant_policy = safe_entrant,
+	std::derived_from<natural_alignment> align_policy = natural_alignment,
+	std::derived_from<inline_slab> slab_policy = inline_slab,
+	std::derived_from<numa_unaware> numa_policy = numa_unaware
+>
+class tls_block_allocator final {
+	static constexpr bool numa_aware = std::is_same_v<numa_policy, numa_local>;
+
+	// block with the allocator it came from, so a remote free can be routed
+	struct routed_block {
+		_ty obj;
+		void* owner = nullptr;
+
+		template<typename ...Args>
+		routed_block(Args&&... args)
+			: obj(std::forward<Args>(args)...) {}
+	};
+
+	using block_type = std::conditional_t<numa_aware, routed_block, _ty>;
+
+	using allocator_type = block_allocator<
+		block_type, _elements, no_validate_dealloc, align_policy, slab_policy
+	>;
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+	static constexpr bool track_owners = numa_aware;
+#else
+	static constexpr bool track_owners = false;
+#endif
+
+	// allocators of every live thread, only used to catch frees to dead ones
+	struct registry {
+		std::mutex lock;
+		std::vector<allocator_type*> allocators;
+	};
+
+	struct allocator_deleter {
+		void operator()(allocator_type* allocator) const {
+			if constexpr(track_owners) {
+				std::lock_guard guard(registry_.lock);
+				std::erase(registry_.allocators, allocator);
+			}
+
+			delete allocator;
+		}
+	};
+
+	using registry_type = std::conditional_t<track_owners, registry, std::monostate>;
+
+	/*
+	 * Records the owner of each block as it's written to the caller's
+	 * output iterator, so that allocate_n keeps its bulk path
+	 */
+	template<typename OutputIt>
+	struct routing_iterator {
+		using difference_type = std::ptrdiff_t;
+
+		OutputIt* out;
+		allocator_type* owner;
+
+		const routing_iterator& operator*() const {
+			return *this;
+		}
+
+		const routing_iterator& operator=(routed_block* block) const {
+			block->owner = owner;
+			*(*out)++ = &block->obj;
+			return *this;
+		}
+
+		routing_iterator& operator++() {
+			return *this;
+		}
+
+		routing_iterator operator++(int) {
+			return *this;
+		}
+	};
+
+	using ref_count = std::conditional_t<
+		std::is_same_v<ref_count_policy, ref_counting>, int, std::monostate
+	>;
+
+	using tls_handle_cache = std::conditional_t<
+		std::is_same_v<entrant_policy, unsafe_entrant>, allocator_type*, std::monostate
+	>;
+
+	static inline thread_local std::unique_ptr<allocator_type, allocator_deleter> allocator_;
+	static inline registry_type registry_;
+	static inline thread_local ref_count ref_count_{};
+
+	[[no_unique_address]] tls_handle_cache cached_handle_{};
+
+	static void create_allocator() {
+		if constexpr(numa_aware) {
+			allocator_.reset(new allocator_type(impl::current_numa_node()));
+		} else {
+			allocator_.reset(new allocator_type());
+		}
+
+		if constexpr(track_owners) {
+			std::lock_guard guard(registry_.lock);
+			registry_.allocators.emplace_back(allocator_.get());
+		}
+	}
+
+	// Compiler will optimise calls to this out when using unsafe_entrant
+	inline void initialise() {
+		if constexpr(std::is_same_v<entrant_policy, safe_entrant>) {
+			if(!allocator_) {
+				create_allocator();
+			}
+		}
+	}
+
+	void deallocate_routed(_ty* t) {
+		auto block = reinterpret_cast<routed_block*>(t);
+		auto owner = static_cast<allocator_type*>(block->owner);
+
+		if(owner == allocator_handle()) [[likely]] {
+			owner->deallocate(block);
+			return;
+		}
+
+		if constexpr(track_owners) {
+			std::lock_guard guard(registry_.lock);
+			assert(std::ranges::find(registry_.allocators, owner) != registry_.allocators.end()
+				&& "block outlived the thread that allocated it");
+		}
+
+		owner->deallocate_remote(block);
+	}
+
+	inline allocator_type* allocator_handle() {
+		if constexpr(std::is_same_v<entrant_policy, unsafe_entrant>) {
+			return cached_handle_;
+		} else {
+			return allocator_.get();
+		}
+	}
+
+public:
+#ifdef HEXI_DEBUG_ALLOCATORS
+	std::size_t total_allocs = 0;
+	std::size_t total_deallocs = 0;
+	std::size_t active_allocs = 0;
+#endif
+
+	tls_block_allocator() {
+		thread_enter();
+	}
+
+	/*
+	 * When used in conjunction with unsafe_entrant, allows the owning object
+	 * to be executed on another thread without paying for checks on every
+	 * allocation
+	 * 
+	 * @note If ref counting is enabled, the count will be incremented.
+	 */
+	inline void thread_enter() {
+		if(!allocator_) {
+			create_allocator();
+		}
+
+		if constexpr(std::is_same_v<entrant_policy, unsafe_entrant>) {
+			cached_handle_ = allocator_.get();
+		}
+
+		if constexpr(std::is_same_v<ref_count_policy, ref_counting>) {
+			++ref_count_;
+		}
+	}
+
+	/*
+	 * When used in conjunction with unsafe_entrant, signals that the current
+	 * thread not make further calls into the allocator.
+	 * 
+	 * @note If ref counting is enabled, the count will be decremented.
+	 */
+	inline void thread_exit() {
+		if constexpr(std::is_same_v<ref_count_policy, ref_counting>) {
+			assert(ref_count_);
+
+			--ref_count_;
+
+			if(ref_count_ == 0) {
+				allocator_.reset();
+			}
+		}
+	}
+
+	/*
+	 * @brief Allocates and constructs an object.
+	 * 
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
+	 * 
+	 * @return Pointer to the allocated object.
+	 */
+	template<typename ...Args>
+	[[nodiscard]] inline _ty* allocate(Args&&... args) {
+		/*
+		 * When safe_entrant is set, need to do this here & in ctor unless
+		 * we can be 100% sure that any object using the allocator is created
+		 * on the same thread that ends up using it.
+		 */
+		initialise();
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_allocs;
+		++active_allocs;
+#endif
+		auto handle = allocator_handle();
+
+		if constexpr(numa_aware) {
+			auto block = handle->allocate(std::forward<Args>(args)...);
+			block->owner = handle;
+			return &block->obj;
+		} else {
+			return handle->allocate(std::forward<Args>(args)...);
+		}
+	}
+
+	/*
+	 * @brief Deallocates and destructs an object.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate(_ty* t) {
+		assert(t);
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_deallocs;
+		--active_allocs;
+#endif
+		if constexpr(numa_aware) {
+			deallocate_routed(t);
+		} else {
+			allocator_handle()->deallocate(t);
+		}
+	}
+
+	/*
+	 * @brief Allocates and default constructs a number of objects.
+	 * 
+	 * @param count The number of objects to allocate.
+	 * @param out Output iterator that receives a pointer to each object.
+	 * 
+	 * @return The output iterator, one past the last written element.
+	 */
+	template<std::output_iterator<_ty*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		initialise();
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		total_allocs += count;
+		active_allocs += count;
+#endif
+		auto handle = allocator_handle();
+
+		if constexpr(numa_aware) {
+			handle->allocate_n(count, routing_iterator<OutputIt>{ &out, handle });
+			return out;
+		} else {
+			return handle->allocate_n(count, out);
+		}
+	}
+
+	/*
+	 * @brief Deallocates and destructs a range of objects.
+	 * 
+	 * @param first Iterator to the first object pointer.
+	 * @param last Iterator one past the last object pointer.
+	 */
+	template<std::forward_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		const auto count = static_cast<std::size_t>(std::distance(first, last));
+		total_deallocs += count;
+		active_allocs -= count;
 #endif
+		if constexpr(numa_aware) {
+			for(; first != last; ++first) {
+				deallocate_routed(*first);
+			}
+		} else {
+			allocator_handle()->deallocate_list(first, last);
+		}
+	}
+
+	/**
+	 * @return The NUMA node of the calling thread's slab or -1 if the
+	 * policy is not in use or the node could not be determined.
+	 */
+	int numa_node() {
+		initialise();
+		return allocator_handle()->numa_node();
+	}
+
+	/**
+	 * @brief Faults in the calling thread's slab up front, rather than
+	 * as blocks are first used.
+	 */
+	void prefault() {
+		initialise();
+		allocator_handle()->prefault();
+	}
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+	auto allocator() {
+		initialise();
+		return allocator_handle();
+	}
+#endif
+
+	~tls_block_allocator() {
+		thread_exit();
+
+#ifdef HEXI_DEBUG_ALLOCATORS
+		assert(active_allocs == 0);
+#endif
+	}
+};
+
+} // hexi
+
+#include <cstddef>
+
+namespace hexi {
+
+// dynamic_buffer backed by thread-local storage, meaning every
+// instance on the same thread shares the same underlying memory.
+// As a rule of thumb, an instance should never be touched by any thread
+// other than the one on which it was created, not even if synchronised
+// ... unless you're positive it won't result in the allocator being called.
+// 
+// Minimum memory usage is intrusive_storage<block_size> * count.
+// Additional blocks are not added if the original is exhausted ('colony' structure),
+// so the allocator will fall back to the system allocator instead.
+//
+// Pros: extremely fast allocation/deallocation for many instances per thread
+// Cons: everything else.
+// 
+// TL;DR Do not use unless you know what you're doing.
+template<decltype(auto) block_size,
+	std::size_t count,
+	typename ref_count_policy = no_ref_counting,
+	typename entrant_policy = safe_entrant,
+	typename storage_type = std::byte>
+using dynamic_tls_buffer = dynamic_buffer<block_size, storage_type,
+	tls_block_allocator<typename dynamic_buffer<block_size>::storage_type, count, no_ref_counting, entrant_policy>
+>;
+
+} // hexi
+
+// #include <hexi/exception.h>
+
+// #include <hexi/endian.h>
+
+// #include <hexi/file_buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/exception.h>
+
+// #include <hexi/shared.h>
+
+// #include <hexi/concepts.h>
+
+#include <filesystem>
+#include <utility>
+#include <cstddef>
+#include <cstdio>
+
+namespace hexi {
+
+class file_buffer final {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = long;
+	using value_type      = char;
+	using contiguous      = is_non_contiguous;
+	using seeking         = unsupported;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	FILE* file_ = nullptr;
+	offset_type read_ = 0;
+	offset_type write_ = 0;
+	bool error_ = false;
+
+	/**
+	* @brief Explicitly close the underlying file handle.
+	* 
+	* This function will be called by the object's destructor
+	* and does not need to be called explicitly.
+	* 
+	* @note Idempotent.
+	*/
+	void close() {
+		if(file_) {
+			std::fclose(file_);
+			file_ = nullptr;
+		}
+	}
+
+public:
+	file_buffer(const std::filesystem::path& path)
+		: file_buffer(path.string().c_str()) { }
+
+	file_buffer(const char* path) {
+		file_ = std::fopen(path, "a+b");
+		
+		if(!file_) {
+			error_ = true;
+			return;
+		}
+		
+		if(std::fseek(file_, 0, SEEK_END)) {
+			error_ = true;
+			return;
+		}
+
+		write_ = std::ftell(file_);
+
+		if(write_ == -1) {
+			error_ = true;
+		}
+	}
+
+	file_buffer(file_buffer&& rhs) noexcept
+		: file_(rhs.file_),
+		  read_(rhs.read_),
+		  write_(rhs.write_),
+		  error_(rhs.error_) {
+		rhs.file_ = nullptr;
+	}
+
+	file_buffer& operator=(file_buffer&& rhs) noexcept {
+		std::exchange(file_, rhs.file_);
+		read_ = rhs.read_;
+		write_ = rhs.write_;
+		error_ = rhs.error_;
+		return *this;
+	}
+
+	file_buffer& operator=(const file_buffer&) = delete;
+	file_buffer(const file_buffer&) = delete;
 
-namespace hexi {
+	~file_buffer() {
+		close();
+	}
 
-#ifdef HEXI_WITH_BOOST_ASIO
-namespace asio = boost::asio;
-#endif
 
-template<typename buffer_type>
-class buffer_sequence {
-	const buffer_type& buffer_;
+	/**
+	 * @brief Flush unwritten data.
+	 */
+	void flush() {
+		std::fflush(file_);
+	}
 
-public:
-	buffer_sequence(const buffer_type& buffer)
-		: buffer_(buffer) { }
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
 
-	class const_iterator {
-		using node = typename buffer_type::node_type;
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) {
+		if(error_) {
+			return;
+		}
 
-	public:
-		const_iterator(const buffer_type& buffer, const node* curr_node)
-			: buffer_(buffer),
-			  curr_node_(curr_node) {}
+		if(std::fseek(file_, read_, 0)) {
+			error_ = true;
+			return;
+		}
 
-		const_iterator& operator++() {
-			curr_node_ = curr_node_->next;
-			return *this;
+		if(std::fread(destination, length, 1, file_) != 1) {
+			error_ = true;
+			return;
 		}
 
-		const_iterator operator++(int) {
-			const_iterator current(*this);
-			curr_node_ = curr_node_->next;
-			return current;
+		read_ += length;
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) {
+		copy(destination, sizeof(T));
+	}
+
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, size_type length) {
+		if(error_) {
+			return;
+		} else if(length > size()) {
+			error_ = true;
+			HEXI_THROW(buffer_underrun(length, read_, size()));
 		}
 
-		asio::const_buffer operator*() const {
-			const auto buffer = buffer_.buffer_from_node(curr_node_);
-			return buffer->read_data();
+		if(std::fseek(file_, read_, SEEK_SET)) {
+			error_ = true;
+			return;
+		}
+		
+		if(std::fread(destination, length, 1, file_) != 1) {
+			error_ = true;
+			return;
 		}
+	}
 
-		bool operator==(const const_iterator& rhs) const {
-			return curr_node_ == rhs.curr_node_;
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(value_type val) noexcept {
+		if(error_) {
+			return npos;
 		}
 
-		bool operator!=(const const_iterator& rhs) const {
-			return curr_node_ != rhs.curr_node_;
+		if(std::fseek(file_, read_, SEEK_SET)) {
+			error_ = true;
+			return npos;
 		}
 
-		const_iterator& operator=(const_iterator&) = delete;
+		value_type buffer{};
 
-	#ifdef HEXI_BUFFER_DEBUG
-		std::span<const char> get_buffer() {
-			auto buffer = buffer_.buffer_from_node(curr_node_);
-			return {
-				reinterpret_cast<const char*>(buffer->read_ptr()), buffer->size()
-			};
+		for(size_type i = 0, j = size(); i < j; ++i) {
+			if(std::fread(&buffer, sizeof(value_type), 1, file_) != 1) {
+				error_ = true;
+				return npos;
+			}
+
+			if(buffer == val) {
+				return i;
+			}
 		}
-	#endif
 
-	private:
-		const buffer_type& buffer_;
-		const node* curr_node_;
-	};
+		return npos;
+	}
 
-const_iterator begin() const {
-	return const_iterator(buffer_, buffer_.root_.next);
-}
+	/**
+	 * @brief Skip a requested number of bytes.
+	 *
+	 * Skips over a number of bytes from the file. This should be used
+	 * if the file holds data that you don't care about but don't want
+	 * to have to read it to another buffer to access data beyond it.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		read_ += length;
+	}
 
-const_iterator end() const {
-	return const_iterator(buffer_, &buffer_.root_);
-}
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return write_ == read_;
+	}
 
-friend class const_iterator;
-};
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	constexpr static bool can_write_seek() {
+		return std::is_same_v<seeking, supported>;
+	}
 
-} // hexi
+	/**
+	 * @brief Write data to the container.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 */
+	void write(const auto& source) {
+		write(&source, sizeof(source));
+	}
 
-#endif // #if defined HEXI_WITH_ASIO || defined HEXI_WITH_BOOST_ASIO
-// #include <hexi/concepts.h>
+	/**
+	 * @brief Write provided data to the file.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
+	 */
+	void write(const void* source, size_type length) {
+		if(error_) {
+			return;
+		}
+		
+		if(std::fseek(file_, write_, SEEK_SET)) {
+			error_ = true;
+			return;
+		}
 
-// #include <hexi/dynamic_buffer.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+		if(std::fwrite(source, length, 1, file_) != 1) {
+			error_ = true;
+			return;
+		}
 
+		write_ += length;
+	}
 
 
-// #include <hexi/pmc/buffer.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+	/**
+	 * @brief Returns the amount of data available in the file.
+	 * 
+	 * @return The number of bytes of data available to read from the file.
+	 */
+	size_type size() const {
+		return static_cast<size_type>(write_) - read_;
+	}
+
+	/** 
+	 * @brief Retrieve the file handle.
+	 * 
+	 * @return The file handle.
+	 */
+	FILE* handle() {
+		return file_;
+	}
+
+	/** 
+	 * @brief Retrieve the file handle.
+	 * 
+	 * @return The file handle.
+	 */
+	const FILE* handle() const {
+		return file_;
+	}
+
+	/** 
+	 * @return True if an error has occurred during file operations.
+	 */
+	bool error() const {
+		return error_;
+	}
 
+	/** 
+	 * @return True if no error has occurred during file operations.
+	 */
+	operator bool() const {
+		return !error();
+	}
+};
+
+} // hexi
 
+// #include <hexi/shared.h>
 
-// #include <hexi/pmc/buffer_read.h>
+// #include <hexi/ring_buffer.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -2161,625 +8624,925 @@ friend class const_iterator;
 // |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
 
+// #include <hexi/exception.h>
 
-// #include <hexi/pmc/buffer_base.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
-
+// #include <hexi/shared.h>
 
+// #include <hexi/concepts.h>
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <cassert>
 #include <cstddef>
+#include <cstring>
 
-namespace hexi::pmc {
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HEXI_HAS_MIRRORED_MAPPING
+#endif
 
-class buffer_base {
-protected:
-	std::size_t read_ = 0;
-	std::size_t write_ = 0;
+namespace hexi {
 
+/**
+ * Fixed-capacity circular buffer that maps the same physical memory twice,
+ * back to back, in the virtual address space. Any region that wraps around
+ * the end of the buffer is therefore still contiguous in memory, so reads
+ * and writes never need to be split and view()/span() deserialisation works
+ * on a buffer that is continuously being recycled.
+ *
+ * The capacity must be a multiple of the system's page size, otherwise
+ * construction will fail. Only available on POSIX systems; construction
+ * fails elsewhere.
+ */
+template<std::size_t buf_size, byte_type storage_type = std::byte>
+requires (buf_size > 0)
+class ring_buffer final {
 public:
-	virtual std::size_t size() const = 0;
-	virtual bool empty() const = 0;
-	virtual ~buffer_base() = default;
-};
+	using size_type       = std::size_t;
+	using offset_type     = size_type;
+	using value_type      = storage_type;
+	using contiguous      = is_contiguous;
+	using seeking         = supported;
 
-} // pmc, hexi
+	// offset of the reserved region within the first mapping
+	using placeholder_type = size_type;
 
-#include <cstddef>
+	static constexpr auto npos { static_cast<size_type>(-1) };
 
-namespace hexi::pmc {
+private:
+	value_type* buffer_ = nullptr;
+	size_type read_ = 0; // always within [0, buf_size)
+	size_type size_ = 0;
+
+#ifdef HEXI_HAS_MIRRORED_MAPPING
+	static int create_shared_memory() {
+#if defined(__linux__)
+		return ::memfd_create("hexi::ring_buffer", MFD_CLOEXEC);
+#else
+		static std::atomic<unsigned int> counter;
+		const auto name = "/hexi-ring-" + std::to_string(::getpid())
+			+ "-" + std::to_string(counter++);
 
-class buffer_read : virtual public buffer_base {
-public:
-	using value_type = std::byte;
+		const auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
 
-	static constexpr auto npos { static_cast<std::size_t>(-1) };
+		if(fd != -1) {
+			::shm_unlink(name.c_str());
+		}
 
-	virtual ~buffer_read() = default;
-	virtual void read(void* destination, std::size_t length) = 0;
-	virtual void copy(void* destination, std::size_t length) const = 0;
-	virtual	void skip(std::size_t length) = 0;
-	virtual const std::byte& operator[](const std::size_t index) const = 0;
-	virtual std::size_t find_first_of(std::byte val) const = 0;
-};
+		return fd;
+#endif
+	}
 
-} // pmc, hexi
+	static value_type* map_mirrored() {
+		const auto page_size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
 
-// #include <hexi/pmc/buffer_write.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+		if(buf_size % page_size) {
+			HEXI_THROW(exception("ring_buffer size must be a multiple of the page size"));
+		}
 
+		const auto fd = create_shared_memory();
 
+		if(fd == -1) {
+			HEXI_THROW(exception("ring_buffer could not create shared memory"));
+		}
 
-// #include <hexi/pmc/buffer_base.h>
+		if(::ftruncate(fd, buf_size) == -1) {
+			::close(fd);
+			HEXI_THROW(exception("ring_buffer could not size shared memory"));
+		}
 
-// #include <hexi/shared.h>
+		// reserve enough address space for both views, then map over it
+		auto base = static_cast<char*>(::mmap(nullptr, buf_size * 2, PROT_NONE,
+		                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
 
-#include <cstddef>
+		if(base == MAP_FAILED) {
+			::close(fd);
+			HEXI_THROW(exception("ring_buffer could not reserve address space"));
+		}
 
-namespace hexi::pmc {
+		auto first = ::mmap(base, buf_size, PROT_READ | PROT_WRITE,
+		                    MAP_SHARED | MAP_FIXED, fd, 0);
 
-class buffer_write : virtual public buffer_base {
-public:
-	using value_type = std::byte;
+		auto second = ::mmap(base + buf_size, buf_size, PROT_READ | PROT_WRITE,
+		                     MAP_SHARED | MAP_FIXED, fd, 0);
 
-	virtual ~buffer_write() = default;
-	virtual void write(const void* source, std::size_t length) = 0;
-	virtual void reserve(std::size_t length) = 0;
-	virtual bool can_write_seek() const = 0;
-	virtual void write_seek(buffer_seek direction, std::size_t offset) = 0;
-};
+		::close(fd);
 
-} // pmc, hexi
+		if(first == MAP_FAILED || second == MAP_FAILED) {
+			::munmap(base, buf_size * 2);
+			HEXI_THROW(exception("ring_buffer could not map mirrored views"));
+		}
 
+		return reinterpret_cast<value_type*>(base);
+	}
 
-namespace hexi::pmc {
+	static void unmap(value_type* buffer) {
+		if(buffer) {
+			::munmap(buffer, buf_size * 2);
+		}
+	}
+#else
+	static value_type* map_mirrored() {
+		HEXI_THROW(exception("ring_buffer is not supported on this platform"));
+		return nullptr;
+	}
 
-class buffer : public buffer_read, public buffer_write {
-public:
-	using value_type = std::byte;
+	static void unmap(value_type*) {}
+#endif
 
-	using buffer_read::operator[];
+public:
+	ring_buffer()
+		: buffer_(map_mirrored()) {}
+
+	ring_buffer(ring_buffer&& rhs) noexcept
+		: buffer_(std::exchange(rhs.buffer_, nullptr)),
+		  read_(std::exchange(rhs.read_, 0)),
+		  size_(std::exchange(rhs.size_, 0)) {}
+
+	ring_buffer& operator=(ring_buffer&& rhs) noexcept {
+		if(this != &rhs) {
+			unmap(buffer_);
+			buffer_ = std::exchange(rhs.buffer_, nullptr);
+			read_ = std::exchange(rhs.read_, 0);
+			size_ = std::exchange(rhs.size_, 0);
+		}
 
-	virtual std::byte& operator[](const std::size_t index) = 0;
-	virtual ~buffer() = default;
-};
+		return *this;
+	}
 
-} // pmc, hexi
+	ring_buffer(const ring_buffer&) = delete;
+	ring_buffer& operator=(const ring_buffer&) = delete;
 
-// #include <hexi/shared.h>
+	~ring_buffer() {
+		unmap(buffer_);
+	}
 
-// #include <hexi/allocators/default_allocator.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
+	}
 
+	/**
+	 * @brief Reads a number of bytes to the provided buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
+	 */
+	void read(void* destination, size_type length) {
+		copy(destination, length);
+		skip(length);
+	}
 
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 */
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
+	}
 
-#include <utility>
+	/**
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor.
+	 * 
+	 * @note The destination buffer address must not belong to the ring_buffer.
+	 * 
+	 * @param destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
+	 */
+	void copy(void* destination, size_type length) const {
+		assert(!impl::region_overlap(buffer_, buf_size * 2, destination, length));
 
-namespace hexi {
+		if(length > size()) {
+			HEXI_THROW(buffer_underrun(length, read_, size()));
+		}
 
-template<typename T>
-struct default_allocator final {
-	template<typename ...Args>
-	[[nodiscard]] inline T* allocate(Args&&... args) const {
-		return new T(std::forward<Args>(args)...);
+		std::memcpy(destination, read_ptr(), length);
 	}
 
-	inline void deallocate(T* t) const {
-		delete t;
+	/**
+	 * @brief Attempts to locate the provided value within the container.
+	 * 
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
+	 */
+	size_type find_first_of(value_type val) const noexcept {
+		const auto data = read_ptr();
+		const auto it = std::find(data, data + size_, val);
+		return it == data + size_? npos : static_cast<size_type>(it - data);
 	}
-};
-
-} // hexi
-
-// #include <hexi/impl/intrusive_storage.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
+	/**
+	 * @brief Skip over a number of bytes.
+	 * 
+	 * Skips over a number of bytes from the container. This should be used
+	 * if the container holds data that you don't care about but don't want
+	 * to have to read it to another buffer to access data beyond it.
+	 * 
+	 * @param length The number of bytes to skip.
+	 */
+	void skip(const size_type length) {
+		assert(length <= size_);
+		read_ += length;
+		size_ -= length;
 
+		if(read_ >= buf_size) {
+			read_ -= buf_size;
+		}
 
-#if _MSC_VER
-#pragma warning(disable : 4996)
-#endif
+		// not required for correctness but keeps the cursors in one view
+		if(!size_) {
+			read_ = 0;
+		}
+	}
 
-// #include <hexi/shared.h>
+	/**
+	 * @brief Advances the write cursor.
+	 * 
+	 * @param size The number of bytes by which to advance the write cursor.
+	 */
+	void advance_write(size_type bytes) {
+		assert(free() >= bytes);
+		size_ += bytes;
+	}
 
-// #include <hexi/concepts.h>
+	/**
+	 * @brief Clears the container.
+	 */
+	void clear() {
+		read_ = size_ = 0;
+	}
 
-#include <array>
-#include <concepts>
-#include <span>
-#include <type_traits>
-#include <cassert>
-#include <cstring>
-#include <cstddef>
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	value_type& operator[](const size_type index) {
+		return read_ptr()[index];
+	}
 
-namespace hexi::impl {
+	/**
+	 * @brief Retrieves a reference to the specified index within the container.
+	 * 
+	 * @param index The index within the container.
+	 * 
+	 * @return A reference to the value at the specified index.
+	 */
+	const value_type& operator[](const size_type index) const {
+		return read_ptr()[index];
+	}
 
-struct intrusive_node {
-	intrusive_node* next;
-	intrusive_node* prev;
-};
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container is empty (has no data to be read).
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !size_;
+	}
 
-template<std::size_t block_size, byte_type storage_type = std::byte>
-struct intrusive_storage final {
-	using value_type = storage_type;
-	using offset_type = std::remove_const_t<decltype(block_size)>;
+	/**
+	 * @return Whether the container is full and cannot be further written to.
+	 */
+	bool full() const {
+		return size_ == capacity();
+	}
 
-	offset_type read_offset = 0;
-	offset_type write_offset = 0;
-	intrusive_node node {};
-	std::array<value_type, block_size> storage;
+	/**
+	 * @brief Determine whether the adaptor supports write seeking.
+	 * 
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
+	 */
+	constexpr static bool can_write_seek() {
+		return std::is_same_v<seeking, supported>;
+	}
 
 	/**
-	 * @brief Clear the container.
+	 * @brief Write data to the container.
 	 * 
-	 * Resets the read and write offsets, does not explicitly
-	 * erase the data contained within the buffer but should
-	 * be treated as such.
+	 * @param source Pointer to the data to be written.
 	 */
-	void clear() {
-		read_offset = 0;
-		write_offset = 0;
+	void write(const auto& source) {
+		write(&source, sizeof(source));
 	}
 
 	/**
 	 * @brief Write provided data to the container.
 	 * 
-	 * If the container size is lower than requested number of bytes,
-	 * the request will be capped at the number of bytes available.
-	 * 
-	 * @note The source buffer must not overlap with the underlying buffer.
+	 * @note The source buffer address must not belong to the ring_buffer.
 	 * 
 	 * @param source Pointer to the data to be written.
 	 * @param length Number of bytes to write from the source.
-	 * 
-	 * @return The number of bytes copied, which may be less than requested.
 	 */
-	std::size_t write(const auto source, std::size_t length) {
-		assert(!region_overlap(source, length, storage.data(), storage.size()));
-		std::size_t write_len = block_size - write_offset;
+	void write(const void* source, size_type length) {
+		assert(!impl::region_overlap(source, length, buffer_, buf_size * 2));
 
-		if(write_len > length) {
-			write_len = length;
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, size_, free()));
 		}
 
-		std::memcpy(storage.data() + write_offset, source, write_len);
-		write_offset += static_cast<offset_type>(write_len);
-		return write_len;
+		std::memcpy(write_ptr(), source, length);
+		size_ += length;
 	}
 
 	/**
-	 * @brief Copies a number of bytes to the provided buffer but without
-	 * advancing the read cursor.
-	 * 
-	 * If the container size is lower than requested number of bytes,
-	 * the request will be capped at the number of bytes available.
+	 * @brief Reserves space at the write cursor to be filled in later.
 	 * 
-	 * @note The destination buffer must not overlap with the underlying buffer.
+	 * @note The placeholder is invalidated once its contents have been read.
 	 * 
-	 * @param[out] destination The buffer to copy the data to.
-	 * @param length The number of bytes to copy.
+	 * @param length The number of bytes to reserve.
 	 * 
-	 * @return The number of bytes copied, which may be less than requested.
+	 * @return A handle to the reserved space.
 	 */
-	std::size_t copy(auto destination, const std::size_t length) const {
-		assert(!region_overlap(storage.data(), storage.size(), destination, length));
-		std::size_t read_len = block_size - read_offset;
-
-		if(read_len > length) {
-			read_len = length;
+	placeholder_type reserve_placeholder(size_type length) {
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, size_, free()));
 		}
 
-		std::memcpy(destination, storage.data() + read_offset, read_len);
-		return read_len;
+		const auto offset = (read_ + size_) % buf_size;
+		size_ += length;
+		return offset;
 	}
 
 	/**
-	 * @brief Reads a number of bytes to the provided buffer.
-	 * 
-	 * If the container size is lower than requested number of bytes,
-	 * the request will be capped at the number of bytes available.
+	 * @brief Writes data into previously reserved space.
 	 * 
-	 * @note The destination buffer must not overlap with the underlying buffer.
-	 * 
-	 * @param length The number of bytes to skip.
-	 * @param[out] destination The buffer to copy the data to.
-	 * @param allow_optimise Whether the buffer can reuse its space where possible.
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
+	 */
+	void fill_placeholder(placeholder_type placeholder, const void* source, size_type length) {
+		std::memcpy(placeholder_ptr(placeholder), source, length);
+	}
+
+	/**
+	 * @param placeholder The handle returned by reserve_placeholder().
 	 * 
-	 * @return The number of bytes read, which may be less than requested.
+	 * @return Pointer to the start of the reserved space, which is
+	 * contiguous even if it wraps around.
 	 */
-	std::size_t read(auto destination, const std::size_t length, const bool allow_optimise = false) {
-		std::size_t read_len = copy(destination, length);
-		read_offset += static_cast<offset_type>(read_len);
+	value_type* placeholder_ptr(placeholder_type placeholder) {
+		// relative to the read cursor, so it's in the same view as write_ptr()
+		return buffer_ + read_ + ((placeholder + buf_size - read_) % buf_size);
+	}
 
-		if(read_offset == write_offset && allow_optimise) {
-			clear();
+	/**
+	 * @brief Performs write seeking within the container.
+	 * 
+	 * @param direction Specify whether to seek in a given direction or to absolute seek.
+	 * @param offset The offset relative to the seek direction or the absolute value
+	 * when using absolute seeking. Absolute offsets are relative to the read cursor,
+	 * since the start of the underlying storage has no fixed meaning.
+	 */
+	void write_seek(const buffer_seek direction, const size_type offset) {
+		switch(direction) {
+			case buffer_seek::sk_backward:
+				size_ -= offset;
+				break;
+			case buffer_seek::sk_forward:
+				size_ += offset;
+				break;
+			case buffer_seek::sk_absolute:
+				size_ = offset;
 		}
 
-		return read_len;
+		assert(size_ <= capacity());
 	}
 
 	/**
-	 * @brief Skip over a number of bytes.
-	 *
-	 * Skips over a number of bytes in the container. This should be used
-	 * if the container holds data that you don't care about but don't want
-	 * to have to read it to another buffer to access data beyond it.
+	 * @return An iterator to the beginning of data available for reading.
+	 */
+	auto begin() {
+		return read_ptr();
+	}
+
+	/**
+	 * @return An iterator to the beginning of data available for reading.
+	 */
+	auto begin() const {
+		return read_ptr();
+	}
+
+	/**
+	 * @return An iterator to the end of data available for reading.
+	 */
+	auto end() {
+		return write_ptr();
+	}
+
+	/**
+	 * @return An iterator to the end of data available for reading.
+	 */
+	auto end() const {
+		return write_ptr();
+	}
+
+	/**
+	 * @brief Overall capacity of the container.
 	 * 
-	 * If the container size is lower than requested number of bytes,
-	 * the request will be capped at the number of bytes available.
+	 * @return The container's total size in bytes.
+	 */
+	constexpr static size_type capacity() {
+		return buf_size;
+	}
+
+	/**
+	 * @brief Returns the size of the container.
 	 * 
-	 * @param length The number of bytes to skip.
-	 * @param allow_optimise Whether the buffer can reuse its space where possible.
+	 * @return The number of bytes of data available to read within the container.
+	 */
+	size_type size() const {
+		return size_;
+	}
+
+	/**
+	 * @brief The amount of free space.
 	 * 
-	 * @return The number of bytes skipped, which may be less than requested.
+	 * @return The number of bytes that can be written, which are always
+	 * contiguous from write_ptr().
 	 */
-	std::size_t skip(const std::size_t length, const bool allow_optimise = false) {
-		std::size_t skip_len = block_size - read_offset;
+	size_type free() const {
+		return buf_size - size_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	const value_type* data() const {
+		return read_ptr();
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	value_type* data() {
+		return read_ptr();
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	const value_type* read_ptr() const {
+		return buffer_ + read_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	value_type* read_ptr() {
+		return buffer_ + read_;
+	}
+
+	/**
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
+	 */
+	const value_type* write_ptr() const {
+		return buffer_ + read_ + size_;
+	}
+
+	/**
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
+	 */
+	value_type* write_ptr() {
+		return buffer_ + read_ + size_;
+	}
+};
+
+} // hexi
+
+// #include <hexi/spsc_buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+// #include <hexi/shared.h>
+
+// #include <hexi/concepts.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace hexi {
+
+namespace impl {
+
+template<decltype(auto) block_sz, byte_type value_type>
+struct spsc_block {
+	std::atomic<spsc_block*> next = nullptr;
+	std::array<value_type, block_sz> storage;
+};
+
+} // impl
+
+/**
+ * Unbounded single-producer, single-consumer byte queue, intended for handing
+ * a stream of data from one thread to another without a lock.
+ *
+ * Data is stored in a linked list of fixed-size blocks. The producer thread
+ * may call write() and the consumer thread may call read(), copy(), skip() and
+ * find_first_of(). size() and empty() may be called from either side, with
+ * the consumer seeing at least as much data as the producer has published.
+ *
+ * Each side owns its own cursor and publishes the running total of bytes it
+ * has processed with release semantics, so the other side only ever sees
+ * fully written data. Blocks drained by the consumer are handed back to the
+ * producer for reuse, so a steady-state stream does not allocate.
+ *
+ * Write seeking is not supported, since data is visible to the consumer
+ * as soon as it has been written.
+ */
+template<decltype(auto) block_sz, byte_type storage_value_type = std::byte>
+requires (block_sz > 0)
+class spsc_buffer final {
+public:
+	using value_type   = storage_value_type;
+	using size_type    = std::size_t;
+	using offset_type  = std::size_t;
+	using contiguous   = is_non_contiguous;
+	using seeking      = unsupported;
+
+	static constexpr auto npos { static_cast<size_type>(-1) };
+
+private:
+	using block = impl::spsc_block<block_sz, value_type>;
 
-		if(skip_len > length) {
-			skip_len = length;
-		}
+	// avoids the producer and consumer cursors sharing a cache line
+	static constexpr std::size_t cache_line = 64;
 
-		read_offset += static_cast<offset_type>(skip_len);
+	struct alignas(cache_line) producer_state {
+		block* tail;
+		size_type offset = 0;
+		block* spare = nullptr; // producer-local list of recycled blocks
+		std::atomic<size_type> total = 0;
+	};
 
-		if(read_offset == write_offset && allow_optimise) {
-			clear();
+	struct alignas(cache_line) consumer_state {
+		block* head;
+		size_type offset = 0;
+		std::atomic<size_type> total = 0;
+	};
+
+	producer_state producer_;
+	consumer_state consumer_;
+
+	// blocks drained by the consumer, waiting to be collected by the producer
+	alignas(cache_line) std::atomic<block*> recycled_ = nullptr;
+
+	// producer only
+	block* next_block() {
+		if(!producer_.spare) {
+			producer_.spare = recycled_.exchange(nullptr, std::memory_order_acquire);
 		}
 
-		return skip_len;
+		if(auto spare = producer_.spare) {
+			producer_.spare = spare->next.load(std::memory_order_relaxed);
+			spare->next.store(nullptr, std::memory_order_relaxed);
+			return spare;
+		}
+
+		return new block();
 	}
 
-	/**
-	 * @brief Returns the size of the container.
-	 * 
-	 * @return The number of bytes available to read within the container.
-	 */
-	std::size_t size() const {
-		return write_offset - read_offset;
+	// consumer only
+	void recycle(block* drained) {
+		auto head = recycled_.load(std::memory_order_relaxed);
+
+		do {
+			drained->next.store(head, std::memory_order_relaxed);
+		} while(!recycled_.compare_exchange_weak(head, drained,
+			std::memory_order_release, std::memory_order_relaxed));
 	}
 
-	/**
-	 * @brief The amount of free space.
-	 * 
-	 * @return The number of bytes of free space within the container.
-	 */
-	std::size_t free() const {
-		return block_size - write_offset;
+	static void free_list(block* head) {
+		while(head) {
+			auto next = head->next.load(std::memory_order_relaxed);
+			delete head;
+			head = next;
+		}
 	}
 
-	/**
-	 * @brief Performs write seeking within the container.
-	 * 
-	 * @param direction Specify whether to seek in a given direction or to absolute seek.
-	 * @param offset The offset relative to the seek direction or the absolute value
-	 * when using absolute seeking.
+	/*
+	 * Advances the consumer past a fully drained block. Only called once it's
+	 * known that more data is available, which guarantees the producer has
+	 * already linked the next block.
 	 */
-	void write_seek(const buffer_seek direction, const std::size_t offset) {
-		switch(direction) {
-			case buffer_seek::sk_absolute:
-				write_offset = offset;
-				break;
-			case buffer_seek::sk_backward:
-				write_offset -= static_cast<offset_type>(offset);
-				break;
-			case buffer_seek::sk_forward:
-				write_offset += static_cast<offset_type>(offset);
-				break;
+	void advance_head() {
+		if(consumer_.offset != block_sz) {
+			return;
 		}
+
+		auto drained = consumer_.head;
+		consumer_.head = drained->next.load(std::memory_order_acquire);
+		consumer_.offset = 0;
+		assert(consumer_.head && "spsc_buffer block not linked");
+		recycle(drained);
 	}
 
-	/**
-	 * @brief Advances the write cursor.
-	 * 
-	 * If the requested number of bytes exceeds the free space, the
-	 * request will be capped at the amount of free space.
-	 * 
-	 * @param size The number of bytes by which to advance the write cursor.
-	 * 
-	 * @return The number of bytes the write cursor was advanced by, which
-	 * may be less than requested.
-	 */
-	std::size_t advance_write(std::size_t size) {
-		const auto remaining = free();
+	template<typename func>
+	void consume(size_type length, func&& handler) {
+		assert(length <= size() && "SPSC buffer read too large!");
+		size_type remaining = length;
 
-		if(remaining < size) {
-			size = remaining;
+		while(remaining) {
+			advance_head();
+			const auto count = std::min(remaining, block_sz - consumer_.offset);
+			handler(consumer_.head->storage.data() + consumer_.offset, length - remaining, count);
+			consumer_.offset += count;
+			remaining -= count;
 		}
 
-		write_offset += static_cast<offset_type>(size);
-		return size;
+		const auto total = consumer_.total.load(std::memory_order_relaxed);
+		consumer_.total.store(total + length, std::memory_order_release);
 	}
 
-	/**
-	 * @brief Retrieve a pointer to the readable portion of the buffer.
-	 * 
-	 * @return Pointer to the readable portion of the buffer.
-	 */
-	const value_type* read_ptr() const {
-		return storage.data() + read_offset;
+public:
+	spsc_buffer() {
+		auto initial = new block();
+		producer_.tail = initial;
+		consumer_.head = initial;
 	}
 
-	/**
-	 * @brief Retrieve a pointer to the readable portion of the buffer.
-	 * 
-	 * @return Pointer to the readable portion of the buffer.
-	 */
-	value_type* read_ptr() {
-		return storage.data() + read_offset;
+	spsc_buffer(const spsc_buffer&) = delete;
+	spsc_buffer& operator=(const spsc_buffer&) = delete;
+
+	~spsc_buffer() {
+		free_list(consumer_.head);
+		free_list(producer_.spare);
+		free_list(recycled_.load(std::memory_order_acquire));
 	}
 
 	/**
-	 * @brief Retrieve a pointer to the writeable portion of the buffer.
+	 * @brief Write data to the container. Producer only.
 	 * 
-	 * @return Pointer to the writeable portion of the buffer.
+	 * @param source Pointer to the data to be written.
 	 */
-	const value_type* write_ptr () const {
-		return storage.data() + write_offset;
+	void write(const auto& source) {
+		write(&source, sizeof(source));
 	}
 
 	/**
-	 * @brief Retrieve a pointer to the writeable portion of the buffer.
+	 * @brief Write provided data to the container. Producer only.
 	 * 
-	 * @return Pointer to the writeable portion of the buffer.
+	 * @note The written data becomes visible to the consumer once
+	 * the call has returned.
+	 * 
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
 	 */
-	value_type* write_ptr() {
-		return storage.data() + write_offset;
+	void write(const void* source, const size_type length) {
+		auto src = static_cast<const value_type*>(source);
+		size_type remaining = length;
+
+		while(remaining) {
+			if(producer_.offset == block_sz) {
+				auto next = next_block();
+				producer_.tail->next.store(next, std::memory_order_release);
+				producer_.tail = next;
+				producer_.offset = 0;
+			}
+
+			const auto count = std::min(remaining, block_sz - producer_.offset);
+			std::memcpy(producer_.tail->storage.data() + producer_.offset, src, count);
+			producer_.offset += count;
+			src += count;
+			remaining -= count;
+		}
+
+		const auto total = producer_.total.load(std::memory_order_relaxed);
+		producer_.total.store(total + length, std::memory_order_release);
 	}
 
 	/**
-	 * @brief Retrieve a span to the readable portion of the buffer.
+	 * @brief Reads a number of bytes to the provided buffer. Consumer only.
 	 * 
-	 * @return Span to the readable portion of the buffer.
+	 * @param[out] destination The buffer to copy the data to.
 	 */
-	std::span<const value_type> read_data() const {
-		return { storage.data() + read_offset, size() };
+	template<typename T>
+	void read(T* destination) {
+		read(destination, sizeof(T));
 	}
 
 	/**
-	 * @brief Retrieve a span to the readable portion of the buffer.
+	 * @brief Reads a number of bytes to the provided buffer. Consumer only.
 	 * 
-	 * @return Span to the readable portion of the buffer.
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to read into the buffer.
 	 */
-	std::span<value_type> read_data() {
-		return { storage.data() + read_offset, size() } ;
+	void read(void* destination, const size_type length) {
+		auto dest = static_cast<value_type*>(destination);
+
+		consume(length, [&](const value_type* data, size_type offset, size_type count) {
+			std::memcpy(dest + offset, data, count);
+		});
 	}
 
 	/**
-	 * @brief Retrieve a span to the writeable portion of the buffer.
+	 * @brief Skip the requested number of bytes. Consumer only.
 	 * 
-	 * @return Span to the writeable portion of the buffer.
+	 * @param length The number of bytes to skip.
 	 */
-	std::span<const value_type> write_data() const {
-		return { storage.data() + write_offset, free() } ;
+	void skip(const size_type length) {
+		consume(length, [](const value_type*, size_type, size_type) {});
 	}
 
 	/**
-	 * @brief Retrieve a span to the writeable portion of the buffer.
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor. Consumer only.
 	 * 
-	 * @return Span to the writeable portion of the buffer.
+	 * @param[out] destination The buffer to copy the data to.
 	 */
-	std::span<value_type> write_data() {
-		return { storage.data() + write_offset, free() } ;
+	template<typename T>
+	void copy(T* destination) const {
+		copy(destination, sizeof(T));
 	}
 
 	/**
-	 * @brief Retrieves a reference to the specified index within the container.
-	 * 
-	 * @param index The index within the container.
+	 * @brief Copies a number of bytes to the provided buffer but without advancing
+	 * the read cursor. Consumer only.
 	 * 
-	 * @return A reference to the value at the specified index.
+	 * @param[out] destination The buffer to copy the data to.
+	 * @param length The number of bytes to copy.
 	 */
-	value_type& operator[](const std::size_t index) {
-		return *(storage.data() + index);
+	void copy(void* destination, const size_type length) const {
+		assert(length <= size() && "SPSC buffer copy too large!");
+		auto dest = static_cast<value_type*>(destination);
+		auto head = consumer_.head;
+		auto offset = consumer_.offset;
+		size_type remaining = length;
+
+		while(remaining) {
+			if(offset == block_sz) {
+				head = head->next.load(std::memory_order_acquire);
+				offset = 0;
+			}
+
+			const auto count = std::min(remaining, block_sz - offset);
+			std::memcpy(dest + length - remaining, head->storage.data() + offset, count);
+			offset += count;
+			remaining -= count;
+		}
 	}
 
 	/**
-	 * @brief Retrieves a reference to the specified index within the container.
+	 * @brief Attempts to locate the provided value within the data that
+	 * is currently available to the consumer. Consumer only.
 	 * 
-	 * @param index The index within the container.
+	 * @param value The value to locate.
 	 * 
-	 * @return A reference to the value at the specified index.
+	 * @return The position of value or npos if not found.
 	 */
-	const value_type& operator[](const std::size_t index) const {
-		return *(storage.data() + index);
-	}
-};
-
-} // impl, hexi
-
-#include <concepts>
-#include <functional>
-#include <memory>
-#include <utility>
-#ifdef HEXI_BUFFER_DEBUG
-#include <algorithm>
-#include <vector>
-#endif
-#include <cstddef>
-#include <cstdint>
-#include <cassert>
-
-namespace hexi {
-
-template<typename buffer_type>
-class buffer_sequence;
-
-template<decltype(auto) block_sz>
-concept int_gt_zero = std::integral<decltype(block_sz)> && block_sz > 0;
-
-template<decltype(auto) block_sz,
-	byte_type storage_value_type = std::byte,
-	typename allocator = default_allocator<impl::intrusive_storage<block_sz, storage_value_type>>
->
-requires int_gt_zero<block_sz>
-class dynamic_buffer final : public pmc::buffer {
-public:
-	using storage_type = impl::intrusive_storage<block_sz, storage_value_type>;
-	using value_type   = storage_value_type;
-	using node_type    = impl::intrusive_node;
-	using size_type    = std::size_t;
-	using offset_type  = std::size_t;
-	using contiguous   = is_non_contiguous;
-	using seeking      = supported;
+	size_type find_first_of(const value_type value) const {
+		const auto available = size();
+		auto head = consumer_.head;
+		auto offset = consumer_.offset;
+		size_type index = 0;
 
-	static constexpr auto npos { static_cast<size_type>(-1) };
+		while(index < available) {
+			if(offset == block_sz) {
+				head = head->next.load(std::memory_order_acquire);
+				offset = 0;
+			}
 
-	using unique_storage = std::unique_ptr<storage_type, std::function<void(storage_type*)>>;
+			const auto count = std::min(available - index, block_sz - offset);
+			const auto begin = head->storage.data() + offset;
+			const auto it = std::find(begin, begin + count, value);
 
-private:
-	node_type root_;
-	size_type size_;
-	[[no_unique_address]] allocator allocator_;
+			if(it != begin + count) {
+				return index + (it - begin);
+			}
 
-	void link_tail_node(node_type* node) {
-		node->next = &root_;
-		node->prev = root_.prev;
-		root_.prev = root_.prev->next = node;
-	}
+			offset += count;
+			index += count;
+		}
 
-	void unlink_node(node_type* node) {
-		node->next->prev = node->prev;
-		node->prev->next = node->next;
+		return npos;
 	}
 
-	inline storage_type* buffer_from_node(const node_type* node) const {
-		return reinterpret_cast<storage_type*>(std::uintptr_t(node)
-			- offsetof(storage_type, node));
+	/**
+	 * @brief Returns the amount of data published by the producer that
+	 * has not yet been consumed.
+	 * 
+	 * @return The number of bytes of data available to read.
+	 */
+	size_type size() const {
+		const auto read = consumer_.total.load(std::memory_order_acquire);
+		const auto written = producer_.total.load(std::memory_order_acquire);
+		return written - read;
 	}
 
-	void move(dynamic_buffer& rhs) noexcept {
-		if(this == &rhs) { // self-assignment
-			return;
-		}
-
-		clear(); // clear our current blocks rather than swapping them
-
-		size_ = rhs.size_;
-		root_ = rhs.root_;
-		root_.next->prev = &root_;
-		root_.prev->next = &root_;
-		rhs.size_ = 0;
-		rhs.root_.next = &rhs.root_;
-		rhs.root_.prev = &rhs.root_;
+	/**
+	 * @brief Whether the container is empty.
+	 * 
+	 * @return Returns true if the container has no data to be read.
+	 */
+	[[nodiscard]]
+	bool empty() const {
+		return !size();
 	}
 
-	void copy(const dynamic_buffer& rhs) {
-		if(this == &rhs) { // self-assignment
-			return;
-		}
-
-		const node_type* head = rhs.root_.next;
-		root_.next = &root_;
-		root_.prev = &root_;
-		size_ = 0;
-
-		while(head != &rhs.root_) {
-			auto buffer = allocate();
-			*buffer = *buffer_from_node(head);
-			link_tail_node(&buffer->node);
-			size_ += buffer->write_offset;
-			head = head->next;
-		}
-	}
-	
-#ifdef HEXI_BUFFER_DEBUG
-	void offset_buffers(std::vector<storage_type*>& buffers, size_type offset) {
-		std::erase_if(buffers, [&](auto block) {
-			if(block->size() > offset) {
-				block->read_offset += offset;
-				block->write_offset -= offset;
-				return false;
-			} else {
-				return true;
-			}
-		});
+	/**
+	 * @brief Retrieves the container's block size.
+	 * 
+	 * @return The block size.
+	 */
+	constexpr static size_type block_size() {
+		return block_sz;
 	}
-#endif
+};
 
-	value_type& byte_at_index(const size_type index) const {
-		assert(index < size_ && "buffer subscript index out of range");
+} // hexi
 
-		auto head = root_.next;
-		auto buffer = buffer_from_node(head);
-		const auto offset_index = index + buffer->read_offset;
-		const auto node_index = offset_index / block_sz;
+// #include <hexi/static_buffer.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
-		for(size_type i = 0; i < node_index; ++i) {
-			head = head->next;
-		}
 
-		buffer = buffer_from_node(head);
-		return (*buffer)[offset_index % block_sz];
-	}
 
-	size_type abs_seek_offset(size_type offset) {
-		if(offset < size_) {
-			return size_ - offset;
-		} else if(offset > size_) {
-			return offset - size_;
-		} else {
-			return 0;
-		}
-	}
+// #include <hexi/exception.h>
 
-	[[nodiscard]] storage_type* allocate() {
-		return allocator_.allocate();
-	}
+// #include <hexi/shared.h>
 
-	void deallocate(storage_type* buffer) {
-		allocator_.deallocate(buffer);
-	}
+// #include <hexi/concepts.h>
 
-public:
-	dynamic_buffer()
-		: root_{ .next = &root_, .prev = &root_ },
-		  size_(0) {}
+#include <array>
+#include <span>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
 
-	~dynamic_buffer() {
-		clear();
-	}
+namespace hexi {
 
-	dynamic_buffer& operator=(dynamic_buffer&& rhs) noexcept {
-		move(rhs);
-		return *this;
-	}
+template<byte_type storage_type, std::size_t buf_size>
+class static_buffer final {
+	std::array<storage_type, buf_size> buffer_ = {};
+	std::size_t read_ = 0;
+	std::size_t write_ = 0;
 
-	dynamic_buffer(dynamic_buffer&& rhs) noexcept {
-		move(rhs);
-	}
+public:
+	using size_type       = typename decltype(buffer_)::size_type;
+	using offset_type     = size_type;
+	using value_type      = storage_type;
+	using contiguous      = is_contiguous;
+	using seeking         = supported;
 
-	dynamic_buffer(const dynamic_buffer& rhs) {
-		copy(rhs);
-	}
+	// offset of the reserved region within the underlying storage
+	using placeholder_type = size_type;
 
-	dynamic_buffer& operator=(const dynamic_buffer& rhs) {
-		clear();
-		copy(rhs);
-		return *this;
+	static constexpr auto npos { static_cast<size_type>(-1) };
+	
+	static_buffer() = default;
+
+	template<typename... T> 
+	static_buffer(T&&... vals) : buffer_{ std::forward<T>(vals)... } {
+		write_ = sizeof... (vals);
 	}
 
+	static_buffer(static_buffer&& rhs) = default;
+	static_buffer& operator=(static_buffer&&) = default;
+	static_buffer& operator=(const static_buffer&) = default;
+	static_buffer(const static_buffer&) = default;
+
 	/**
 	 * @brief Reads a number of bytes to the provided buffer.
 	 * 
-	 * @note The destination buffer must not overlap with any of the underlying
-	 * buffers being used by the dynamic buffer.
-	 * 
-	 * @param[out] destination The buffer to copy the data to.
+	 * @param destination The buffer to copy the data to.
 	 */
 	template<typename T>
 	void read(T* destination) {
@@ -2789,42 +9552,23 @@ public:
 	/**
 	 * @brief Reads a number of bytes to the provided buffer.
 	 * 
-	 * @note The destination buffer must not overlap with any of the underlying
-	 * buffers being used by the dynamic buffer.
-	 * 
-	 * @param[out] destination The buffer to copy the data to.
+	 * @param destination The buffer to copy the data to.
 	 * @param length The number of bytes to read into the buffer.
 	 */
-	void read(void* destination, size_type length) override {
-		assert(length <= size_ && "Chained buffer read too large!");
-		size_type remaining = length;
-
-		while(true) {
-			auto buffer = buffer_from_node(root_.next);
-			remaining -= buffer->read(
-				static_cast<value_type*>(destination) + length - remaining, remaining,
-				                         root_.next == root_.prev
-			);
+	void read(void* destination, size_type length) {
+		copy(destination, length);
+		read_ += length;
 
-			if(remaining) [[unlikely]] {
-				unlink_node(root_.next);
-				deallocate(buffer);
-			} else {
-				break;
-			}
+		if(read_ == write_) {
+			read_ = write_ = 0;
 		}
-
-		size_ -= length;
 	}
 
 	/**
 	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the container's read cursor.
-	 * 
-	 * @note The source buffer must not overlap with any of the underlying
-	 * buffers being used by the dynamic buffer.
+	 * the read cursor.
 	 * 
-	 * @param[out] destination The buffer to copy the data to.
+	 * @param destination The buffer to copy the data to.
 	 */
 	template<typename T>
 	void copy(T* destination) const {
@@ -2833,266 +9577,227 @@ public:
 
 	/**
 	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the container's read cursor.
+	 * the read cursor.
 	 * 
-	 * @note The destination buffer must not overlap with any of the underlying
-	 * buffers being used by the dynamic buffer.
+	 * @note The destination buffer address must not belong to the static_buffer.
 	 * 
-	 * @param[out] destination The buffer to copy the data to.
+	 * @param destination The buffer to copy the data to.
 	 * @param length The number of bytes to copy.
 	 */
-	void copy(void* destination, const size_type length) const override {
-		assert(length <= size_ && "Chained buffer copy too large!");
-		size_type remaining = length;
-		auto head = root_.next;
-
-		while(true) {
-			const auto buffer = buffer_from_node(head);
-			remaining -= buffer->copy(
-				static_cast<value_type*>(destination) + length - remaining, remaining
-			);
+	void copy(void* destination, size_type length) const {
+		assert(!region_overlap(buffer_.data(), buffer_.size(), destination, length));
 
-			if(remaining) [[unlikely]] {
-				head = head->next;
-			} else {
-				break;
-			}
+		if(length > size()) {
+			HEXI_THROW(buffer_underrun(length, read_, size()));
 		}
+
+		std::memcpy(destination, read_ptr(), length);
 	}
 
-#ifdef HEXI_BUFFER_DEBUG
 	/**
-	 * @brief Retrives underlying buffers owned by the dynamic buffer.
-	 *
-	 * @param length Limit returned buffers to those holding up to the requested amount
-	 * of data.
-	 * @param offset The offset to start at.
+	 * @brief Attempts to locate the provided value within the container.
 	 * 
-	 * @return Container of pointers to the underlying buffers holding the range of data
-	 * requested by length and offset.
+	 * @param value The value to locate.
+	 * 
+	 * @return The position of value or npos if not found.
 	 */
-	std::vector<storage_type*> fetch_buffers(const size_type length, const size_type offset = 0) {
-		size_type total = length + offset;
-		assert(total <= size_ && "Chained buffer fetch too large!");
-		std::vector<storage_type*> buffers;
-		auto head = root_.next;
+	size_type find_first_of(value_type val) const noexcept {
+		const auto data = read_ptr();
 
-		while(total) {
-			auto buffer = buffer_from_node(head);
-			size_type read_size = block_sz - buffer->read_offset;
-			
-			// guard against overflow - buffer may have more content than requested
-			if(read_size > total) {
-				read_size = total;
+		for(size_type i = 0, j = size(); i < j; ++i) {
+			if(data[i] == val) {
+				return i;
 			}
-
-			buffers.emplace_back(buffer);
-			total -= read_size;
-			head = head->next;
-		}
-
-		if(offset) {
-			offset_buffers(buffers, offset);
 		}
 
-		return buffers;
+		return npos;
 	}
-#endif
 
 	/**
-	 * @brief Skip the requested number of bytes.
-	 *
+	 * @brief Skip over a number of bytes.
+	 * 
 	 * Skips over a number of bytes from the container. This should be used
 	 * if the container holds data that you don't care about but don't want
 	 * to have to read it to another buffer to access data beyond it.
 	 * 
 	 * @param length The number of bytes to skip.
 	 */
-	void skip(const size_type length) override {
-		assert(length <= size_ && "Chained buffer skip too large!");
-		size_type remaining = length;
+	void skip(const size_type length) {
+		read_ += length;
 
-		while(true) {
-			auto buffer = buffer_from_node(root_.next);
-			remaining -= buffer->skip(remaining, root_.next == root_.prev);
+		if(read_ == write_) {
+			read_ = write_ = 0;
+		}
+	}
 
-			if(remaining) [[unlikely]] {
-				unlink_node(root_.next);
-				deallocate(buffer);
-			} else {
-				break;
-			}
+	/**
+	 * @brief Advances the write cursor.
+	 * 
+	 * @param size The number of bytes by which to advance the write cursor.
+	 */
+	void advance_write(size_type bytes) {
+		assert(free() >= bytes);
+		write_ += bytes;
+	}
+
+	/**
+	 * @brief Resizes the buffer.
+	 * 
+	 * @param size The new size of the buffer.
+	 * 
+	 */
+	void resize(size_type size) {
+		if(size > buffer_.size()) {
+			HEXI_THROW(exception("attempted to resize static_buffer to larger than capacity"));
 		}
 
-		size_ -= length;
+		write_ = size;
+	}
+
+	/**
+	 * @brief Clears the container.
+	 */
+	void clear() {
+		read_ = write_ = 0;
+	}
+
+	/**
+	 * @brief Moves any unread data to the front of the buffer, freeing space at the end.
+	 * If a move is performed, pointers obtained from read/write_ptr() will be invalidated.
+	 * 
+	 * If the buffer contains no data available for reading, this function will have no effect.
+	 * 
+	 * @return True if additional space was made available.
+	 */
+	bool defragment() {
+		if(read_ == 0) {
+			return false;
+		}
+
+		write_ = size();
+		std::memmove(buffer_.data(), read_ptr(), write_);
+		read_ = 0;
+		return true;
 	}
 
 	/**
-	 * @brief Write data to the container.
+	 * @brief Retrieves a reference to the specified index within the container.
 	 * 
-	 * @note The source buffer must not overlap with any of the underlying buffers
-	 * being used by the dynamic buffer.
+	 * @param index The index within the container.
 	 * 
-	 * @param source Pointer to the data to be written.
+	 * @return A reference to the value at the specified index.
 	 */
-	void write(const auto& source) {
-		write(&source, sizeof(source));
+	value_type& operator[](const size_type index) {
+		return read_ptr()[index];
 	}
 
 	/**
-	 * @brief Write provided data to the container.
+	 * @brief Retrieves a reference to the specified index within the container.
 	 * 
-	 * @note The source buffer must not overlap with any of the underlying buffers
-	 * being used by the dynamic buffer.
+	 * @param index The index within the container.
 	 * 
-	 * @param source Pointer to the data to be written.
-	 * @param length Number of bytes to write from the source.
+	 * @return A reference to the value at the specified index.
 	 */
-	void write(const void* source, const size_type length) override {
-		size_type remaining = length;
-		node_type* tail = root_.prev;
-
-		do {
-			storage_type* buffer;
-
-			if(tail != &root_) [[likely]] {
-				buffer = buffer_from_node(tail);
-			} else {
-				buffer = allocate();
-				link_tail_node(&buffer->node);
-				tail = root_.prev;
-			}
-
-			remaining -= buffer->write(
-				static_cast<const value_type*>(source) + length - remaining, remaining
-			);
-
-			tail = tail->next;
-		} while(remaining);
-
-		size_ += length;
+	const value_type& operator[](const size_type index) const {
+		return read_ptr()[index];
 	}
 
 	/**
-	 * @brief Reserves a number of bytes within the container for future use.
+	 * @brief Whether the container is empty.
 	 * 
-	 * @param length The number of bytes that the container should reserve.
+	 * @return Returns true if the container is empty (has no data to be read).
 	 */
-	void reserve(const size_type length) override {
-		size_type remaining = length;
-		node_type* tail = root_.prev;
-
-		do {
-			storage_type* buffer;
-
-			if(tail == &root_) [[unlikely]] {
-				buffer = allocate();
-				link_tail_node(&buffer->node);
-				tail = root_.prev;
-			} else {
-				buffer = buffer_from_node(tail);
-			}
-
-			remaining -= buffer->advance_write(remaining);
-			tail = tail->next;
-		} while(remaining);
-
-		size_ += length;
+	[[nodiscard]]
+	bool empty() const {
+		return write_ == read_;
 	}
 
 	/**
-	 * @brief Returns the size of the container.
-	 * 
-	 * @return The number of bytes of data available to read within the container.
+	 * @return Whether the container is full and cannot be further written to.
 	 */
-	size_type size() const override {
-		return size_;
+	bool full() const {
+		return write_ == capacity();
 	}
 
 	/**
-	 * @brief Retrieves the last buffer in the container's list.
+	 * @brief Determine whether the adaptor supports write seeking.
 	 * 
-	 * @return A reference to the value at the specified index.
-	 * @note The container retains ownership over the buffer, so it must not
-	 * be deallocated by the caller.
+	 * This is determined at compile-time and does not need to be checked at
+	 * run-time.
+	 * 
+	 * @return True if write seeking is supported, otherwise false.
 	 */
-	storage_type* back() const {
-		if(root_.prev == &root_) {
-			return nullptr;
-		}
-
-		return buffer_from_node(root_.prev);
+	constexpr static bool can_write_seek() {
+		return std::is_same_v<seeking, supported>;
 	}
 
 	/**
-	 * @brief Retrieves the buffer's block sized.
+	 * @brief Write data to the container.
 	 * 
-	 * @param index The index within the buffer.
-	 * @return A reference to the value at the specified index.
+	 * @param source Pointer to the data to be written.
 	 */
-	storage_type* front() const {
-		if(root_.next == &root_) {
-			return nullptr;
-		}
-
-		return buffer_from_node(root_.next);
+	void write(const auto& source) {
+		write(&source, sizeof(source));
 	}
 
 	/**
-	 * @brief Removes the first buffer from the container.
+	 * @brief Write provided data to the container.
 	 * 
-	 * @return A pointer to the popped buffer.
+	 * @note The source buffer address must not belong to the static_buffer.
 	 * 
-	 * @note Removing the buffer from the container also transfers ownership.
-	 * Therefore, the caller assumes responsibility for deallocating the buffer
-	 * when it is no longer required. Alternatively, it can be pushed back into
-	 * the container to transfer ownership back.
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write from the source.
 	 */
-	auto pop_front() {
-		auto buffer = buffer_from_node(root_.next);
-		size_ -= buffer->size();
-		unlink_node(root_.next);
-		return unique_storage(buffer, [&](auto ptr) {
-			deallocate(ptr);
-		});
+	void write(const void* source, size_type length) {
+		assert(!region_overlap(source, length, buffer_.data(), buffer_.size()));
+
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, write_, free()));
+		}
+
+		std::memcpy(write_ptr(), source, length);
+		write_ += length;
 	}
 
 	/**
-	 * @brief Attaches additional storage to the container.
+	 * @brief Reserves space at the write cursor to be filled in later.
 	 * 
-	 * @param buffer The block to add to the container.
+	 * @note The placeholder is invalidated by defragment() or once its
+	 * contents have been read.
 	 * 
-	 * @note Once pushed, the container is assumed to have ownership over the buffer.
-	 * The buffer storage must have been allocated by the same allocator as the container.
+	 * @param length The number of bytes to reserve.
+	 * 
+	 * @return A handle to the reserved space.
 	 */
-	void push_back(storage_type* buffer) {
-		link_tail_node(&buffer->node);
-		size_ += buffer->write_offset;
+	placeholder_type reserve_placeholder(size_type length) {
+		if(free() < length) {
+			HEXI_THROW(buffer_overflow(length, write_, free()));
+		}
+
+		const auto offset = write_;
+		write_ += length;
+		return offset;
 	}
 
 	/**
-	 * @brief Advances the write cursor.
+	 * @brief Writes data into previously reserved space.
 	 * 
-	 * @param size The number of bytes by which the write cursor to advance the cursor.
+	 * @param placeholder The handle returned by reserve_placeholder().
+	 * @param source Pointer to the data to be written.
+	 * @param length Number of bytes to write, which must not exceed the
+	 * reserved length.
 	 */
-	void advance_write(const size_type size) {
-		auto buffer = buffer_from_node(root_.prev);
-		const auto actual = buffer->advance_write(size);
-		assert(size <= block_sz && actual <= size &&
-		       "Attempted to advance write cursor out of bounds!");
-		size_ += size;
+	void fill_placeholder(placeholder_type placeholder, const void* source, size_type length) {
+		std::memcpy(placeholder_ptr(placeholder), source, length);
 	}
 
 	/**
-	 * @brief Determine whether the adaptor supports write seeking.
+	 * @param placeholder The handle returned by reserve_placeholder().
 	 * 
-	 * This is determined at compile-time and does not need to be checked at
-	 * run-time.
-	 * 
-	 * @return True if write seeking is supported, otherwise false.
+	 * @return Pointer to the start of the reserved space.
 	 */
-	bool can_write_seek() const override {
-		return std::is_same_v<seeking, supported>;
+	value_type* placeholder_ptr(placeholder_type placeholder) {
+		return buffer_.data() + placeholder;
 	}
 
 	/**
@@ -3102,179 +9807,155 @@ public:
 	 * @param offset The offset relative to the seek direction or the absolute value
 	 * when using absolute seeking.
 	 */
-	void write_seek(const buffer_seek direction, size_type offset) override {
-		// nothing to do in this case
-		if(direction == buffer_seek::sk_absolute && offset == size_) {
-			return;
-		}
-
-		auto tail = root_.prev;
-
+	void write_seek(const buffer_seek direction, const size_type offset) {
 		switch(direction) {
 			case buffer_seek::sk_backward:
-				size_ -= offset;
+				write_ -= offset;
 				break;
 			case buffer_seek::sk_forward:
-				size_ += offset;
+				write_ += offset;
 				break;
 			case buffer_seek::sk_absolute:
-				size_ = offset;
-				offset = abs_seek_offset(offset);
-				break;
+				write_ = offset;
 		}
+	}
 
-		const bool rewind
-			= (direction == buffer_seek::sk_backward
-			   || (direction == buffer_seek::sk_absolute && offset < size_));
-
-		while(offset) {
-			auto buffer = buffer_from_node(tail);
-			const auto max_seek = rewind? buffer->size() : buffer->free();
-
-			if(max_seek >= offset) {
-				buffer->write_seek(direction, offset);
-				offset = 0;
-			} else {
-				buffer->write_seek(direction, max_seek);
-				offset -= max_seek;
-				tail = rewind? tail->prev : tail->next;
-			}
-		}
+	/**
+	 * @return An iterator to the beginning of data available for reading.
+	 */
+	auto begin() {
+		return buffer_.begin() + read_;
+	}
 
-		root_.prev = tail;
+	/**
+	 * @return An iterator to the beginning of data available for reading.
+	 */
+	auto begin() const {
+		return buffer_.begin() + read_;
 	}
 
 	/**
-	 * @brief Clears the container.
+	 * @return An iterator to the end of data available for reading.
 	 */
-	void clear() {
-		node_type* head = root_.next;
+	auto end() {
+		return buffer_.begin() + write_;
+	}
 
-		while(head != &root_) {
-			auto next = head->next;
-			deallocate(buffer_from_node(head));
-			head = next;
-		}
+	/**
+	 * @return An iterator to the end of data available for reading.
+	 */
+	auto end() const {
+		return buffer_.begin() + write_;
+	}
 
-		root_.next = &root_;
-		root_.prev = &root_;
-		size_ = 0;
+	/**
+	 * @brief Overall capacity of the container.
+	 * 
+	 * @return The container's total size in bytes.
+	 */
+	constexpr static size_type capacity() {
+		return buf_size;
 	}
 
 	/**
-	 * @brief Whether the container is empty.
+	 * @brief Returns the size of the container.
 	 * 
-	 * @return Returns true if the container is empty (has no data to be read).
+	 * @return The number of bytes of data available to read within the container.
 	 */
-	[[nodiscard]]
-	bool empty() const override {
-		return !size_;
+	size_type size() const {
+		return write_ - read_;
 	}
 
 	/**
-	 * @brief Retrieves the container's block size.
+	 * @brief The amount of free space.
 	 * 
-	 * @return The block size.
+	 * @return The number of bytes of free space within the container.
 	 */
-	constexpr static size_type block_size() {
-		return block_sz;
+	size_type free() const {
+		return buf_size - write_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	const value_type* data() const {
+		return read_ptr();
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	value_type* data() {
+		return read_ptr();
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	const value_type* read_ptr() const {
+		return buffer_.data() + read_;
+	}
+
+	/**
+	 * @return Pointer to the data available for reading.
+	 */
+	value_type* read_ptr() {
+		return buffer_.data() + read_;
 	}
 
 	/**
-	 * @brief Retrieves a reference to the specified index within the container.
-	 * 
-	 * @param index The index within the container.
-	 * 
-	 * @return A reference to the value at the specified index.
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
 	 */
-	value_type& operator[](const size_type index) override {
-		return byte_at_index(index);
+	const value_type* write_ptr() const {
+		return buffer_.data() + write_;
 	}
 
 	/**
-	 * @brief Retrieves a reference to the specified index within the container.
-	 * 
-	 * @param index The index within the container.
-	 * 
-	 * @return A reference to the value at the specified index.
+	 * @return Pointer to the location within the buffer where the next write
+	 * will be made.
 	 */
-	const value_type& operator[](const size_type index) const override {
-		return byte_at_index(index);
+	value_type* write_ptr() {
+		return buffer_.data() + write_;
 	}
 
 	/**
-	 * @brief Retrieves the number of allocated blocks currently being used by the container.
-	 * 
-	 * @return The number of allocated blocks.
+	 * @return Pointer to the underlying storage.
 	 */
-	size_type block_count() const {
-		auto node = &root_;
-		size_type count = 0;
-
-		// not calculating based on block size & size as it
-		// wouldn't play nice with seeking or manual push/pop
-		while(node->next != root_.prev->next) {
-			++count;
-			node = node->next;
-		}
-
-		return count;
+	value_type* storage() {
+		return buffer_.data();
 	}
 
 	/**
-	 * @brief Attempts to locate the provided value within the container.
-	 * 
-	 * @param value The value to locate.
-	 * 
-	 * @return The position of value or npos if not found.
+	 * @return Pointer to the underlying storage.
 	 */
-	size_type find_first_of(value_type value) const override {
-		size_type index = 0;
-		auto head = root_.next;
-
-		while(head != &root_) {
-			const auto buffer = buffer_from_node(head);
-			const auto data = buffer->read_data();
-			
-			for(const auto& byte : data) {
-				if(byte == value) {
-					return index;
-				}
-
-				++index;
-			}
-
-			head = head->next;
-		}
-
-		return npos;
+	const value_type* storage() const {
+		return buffer_.data();
 	}
 
 	/**
-	 * @brief Retrieves the container's allocator.
+	 * @brief Retrieves a span representing the data available for reading contained within
+	 * underlying storage.
 	 * 
-	 * @return The memory allocator.
+	 * @return A span over the data waiting to be read from the container.
 	 */
-	auto& get_allocator() {
-		return allocator_;
+	std::span<const value_type> read_span() const {
+		return { read_ptr(), size() };
 	}
 
 	/**
-	 * @brief Retrieves the container's allocator.
+	 * @brief Retrieves a span representing the free space within the underlying storage.
 	 * 
-	 * @return The memory allocator.
+	 * @return A span over the container's free space.
 	 */
-	auto& get_allocator() const {
-		return allocator_;
+	std::span<value_type> write_span() {
+		return { write_ptr(), free() };
 	}
-
-	template<typename buffer_type>
-	friend class buffer_sequence;
 };
 
 } // hexi
 
-// #include <hexi/dynamic_tls_buffer.h>
+// #include <hexi/null_buffer.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -3283,18 +9964,47 @@ public:
 
 
 
-// #include <hexi/dynamic_buffer.h>
+// #include <hexi/pmc/buffer_write.h>
 
-// #include <hexi/allocators/tls_block_allocator.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+// #include <hexi/shared.h>
 
+// #include <hexi/exception.h>
 
+#include <cstddef>
 
-// #include <hexi/allocators/block_allocator.h>
+namespace hexi {
+
+class null_buffer final : public pmc::buffer_write {
+public:
+	using size_type       = std::size_t;
+	using offset_type     = std::size_t;
+	using value_type      = std::byte;
+	using contiguous      = is_contiguous;
+	using seeking         = unsupported;
+
+	struct placeholder_type {};
+
+	void write(const auto& /*elem*/) {}
+	void write(const void* /*source*/, size_type /*length*/) override {};
+	void read(auto* /*elem*/) {}
+	void read(void* /*destination*/, size_type /*length*/) {};
+	void copy(auto* /*elem*/) const {}
+	void copy(void* /*destination*/, size_type /*length*/) const {};
+	void reserve(const size_type /*length*/) override {};
+	size_type size() const override{ return 0; };
+	[[nodiscard]] bool empty() const override { return true; };
+	bool can_write_seek() const override { return false; }
+	placeholder_type reserve_placeholder(size_type /*length*/) { return {}; }
+	void fill_placeholder(placeholder_type, const void* /*source*/, size_type /*length*/) {}
+
+	void write_seek(const buffer_seek /*direction*/, const std::size_t /*offset*/) override {
+		HEXI_THROW(exception("Don't do this on a null_buffer")); 
+	};
+};
+
+} // hexi
+
+// #include <hexi/quantise.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -3303,387 +10013,468 @@ public:
 
 
 
+// #include <hexi/stream_adaptors.h>
+
+#include <algorithm>
 #include <array>
-#include <memory>
-#include <new>
-#include <thread>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <ranges>
+#include <span>
 #include <type_traits>
-#include <utility>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 
-#ifndef NDEBUG
-#define HEXI_DEBUG_ALLOCATORS
-#endif
-
 namespace hexi {
 
 namespace impl {
 
-struct free_block {
-	free_block* next;
-};
+template<unsigned bits>
+using uint_least = std::conditional_t<bits <= 8, std::uint8_t,
+	std::conditional_t<bits <= 16, std::uint16_t,
+	std::conditional_t<bits <= 32, std::uint32_t, std::uint64_t>>>;
 
-template<decltype(auto) size>
-concept gt_zero = size > 0;
+template<typename T>
+constexpr T sign_not_zero(const T value) {
+	return value < T(0)? T(-1) : T(1);
+}
 
-template<typename T, typename U>
-concept sizeof_gte = sizeof(T) >= sizeof(U);
+// clamps to [0, 1], mapping NaN to zero
+template<typename T>
+constexpr T saturate(const T value) {
+	return value > T(0)? (value < T(1)? value : T(1)) : T(0);
+}
 
 } // impl
 
-struct no_validate_dealloc {};
-struct validate_dealloc : no_validate_dealloc {};
-
-/**
- * Basic fixed-size block stack allocator that preallocates a slab of memory
- * capable of holding a compile-time determined number of elements.
- * When constructed, a linked list of chunks is built within the slab and
- * each allocation request will take the head node. Since the allocations
- * are fixed-size, the list does not need to be traversed for a suitable
- * size. Deallocations place the chunk as the new head (LIFO).
- *
- * If the preallocated slab runs out of chunks, it will fall back to using the
- * system allocator rather than allocating additional slabs. This means sizing
- * the initial allocation correctly is important for maximum performance, so
- * it's better to be pessimistic. This is a server application and RAM is cheap. :)
- *
- * PagePolicy: 'lock' requests that the OS does not page out the memory slab to disk.
- *
- * ThreadPolicy: 'same_thread' triggers an assert if an allocated object
- * is deallocated from a different thread. Used by the TLS allocator, since
- * implementing the functionality there is messier (and slower).
+/*
+ * Codecs convert a value to and from a compact wire representation.
+ * They're used through the adaptors further down rather than directly.
+ * 
+ * Each provides a value_type, an unsigned or signed integral wire_type,
+ * the number of significant bits in the wire value (for bit_stream) and
+ * encode/decode functions.
  */
-template<typename _ty, 
-	std::size_t _elements,
-	std::derived_from<no_validate_dealloc> ValidatePolicy = no_validate_dealloc>
-requires impl::gt_zero<_elements> && impl::sizeof_gte<_ty, impl::free_block>
-class block_allocator {
-	using tid_type = std::conditional_t<
-		std::is_same_v<ValidatePolicy, validate_dealloc>, std::thread::id, std::monostate
-	>;
-
-	struct mem_block {
-		_ty obj;
-
-		struct {
-			[[no_unique_address]] tid_type thread_id;
-			bool using_new;
-		} meta;
-	};
+namespace codec {
 
-	static constexpr auto block_size = sizeof(mem_block);
+template<std::floating_point T, unsigned bits_>
+class quantise final {
+	static_assert(bits_ > 0 && bits_ <= std::numeric_limits<T>::digits,
+		"quantised values must fit within the type's mantissa");
 
-	impl::free_block* head_ = nullptr;
-	[[no_unique_address]] tid_type thread_id_;
-	std::array<char, block_size * _elements> storage_;
+	static constexpr T steps = T((std::uint64_t(1) << bits_) - 1);
 
-	void initialise_free_list() {
-		auto storage = storage_.data();
+	T min_, scale_, step_;
 
-		for(std::size_t i = 0; i < _elements; ++i) {
-			auto block = reinterpret_cast<impl::free_block*>(storage + (block_size * i));
-			push(block);
-		}
-	}
+public:
+	using value_type = T;
+	using wire_type = impl::uint_least<bits_>;
+	static constexpr unsigned bits = bits_;
 
-	inline void push(impl::free_block* block) {
-		assert(block);
-		block->next = head_;
-		head_ = block;
+	constexpr quantise(const T min, const T max)
+		: min_(min), scale_(steps / (max - min)), step_((max - min) / steps) {
+		assert(max > min);
 	}
 
-	[[nodiscard]] inline impl::free_block* pop() {
-		if(!head_) {
-			return nullptr;
-		}
+	constexpr wire_type encode(const T value) const {
+		auto scaled = (value - min_) * scale_;
+		scaled = scaled > T(0)? scaled : T(0); // NaN ends up at the minimum
+		scaled = scaled < steps? scaled : steps;
 
-		auto block = head_;
-		head_ = block->next;
-		return block;
-	}
+		/*
+		 * Rounded without adding 0.5 first, as at the full width of the
+		 * mantissa, steps + 0.5 isn't representable and would round up
+		 * to a value that doesn't fit in the wire bits
+		 */
+		auto whole = static_cast<wire_type>(scaled);
 
-public:
-#ifdef HEXI_DEBUG_ALLOCATORS
-	std::size_t storage_active_count = 0;
-	std::size_t new_active_count = 0;
-	std::size_t active_count = 0;
-	std::size_t total_allocs = 0;
-	std::size_t total_deallocs = 0;
-#endif
+		if(scaled - T(whole) >= T(0.5)) {
+			++whole;
+		}
 
-	block_allocator() requires std::same_as<ValidatePolicy, validate_dealloc>
-		: thread_id_(std::this_thread::get_id()) {
-		initialise_free_list();
+		return whole;
 	}
 
-	block_allocator() {
-		initialise_free_list();
+	constexpr T decode(const wire_type value) const {
+		return min_ + T(value) * step_;
 	}
+};
 
-	template<typename ...Args>
-	[[nodiscard]] inline _ty* allocate(Args&&... args) {
-		auto block = reinterpret_cast<mem_block*>(pop());
+template<std::floating_point T, unsigned fraction, std::integral wire>
+class fixed_point final {
+	static_assert(sizeof(wire) <= sizeof(std::uint32_t), "wire type must be 32 bits or fewer");
+	static_assert(fraction < sizeof(wire) * 8, "too many fractional bits for wire type");
 
-		if(block) [[likely]] {
-#ifdef HEXI_DEBUG_ALLOCATORS
-			++storage_active_count;
-#endif
-			block->meta.using_new = false;
-		} else {
-#ifdef HEXI_DEBUG_ALLOCATORS
-			++new_active_count;
-#endif
-			block = new mem_block;
-			block->meta.using_new = true;
-		}
+	static constexpr double scale = double(std::uint64_t(1) << fraction);
+	static constexpr double lowest = std::numeric_limits<wire>::lowest();
+	static constexpr double highest = std::numeric_limits<wire>::max();
 
-		if constexpr(std::is_same_v<ValidatePolicy, validate_dealloc>) {
-			block->meta.thread_id = thread_id_;
-		}
+public:
+	using value_type = T;
+	using wire_type = wire;
+	static constexpr unsigned bits = sizeof(wire) * 8;
 
-#ifdef HEXI_DEBUG_ALLOCATORS
-		++total_allocs;
-		++active_count;
-#endif
-		return new (&block->obj) _ty(std::forward<Args>(args)...);
+	constexpr wire_type encode(const T value) const {
+		auto scaled = double(value) * scale;
+		scaled = scaled > lowest? scaled : lowest;
+		scaled = scaled < highest? scaled : highest;
+		return static_cast<wire_type>(scaled + (scaled < 0.0? -0.5 : 0.5));
 	}
 
-	inline void deallocate(_ty* t) {
-		assert(t);
-		auto block = reinterpret_cast<mem_block*>(t);
-
-		if constexpr(std::is_same_v<ValidatePolicy, validate_dealloc>) {
-			assert(block->meta.thread_id == thread_id_
-				&& "thread policy violation or clobbered block");
-		}
+	constexpr T decode(const wire_type value) const {
+		return T(double(value) / scale);
+	}
+};
 
-		if(block->meta.using_new) [[unlikely]] {
-#ifdef HEXI_DEBUG_ALLOCATORS
-			--new_active_count;
-#endif
-			t->~_ty();
-			operator delete(block);
+/*
+ * IEEE 754 binary16, rounding to nearest even. Values beyond the
+ * range of a half become infinity and NaNs are preserved.
+ */
+template<std::floating_point T>
+class half final {
+public:
+	using value_type = T;
+	using wire_type = std::uint16_t;
+	static constexpr unsigned bits = 16;
+
+	constexpr wire_type encode(const T value) const {
+		constexpr std::uint32_t infinity = 255u << 23;
+		constexpr std::uint32_t max = (127u + 16u) << 23;
+		constexpr std::uint32_t min_normal = 113u << 23;
+		constexpr std::uint32_t denormal_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		auto input = std::bit_cast<std::uint32_t>(static_cast<float>(value));
+		const auto sign = input & 0x80000000u;
+		input ^= sign;
+		std::uint32_t output = 0;
+
+		if(input >= max) {
+			output = input > infinity? 0x7e00u : 0x7c00u;
+		} else if(input < min_normal) {
+			// let the FPU handle the rounding of subnormals
+			const auto magic = std::bit_cast<float>(denormal_magic);
+			output = std::bit_cast<std::uint32_t>(std::bit_cast<float>(input) + magic) - denormal_magic;
 		} else {
-#ifdef HEXI_DEBUG_ALLOCATORS
-			--storage_active_count;
-#endif
-			t->~_ty();
-			push(reinterpret_cast<impl::free_block*>(t));
+			const auto odd = (input >> 13) & 1u;
+			input += ((15u - 127u) << 23) + 0xfffu + odd;
+			output = input >> 13;
 		}
-
-#ifdef HEXI_DEBUG_ALLOCATORS
-		++total_deallocs;
-		--active_count;
-#endif
-	}
-
-	~block_allocator() {
-#ifdef HEXI_DEBUG_ALLOCATORS
-		assert(active_count == 0);
-#endif
+
+		return static_cast<wire_type>(output | (sign >> 16));
 	}
-};
 
-} // hexi
+	constexpr T decode(const wire_type value) const {
+		constexpr std::uint32_t shifted_exponent = 0x7c00u << 13;
+		constexpr std::uint32_t magic = 113u << 23;
 
-#include <type_traits>
-#include <utility>
-#include <cassert>
-#include <cstddef>
-#include <cstdint>
+		auto output = std::uint32_t(value & 0x7fffu) << 13;
+		const auto exponent = output & shifted_exponent;
+		output += (127u - 15u) << 23;
 
-#ifndef NDEBUG
-#define HEXI_DEBUG_ALLOCATORS
-#endif
+		if(exponent == shifted_exponent) {
+			output += (128u - 16u) << 23; // infinity or NaN
+		} else if(exponent == 0) {
+			output += 1u << 23;
+			output = std::bit_cast<std::uint32_t>(std::bit_cast<float>(output) - std::bit_cast<float>(magic));
+		}
 
-namespace hexi {
+		output |= std::uint32_t(value & 0x8000u) << 16;
+		return static_cast<T>(std::bit_cast<float>(output));
+	}
+};
 
-struct safe_entrant {};
-struct no_ref_counting {};
+/*
+ * The upper half of an IEEE 754 binary32, rounding to nearest even.
+ * Keeps the full range of a float at the cost of precision.
+ */
+template<std::floating_point T>
+class bfloat16 final {
+public:
+	using value_type = T;
+	using wire_type = std::uint16_t;
+	static constexpr unsigned bits = 16;
 
-struct unsafe_entrant : safe_entrant {};
-struct ref_counting : no_ref_counting {};
+	constexpr wire_type encode(const T value) const {
+		auto input = std::bit_cast<std::uint32_t>(static_cast<float>(value));
 
-template<typename _ty,
-	std::size_t _elements,
-	std::derived_from<no_ref_counting> ref_count_policy = no_ref_counting,
-	std::derived_from<safe_entrant> entrant_policy = safe_entrant
->
-class tls_block_allocator final {
-	using allocator_type = block_allocator<_ty, _elements>;
+		if((input & 0x7fffffffu) > 0x7f800000u) {
+			return static_cast<wire_type>((input >> 16) | 0x40u); // keep NaNs quiet
+		}
 
-	using ref_count = std::conditional_t<
-		std::is_same_v<ref_count_policy, ref_counting>, int, std::monostate
-	>;
+		input += 0x7fffu + ((input >> 16) & 1u);
+		return static_cast<wire_type>(input >> 16);
+	}
 
-	using tls_handle_cache = std::conditional_t<
-		std::is_same_v<entrant_policy, unsafe_entrant>, allocator_type*, std::monostate
-	>;
+	constexpr T decode(const wire_type value) const {
+		return static_cast<T>(std::bit_cast<float>(std::uint32_t(value) << 16));
+	}
+};
 
-	static inline thread_local std::unique_ptr<allocator_type> allocator_;
-	static inline thread_local ref_count ref_count_{};
+/*
+ * Unit vectors mapped onto an octahedron and unfolded onto a square,
+ * giving two components of the given number of bits each. The decoded
+ * vector is normalised.
+ */
+template<unsigned bits_per_component>
+class octahedral final {
+	static_assert(bits_per_component > 1 && bits_per_component <= 16);
 
-	[[no_unique_address]] tls_handle_cache cached_handle_{};
+	static constexpr float steps = float((1u << bits_per_component) - 1);
 
-	// Compiler will optimise calls to this out when using unsafe_entrant
-	inline void initialise() {
-		if constexpr(std::is_same_v<entrant_policy, safe_entrant>) {
-			if(!allocator_) {
-				allocator_ = std::make_unique<allocator_type>();
-			}
+public:
+	using value_type = std::array<float, 3>;
+	using wire_type = impl::uint_least<bits_per_component * 2>;
+	static constexpr unsigned bits = bits_per_component * 2;
+
+	constexpr wire_type encode(const value_type& value) const {
+		const auto [x, y, z] = value;
+		const auto length = std::abs(x) + std::abs(y) + std::abs(z);
+		auto u = length > 0.0f? x / length : 0.0f;
+		auto v = length > 0.0f? y / length : 0.0f;
+
+		if(z < 0.0f) {
+			const auto fold_u = (1.0f - std::abs(v)) * impl::sign_not_zero(u);
+			v = (1.0f - std::abs(u)) * impl::sign_not_zero(v);
+			u = fold_u;
 		}
+
+		const auto qu = static_cast<wire_type>(impl::saturate(u * 0.5f + 0.5f) * steps + 0.5f);
+		const auto qv = static_cast<wire_type>(impl::saturate(v * 0.5f + 0.5f) * steps + 0.5f);
+		return static_cast<wire_type>(qu | (wire_type(qv) << bits_per_component));
 	}
 
-	inline allocator_type* allocator_handle() {
-		if constexpr(std::is_same_v<entrant_policy, unsafe_entrant>) {
-			return cached_handle_;
-		} else {
-			return allocator_.get();
+	constexpr value_type decode(const wire_type value) const {
+		constexpr auto mask = (std::uint32_t(1) << bits_per_component) - 1;
+		auto x = float(value & mask) / steps * 2.0f - 1.0f;
+		auto y = float((value >> bits_per_component) & mask) / steps * 2.0f - 1.0f;
+		const auto z = 1.0f - std::abs(x) - std::abs(y);
+
+		if(z < 0.0f) {
+			const auto fold_x = (1.0f - std::abs(y)) * impl::sign_not_zero(x);
+			y = (1.0f - std::abs(x)) * impl::sign_not_zero(y);
+			x = fold_x;
 		}
+
+		const auto length = std::sqrt(x * x + y * y + z * z);
+		return { x / length, y / length, z / length };
 	}
+};
+
+/*
+ * Unit quaternions as the index of the largest component, which is
+ * reconstructed on decode, and the other three components with the given
+ * number of bits each. q and -q are the same rotation, so the sign is
+ * flipped to make the largest component positive.
+ */
+template<unsigned bits_per_component>
+class smallest_three final {
+	static_assert(bits_per_component > 1 && bits_per_component <= 20);
+
+	static constexpr float range = 0.70710678118f; // 1 / sqrt(2)
+	static constexpr float steps = float((1u << bits_per_component) - 1);
 
 public:
-#ifdef HEXI_DEBUG_ALLOCATORS
-	std::size_t total_allocs = 0;
-	std::size_t total_deallocs = 0;
-	std::size_t active_allocs = 0;
-#endif
+	using value_type = std::array<float, 4>;
+	using wire_type = impl::uint_least<2 + bits_per_component * 3>;
+	static constexpr unsigned bits = 2 + bits_per_component * 3;
 
-	tls_block_allocator() {
-		thread_enter();
-	}
+	constexpr wire_type encode(const value_type& value) const {
+		std::size_t largest = 0;
 
-	/*
-	 * When used in conjunction with unsafe_entrant, allows the owning object
-	 * to be executed on another thread without paying for checks on every
-	 * allocation
-	 * 
-	 * @note If ref counting is enabled, the count will be incremented.
-	 */
-	inline void thread_enter() {
-		if(!allocator_) {
-			allocator_ = std::make_unique<allocator_type>();
+		for(std::size_t i = 1; i < value.size(); ++i) {
+			if(std::abs(value[i]) > std::abs(value[largest])) {
+				largest = i;
+			}
 		}
 
-		if constexpr(std::is_same_v<entrant_policy, unsafe_entrant>) {
-			cached_handle_ = allocator_.get();
-		}
+		const auto sign = value[largest] < 0.0f? -1.0f : 1.0f;
+		wire_type output = static_cast<wire_type>(largest);
+		unsigned shift = 2;
 
-		if constexpr(std::is_same_v<ref_count_policy, ref_counting>) {
-			++ref_count_;
+		for(std::size_t i = 0; i < value.size(); ++i) {
+			if(i == largest) {
+				continue;
+			}
+
+			const auto normalised = impl::saturate((value[i] * sign + range) / (2.0f * range));
+			output |= static_cast<wire_type>(normalised * steps + 0.5f) << shift;
+			shift += bits_per_component;
 		}
-	}
 
-	/*
-	 * When used in conjunction with unsafe_entrant, signals that the current
-	 * thread not make further calls into the allocator.
-	 * 
-	 * @note If ref counting is enabled, the count will be decremented.
-	 */
-	inline void thread_exit() {
-		if constexpr(std::is_same_v<ref_count_policy, ref_counting>) {
-			assert(ref_count_);
+		return output;
+	}
 
-			--ref_count_;
+	constexpr value_type decode(const wire_type value) const {
+		constexpr auto mask = (std::uint32_t(1) << bits_per_component) - 1;
+		const auto largest = static_cast<std::size_t>(value & 0x03u);
+		value_type output{};
+		float sum = 0.0f;
+		unsigned shift = 2;
 
-			if(ref_count_ == 0) {
-				allocator_.reset();
+		for(std::size_t i = 0; i < output.size(); ++i) {
+			if(i == largest) {
+				continue;
 			}
+
+			const auto component = float((value >> shift) & mask) / steps * (2.0f * range) - range;
+			output[i] = component;
+			sum += component * component;
+			shift += bits_per_component;
 		}
+
+		output[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+		return output;
 	}
+};
 
-	/*
-	 * @brief Allocates and constructs an object.
-	 * 
-	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
-	 * 
-	 * @return Pointer to the allocated object.
-	 */
-	template<typename ...Args>
-	[[nodiscard]] inline _ty* allocate(Args&&... args) {
-		/*
-		 * When safe_entrant is set, need to do this here & in ctor unless
-		 * we can be 100% sure that any object using the allocator is created
-		 * on the same thread that ends up using it.
-		 */
-		initialise();
+} // codec
 
-#ifdef HEXI_DEBUG_ALLOCATORS
-		++total_allocs;
-		++active_allocs;
-#endif
-		return allocator_handle()->allocate(std::forward<Args>(args)...);
-	}
+/*
+ * Stream adaptor that applies a codec to a single value or to a contiguous
+ * range of values. Values are encoded in batches, so the conversions over a
+ * range are amenable to vectorisation, and are written with the stream's
+ * byte order.
+ */
+template<typename codec_type, typename T>
+class packed final : public packed_tag_t {
+public:
+	using value_type = T;
+	using wire_type = typename codec_type::wire_type;
+	static constexpr unsigned bits = codec_type::bits;
 
-	/*
-	 * @brief Deallocates and destructs an object.
-	 * 
-	 * @param t The object to be deallocated.
-	 */
-	inline void deallocate(_ty* t) {
-		assert(t);
+	std::span<T> values;
+	codec_type codec;
 
-#ifdef HEXI_DEBUG_ALLOCATORS
-		++total_deallocs;
-		--active_allocs;
-#endif
-		allocator_handle()->deallocate(t);
-	}
+	packed(std::span<T> values, codec_type codec)
+		: values(values), codec(codec) {}
+};
 
-#ifdef HEXI_DEBUG_ALLOCATORS
-	auto allocator() {
-		initialise();
-		return allocator_handle();
-	}
-#endif
+namespace impl {
 
-	~tls_block_allocator() {
-		thread_exit();
+template<typename T, typename value_type>
+concept packable = std::same_as<std::remove_const_t<T>, value_type>
+	|| (std::ranges::contiguous_range<T>
+		&& std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<T>>, value_type>);
 
-#ifdef HEXI_DEBUG_ALLOCATORS
-		assert(active_allocs == 0);
-#endif
-	}
+template<typename T>
+struct packed_value {
+	using type = T;
 };
 
-} // hexi
+template<std::ranges::range T>
+struct packed_value<T> {
+	using type = std::ranges::range_value_t<T>;
+};
 
-#include <cstddef>
+template<typename T>
+using packed_value_t = std::remove_const_t<typename packed_value<T>::type>;
 
-namespace hexi {
+template<typename codec_type, typename T>
+auto make_packed(T& value, codec_type codec) {
+	if constexpr(std::same_as<std::remove_const_t<T>, typename codec_type::value_type>) {
+		return packed<codec_type, T>(std::span<T>(&value, 1), codec);
+	} else {
+		using element = std::remove_reference_t<std::ranges::range_reference_t<T>>;
+		return packed<codec_type, element>(std::span<element>(value), codec);
+	}
+}
 
-// dynamic_buffer backed by thread-local storage, meaning every
-// instance on the same thread shares the same underlying memory.
-// As a rule of thumb, an instance should never be touched by any thread
-// other than the one on which it was created, not even if synchronised
-// ... unless you're positive it won't result in the allocator being called.
-// 
-// Minimum memory usage is intrusive_storage<block_size> * count.
-// Additional blocks are not added if the original is exhausted ('colony' structure),
-// so the allocator will fall back to the system allocator instead.
-//
-// Pros: extremely fast allocation/deallocation for many instances per thread
-// Cons: everything else.
-// 
-// TL;DR Do not use unless you know what you're doing.
-template<decltype(auto) block_size,
-	std::size_t count,
-	typename ref_count_policy = no_ref_counting,
-	typename entrant_policy = safe_entrant,
-	typename storage_type = std::byte>
-using dynamic_tls_buffer = dynamic_buffer<block_size, storage_type,
-	tls_block_allocator<typename dynamic_buffer<block_size>::storage_type, count, no_ref_counting, entrant_policy>
->;
+} // impl
+
+/**
+ * @brief Maps a floating point value within a known range onto an
+ * unsigned integer of the given number of bits.
+ * 
+ * @tparam bits The number of bits to quantise to.
+ * @param value The value, or a contiguous range of values.
+ * @param min The lowest value that can be represented.
+ * @param max The highest value that can be represented.
+ * 
+ * @note Values outside of the range are clamped.
+ */
+template<unsigned bits, typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto quantised(T& value, const std::type_identity_t<value_type> min, const std::type_identity_t<value_type> max) {
+	return impl::make_packed(value, codec::quantise<value_type, bits>(min, max));
+}
+
+/**
+ * @brief Stores a floating point value as a fixed point integer.
+ * 
+ * @tparam fraction The number of fractional bits.
+ * @tparam wire_type The integral type to store the value as.
+ * @param value The value, or a contiguous range of values.
+ * 
+ * @note Values outside of the range of the wire type are clamped.
+ */
+template<unsigned fraction, std::integral wire_type = std::int32_t,
+         typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto fixed_point(T& value) {
+	return impl::make_packed(value, codec::fixed_point<value_type, fraction, wire_type>());
+}
+
+/**
+ * @brief Stores a floating point value as an IEEE 754 half.
+ * 
+ * @param value The value, or a contiguous range of values.
+ */
+template<typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto half_float(T& value) {
+	return impl::make_packed(value, codec::half<value_type>());
+}
+
+/**
+ * @brief Stores a floating point value as a bfloat16.
+ * 
+ * @param value The value, or a contiguous range of values.
+ */
+template<typename T, typename value_type = impl::packed_value_t<T>>
+requires impl::packable<T, value_type> && std::floating_point<value_type>
+auto bfloat16(T& value) {
+	return impl::make_packed(value, codec::bfloat16<value_type>());
+}
+
+/**
+ * @brief Stores a unit vector with octahedral encoding.
+ * 
+ * @tparam bits The number of bits for each of the two encoded components.
+ * @param value A std::array<float, 3>, or a contiguous range of them.
+ */
+template<unsigned bits, typename T>
+requires impl::packable<T, std::array<float, 3>>
+auto octahedral(T& value) {
+	return impl::make_packed(value, codec::octahedral<bits>());
+}
+
+/**
+ * @brief Stores a unit quaternion as its three smallest components.
+ * 
+ * @tparam bits The number of bits for each of the three encoded components.
+ * @param value A std::array<float, 4> holding x, y, z and w, or a contiguous
+ * range of them.
+ */
+template<unsigned bits, typename T>
+requires impl::packable<T, std::array<float, 4>>
+auto smallest_three(T& value) {
+	return impl::make_packed(value, codec::smallest_three<bits>());
+}
 
 } // hexi
 
-// #include <hexi/exception.h>
+// #include <hexi/stream_adaptors.h>
 
-// #include <hexi/endian.h>
+// #include <hexi/allocators/block_allocator.h>
 
-// #include <hexi/file_buffer.h>
+// #include <hexi/allocators/default_allocator.h>
+
+// #include <hexi/allocators/default_init_allocator.h>
+
+// #include <hexi/allocators/depot_allocator.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -3692,325 +10483,413 @@ using dynamic_tls_buffer = dynamic_buffer<block_size, storage_type,
 
 
 
-// #include <hexi/exception.h>
-
-// #include <hexi/shared.h>
-
-// #include <hexi/concepts.h>
-
-#include <filesystem>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <new>
 #include <utility>
+#include <cassert>
 #include <cstddef>
-#include <cstdio>
+#include <cstdint>
+
+#ifndef NDEBUG
+#define HEXI_DEBUG_ALLOCATORS
+#endif
 
 namespace hexi {
 
-class file_buffer final {
-public:
-	using size_type       = std::size_t;
-	using offset_type     = long;
-	using value_type      = char;
-	using contiguous      = is_non_contiguous;
-	using seeking         = unsupported;
+namespace impl {
 
-	static constexpr auto npos { static_cast<size_type>(-1) };
+template<std::size_t magazine_size>
+struct magazine {
+	std::uint32_t index;
+	std::atomic<std::uint32_t> next;
+	std::size_t count = 0;
+	std::array<void*, magazine_size> blocks;
+};
+
+/*
+ * Global store of magazines, shared by every thread. Full and empty
+ * magazines are kept on two Treiber stacks. Magazines are addressed by index
+ * rather than by pointer, so that the head of each stack can carry a tag
+ * alongside the index in a single 64-bit word, which avoids ABA without
+ * needing a double-width CAS. Magazines are never freed while the depot is
+ * alive, so reading the next link of a stale head is always safe.
+ */
+template<std::size_t magazine_size, std::size_t block_size, std::size_t block_align>
+class magazine_depot {
+public:
+	using magazine_type = magazine<magazine_size>;
 
 private:
-	FILE* file_ = nullptr;
-	offset_type read_ = 0;
-	offset_type write_ = 0;
-	bool error_ = false;
+	static constexpr std::uint32_t chunk_size = 64;
+	static constexpr std::uint32_t max_chunks = 1024;
+	static constexpr std::uint32_t nil = UINT32_MAX;
 
-	/**
-	* @brief Explicitly close the underlying file handle.
-	* 
-	* This function will be called by the object's destructor
-	* and does not need to be called explicitly.
-	* 
-	* @note Idempotent.
-	*/
-	void close() {
-		if(file_) {
-			std::fclose(file_);
-			file_ = nullptr;
-		}
+	std::array<std::atomic<magazine_type*>, max_chunks> chunks_{};
+	std::atomic<std::uint32_t> next_index_ = 0;
+	std::atomic<std::uint64_t> full_ = pack(nil, 0);
+	std::atomic<std::uint64_t> empty_ = pack(nil, 0);
+	std::atomic<std::size_t> full_count_ = 0;
+
+	static constexpr std::uint64_t pack(const std::uint32_t index, const std::uint32_t tag) {
+		return (static_cast<std::uint64_t>(tag) << 32) | index;
 	}
 
-public:
-	file_buffer(const std::filesystem::path& path)
-		: file_buffer(path.string().c_str()) { }
+	static constexpr std::uint32_t index_of(const std::uint64_t head) {
+		return static_cast<std::uint32_t>(head);
+	}
 
-	file_buffer(const char* path) {
-		file_ = std::fopen(path, "a+b");
-		
-		if(!file_) {
-			error_ = true;
-			return;
+	static constexpr std::uint32_t tag_of(const std::uint64_t head) {
+		return static_cast<std::uint32_t>(head >> 32);
+	}
+
+	magazine_type* get(const std::uint32_t index) const {
+		const auto chunk = chunks_[index / chunk_size].load(std::memory_order_acquire);
+		return chunk + (index % chunk_size);
+	}
+
+	void push(std::atomic<std::uint64_t>& head, magazine_type* mag) {
+		auto old = head.load(std::memory_order_relaxed);
+
+		do {
+			mag->next.store(index_of(old), std::memory_order_relaxed);
+		} while(!head.compare_exchange_weak(old, pack(mag->index, tag_of(old) + 1),
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	magazine_type* pop(std::atomic<std::uint64_t>& head) {
+		auto old = head.load(std::memory_order_acquire);
+
+		while(index_of(old) != nil) {
+			const auto mag = get(index_of(old));
+			const auto next = mag->next.load(std::memory_order_relaxed);
+
+			if(head.compare_exchange_weak(old, pack(next, tag_of(old) + 1),
+				std::memory_order_acquire, std::memory_order_acquire)) {
+				return mag;
+			}
 		}
-		
-		if(std::fseek(file_, 0, SEEK_END)) {
-			error_ = true;
-			return;
+
+		return nullptr;
+	}
+
+	magazine_type* create() {
+		if(next_index_.load(std::memory_order_relaxed) >= chunk_size * max_chunks) {
+			return nullptr;
 		}
 
-		write_ = std::ftell(file_);
+		const auto index = next_index_.fetch_add(1, std::memory_order_relaxed);
 
-		if(write_ == -1) {
-			error_ = true;
+		if(index >= chunk_size * max_chunks) [[unlikely]] {
+			return nullptr;
 		}
-	}
 
-	file_buffer(file_buffer&& rhs) noexcept
-		: file_(rhs.file_),
-		  read_(rhs.read_),
-		  write_(rhs.write_),
-		  error_(rhs.error_) {
-		rhs.file_ = nullptr;
-	}
+		auto& slot = chunks_[index / chunk_size];
+		auto chunk = slot.load(std::memory_order_acquire);
 
-	file_buffer& operator=(file_buffer&& rhs) noexcept {
-		std::exchange(file_, rhs.file_);
-		read_ = rhs.read_;
-		write_ = rhs.write_;
-		error_ = rhs.error_;
-		return *this;
-	}
+		if(!chunk) {
+			auto fresh = new magazine_type[chunk_size];
 
-	file_buffer& operator=(const file_buffer&) = delete;
-	file_buffer(const file_buffer&) = delete;
+			if(slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+				chunk = fresh;
+			} else {
+				delete[] fresh;
+			}
+		}
 
-	~file_buffer() {
-		close();
+		auto mag = chunk + (index % chunk_size);
+		mag->index = index;
+		mag->count = 0;
+		return mag;
 	}
 
+public:
+#ifdef HEXI_DEBUG_ALLOCATORS
+	std::atomic<std::size_t> system_allocs = 0;
+	std::atomic<std::size_t> system_deallocs = 0;
+#endif
 
-	/**
-	 * @brief Flush unwritten data.
-	 */
-	void flush() {
-		std::fflush(file_);
+	void* allocate_block() {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++system_allocs;
+#endif
+		return ::operator new(block_size, std::align_val_t(block_align));
 	}
 
-	/**
-	 * @brief Reads a number of bytes to the provided buffer.
-	 * 
-	 * @param destination The buffer to copy the data to.
-	 */
-	template<typename T>
-	void read(T* destination) {
-		read(destination, sizeof(T));
+	void deallocate_block(void* block) {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++system_deallocs;
+#endif
+		::operator delete(block, std::align_val_t(block_align));
 	}
 
-	/**
-	 * @brief Reads a number of bytes to the provided buffer.
-	 * 
-	 * @param destination The buffer to copy the data to.
-	 * @param length The number of bytes to read into the buffer.
+	/*
+	 * Stores a magazine that holds blocks. Once the depot is holding its
+	 * limit, the blocks are returned to the system instead so that memory
+	 * released by one burst doesn't stay pinned forever.
 	 */
-	void read(void* destination, size_type length) {
-		if(error_) {
-			return;
-		}
+	void push_full(magazine_type* mag, const std::size_t limit) {
+		if(full_count_.fetch_add(1, std::memory_order_relaxed) >= limit) {
+			full_count_.fetch_sub(1, std::memory_order_relaxed);
 
-		if(std::fseek(file_, read_, 0)) {
-			error_ = true;
+			for(std::size_t i = 0; i < mag->count; ++i) {
+				deallocate_block(mag->blocks[i]);
+			}
+
+			mag->count = 0;
+			push(empty_, mag);
 			return;
 		}
 
-		if(std::fread(destination, length, 1, file_) != 1) {
-			error_ = true;
-			return;
+		push(full_, mag);
+	}
+
+	magazine_type* pop_full() {
+		auto mag = pop(full_);
+
+		if(mag) {
+			full_count_.fetch_sub(1, std::memory_order_relaxed);
 		}
 
-		read_ += length;
+		return mag;
 	}
 
-	/**
-	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the read cursor.
-	 * 
-	 * @param destination The buffer to copy the data to.
-	 */
-	template<typename T>
-	void copy(T* destination) {
-		copy(destination, sizeof(T));
+	void push_empty(magazine_type* mag) {
+		assert(mag->count == 0);
+		push(empty_, mag);
 	}
 
-	/**
-	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the read cursor.
-	 * 
-	 * @param destination The buffer to copy the data to.
-	 * @param length The number of bytes to copy.
-	 */
-	void copy(void* destination, size_type length) {
-		if(error_) {
-			return;
-		} else if(length > size()) {
-			error_ = true;
-			HEXI_THROW(buffer_underrun(length, read_, size()));
+	magazine_type* pop_empty() {
+		if(auto mag = pop(empty_)) {
+			return mag;
 		}
 
-		if(std::fseek(file_, read_, SEEK_SET)) {
-			error_ = true;
+		return create();
+	}
+
+	/*
+	 * Returns a magazine that may be partially filled, such as when a
+	 * thread exits.
+	 */
+	void release(magazine_type* mag, const std::size_t limit) {
+		if(!mag) {
 			return;
 		}
-		
-		if(std::fread(destination, length, 1, file_) != 1) {
-			error_ = true;
-			return;
+
+		if(mag->count) {
+			push_full(mag, limit);
+		} else {
+			push_empty(mag);
 		}
 	}
 
-	/**
-	 * @brief Attempts to locate the provided value within the container.
-	 * 
-	 * @param value The value to locate.
-	 * 
-	 * @return The position of value or npos if not found.
-	 */
-	size_type find_first_of(value_type val) noexcept {
-		if(error_) {
-			return npos;
+	std::size_t full_count() const {
+		return full_count_.load(std::memory_order_relaxed);
+	}
+
+	~magazine_depot() {
+		while(auto mag = pop(full_)) {
+			for(std::size_t i = 0; i < mag->count; ++i) {
+				deallocate_block(mag->blocks[i]);
+			}
 		}
 
-		if(std::fseek(file_, read_, SEEK_SET)) {
-			error_ = true;
-			return npos;
+		for(auto& chunk : chunks_) {
+			delete[] chunk.load(std::memory_order_relaxed);
 		}
+	}
+};
 
-		value_type buffer{};
+} // impl
 
-		for(size_type i = 0, j = size(); i < j; ++i) {
-			if(std::fread(&buffer, sizeof(value_type), 1, file_) != 1) {
-				error_ = true;
-				return npos;
-			}
+/*
+ * Magazine allocator in the style of Bonwick's magazine layer, as used by
+ * tcmalloc and friends. Each thread caches blocks in two magazines of up to
+ * magazine_size blocks each and only touches the global depot once both
+ * are exhausted (allocation) or full (deallocation), exchanging a whole
+ * magazine at a time with lock-free operations.
+ * 
+ * Unlike tls_block_allocator, blocks don't belong to any particular thread.
+ * A block can be deallocated by any thread, at which point it joins that
+ * thread's cache, so memory balances out across threads rather than being
+ * stranded in the pool of a thread that allocated heavily once. When a
+ * thread exits, its magazines are handed to the depot, so blocks that are
+ * still outstanding remain valid and the cached ones can be reused by other
+ * threads.
+ * 
+ * Blocks are requested from the system allocator when the depot has none to
+ * give. The depot holds at most depot_limit full magazines, with anything
+ * beyond that being handed back to the system allocator.
+ * 
+ * All blocks must be deallocated before the depot is destroyed at exit.
+ */
+template<typename _ty,
+	std::size_t magazine_size = 64,
+	std::size_t depot_limit = 64>
+requires (magazine_size > 0)
+class depot_allocator final {
+	using depot_type = impl::magazine_depot<magazine_size, sizeof(_ty), alignof(_ty)>;
+	using magazine_type = typename depot_type::magazine_type;
+
+	struct thread_cache {
+		magazine_type* loaded = nullptr;
+		magazine_type* previous = nullptr;
+
+		~thread_cache() {
+			depot_.release(loaded, depot_limit);
+			depot_.release(previous, depot_limit);
+		}
+	};
 
-			if(buffer == val) {
-				return i;
-			}
+	static inline depot_type depot_;
+	static inline thread_local thread_cache cache_;
+
+	static void* acquire() {
+		auto& cache = cache_;
+
+		if(cache.loaded && cache.loaded->count) [[likely]] {
+			return cache.loaded->blocks[--cache.loaded->count];
 		}
 
-		return npos;
-	}
+		if(cache.previous && cache.previous->count) {
+			std::swap(cache.loaded, cache.previous);
+			return cache.loaded->blocks[--cache.loaded->count];
+		}
 
-	/**
-	 * @brief Skip a requested number of bytes.
-	 *
-	 * Skips over a number of bytes from the file. This should be used
-	 * if the file holds data that you don't care about but don't want
-	 * to have to read it to another buffer to access data beyond it.
-	 * 
-	 * @param length The number of bytes to skip.
-	 */
-	void skip(const size_type length) {
-		read_ += length;
-	}
+		// both magazines are empty, try to swap one for a full magazine
+		if(auto full = depot_.pop_full()) {
+			if(cache.previous) {
+				depot_.push_empty(cache.previous);
+			}
 
-	/**
-	 * @brief Whether the container is empty.
-	 * 
-	 * @return Returns true if the container is empty (has no data to be read).
-	 */
-	[[nodiscard]]
-	bool empty() const {
-		return write_ == read_;
-	}
+			cache.previous = cache.loaded;
+			cache.loaded = full;
+			return cache.loaded->blocks[--cache.loaded->count];
+		}
 
-	/**
-	 * @brief Determine whether the adaptor supports write seeking.
-	 * 
-	 * This is determined at compile-time and does not need to be checked at
-	 * run-time.
-	 * 
-	 * @return True if write seeking is supported, otherwise false.
-	 */
-	constexpr static bool can_write_seek() {
-		return std::is_same_v<seeking, supported>;
+		return depot_.allocate_block();
 	}
 
-	/**
-	 * @brief Write data to the container.
-	 * 
-	 * @param source Pointer to the data to be written.
-	 */
-	void write(const auto& source) {
-		write(&source, sizeof(source));
-	}
+	static void store(void* block) {
+		auto& cache = cache_;
 
-	/**
-	 * @brief Write provided data to the file.
-	 * 
-	 * @param source Pointer to the data to be written.
-	 * @param length Number of bytes to write from the source.
-	 */
-	void write(const void* source, size_type length) {
-		if(error_) {
+		if(cache.loaded && cache.loaded->count < magazine_size) [[likely]] {
+			cache.loaded->blocks[cache.loaded->count++] = block;
 			return;
 		}
-		
-		if(std::fseek(file_, write_, SEEK_SET)) {
-			error_ = true;
+
+		if(cache.previous && cache.previous->count < magazine_size) {
+			std::swap(cache.loaded, cache.previous);
+			cache.loaded->blocks[cache.loaded->count++] = block;
 			return;
 		}
 
-		if(std::fwrite(source, length, 1, file_) != 1) {
-			error_ = true;
+		// both magazines are full (or missing), try to swap one for an empty magazine
+		if(auto empty = depot_.pop_empty()) {
+			if(cache.previous) {
+				depot_.push_full(cache.previous, depot_limit);
+			}
+
+			cache.previous = cache.loaded;
+			cache.loaded = empty;
+			cache.loaded->blocks[cache.loaded->count++] = block;
 			return;
 		}
 
-		write_ += length;
+		depot_.deallocate_block(block);
 	}
 
+public:
+#ifdef HEXI_DEBUG_ALLOCATORS
+	std::size_t total_allocs = 0;
+	std::size_t total_deallocs = 0;
+	std::size_t active_allocs = 0;
+#endif
 
-	/**
-	 * @brief Returns the amount of data available in the file.
+	/*
+	 * @brief Allocates and constructs an object.
 	 * 
-	 * @return The number of bytes of data available to read from the file.
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
 	 */
-	size_type size() const {
-		return static_cast<size_type>(write_) - read_;
+	template<typename ...Args>
+	[[nodiscard]] inline _ty* allocate(Args&&... args) {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_allocs;
+		++active_allocs;
+#endif
+		return new (acquire()) _ty(std::forward<Args>(args)...);
+	}
+
+	/*
+	 * @brief Deallocates and destructs an object. May be called from
+	 * any thread.
+	 * 
+	 * @param t The object to be deallocated.
+	 */
+	inline void deallocate(_ty* t) {
+		assert(t);
+#ifdef HEXI_DEBUG_ALLOCATORS
+		++total_deallocs;
+		--active_allocs;
+#endif
+		t->~_ty();
+		store(t);
 	}
 
-	/** 
-	 * @brief Retrieve the file handle.
+	/**
+	 * @brief Allocates and default constructs a number of objects.
 	 * 
-	 * @return The file handle.
+	 * @param count The number of objects to allocate.
+	 * @param out Output iterator that receives a pointer to each object.
+	 * 
+	 * @return The output iterator, one past the last written element.
 	 */
-	FILE* handle() {
-		return file_;
+	template<std::output_iterator<_ty*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = allocate();
+		}
+
+		return out;
 	}
 
-	/** 
-	 * @brief Retrieve the file handle.
+	/**
+	 * @brief Deallocates and destructs a range of objects.
 	 * 
-	 * @return The file handle.
+	 * @param first Iterator to the first object pointer.
+	 * @param last Iterator one past the last object pointer.
 	 */
-	const FILE* handle() const {
-		return file_;
+	template<std::input_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+		for(; first != last; ++first) {
+			deallocate(*first);
+		}
 	}
 
-	/** 
-	 * @return True if an error has occurred during file operations.
+	/**
+	 * @return The number of full magazines currently held by the depot.
 	 */
-	bool error() const {
-		return error_;
+	static std::size_t depot_size() {
+		return depot_.full_count();
 	}
 
-	/** 
-	 * @return True if no error has occurred during file operations.
-	 */
-	operator bool() const {
-		return !error();
+#ifdef HEXI_DEBUG_ALLOCATORS
+	static const depot_type& depot() {
+		return depot_;
+	}
+#endif
+
+	~depot_allocator() {
+#ifdef HEXI_DEBUG_ALLOCATORS
+		assert(active_allocs == 0);
+#endif
 	}
 };
 
 } // hexi
 
-// #include <hexi/shared.h>
-
-// #include <hexi/static_buffer.h>
+// #include <hexi/allocators/pmr_allocator.h>
 //  _               _ 
 // | |__   _____  _(_)
 // | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
@@ -4019,473 +10898,507 @@ public:
 
 
 
-// #include <hexi/exception.h>
-
-// #include <hexi/shared.h>
-
-// #include <hexi/concepts.h>
-
-#include <array>
-#include <span>
+#include <memory_resource>
+#include <new>
 #include <utility>
 #include <cassert>
-#include <cstddef>
-#include <cstring>
 
 namespace hexi {
 
-template<byte_type storage_type, std::size_t buf_size>
-class static_buffer final {
-	std::array<storage_type, buf_size> buffer_ = {};
-	std::size_t read_ = 0;
-	std::size_t write_ = 0;
+/*
+ * Block allocator that takes its memory from a std::pmr::memory_resource,
+ * allowing dynamic_buffer to share a resource with the rest of a program,
+ * such as a monotonic_buffer_resource that holds everything belonging to
+ * a single message or request. The resource must outlive any buffers using it.
+ * Two pmr_allocators compare equal if their resources do, which allows
+ * buffers sharing a resource to hand blocks to each other.
+ */
+template<typename _ty>
+class pmr_allocator final {
+	std::pmr::memory_resource* resource_;
 
 public:
-	using size_type       = typename decltype(buffer_)::size_type;
-	using offset_type     = size_type;
-	using value_type      = storage_type;
-	using contiguous      = is_contiguous;
-	using seeking         = supported;
-
-	static constexpr auto npos { static_cast<size_type>(-1) };
-	
-	static_buffer() = default;
+	pmr_allocator() noexcept
+		: resource_(std::pmr::get_default_resource()) {}
 
-	template<typename... T> 
-	static_buffer(T&&... vals) : buffer_{ std::forward<T>(vals)... } {
-		write_ = sizeof... (vals);
+	explicit pmr_allocator(std::pmr::memory_resource* resource) noexcept
+		: resource_(resource) {
+		assert(resource);
 	}
 
-	static_buffer(static_buffer&& rhs) = default;
-	static_buffer& operator=(static_buffer&&) = default;
-	static_buffer& operator=(const static_buffer&) = default;
-	static_buffer(const static_buffer&) = default;
-
 	/**
-	 * @brief Reads a number of bytes to the provided buffer.
+	 * @brief Allocates and constructs an object.
 	 * 
-	 * @param destination The buffer to copy the data to.
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
 	 */
-	template<typename T>
-	void read(T* destination) {
-		read(destination, sizeof(T));
+	template<typename ...Args>
+	[[nodiscard]] inline _ty* allocate(Args&&... args) {
+		auto memory = resource_->allocate(sizeof(_ty), alignof(_ty));
+		return new (memory) _ty(std::forward<Args>(args)...);
 	}
 
 	/**
-	 * @brief Reads a number of bytes to the provided buffer.
+	 * @brief Deallocates and destructs an object.
 	 * 
-	 * @param destination The buffer to copy the data to.
-	 * @param length The number of bytes to read into the buffer.
+	 * @param t The object to be deallocated.
 	 */
-	void read(void* destination, size_type length) {
-		copy(destination, length);
-		read_ += length;
-
-		if(read_ == write_) {
-			read_ = write_ = 0;
-		}
+	inline void deallocate(_ty* t) {
+		assert(t);
+		t->~_ty();
+		resource_->deallocate(t, sizeof(_ty), alignof(_ty));
 	}
 
 	/**
-	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the read cursor.
-	 * 
-	 * @param destination The buffer to copy the data to.
+	 * @return The memory resource that objects are allocated from.
 	 */
-	template<typename T>
-	void copy(T* destination) const {
-		copy(destination, sizeof(T));
+	std::pmr::memory_resource* resource() const {
+		return resource_;
 	}
 
-	/**
-	 * @brief Copies a number of bytes to the provided buffer but without advancing
-	 * the read cursor.
-	 * 
-	 * @note The destination buffer address must not belong to the static_buffer.
-	 * 
-	 * @param destination The buffer to copy the data to.
-	 * @param length The number of bytes to copy.
-	 */
-	void copy(void* destination, size_type length) const {
-		assert(!region_overlap(buffer_.data(), buffer_.size(), destination, length));
+	bool operator==(const pmr_allocator& rhs) const {
+		return *resource_ == *rhs.resource_;
+	}
+};
 
-		if(length > size()) {
-			HEXI_THROW(buffer_underrun(length, read_, size()));
-		}
+} // hexi
 
-		std::memcpy(destination, read_ptr(), length);
-	}
+// #include <hexi/allocators/ref_allocator.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
-	/**
-	 * @brief Attempts to locate the provided value within the container.
-	 * 
-	 * @param value The value to locate.
-	 * 
-	 * @return The position of value or npos if not found.
-	 */
-	size_type find_first_of(value_type val) const noexcept {
-		const auto data = read_ptr();
 
-		for(size_type i = 0, j = size(); i < j; ++i) {
-			if(data[i] == val) {
-				return i;
-			}
-		}
 
-		return npos;
-	}
+#include <iterator>
+#include <utility>
+#include <cstddef>
 
-	/**
-	 * @brief Skip over a number of bytes.
-	 * 
-	 * Skips over a number of bytes from the container. This should be used
-	 * if the container holds data that you don't care about but don't want
-	 * to have to read it to another buffer to access data beyond it.
-	 * 
-	 * @param length The number of bytes to skip.
-	 */
-	void skip(const size_type length) {
-		read_ += length;
+namespace hexi {
 
-		if(read_ == write_) {
-			read_ = write_ = 0;
-		}
+/*
+ * Refers to an allocator instance owned elsewhere, such as a pool or arena
+ * belonging to a worker or connection, so that it can be shared between
+ * many buffers. The referenced allocator must outlive any buffers using it.
+ * Two ref_allocators compare equal if they refer to the same instance,
+ * which allows buffers sharing an instance to hand blocks to each other.
+ */
+template<typename allocator_type>
+class ref_allocator final {
+	allocator_type* allocator_;
+
+public:
+	explicit ref_allocator(allocator_type& allocator)
+		: allocator_(&allocator) {}
+
+	template<typename ...Args>
+	[[nodiscard]] inline auto allocate(Args&&... args) {
+		return allocator_->allocate(std::forward<Args>(args)...);
 	}
 
-	/**
-	 * @brief Advances the write cursor.
-	 * 
-	 * @param size The number of bytes by which to advance the write cursor.
-	 */
-	void advance_write(size_type bytes) {
-		assert(free() >= bytes);
-		write_ += bytes;
+	template<typename T>
+	inline void deallocate(T* t) {
+		allocator_->deallocate(t);
 	}
 
-	/**
-	 * @brief Resizes the buffer.
-	 * 
-	 * @param size The new size of the buffer.
-	 * 
-	 */
-	void resize(size_type size) {
-		if(size > buffer_.size()) {
-			HEXI_THROW(exception("attempted to resize static_buffer to larger than capacity"));
-		}
+	template<typename OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out)
+	requires requires(allocator_type& a) { a.allocate_n(count, out); } {
+		return allocator_->allocate_n(count, out);
+	}
 
-		write_ = size;
+	template<typename InputIt>
+	void deallocate_list(InputIt first, InputIt last)
+	requires requires(allocator_type& a) { a.deallocate_list(first, last); } {
+		allocator_->deallocate_list(first, last);
 	}
 
-	/**
-	 * @brief Clears the container.
-	 */
-	void clear() {
-		read_ = write_ = 0;
+	allocator_type& get() const {
+		return *allocator_;
 	}
 
-	/**
-	 * @brief Moves any unread data to the front of the buffer, freeing space at the end.
-	 * If a move is performed, pointers obtained from read/write_ptr() will be invalidated.
-	 * 
-	 * If the buffer contains no data available for reading, this function will have no effect.
-	 * 
-	 * @return True if additional space was made available.
-	 */
-	bool defragment() {
-		if(read_ == 0) {
-			return false;
-		}
+	bool operator==(const ref_allocator&) const = default;
+};
 
-		write_ = size();
-		std::memmove(buffer_.data(), read_ptr(), write_);
-		read_ = 0;
-		return true;
+} // hexi
+
+// #include <hexi/allocators/region_allocator.h>
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace hexi {
+
+namespace impl {
+
+constexpr std::size_t region_granularity = 16;
+constexpr std::size_t region_small_classes = 8; // 16 to 128 bytes, in steps of 16
+
+/*
+ * Above 128 bytes, each power of two range (2^k, 2^(k+1)] is split into
+ * four classes, spaced 2^(k-2) bytes apart
+ */
+constexpr std::size_t region_class_index(const std::size_t size) {
+	if(size <= region_small_classes * region_granularity) {
+		return (std::max<std::size_t>(size, 1) + region_granularity - 1) / region_granularity - 1;
 	}
 
-	/**
-	 * @brief Retrieves a reference to the specified index within the container.
-	 * 
-	 * @param index The index within the container.
-	 * 
-	 * @return A reference to the value at the specified index.
-	 */
-	value_type& operator[](const size_type index) {
-		return read_ptr()[index];
+	const std::size_t k = std::bit_width(size - 1) - 1;
+	const std::size_t step = std::size_t(1) << (k - 2);
+	const auto offset = (size - (std::size_t(1) << k) + step - 1) / step;
+	return region_small_classes + (k - 7) * 4 + offset - 1;
+}
+
+constexpr std::size_t region_class_size(const std::size_t index) {
+	if(index < region_small_classes) {
+		return (index + 1) * region_granularity;
 	}
 
-	/**
-	 * @brief Retrieves a reference to the specified index within the container.
-	 * 
-	 * @param index The index within the container.
-	 * 
-	 * @return A reference to the value at the specified index.
-	 */
-	const value_type& operator[](const size_type index) const {
-		return read_ptr()[index];
-	}
+	const auto k = 7 + (index - region_small_classes) / 4;
+	const auto offset = (index - region_small_classes) % 4 + 1;
+	return (std::size_t(1) << k) + offset * (std::size_t(1) << (k - 2));
+}
+
+} // impl
+
+/**
+ * Arena intended to be owned by something with a bounded lifetime, such as
+ * a connection. Memory is bump allocated from chunks requested from the
+ * system allocator and released in one go when the region is released or
+ * destroyed, rather than piece by piece.
+ * 
+ * Sizes are rounded up to one of a fixed set of classes, four per power of
+ * two, so no more than a quarter of a block is wasted to rounding, e.g. a
+ * block of slightly over 4KB takes 5KB. Deallocated memory is kept on a free
+ * list per class and reused for any size in that class while the region is
+ * alive, so a long-lived connection with varying allocation sizes, such as
+ * a growing vector, doesn't grow without bound. Allocations larger than the
+ * largest class or the chunk size are given their own memory by the system
+ * allocator and returned to it when they're deallocated.
+ * 
+ * Releasing the region is proportional to the number of chunks rather than
+ * the number of allocations, but it isn't free. Neither is tearing down the
+ * region's users, e.g. a dynamic_buffer still returns each of its blocks
+ * through deallocate(), which is cheap but not a no-op.
+ * 
+ * Anything allocated from the region must no longer be in use by the time
+ * it is released. A region is not thread-safe.
+ */
+class region final {
+	struct chunk {
+		chunk* next;
+	};
+
+	struct large_block {
+		large_block* prev;
+		large_block* next;
+	};
+
+	struct free_block {
+		free_block* next;
+	};
+
+	static constexpr std::size_t max_class_size = 256 * 1024;
+	static constexpr std::size_t class_count = impl::region_class_index(max_class_size) + 1;
+	static constexpr std::size_t max_align = 64;
+	static constexpr std::size_t header_size = max_align; // keeps chunk data aligned
+
+	std::size_t chunk_size_;
+	chunk* chunks_ = nullptr;
+	large_block* large_ = nullptr;
+	std::byte* bump_ = nullptr;
+	std::byte* end_ = nullptr;
+	std::array<free_block*, class_count> free_{};
 
-	/**
-	 * @brief Whether the container is empty.
-	 * 
-	 * @return Returns true if the container is empty (has no data to be read).
-	 */
-	[[nodiscard]]
-	bool empty() const {
-		return write_ == read_;
+	static std::size_t class_size(const std::size_t index) {
+		return impl::region_class_size(index);
 	}
 
-	/**
-	 * @return Whether the container is full and cannot be further written to.
-	 */
-	bool full() const {
-		return write_ == capacity();
+	// blocks are aligned to the largest power of two that divides their class
+	static std::size_t class_align(const std::size_t index) {
+		const auto size = class_size(index);
+		return std::min(size & (~size + 1), max_align);
 	}
 
-	/**
-	 * @brief Determine whether the adaptor supports write seeking.
-	 * 
-	 * This is determined at compile-time and does not need to be checked at
-	 * run-time.
-	 * 
-	 * @return True if write seeking is supported, otherwise false.
-	 */
-	constexpr static bool can_write_seek() {
-		return std::is_same_v<seeking, supported>;
+	// returns class_count if the allocation is too large for any class
+	std::size_t find_class(const std::size_t size, const std::size_t align) const {
+		if(size > max_class_size) {
+			return class_count;
+		}
+
+		auto index = impl::region_class_index(std::max(size, align));
+
+		// over-aligned requests move up to the next class that's aligned for them
+		while(index < class_count && class_align(index) < align) {
+			++index;
+		}
+
+		if(index == class_count || class_size(index) > chunk_size_) {
+			return class_count;
+		}
+
+		return index;
 	}
 
-	/**
-	 * @brief Write data to the container.
-	 * 
-	 * @param source Pointer to the data to be written.
-	 */
-	void write(const auto& source) {
-		write(&source, sizeof(source));
+	std::byte* new_chunk(const std::size_t size) {
+		auto memory = static_cast<std::byte*>(::operator new(
+			header_size + size, std::align_val_t(max_align)
+		));
+
+		auto header = reinterpret_cast<chunk*>(memory);
+		header->next = chunks_;
+		chunks_ = header;
+		return memory + header_size;
 	}
 
-	/**
-	 * @brief Write provided data to the container.
-	 * 
-	 * @note The source buffer address must not belong to the static_buffer.
-	 * 
-	 * @param source Pointer to the data to be written.
-	 * @param length Number of bytes to write from the source.
-	 */
-	void write(const void* source, size_type length) {
-		assert(!region_overlap(source, length, buffer_.data(), buffer_.size()));
+	void* allocate_large(const std::size_t size) {
+		auto memory = static_cast<std::byte*>(::operator new(
+			header_size + size, std::align_val_t(max_align)
+		));
 
-		if(free() < length) {
-			HEXI_THROW(buffer_overflow(length, write_, free()));
+		auto header = reinterpret_cast<large_block*>(memory);
+		header->prev = nullptr;
+		header->next = large_;
+
+		if(large_) {
+			large_->prev = header;
 		}
 
-		std::memcpy(write_ptr(), source, length);
-		write_ += length;
+		large_ = header;
+		return memory + header_size;
 	}
 
-	/**
-	 * @brief Performs write seeking within the container.
-	 * 
-	 * @param direction Specify whether to seek in a given direction or to absolute seek.
-	 * @param offset The offset relative to the seek direction or the absolute value
-	 * when using absolute seeking.
-	 */
-	void write_seek(const buffer_seek direction, const size_type offset) {
-		switch(direction) {
-			case buffer_seek::sk_backward:
-				write_ -= offset;
-				break;
-			case buffer_seek::sk_forward:
-				write_ += offset;
-				break;
-			case buffer_seek::sk_absolute:
-				write_ = offset;
+	void deallocate_large(void* ptr) {
+		auto header = reinterpret_cast<large_block*>(static_cast<std::byte*>(ptr) - header_size);
+
+		if(header->prev) {
+			header->prev->next = header->next;
+		} else {
+			large_ = header->next;
 		}
-	}
 
-	/**
-	 * @return An iterator to the beginning of data available for reading.
-	 */
-	auto begin() {
-		return buffer_.begin() + read_;
-	}
+		if(header->next) {
+			header->next->prev = header->prev;
+		}
 
-	/**
-	 * @return An iterator to the beginning of data available for reading.
-	 */
-	auto begin() const {
-		return buffer_.begin() + read_;
+		::operator delete(header, std::align_val_t(max_align));
 	}
 
-	/**
-	 * @return An iterator to the end of data available for reading.
-	 */
-	auto end() {
-		return buffer_.begin() + write_;
-	}
+	void* bump_allocate(const std::size_t bytes, const std::size_t alignment) {
+		auto bump = reinterpret_cast<std::uintptr_t>(bump_);
+		bump = (bump + alignment - 1) & ~(alignment - 1);
 
-	/**
-	 * @return An iterator to the end of data available for reading.
-	 */
-	auto end() const {
-		return buffer_.begin() + write_;
+		if(!bump_ || bump + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+			bump_ = new_chunk(chunk_size_);
+			end_ = bump_ + chunk_size_;
+			bump = reinterpret_cast<std::uintptr_t>(bump_);
+		}
+
+		auto memory = reinterpret_cast<std::byte*>(bump);
+		bump_ = memory + bytes;
+		return memory;
 	}
 
+public:
 	/**
-	 * @brief Overall capacity of the container.
-	 * 
-	 * @return The container's total size in bytes.
+	 * @param chunk_size The number of bytes to request from the system
+	 * allocator at a time. Allocations that don't fit within a chunk are
+	 * made by the system allocator instead.
 	 */
-	constexpr static size_type capacity() {
-		return buf_size;
-	}
+	explicit region(const std::size_t chunk_size = 64 * 1024)
+		: chunk_size_(chunk_size) {}
+
+	region(const region&) = delete;
+	region& operator=(const region&) = delete;
 
 	/**
-	 * @brief Returns the size of the container.
+	 * @brief Allocates memory from the region.
 	 * 
-	 * @return The number of bytes of data available to read within the container.
+	 * @param size The number of bytes to allocate.
+	 * @param align The required alignment, which must not exceed 64.
+	 * 
+	 * @return Pointer to the allocated memory.
 	 */
-	size_type size() const {
-		return write_ - read_;
+	[[nodiscard]] void* allocate(const std::size_t size, const std::size_t align = alignof(std::max_align_t)) {
+		assert(align <= max_align && "region alignment too large");
+		const auto index = find_class(size, align);
+
+		if(index == class_count) [[unlikely]] {
+			return allocate_large(size);
+		}
+
+		if(auto block = free_[index]) {
+			free_[index] = block->next;
+			return block;
+		}
+
+		return bump_allocate(class_size(index), class_align(index));
 	}
 
 	/**
-	 * @brief The amount of free space.
+	 * @brief Returns memory to the region for reuse.
 	 * 
-	 * @return The number of bytes of free space within the container.
+	 * @param ptr Pointer to the memory.
+	 * @param size The size that was passed to allocate().
+	 * @param align The alignment that was passed to allocate().
 	 */
-	size_type free() const {
-		return buf_size - write_;
-	}
+	void deallocate(void* ptr, const std::size_t size, const std::size_t align = alignof(std::max_align_t)) {
+		assert(ptr);
+		const auto index = find_class(size, align);
 
-	/**
-	 * @return Pointer to the data available for reading.
-	 */
-	const value_type* data() const {
-		return read_ptr();
-	}
+		if(index == class_count) [[unlikely]] {
+			deallocate_large(ptr);
+			return;
+		}
 
-	/**
-	 * @return Pointer to the data available for reading.
-	 */
-	value_type* data() {
-		return read_ptr();
+		auto block = static_cast<free_block*>(ptr);
+		block->next = free_[index];
+		free_[index] = block;
 	}
 
 	/**
-	 * @return Pointer to the data available for reading.
+	 * @brief Releases all memory held by the region back to the system.
+	 * Anything that was allocated from it becomes invalid.
 	 */
-	const value_type* read_ptr() const {
-		return buffer_.data() + read_;
-	}
+	void release() {
+		while(chunks_) {
+			auto next = chunks_->next;
+			::operator delete(chunks_, std::align_val_t(max_align));
+			chunks_ = next;
+		}
 
-	/**
-	 * @return Pointer to the data available for reading.
-	 */
-	value_type* read_ptr() {
-		return buffer_.data() + read_;
-	}
+		while(large_) {
+			auto next = large_->next;
+			::operator delete(large_, std::align_val_t(max_align));
+			large_ = next;
+		}
 
-	/**
-	 * @return Pointer to the location within the buffer where the next write
-	 * will be made.
-	 */
-	const value_type* write_ptr() const {
-		return buffer_.data() + write_;
+		bump_ = nullptr;
+		end_ = nullptr;
+		free_.fill(nullptr);
 	}
 
-	/**
-	 * @return Pointer to the location within the buffer where the next write
-	 * will be made.
-	 */
-	value_type* write_ptr() {
-		return buffer_.data() + write_;
+	~region() {
+		release();
 	}
+};
 
-	/**
-	 * @return Pointer to the underlying storage.
-	 */
-	value_type* storage() {
-		return buffer_.data();
-	}
+/**
+ * Block allocator that takes its memory from a region. Intended for use
+ * with dynamic_buffer, allowing every buffer belonging to a connection to
+ * share the connection's region.
+ * 
+ * Copies refer to the same region and compare equal, so blocks can be
+ * handed between buffers using the same region.
+ */
+template<typename T>
+class region_allocator final {
+	region* region_;
 
-	/**
-	 * @return Pointer to the underlying storage.
-	 */
-	const value_type* storage() const {
-		return buffer_.data();
-	}
+public:
+	explicit region_allocator(region& region)
+		: region_(&region) {}
 
 	/**
-	 * @brief Retrieves a span representing the data available for reading contained within
-	 * underlying storage.
+	 * @brief Allocates and constructs an object.
 	 * 
-	 * @return A span over the data waiting to be read from the container.
+	 * @tparam Args Variadic arguments to be forwarded to the object's constructor.
 	 */
-	std::span<const value_type> read_span() const {
-		return { read_ptr(), size() };
+	template<typename ...Args>
+	[[nodiscard]] inline T* allocate(Args&&... args) {
+		auto memory = region_->allocate(sizeof(T), alignof(T));
+		return new (memory) T(std::forward<Args>(args)...);
 	}
 
 	/**
-	 * @brief Retrieves a span representing the free space within the underlying storage.
+	 * @brief Destructs an object and returns its memory to the region's
+	 * free list.
 	 * 
-	 * @return A span over the container's free space.
+	 * @param t The object to be deallocated.
 	 */
-	std::span<value_type> write_span() {
-		return { write_ptr(), free() };
+	inline void deallocate(T* t) {
+		assert(t);
+		t->~T();
+		region_->deallocate(t, sizeof(T), alignof(T));
 	}
-};
-
-} // hexi
-
-// #include <hexi/null_buffer.h>
-//  _               _ 
-// | |__   _____  _(_)
-// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
-// | | | |  __/>  <| | Version 1.3.5
-// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
+	template<std::output_iterator<T*> OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = allocate();
+		}
 
+		return out;
+	}
 
-// #include <hexi/pmc/buffer_write.h>
+	template<std::input_iterator InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+		for(; first != last; ++first) {
+			deallocate(*first);
+		}
+	}
 
-// #include <hexi/shared.h>
+	/**
+	 * @return The region that memory is allocated from.
+	 */
+	region& get() const {
+		return *region_;
+	}
 
-// #include <hexi/exception.h>
+	bool operator==(const region_allocator&) const = default;
+};
 
-#include <cstddef>
+/**
+ * Standard library compatible allocator that takes its memory from a region,
+ * for containers that are read into and are tied to a connection's lifetime.
+ */
+template<typename T>
+class region_std_allocator {
+	template<typename U>
+	friend class region_std_allocator;
 
-namespace hexi {
+	region* region_;
 
-class null_buffer final : public pmc::buffer_write {
 public:
-	using size_type       = std::size_t;
-	using offset_type     = std::size_t;
-	using value_type      = std::byte;
-	using contiguous      = is_contiguous;
-	using seeking         = unsupported;
+	using value_type = T;
 
-	void write(const auto& /*elem*/) {}
-	void write(const void* /*source*/, size_type /*length*/) override {};
-	void read(auto* /*elem*/) {}
-	void read(void* /*destination*/, size_type /*length*/) {};
-	void copy(auto* /*elem*/) const {}
-	void copy(void* /*destination*/, size_type /*length*/) const {};
-	void reserve(const size_type /*length*/) override {};
-	size_type size() const override{ return 0; };
-	[[nodiscard]] bool empty() const override { return true; };
-	bool can_write_seek() const override { return false; }
+	explicit region_std_allocator(region& region) noexcept
+		: region_(&region) {}
 
-	void write_seek(const buffer_seek /*direction*/, const std::size_t /*offset*/) override {
-		HEXI_THROW(exception("Don't do this on a null_buffer")); 
-	};
-};
+	template<typename U>
+	region_std_allocator(const region_std_allocator<U>& rhs) noexcept
+		: region_(rhs.region_) {}
 
-} // hexi
+	[[nodiscard]] T* allocate(const std::size_t count) {
+		return static_cast<T*>(region_->allocate(sizeof(T) * count, alignof(T)));
+	}
 
-// #include <hexi/stream_adaptors.h>
+	void deallocate(T* ptr, const std::size_t count) noexcept {
+		region_->deallocate(ptr, sizeof(T) * count, alignof(T));
+	}
 
-// #include <hexi/allocators/block_allocator.h>
+	template<typename U>
+	bool operator==(const region_std_allocator<U>& rhs) const noexcept {
+		return region_ == rhs.region_;
+	}
+};
 
-// #include <hexi/allocators/default_allocator.h>
+} // hexi
 
 // #include <hexi/allocators/tls_block_allocator.h>
 
@@ -4673,7 +11586,7 @@ class binary_stream_reader : virtual public stream_base {
 			SAFE_READ(container.data(), bytes, void());
 		} else {
 			for(count_type i = 0; i < count; ++i) {
-				cvalue_type value;
+				auto value = impl::make_element(container, nullptr);
 				*this >> value;
 				container.emplace_back(std::move(value));
 			}
@@ -4740,7 +11653,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(prefixed<std::string> adaptor) {
+	template<std_string T>
+	binary_stream_reader& operator>>(prefixed<T> adaptor) {
 		std::uint32_t size = 0;
 		*this >> endian::le(size);
 
@@ -4766,7 +11680,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(prefixed_varint<std::string> adaptor) {
+	template<std_string T>
+	binary_stream_reader& operator>>(prefixed_varint<T> adaptor) {
 		const auto size = impl::varint_decode<std::size_t>(*this);
 
 		// if an error was triggered during decode, we shouldn't reach here
@@ -4792,7 +11707,8 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(null_terminated<std::string> adaptor) {
+	template<std_string T>
+	binary_stream_reader& operator>>(null_terminated<T> adaptor) {
 		auto pos = buffer_.find_first_of(std::byte{0});
 
 		if(pos == buffer_.npos) {
@@ -4824,7 +11740,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_reader& operator>>(std::string& data) {
+	binary_stream_reader& operator>>(std_string auto& data) {
 		return *this >> prefixed(data);
 	}
 
@@ -4927,7 +11843,7 @@ public:
 	 * 
 	 * @param dest The destination string.
 	 */
-	void get(std::string& dest) {
+	void get(std_string auto& dest) {
 		*this >> dest;
 	}
 
@@ -4937,7 +11853,7 @@ public:
 	 * @param[out] dest The std::string to hold the result.
 	 * @param count The number of bytes to be read.
 	 */
-	void get(std::string& dest, std::size_t size) {
+	void get(std_string auto& dest, std::size_t size) {
 		STREAM_READ_BOUNDS_ENFORCE(size, void());
 
 		dest.resize_and_overwrite(size, [&](char* strbuf, std::size_t len) {
@@ -5281,7 +12197,7 @@ public:
 	 * @return Reference to the current stream.
 	 */
 	template<typename T>
-	requires std::is_same_v<std::decay_t<T>, std::string>
+	requires std_string<std::decay_t<T>>
 	binary_stream_writer& operator<<(null_terminated<T> adaptor) {
 		assert(adaptor->find_first_of('\0') == adaptor->npos);
 		write(adaptor->data(), adaptor->size() + 1); // yes, the standard allows this
@@ -5321,7 +12237,7 @@ public:
 	 * 
 	 * @return Reference to the current stream.
 	 */
-	binary_stream_writer& operator<<(const std::string& string) {
+	binary_stream_writer& operator<<(const std_string auto& string) {
 		return *this << prefixed(string);
 	}
 
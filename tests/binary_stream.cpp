@@ -12,15 +12,18 @@
 #include <hexi/static_buffer.h>
 #include <hexi/binary_stream.h>
 #include <hexi/buffer_adaptor.h>
+#include <hexi/null_buffer.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <array>
 #include <chrono>
 #include <limits>
 #include <list>
+#include <memory_resource>
 #include <numeric>
 #include <random>
 #include <set>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 #include <cstdlib>
@@ -1111,6 +1114,180 @@ TEST(binary_stream, prefixed_containers) {
 	ASSERT_EQ(objects, output_objs);
 }
 
+TEST(binary_stream, pmr_containers) {
+	std::vector<char> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+
+	// long enough to defeat the small string optimisation
+	const std::vector<std::string_view> input {
+		"The quick brown fox jumps over the lazy dog",
+		"Pack my box with five dozen liquor jugs",
+		"How vexingly quick daft zebras jump"
+	};
+
+	// anything allocated from outside of the arena will throw
+	std::array<std::byte, 1024> arena;
+	std::pmr::monotonic_buffer_resource resource(
+		arena.data(), arena.size(), std::pmr::null_memory_resource()
+	);
+
+	stream << hexi::prefixed(input);
+	std::pmr::vector<std::pmr::string> output(&resource);
+	stream >> hexi::prefixed(output);
+	ASSERT_TRUE(std::ranges::equal(input, output));
+
+	for(const auto& str : output) {
+		ASSERT_EQ(str.get_allocator().resource(), &resource);
+	}
+
+	// the container has no allocator to hand down, so the stream's is used
+	stream << hexi::prefixed(input);
+	stream.memory_resource(&resource);
+	std::vector<std::pmr::string> bound;
+	stream >> hexi::prefixed(bound);
+	ASSERT_TRUE(std::ranges::equal(input, bound));
+
+	for(const auto& str : bound) {
+		ASSERT_EQ(str.get_allocator().resource(), &resource);
+	}
+
+	stream << output[0];
+	stream << hexi::null_terminated(output[1]);
+	std::pmr::string str(&resource), terminated(&resource);
+	stream >> str >> hexi::null_terminated(terminated);
+	ASSERT_EQ(str, input[0]);
+	ASSERT_EQ(terminated, input[1]);
+	ASSERT_TRUE(stream);
+	ASSERT_TRUE(stream.empty());
+}
+
+namespace {
+
+enum class Opcode : std::uint16_t {
+	login = 1, logout = 2
+};
+
+struct AggregateMessage {
+	std::uint32_t id;
+	Opcode opcode;
+	std::uint16_t flags;
+	std::string_view name;
+	std::uint8_t kind;
+	std::uint64_t timestamp;
+	float scale;
+	std::string_view tag;
+
+	bool operator==(const AggregateMessage&) const = default;
+};
+
+using message_layout = hexi::impl::aggregate_layout<AggregateMessage>;
+static_assert(hexi::field_serialisable<AggregateMessage>);
+static_assert(message_layout::count == 8);
+static_assert(message_layout::known);
+
+// id, opcode and flags are contiguous, as are timestamp and scale, but
+// there's padding between kind and timestamp
+static_assert(message_layout::runs({ true, true, true, false, true, true, true, false })
+	== std::array<std::size_t, 8>{ 3, 3, 3, 4, 5, 7, 7, 8 });
+
+} // namespace
+
+TEST(binary_stream, aggregate_fields) {
+	const AggregateMessage input {
+		.id = 0xdeadbeef,
+		.opcode = Opcode::logout,
+		.flags = 0x1234,
+		.name = "The quick brown fox",
+		.kind = 7,
+		.timestamp = 0x0102030405060708,
+		.scale = 1.5f,
+		.tag = "lazy dog"
+	};
+
+	std::vector<char> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	stream << input;
+
+	// should match serialising each field by hand
+	std::vector<char> expected;
+	hexi::buffer_adaptor expected_adaptor(expected);
+	hexi::binary_stream manual(expected_adaptor);
+	manual << input.id << input.opcode << input.flags << input.name
+		<< input.kind << input.timestamp << input.scale << input.tag;
+	ASSERT_EQ(buffer, expected);
+	ASSERT_EQ(stream.total_write(), expected.size());
+
+	AggregateMessage output{};
+	stream >> output;
+	ASSERT_TRUE(stream);
+	ASSERT_TRUE(stream.empty());
+	ASSERT_EQ(input, output);
+}
+
+TEST(binary_stream, aggregate_fields_endian) {
+	const AggregateMessage input {
+		.id = 0xdeadbeef,
+		.opcode = Opcode::login,
+		.flags = 0x1234,
+		.name = "Pack my box with five dozen liquor jugs",
+		.kind = 3,
+		.timestamp = 0x0102030405060708,
+		.scale = -2.25f,
+		.tag = ""
+	};
+
+	std::vector<char> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor, hexi::endian::big);
+	stream << input;
+
+	std::vector<char> expected;
+	hexi::buffer_adaptor expected_adaptor(expected);
+	hexi::binary_stream manual(expected_adaptor, hexi::endian::big);
+	manual << input.id << input.opcode << input.flags << input.name
+		<< input.kind << input.timestamp << input.scale << input.tag;
+	ASSERT_EQ(buffer, expected);
+
+	// big endian id at the start of the message
+	ASSERT_EQ(static_cast<std::uint8_t>(buffer[0]), 0xde);
+	ASSERT_EQ(static_cast<std::uint8_t>(buffer[3]), 0xef);
+
+	AggregateMessage output{};
+	stream >> output;
+	ASSERT_TRUE(stream);
+	ASSERT_EQ(input, output);
+}
+
+TEST(binary_stream, aggregate_fields_truncated) {
+	const AggregateMessage input {
+		.id = 1,
+		.opcode = Opcode::login,
+		.flags = 0,
+		.name = "truncated",
+		.kind = 0,
+		.timestamp = 0,
+		.scale = 0.0f,
+		.tag = ""
+	};
+	std::vector<char> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	stream << input;
+
+	// not enough data for the first run of fields
+	std::vector<char> truncated(buffer.begin(), buffer.begin() + 6);
+	hexi::buffer_adaptor truncated_adaptor(truncated);
+	hexi::binary_stream truncated_stream(truncated_adaptor, hexi::no_throw);
+
+	AggregateMessage output{};
+	truncated_stream >> output;
+	ASSERT_FALSE(truncated_stream);
+	ASSERT_EQ(truncated_stream.state(), hexi::stream_state::buff_limit_err);
+	ASSERT_EQ(truncated_stream.total_read(), 0);
+}
+
 TEST(binary_stream, std_array_size) {
 	std::array<char, 16> buffer;
 	hexi::buffer_adaptor adaptor(buffer, hexi::init_empty);
@@ -1118,4 +1295,129 @@ TEST(binary_stream, std_array_size) {
 	ASSERT_TRUE(adaptor.empty());
 	ASSERT_EQ(adaptor.size(), 0);
 	ASSERT_EQ(stream.size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(binary_stream, placeholder_dynamic_buffer) {
+	hexi::dynamic_buffer<8> buffer;
+	hexi::binary_stream stream(buffer);
+
+	// starts mid-block so the slot straddles a block boundary
+	stream << std::uint32_t(0xdeadbeef) << std::uint16_t(0);
+	auto slot = stream.placeholder<std::uint32_t>();
+	ASSERT_TRUE(slot.valid());
+	const std::string_view payload = "payload";
+	stream.put(payload.data(), payload.size());
+	slot.fill(static_cast<std::uint32_t>(payload.size()));
+	ASSERT_EQ(stream.total_write(), 4 + 2 + 4 + payload.size());
+
+	std::uint32_t magic = 0, length = 0;
+	std::uint16_t pad = 0;
+	stream >> magic >> pad >> length;
+	ASSERT_EQ(magic, 0xdeadbeef);
+	ASSERT_EQ(length, payload.size());
+
+	std::string output(length, '\0');
+	stream.get(output.data(), length);
+	ASSERT_EQ(output, payload);
+	ASSERT_TRUE(stream);
+}
+
+TEST(binary_stream, placeholder_full_tail) {
+	hexi::dynamic_buffer<4> buffer;
+	hexi::binary_stream stream(buffer);
+
+	// tail block is exactly full, so the slot begins in a new block
+	stream << std::uint32_t(1);
+	auto slot = stream.placeholder<std::uint16_t>();
+	stream << std::uint8_t(2);
+	slot.fill(0x1234);
+
+	std::uint32_t first = 0;
+	std::uint16_t second = 0;
+	std::uint8_t third = 0;
+	stream >> first >> second >> third;
+	ASSERT_EQ(first, 1);
+	ASSERT_EQ(second, 0x1234);
+	ASSERT_EQ(third, 2);
+}
+
+TEST(binary_stream, placeholder_static_buffer) {
+	hexi::static_buffer<char, 8> buffer;
+	hexi::binary_stream stream(buffer);
+
+	auto slot = stream.placeholder<std::uint32_t>();
+	stream << std::uint32_t(2);
+	slot.fill(1);
+	ASSERT_TRUE(stream);
+
+	std::uint32_t first = 0, second = 0;
+	stream >> first >> second;
+	ASSERT_EQ(first, 1);
+	ASSERT_EQ(second, 2);
+
+	// no room left, so the slot is invalid
+	hexi::static_buffer<char, 2> small;
+	hexi::binary_stream small_stream(small, hexi::no_throw);
+	auto bad = small_stream.placeholder<std::uint32_t>();
+	ASSERT_FALSE(bad.valid());
+	ASSERT_FALSE(small_stream);
+	bad.fill(1);
+}
+
+TEST(binary_stream, placeholder_endianness) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor, hexi::endian::big);
+
+	auto slot = stream.placeholder<std::uint16_t>();
+	slot.fill(0x0102);
+	ASSERT_EQ(buffer[0], 0x01);
+	ASSERT_EQ(buffer[1], 0x02);
+}
+
+TEST(binary_stream, placeholder_varint) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+
+	auto slot = stream.placeholder_varint<std::uint32_t>();
+	stream << std::uint8_t(0xff);
+	slot.fill(300);
+	ASSERT_EQ(buffer.size(), 5 + 1);
+
+	// padded encoding must still decode to the same value
+	ASSERT_EQ(hexi::impl::varint_decode<std::uint32_t>(stream), 300);
+	std::uint8_t trailer = 0;
+	stream >> trailer;
+	ASSERT_EQ(trailer, 0xff);
+}
+
+TEST(binary_stream, placeholder_varint_compact) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+
+	auto slot = stream.placeholder_varint<std::uint64_t>();
+	const std::string_view payload = "compacted";
+	stream.put(payload.data(), payload.size());
+	slot.fill_compact(payload.size());
+
+	ASSERT_EQ(adaptor.size(), 1 + payload.size());
+	ASSERT_EQ(stream.total_write(), 1 + payload.size());
+	ASSERT_EQ(hexi::impl::varint_decode<std::size_t>(stream), payload.size());
+
+	std::string output(payload.size(), '\0');
+	stream.get(output.data(), output.size());
+	ASSERT_EQ(output, payload);
+	ASSERT_TRUE(adaptor.empty());
+}
+
+TEST(binary_stream, placeholder_null_buffer) {
+	hexi::null_buffer buffer;
+	hexi::binary_stream stream(buffer);
+	auto slot = stream.placeholder<std::uint32_t>();
+	auto var = stream.placeholder_varint<std::uint16_t>();
+	slot.fill(1);
+	var.fill(1);
+	ASSERT_EQ(stream.total_write(), 4 + 3);
+}
@@ -0,0 +1,188 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/bit_stream.h>
+#include <hexi/binary_stream.h>
+#include <hexi/buffer_adaptor.h>
+#include <hexi/dynamic_buffer.h>
+#include <hexi/static_buffer.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+TEST(bit_stream, msb_first_layout) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::bit_stream stream(adaptor);
+	stream.put_bits(0b101, 3);
+	stream.put_bits(0b11, 2);
+	stream.put_bit(false);
+	stream.put_bits(0x1ff, 9);
+	ASSERT_EQ(stream.total_write(), 15);
+	ASSERT_TRUE(buffer.empty()); // still in the accumulator
+	stream.flush();
+
+	ASSERT_EQ(buffer.size(), 2);
+	ASSERT_EQ(buffer[0], 0b1011'1011);
+	ASSERT_EQ(buffer[1], 0b1111'1110);
+}
+
+TEST(bit_stream, lsb_first_layout) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::bit_stream stream(adaptor, hexi::bit_order::lsb_first);
+	stream.put_bits(0b101, 3);
+	stream.put_bits(0b11, 2);
+	stream.put_bit(false);
+	stream.put_bits(0x1ff, 9);
+	stream.flush();
+
+	ASSERT_EQ(buffer.size(), 2);
+	ASSERT_EQ(buffer[0], 0b1101'1101);
+	ASSERT_EQ(buffer[1], 0b0111'1111);
+}
+
+TEST(bit_stream, word_flush) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::bit_stream stream(adaptor);
+
+	for(int i = 0; i < 6; ++i) {
+		stream.put_bits(0xfff, 12);
+	}
+
+	// 72 bits, a full word has been written and one byte is pending
+	ASSERT_EQ(buffer.size(), 8);
+	stream.flush();
+	ASSERT_EQ(buffer.size(), 9);
+	ASSERT_TRUE(std::ranges::all_of(buffer, [](auto byte) { return byte == 0xff; }));
+}
+
+template<typename order>
+void round_trip(order) {
+	std::mt19937_64 rng(0x5eed);
+	std::vector<std::pair<std::uint64_t, unsigned>> values;
+
+	for(int i = 0; i < 1000; ++i) {
+		const auto count = static_cast<unsigned>(rng() % 65);
+		const auto mask = count == 64? ~0ull : (1ull << count) - 1;
+		values.emplace_back(rng() & mask, count);
+	}
+
+	hexi::dynamic_buffer<64> buffer;
+	hexi::bit_stream writer(buffer, order{});
+
+	for(auto [value, count] : values) {
+		writer.put_bits(value, count);
+	}
+
+	writer.flush();
+	ASSERT_EQ(buffer.size(), (writer.total_write() + 7) / 8);
+
+	hexi::bit_stream reader(buffer, order{});
+
+	for(auto [value, count] : values) {
+		ASSERT_EQ(reader.get_bits(count), value) << count;
+	}
+
+	ASSERT_TRUE(reader);
+	reader.align_read();
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(bit_stream, round_trip_msb_first) {
+	round_trip(hexi::bit_order::msb_first);
+}
+
+TEST(bit_stream, round_trip_lsb_first) {
+	round_trip(hexi::bit_order::lsb_first);
+}
+
+TEST(bit_stream, signed_values) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::bit_stream stream(adaptor);
+	stream.put_bits(-3, 4);
+	stream.put_bits(5, 4);
+	stream.put_bits(-1, 64);
+	stream.put_bits(-100, 12);
+	stream.flush();
+
+	ASSERT_EQ(stream.get_bits<std::int8_t>(4), -3);
+	ASSERT_EQ(stream.get_bits<std::int8_t>(4), 5);
+	ASSERT_EQ(stream.get_bits<std::int64_t>(64), -1);
+	ASSERT_EQ(stream.get_bits<std::int16_t>(12), -100);
+}
+
+TEST(bit_stream, mixed_with_binary_stream) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+
+	{
+		hexi::bit_stream bits(adaptor);
+		bits.put_bit(true);
+		bits.put_bits(6, 3);
+		bits.put_bits(1000, 11);
+		bits.flush();
+	}
+
+	hexi::binary_stream stream(adaptor);
+	stream << std::uint32_t(0xdeadbeef);
+	ASSERT_EQ(buffer.size(), 6);
+
+	{
+		hexi::bit_stream bits(adaptor);
+		ASSERT_TRUE(bits.get_bit());
+		ASSERT_EQ(bits.get_bits(3), 6);
+		ASSERT_FALSE(bits.read_aligned());
+		ASSERT_EQ(bits.get_bits(11), 1000);
+		bits.align_read();
+		ASSERT_TRUE(bits.read_aligned());
+		ASSERT_EQ(bits.total_read(), 16);
+	}
+
+	std::uint32_t value = 0;
+	stream >> value;
+	ASSERT_EQ(value, 0xdeadbeef);
+	ASSERT_TRUE(stream);
+}
+
+TEST(bit_stream, underrun) {
+	std::vector<std::uint8_t> buffer { 0xff };
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::bit_stream stream(adaptor);
+	ASSERT_EQ(stream.get_bits(4), 0xf);
+	ASSERT_THROW(stream.get_bits(5), hexi::buffer_underrun);
+	ASSERT_EQ(stream.state(), hexi::stream_state::buff_limit_err);
+}
+
+TEST(bit_stream, underrun_noexcept) {
+	std::vector<std::uint8_t> buffer { 0xff };
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::bit_stream stream(adaptor, hexi::no_throw);
+	ASSERT_EQ(stream.get_bits(12), 0);
+	ASSERT_FALSE(stream);
+	ASSERT_EQ(stream.state(), hexi::stream_state::buff_limit_err);
+
+	// nothing was consumed by the failed read
+	stream.clear_state();
+	ASSERT_EQ(stream.get_bits(8), 0xff);
+	ASSERT_TRUE(stream);
+}
+
+TEST(bit_stream, overflow) {
+	hexi::static_buffer<std::uint8_t, 4> buffer;
+	hexi::bit_stream stream(buffer, hexi::no_throw);
+	stream.put_bits(0xabcdef, 24);
+	stream.put_bits(0xfedcba, 24);
+	stream.put_bits(0x1234, 16);
+	stream.put_bits(1, 1);
+	ASSERT_FALSE(stream);
+	ASSERT_EQ(stream.state(), hexi::stream_state::buff_write_err);
+}
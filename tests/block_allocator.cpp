@@ -0,0 +1,237 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <gtest/gtest.h>
+#include <array>
+#include <memory>
+#include <cstdint>
+
+#define HEXI_DEBUG_ALLOCATORS
+#include <hexi/allocators/block_allocator.h>
+#include <hexi/allocators/tls_block_allocator.h>
+
+namespace {
+
+struct test_block {
+	std::array<std::uint8_t, 40> data;
+};
+
+} // unnamed
+
+TEST(block_allocator, natural_stride) {
+	using allocator = hexi::block_allocator<test_block, 4>;
+	static_assert(allocator::block_size == sizeof(test_block));
+	static_assert(allocator::slab_size == sizeof(test_block) * 4);
+}
+
+TEST(block_allocator, cache_line_alignment) {
+	using allocator = hexi::block_allocator<
+		test_block, 8, hexi::no_validate_dealloc, hexi::cache_line_alignment
+	>;
+
+	static_assert(allocator::block_size == 64);
+
+	auto alloc = std::make_unique<allocator>();
+	std::array<test_block*, 8> blocks{};
+
+	for(auto& block : blocks) {
+		block = alloc->allocate();
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(block) % 64, 0);
+		ASSERT_TRUE(alloc->owns(block));
+	}
+
+	ASSERT_EQ(alloc->storage_active_count, 8);
+
+	for(auto& block : blocks) {
+		alloc->deallocate(block);
+	}
+
+	ASSERT_EQ(alloc->storage_active_count, 0);
+}
+
+TEST(block_allocator, page_alignment_overflow) {
+	using allocator = hexi::block_allocator<
+		test_block, 2, hexi::validate_dealloc, hexi::page_alignment
+	>;
+
+	static_assert(allocator::block_size == 4096);
+
+	auto alloc = std::make_unique<allocator>();
+	auto first = alloc->allocate();
+	auto second = alloc->allocate();
+	auto heap = alloc->allocate(); // slab exhausted
+
+	ASSERT_TRUE(alloc->owns(first));
+	ASSERT_TRUE(alloc->owns(second));
+	ASSERT_FALSE(alloc->owns(heap));
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(heap) % 4096, 0);
+	ASSERT_EQ(alloc->storage_active_count, 2);
+	ASSERT_EQ(alloc->new_active_count, 1);
+
+	alloc->deallocate(heap);
+	alloc->deallocate(second);
+	alloc->deallocate(first);
+	ASSERT_EQ(alloc->active_count, 0);
+}
+
+TEST(block_allocator, mapped_slab) {
+	using allocator = hexi::block_allocator<
+		test_block, 128, hexi::no_validate_dealloc,
+		hexi::cache_line_alignment, hexi::mapped_slab
+	>;
+
+	allocator alloc;
+	ASSERT_FALSE(alloc.huge_pages());
+
+	auto block = alloc.allocate();
+	block->data.fill(0xff);
+	ASSERT_TRUE(alloc.owns(block));
+	alloc.deallocate(block);
+}
+
+TEST(block_allocator, huge_page_slab) {
+	using allocator = hexi::block_allocator<
+		test_block, 1024, hexi::no_validate_dealloc,
+		hexi::natural_alignment, hexi::huge_page_slab
+	>;
+
+	// whether explicit huge pages are available depends on the system,
+	// so only check that the fallback works
+	allocator alloc;
+	std::array<test_block*, 1024> blocks{};
+
+	for(auto& block : blocks) {
+		block = alloc.allocate();
+		block->data.fill(0xaa);
+	}
+
+	ASSERT_EQ(alloc.new_active_count, 0);
+
+	for(auto& block : blocks) {
+		ASSERT_EQ(block->data[0], 0xaa);
+		alloc.deallocate(block);
+	}
+}
+
+TEST(block_allocator, tls_policies) {
+	hexi::tls_block_allocator<
+		test_block, 16, hexi::no_ref_counting, hexi::safe_entrant,
+		hexi::cache_line_alignment, hexi::mapped_slab
+	> tlsalloc;
+
+	auto block = tlsalloc.allocate();
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(block) % 64, 0);
+	ASSERT_TRUE(tlsalloc.allocator()->owns(block));
+	tlsalloc.deallocate(block);
+}
+
+TEST(block_allocator, bulk_allocate) {
+	using allocator = hexi::block_allocator<test_block, 8, hexi::validate_dealloc>;
+	auto alloc = std::make_unique<allocator>();
+	std::array<test_block*, 10> blocks{};
+
+	// two more than the slab holds, so the remainder comes from the heap
+	auto end = alloc->allocate_n(blocks.size(), blocks.begin());
+	ASSERT_EQ(end, blocks.end());
+	ASSERT_EQ(alloc->storage_active_count, 8);
+	ASSERT_EQ(alloc->new_active_count, 2);
+	ASSERT_EQ(alloc->total_allocs, 10);
+
+	for(auto block : blocks) {
+		ASSERT_NE(block, nullptr);
+		block->data.fill(0x11);
+	}
+
+	alloc->deallocate_list(blocks.begin(), blocks.end());
+	ASSERT_EQ(alloc->active_count, 0);
+	ASSERT_EQ(alloc->total_deallocs, 10);
+
+	// every slab block should be back on the free list
+	alloc->allocate_n(8, blocks.begin());
+	ASSERT_EQ(alloc->new_active_count, 0);
+
+	for(auto i = 0u; i < 8; ++i) {
+		ASSERT_TRUE(alloc->owns(blocks[i]));
+	}
+
+	alloc->deallocate_list(blocks.begin(), blocks.begin() + 8);
+	ASSERT_EQ(alloc->active_count, 0);
+}
+
+TEST(block_allocator, lazy_slab) {
+	using allocator = hexi::block_allocator<test_block, 4, hexi::validate_dealloc>;
+	auto alloc = std::make_unique<allocator>();
+
+	// untouched blocks are handed out in address order
+	auto first = alloc->allocate();
+	auto second = alloc->allocate();
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(second) - reinterpret_cast<std::uintptr_t>(first),
+	          allocator::block_size);
+
+	// returned blocks are preferred over untouched ones
+	alloc->deallocate(first);
+	auto reused = alloc->allocate();
+	ASSERT_EQ(reused, first);
+
+	alloc->prefault();
+	auto third = alloc->allocate();
+	auto fourth = alloc->allocate();
+	ASSERT_TRUE(alloc->owns(third));
+	ASSERT_TRUE(alloc->owns(fourth));
+	ASSERT_EQ(alloc->storage_active_count, 4);
+
+	auto heap = alloc->allocate();
+	ASSERT_FALSE(alloc->owns(heap));
+	alloc->prefault(); // nothing left to touch
+
+	for(auto block : { reused, second, third, fourth, heap }) {
+		alloc->deallocate(block);
+	}
+
+	ASSERT_EQ(alloc->active_count, 0);
+}
+
+TEST(block_allocator, bulk_allocate_lazy_slab) {
+	using allocator = hexi::block_allocator<test_block, 8, hexi::validate_dealloc>;
+	auto alloc = std::make_unique<allocator>();
+	std::array<test_block*, 10> blocks{};
+	ASSERT_EQ(alloc->untouched(), 8);
+
+	// carved from the untouched part of the slab as a contiguous run
+	alloc->allocate_n(3, blocks.begin());
+	ASSERT_EQ(alloc->untouched(), 5);
+	ASSERT_EQ(alloc->storage_active_count, 3);
+
+	for(auto i = 1u; i < 3; ++i) {
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(blocks[i]) - reinterpret_cast<std::uintptr_t>(blocks[i - 1]),
+		          allocator::block_size);
+	}
+
+	// free blocks first, then the rest of the slab, then the heap
+	alloc->deallocate(blocks[0]);
+	alloc->allocate_n(7, blocks.begin() + 3);
+	ASSERT_EQ(blocks[3], blocks[0]);
+	ASSERT_EQ(alloc->untouched(), 0);
+	ASSERT_EQ(alloc->storage_active_count, 8);
+	ASSERT_EQ(alloc->new_active_count, 1);
+
+	alloc->deallocate_list(blocks.begin() + 1, blocks.end());
+	ASSERT_EQ(alloc->active_count, 0);
+}
+
+TEST(block_allocator, prefault_mapped) {
+	using allocator = hexi::block_allocator<
+		test_block, 10000, hexi::no_validate_dealloc,
+		hexi::natural_alignment, hexi::mapped_slab
+	>;
+
+	auto alloc = std::make_unique<allocator>();
+	auto block = alloc->allocate();
+	alloc->prefault();
+	block->data.fill(0x22);
+	ASSERT_EQ(block->data[39], 0x22);
+	alloc->deallocate(block);
+}
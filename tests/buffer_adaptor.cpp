@@ -5,6 +5,7 @@
 // |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
 
 #include <hexi/buffer_adaptor.h>
+#include <hexi/allocators/default_init_allocator.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <array>
@@ -183,4 +184,91 @@ TEST(buffer_adaptor, string_buffer) {
 	const auto str = "The quick brown fox jumped over the lazy dog"sv;
 	adaptor.write(str.data(), str.size());
 	ASSERT_EQ(buffer, str);
-}
\ No newline at end of file
+}
+
+TEST(buffer_adaptor, compaction_bounds_growth) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor<decltype(buffer), true, hexi::compact<64, 50>> adaptor(buffer);
+	std::array<std::uint8_t, 16> data{};
+	std::array<std::uint8_t, 16> out{};
+
+	// keep one message in flight so the buffer is never fully drained
+	adaptor.write(data.data(), data.size());
+
+	for(std::uint8_t i = 0; i < 200; ++i) {
+		data.fill(i);
+		adaptor.write(data.data(), data.size());
+		adaptor.read(out.data(), out.size());
+	}
+
+	ASSERT_EQ(adaptor.size(), data.size());
+	ASSERT_LE(buffer.size(), 128);
+
+	adaptor.read(out.data(), out.size());
+	ASSERT_EQ(out, data);
+}
+
+TEST(buffer_adaptor, defragment) {
+	std::vector<std::uint8_t> buffer { 1, 2, 3, 4, 5 };
+	hexi::buffer_adaptor adaptor(buffer);
+	adaptor.skip(2);
+	ASSERT_TRUE(adaptor.defragment());
+	ASSERT_FALSE(adaptor.defragment());
+	ASSERT_EQ(adaptor.size(), 3);
+	ASSERT_EQ(adaptor.read_ptr(), buffer.data());
+	ASSERT_EQ(adaptor[0], 3);
+	ASSERT_EQ(adaptor[2], 5);
+}
+
+TEST(buffer_adaptor, geometric_growth) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor<
+		decltype(buffer), true, hexi::no_compaction, hexi::geometric_growth<>
+	> adaptor(buffer);
+
+	std::size_t reallocations = 0;
+	auto last_capacity = buffer.capacity();
+
+	for(std::uint32_t i = 0; i < 1000; ++i) {
+		adaptor.write(i);
+
+		if(buffer.capacity() != last_capacity) {
+			last_capacity = buffer.capacity();
+			++reallocations;
+		}
+	}
+
+	// only the capacity grows geometrically
+	ASSERT_EQ(adaptor.size(), 1000 * sizeof(std::uint32_t));
+	ASSERT_EQ(buffer.size(), adaptor.size());
+	ASSERT_LE(reallocations, 12);
+
+	for(std::uint32_t i = 0; i < 1000; ++i) {
+		std::uint32_t value = 0;
+		adaptor.read(&value);
+		ASSERT_EQ(value, i);
+	}
+}
+
+TEST(buffer_adaptor, uninit_vector) {
+	hexi::uninit_vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+
+	for(std::uint32_t i = 0; i < 1000; ++i) {
+		adaptor.write(i);
+	}
+
+	// no uninitialised bytes are exposed beyond those written
+	ASSERT_EQ(buffer.size(), 1000 * sizeof(std::uint32_t));
+	ASSERT_EQ(adaptor.size(), buffer.size());
+
+	for(std::uint32_t i = 0; i < 1000; ++i) {
+		std::uint32_t value = 0;
+		adaptor.read(&value);
+		ASSERT_EQ(value, i);
+	}
+
+	// explicit values are still honoured
+	hexi::uninit_vector<std::uint8_t> filled(16, 0xff);
+	ASSERT_TRUE(std::ranges::all_of(filled, [](auto v) { return v == 0xff; }));
+}
@@ -0,0 +1,76 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+
+#define HEXI_DEBUG_ALLOCATORS
+#include <hexi/buffer_pool.h>
+#include <hexi/dynamic_buffer.h>
+#include <hexi/dynamic_tls_buffer.h>
+#include <hexi/binary_stream.h>
+
+TEST(buffer_pool, recycle) {
+	hexi::buffer_pool<hexi::dynamic_buffer<16>, 2> pool;
+	ASSERT_EQ(pool.size(), 0);
+
+	auto buffer = pool.acquire();
+	const auto address = buffer.get();
+	buffer->write(std::uint64_t(1));
+	buffer.reset();
+	ASSERT_EQ(pool.size(), 1);
+
+	// comes back empty but with its block still linked
+	auto recycled = pool.acquire();
+	ASSERT_EQ(recycled.get(), address);
+	ASSERT_TRUE(recycled->empty());
+	ASSERT_EQ(recycled->block_count(), 1);
+	ASSERT_EQ(pool.size(), 0);
+}
+
+TEST(buffer_pool, capacity) {
+	hexi::buffer_pool<hexi::dynamic_buffer<16>, 2> pool;
+	pool.reserve(5);
+	ASSERT_EQ(pool.size(), 2);
+
+	{
+		auto a = pool.acquire();
+		auto b = pool.acquire();
+		auto c = pool.acquire();
+		ASSERT_EQ(pool.size(), 0);
+	}
+
+	ASSERT_EQ(pool.size(), 2);
+	pool.shrink_to_fit();
+	ASSERT_EQ(pool.size(), 0);
+}
+
+TEST(buffer_pool, tls_allocation_free) {
+	using buffer_type = hexi::dynamic_tls_buffer<32, 16>;
+	using storage_type = buffer_type::storage_type;
+	hexi::tls_block_allocator<storage_type, 16> tlsalloc;
+	auto& pool = hexi::buffer_pool<buffer_type>::local();
+
+	auto send = [&] {
+		auto buffer = pool.acquire();
+		hexi::binary_stream stream(*buffer);
+		stream << std::uint32_t(0x1234) << std::uint64_t(0x5678);
+		std::uint32_t opcode = 0;
+		stream >> opcode;
+		ASSERT_EQ(opcode, 0x1234);
+	};
+
+	send(); // warm up
+	const auto allocs = tlsalloc.allocator()->total_allocs;
+
+	for(int i = 0; i < 10; ++i) {
+		send();
+	}
+
+	ASSERT_EQ(tlsalloc.allocator()->total_allocs, allocs);
+	pool.shrink_to_fit();
+}
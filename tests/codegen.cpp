@@ -0,0 +1,274 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include "codegen_example.h"
+#include <hexi/binary_stream.h>
+#include <hexi/buffer_adaptor.h>
+#include <hexi/dynamic_buffer.h>
+#include <hexi/endian.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+example::LoginRequest make_login() {
+	return {
+		.opcode = 0x1234,
+		.build = 12340,
+		.flags = 0x05,
+		.session = 0xdeadbeefcafe,
+		.username = "Chaosvex",
+		.checksum = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 },
+		.locale = "enGB",
+		.addons = { 1, 10, 100, 1000, 10000 },
+		.remember = true
+	};
+}
+
+example::ChatMessage make_chat() {
+	return {
+		.channel = 7,
+		.language = -1,
+		.text = "The quick brown fox jumps over the lazy dog",
+		.recipients = { 1, 0xffffffffffff, 42 }
+	};
+}
+
+// hand-written equivalent of the ChatMessage codec, used to check the
+// wire format and as the baseline for the benchmarks
+void hand_encode(auto& stream, const example::ChatMessage& msg) {
+	auto channel = msg.channel;
+	auto language = msg.language;
+	auto text_size = static_cast<std::uint16_t>(msg.text.size());
+	stream << hexi::endian::be(channel) << hexi::endian::le(language);
+	stream << hexi::endian::be(text_size);
+	stream.put(msg.text.data(), msg.text.size());
+
+	auto count = static_cast<std::uint16_t>(msg.recipients.size());
+	stream << hexi::endian::be(count);
+
+	for(auto recipient : msg.recipients) {
+		stream << hexi::endian::be(recipient);
+	}
+}
+
+void hand_decode(auto& stream, example::ChatMessage& msg) {
+	std::uint16_t text_size = 0, count = 0;
+	stream >> hexi::endian::be(msg.channel) >> hexi::endian::le(msg.language);
+	stream >> hexi::endian::be(text_size);
+	stream.get(msg.text, text_size);
+	stream >> hexi::endian::be(count);
+	msg.recipients.resize(count);
+
+	for(auto& recipient : msg.recipients) {
+		stream >> hexi::endian::be(recipient);
+	}
+}
+
+} // namespace
+
+TEST(codegen, login_round_trip) {
+	const auto input = make_login();
+	std::vector<char> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	example::encode(stream, input);
+	ASSERT_EQ(buffer.size(), example::encoded_size(input));
+
+	example::LoginRequest output;
+	example::decode(stream, output);
+	ASSERT_TRUE(stream);
+	ASSERT_TRUE(stream.empty());
+	ASSERT_EQ(input, output);
+}
+
+TEST(codegen, empty_round_trip) {
+	const example::LoginRequest input;
+	hexi::dynamic_buffer<32> buffer;
+	hexi::binary_stream stream(buffer);
+	example::encode(stream, input);
+	ASSERT_EQ(buffer.size(), example::LoginRequest::min_size);
+	ASSERT_EQ(buffer.size(), example::encoded_size(input));
+
+	example::LoginRequest output = make_login();
+	example::decode(stream, output);
+	ASSERT_TRUE(stream);
+	ASSERT_EQ(input, output);
+}
+
+TEST(codegen, position_layout) {
+	const example::Position input {
+		.entity = 0x0102030405060708,
+		.x = 1.0f,
+		.y = -2.5f,
+		.z = 100.0f,
+		.orientation = 3.14159f,
+		.flags = 0xabcd
+	};
+
+	std::vector<std::uint8_t> buffer;
+	example::encode_to(buffer, input);
+	ASSERT_EQ(buffer.size(), example::Position::min_size);
+
+	// entity and flags are big endian, the floats little endian
+	const std::array<std::uint8_t, 8> entity { 1, 2, 3, 4, 5, 6, 7, 8 };
+	ASSERT_TRUE(std::equal(entity.begin(), entity.end(), buffer.begin()));
+	ASSERT_EQ(buffer[24], 0xab);
+	ASSERT_EQ(buffer[25], 0xcd);
+
+	float x = 0.0f;
+	std::memcpy(&x, buffer.data() + 8, sizeof(x));
+	ASSERT_EQ(hexi::endian::little_to_native(x), input.x);
+
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	example::Position output;
+	example::decode(stream, output);
+	ASSERT_TRUE(stream);
+	ASSERT_EQ(input, output);
+}
+
+TEST(codegen, chat_matches_hand_written) {
+	const auto input = make_chat();
+	std::vector<char> generated;
+	example::encode_to(generated, input);
+	ASSERT_EQ(generated.size(), example::encoded_size(input));
+
+	std::vector<char> expected;
+	hexi::buffer_adaptor adaptor(expected);
+	hexi::binary_stream stream(adaptor);
+	hand_encode(stream, input);
+	ASSERT_EQ(generated, expected);
+
+	example::ChatMessage output;
+	example::decode(stream, output);
+	ASSERT_TRUE(stream);
+	ASSERT_EQ(input, output);
+}
+
+TEST(codegen, encode_to_appends) {
+	const auto input = make_chat();
+	std::vector<char> buffer { 'a', 'b' };
+	example::encode_to(buffer, input);
+	ASSERT_EQ(buffer.size(), example::encoded_size(input) + 2);
+	ASSERT_GE(buffer.capacity(), buffer.size());
+}
+
+TEST(codegen, truncated) {
+	const auto input = make_login();
+	std::vector<char> buffer;
+	example::encode_to(buffer, input);
+
+	// every possible truncation must fail cleanly
+	for(std::size_t size = 0; size < buffer.size(); ++size) {
+		std::vector<char> truncated(buffer.begin(), buffer.begin() + size);
+		hexi::buffer_adaptor adaptor(truncated);
+		hexi::binary_stream stream(adaptor, hexi::no_throw);
+		example::LoginRequest output;
+		example::decode(stream, output);
+		ASSERT_FALSE(stream) << "size " << size;
+		ASSERT_EQ(stream.state(), hexi::stream_state::buff_limit_err);
+	}
+
+	std::vector<char> truncated(buffer.begin(), buffer.end() - 1);
+	hexi::buffer_adaptor adaptor(truncated);
+	hexi::binary_stream stream(adaptor);
+	example::LoginRequest output;
+	ASSERT_THROW(example::decode(stream, output), hexi::buffer_underrun);
+}
+
+TEST(codegen, corrupt_count) {
+	const example::LoginRequest input;
+	std::vector<std::uint8_t> buffer;
+	example::encode_to(buffer, input);
+
+	// replace the empty addons count with a huge varint
+	const std::size_t count_offset = buffer.size() - 2;
+	ASSERT_EQ(buffer[count_offset], 0);
+	buffer.erase(buffer.begin() + count_offset);
+	const std::array<std::uint8_t, 9> huge { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3f };
+	buffer.insert(buffer.begin() + count_offset, huge.begin(), huge.end());
+
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor, hexi::no_throw);
+	example::LoginRequest output;
+	example::decode(stream, output);
+	ASSERT_FALSE(stream);
+	ASSERT_TRUE(output.addons.empty());
+}
+
+/*
+ * Benchmarks comparing the generated codecs against the hand-written
+ * equivalent. Disabled by default, run with --gtest_also_run_disabled_tests
+ * and --gtest_filter=codegen.DISABLED_benchmark_*
+ */
+namespace {
+
+constexpr std::size_t iterations = 1'000'000;
+
+template<typename Func>
+void report(const char* name, Func&& func) {
+	const auto start = std::chrono::steady_clock::now();
+
+	for(std::size_t i = 0; i < iterations; ++i) {
+		func();
+	}
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	const auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+	std::cout << name << ": " << ns / iterations << " ns/op\n";
+}
+
+} // namespace
+
+TEST(codegen, DISABLED_benchmark_encode) {
+	const auto input = make_chat();
+	std::vector<char> buffer;
+	buffer.reserve(example::encoded_size(input));
+
+	report("generated encode", [&] {
+		buffer.clear();
+		hexi::buffer_adaptor adaptor(buffer);
+		hexi::binary_stream stream(adaptor);
+		example::encode(stream, input);
+	});
+
+	report("hand-written encode", [&] {
+		buffer.clear();
+		hexi::buffer_adaptor adaptor(buffer);
+		hexi::binary_stream stream(adaptor);
+		hand_encode(stream, input);
+	});
+}
+
+TEST(codegen, DISABLED_benchmark_decode) {
+	const auto input = make_chat();
+	std::vector<char> buffer;
+	example::encode_to(buffer, input);
+
+	example::ChatMessage output, hand;
+
+	report("generated decode", [&] {
+		hexi::buffer_adaptor adaptor(buffer);
+		hexi::binary_stream stream(adaptor);
+		example::decode(stream, output);
+	});
+
+	report("hand-written decode", [&] {
+		hexi::buffer_adaptor adaptor(buffer);
+		hexi::binary_stream stream(adaptor);
+		hand_decode(stream, hand);
+	});
+
+	ASSERT_EQ(output, input);
+	ASSERT_EQ(hand, input);
+}
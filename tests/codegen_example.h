@@ -0,0 +1,435 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+// Generated by tools/codegen/codegen.py, do not edit by hand.
+
+#pragma once
+
+#include <hexi/binary_stream.h>
+#include <hexi/buffer_adaptor.h>
+#include <hexi/endian.h>
+#include <array>
+#include <bit>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace example {
+
+namespace detail {
+
+inline std::size_t varint_size(std::uint64_t value) {
+	std::size_t size = 1;
+
+	while(value > 0x7f) {
+		value >>= 7;
+		++size;
+	}
+
+	return size;
+}
+
+// stages the encoding so that it can be written with a single call
+template<typename stream_type>
+void put_varint(stream_type& stream, std::uint64_t value) {
+	std::array<std::uint8_t, 10> encoded;
+	std::size_t size = 0;
+
+	while(value > 0x7f) {
+		encoded[size++] = static_cast<std::uint8_t>(value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+
+	encoded[size++] = static_cast<std::uint8_t>(value);
+	stream.put(encoded.data(), size);
+}
+
+// raises the stream's usual error if fewer than count elements remain,
+// without the multiplication being able to overflow on a corrupt count
+template<typename stream_type>
+bool ensure(stream_type& stream, const std::size_t count, const std::size_t size = 1) {
+	if(count > stream.size() / size) [[unlikely]] {
+		stream.skip(stream.size() + 1);
+		return false;
+	}
+
+	return static_cast<bool>(stream);
+}
+
+} // detail
+
+struct LoginRequest {
+	std::uint16_t opcode{};
+	std::uint32_t build{};
+	std::uint8_t flags{};
+	std::uint64_t session{};
+	std::string username;
+	std::array<std::uint8_t, 20> checksum{};
+	std::string locale;
+	std::vector<std::uint32_t> addons;
+	bool remember{};
+
+	// smallest possible encoding, as checked before decoding
+	static constexpr std::size_t min_size = 32;
+
+	bool operator==(const LoginRequest&) const = default;
+};
+
+// the exact number of bytes that encode() will write
+inline std::size_t encoded_size(const LoginRequest& msg) {
+	return 29
+		+ detail::varint_size(msg.session)
+		+ msg.username.size()
+		+ msg.locale.size() + 1
+		+ detail::varint_size(msg.addons.size())
+		+ msg.addons.size() * sizeof(std::uint32_t);
+}
+
+template<typename stream_type>
+void encode(stream_type& stream, const LoginRequest& msg) {
+	// opcode, build, flags
+	{
+		std::array<char, 7> segment;
+		const std::uint16_t opcode_value = hexi::endian::native_to_little(msg.opcode);
+		std::memcpy(segment.data(), &opcode_value, 2);
+		const std::uint32_t build_value = hexi::endian::native_to_little(msg.build);
+		std::memcpy(segment.data() + 2, &build_value, 4);
+		const std::uint8_t flags_value = msg.flags;
+		std::memcpy(segment.data() + 6, &flags_value, 1);
+		stream.put(segment.data(), segment.size());
+	}
+
+	detail::put_varint(stream, msg.session);
+
+	// username size
+	{
+		std::array<char, 1> segment;
+		assert(msg.username.size() <= UINT8_MAX);
+		const std::uint8_t username_size = static_cast<std::uint8_t>(msg.username.size());
+		std::memcpy(segment.data(), &username_size, 1);
+		stream.put(segment.data(), segment.size());
+	}
+
+	stream.put(msg.username.data(), msg.username.size());
+
+	// checksum
+	{
+		std::array<char, 20> segment;
+		std::memcpy(segment.data(), msg.checksum.data(), 20);
+		stream.put(segment.data(), segment.size());
+	}
+
+	assert(msg.locale.find('\0') == std::string::npos);
+	stream.put(msg.locale.c_str(), msg.locale.size() + 1);
+
+	detail::put_varint(stream, msg.addons.size());
+
+	if(!msg.addons.empty()) {
+		if constexpr(std::endian::native == std::endian::little) {
+			stream.put(msg.addons.data(), msg.addons.size());
+		} else {
+			for(const auto value : msg.addons) {
+				const auto converted = hexi::endian::native_to_little(value);
+				stream.put(&converted, 1);
+			}
+		}
+	}
+
+	// remember
+	{
+		std::array<char, 1> segment;
+		const bool remember_value = msg.remember;
+		std::memcpy(segment.data(), &remember_value, 1);
+		stream.put(segment.data(), segment.size());
+	}
+}
+
+template<typename stream_type>
+void decode(stream_type& stream, LoginRequest& msg) {
+	if(!detail::ensure(stream, LoginRequest::min_size)) {
+		return;
+	}
+
+	std::array<char, 7> opcode_segment;
+	stream.get(opcode_segment.data(), 7);
+
+	if(!stream) {
+		return;
+	}
+
+	std::memcpy(&msg.opcode, opcode_segment.data(), 2);
+	msg.opcode = hexi::endian::little_to_native(msg.opcode);
+	std::memcpy(&msg.build, opcode_segment.data() + 2, 4);
+	msg.build = hexi::endian::little_to_native(msg.build);
+	std::memcpy(&msg.flags, opcode_segment.data() + 6, 1);
+
+	msg.session = hexi::impl::varint_decode<std::uint64_t>(stream);
+
+	if(!stream) {
+		return;
+	}
+
+	std::array<char, 1> username_prefix;
+	stream.get(username_prefix.data(), 1);
+
+	if(!stream) {
+		return;
+	}
+
+	std::uint8_t username_size;
+	std::memcpy(&username_size, username_prefix.data(), 1);
+
+	stream.get(msg.username, username_size);
+
+	std::array<char, 20> checksum_segment;
+	stream.get(checksum_segment.data(), 20);
+
+	if(!stream) {
+		return;
+	}
+
+	std::memcpy(msg.checksum.data(), checksum_segment.data(), 20);
+
+	stream >> hexi::null_terminated(msg.locale);
+
+	const auto addons_size = hexi::impl::varint_decode<std::size_t>(stream);
+
+	if(!stream) {
+		return;
+	}
+
+	if(!detail::ensure(stream, addons_size, sizeof(std::uint32_t))) {
+		return;
+	}
+
+	msg.addons.resize(addons_size);
+
+	if(!msg.addons.empty()) {
+		stream.get(msg.addons.data(), msg.addons.size());
+
+		if constexpr(std::endian::native != std::endian::little) {
+			for(auto& value : msg.addons) {
+				value = hexi::endian::little_to_native(value);
+			}
+		}
+	}
+
+	std::array<char, 1> remember_segment;
+	stream.get(remember_segment.data(), 1);
+
+	if(!stream) {
+		return;
+	}
+
+	msg.remember = remember_segment[0] != 0;
+}
+
+// appends the message to a contiguous container, reserving the exact space up front
+template<typename container_type>
+void encode_to(container_type& container, const LoginRequest& msg) {
+	container.reserve(container.size() + encoded_size(msg));
+	hexi::buffer_adaptor adaptor(container);
+	hexi::binary_stream stream(adaptor);
+	encode(stream, msg);
+}
+
+struct Position {
+	std::uint64_t entity{};
+	float x{};
+	float y{};
+	float z{};
+	float orientation{};
+	std::uint16_t flags{};
+
+	// smallest possible encoding, as checked before decoding
+	static constexpr std::size_t min_size = 26;
+
+	bool operator==(const Position&) const = default;
+};
+
+// the exact number of bytes that encode() will write
+inline std::size_t encoded_size(const Position& /*msg*/) {
+	return 26;
+}
+
+template<typename stream_type>
+void encode(stream_type& stream, const Position& msg) {
+	// entity, x, y, z, orientation, flags
+	{
+		std::array<char, 26> segment;
+		const std::uint64_t entity_value = hexi::endian::native_to_big(msg.entity);
+		std::memcpy(segment.data(), &entity_value, 8);
+		const float x_value = hexi::endian::native_to_little(msg.x);
+		std::memcpy(segment.data() + 8, &x_value, 4);
+		const float y_value = hexi::endian::native_to_little(msg.y);
+		std::memcpy(segment.data() + 12, &y_value, 4);
+		const float z_value = hexi::endian::native_to_little(msg.z);
+		std::memcpy(segment.data() + 16, &z_value, 4);
+		const float orientation_value = hexi::endian::native_to_little(msg.orientation);
+		std::memcpy(segment.data() + 20, &orientation_value, 4);
+		const std::uint16_t flags_value = hexi::endian::native_to_big(msg.flags);
+		std::memcpy(segment.data() + 24, &flags_value, 2);
+		stream.put(segment.data(), segment.size());
+	}
+}
+
+template<typename stream_type>
+void decode(stream_type& stream, Position& msg) {
+	if(!detail::ensure(stream, Position::min_size)) {
+		return;
+	}
+
+	std::array<char, 26> entity_segment;
+	stream.get(entity_segment.data(), 26);
+
+	if(!stream) {
+		return;
+	}
+
+	std::memcpy(&msg.entity, entity_segment.data(), 8);
+	msg.entity = hexi::endian::big_to_native(msg.entity);
+	std::memcpy(&msg.x, entity_segment.data() + 8, 4);
+	msg.x = hexi::endian::little_to_native(msg.x);
+	std::memcpy(&msg.y, entity_segment.data() + 12, 4);
+	msg.y = hexi::endian::little_to_native(msg.y);
+	std::memcpy(&msg.z, entity_segment.data() + 16, 4);
+	msg.z = hexi::endian::little_to_native(msg.z);
+	std::memcpy(&msg.orientation, entity_segment.data() + 20, 4);
+	msg.orientation = hexi::endian::little_to_native(msg.orientation);
+	std::memcpy(&msg.flags, entity_segment.data() + 24, 2);
+	msg.flags = hexi::endian::big_to_native(msg.flags);
+}
+
+// appends the message to a contiguous container, reserving the exact space up front
+template<typename container_type>
+void encode_to(container_type& container, const Position& msg) {
+	container.reserve(container.size() + encoded_size(msg));
+	hexi::buffer_adaptor adaptor(container);
+	hexi::binary_stream stream(adaptor);
+	encode(stream, msg);
+}
+
+struct ChatMessage {
+	std::uint32_t channel{};
+	std::int16_t language{};
+	std::string text;
+	std::vector<std::uint64_t> recipients;
+
+	// smallest possible encoding, as checked before decoding
+	static constexpr std::size_t min_size = 10;
+
+	bool operator==(const ChatMessage&) const = default;
+};
+
+// the exact number of bytes that encode() will write
+inline std::size_t encoded_size(const ChatMessage& msg) {
+	return 10
+		+ msg.text.size()
+		+ msg.recipients.size() * sizeof(std::uint64_t);
+}
+
+template<typename stream_type>
+void encode(stream_type& stream, const ChatMessage& msg) {
+	// channel, language, text size
+	{
+		std::array<char, 8> segment;
+		const std::uint32_t channel_value = hexi::endian::native_to_big(msg.channel);
+		std::memcpy(segment.data(), &channel_value, 4);
+		const std::int16_t language_value = hexi::endian::native_to_little(msg.language);
+		std::memcpy(segment.data() + 4, &language_value, 2);
+		assert(msg.text.size() <= UINT16_MAX);
+		const std::uint16_t text_size = hexi::endian::native_to_big(static_cast<std::uint16_t>(msg.text.size()));
+		std::memcpy(segment.data() + 6, &text_size, 2);
+		stream.put(segment.data(), segment.size());
+	}
+
+	stream.put(msg.text.data(), msg.text.size());
+
+	// recipients size
+	{
+		std::array<char, 2> segment;
+		assert(msg.recipients.size() <= UINT16_MAX);
+		const std::uint16_t recipients_size = hexi::endian::native_to_big(static_cast<std::uint16_t>(msg.recipients.size()));
+		std::memcpy(segment.data(), &recipients_size, 2);
+		stream.put(segment.data(), segment.size());
+	}
+
+	if(!msg.recipients.empty()) {
+		if constexpr(std::endian::native == std::endian::big) {
+			stream.put(msg.recipients.data(), msg.recipients.size());
+		} else {
+			for(const auto value : msg.recipients) {
+				const auto converted = hexi::endian::native_to_big(value);
+				stream.put(&converted, 1);
+			}
+		}
+	}
+}
+
+template<typename stream_type>
+void decode(stream_type& stream, ChatMessage& msg) {
+	if(!detail::ensure(stream, ChatMessage::min_size)) {
+		return;
+	}
+
+	std::array<char, 8> channel_segment;
+	stream.get(channel_segment.data(), 8);
+
+	if(!stream) {
+		return;
+	}
+
+	std::memcpy(&msg.channel, channel_segment.data(), 4);
+	msg.channel = hexi::endian::big_to_native(msg.channel);
+	std::memcpy(&msg.language, channel_segment.data() + 4, 2);
+	msg.language = hexi::endian::little_to_native(msg.language);
+	std::uint16_t text_size;
+	std::memcpy(&text_size, channel_segment.data() + 6, 2);
+	text_size = hexi::endian::big_to_native(text_size);
+
+	stream.get(msg.text, text_size);
+
+	std::array<char, 2> recipients_prefix;
+	stream.get(recipients_prefix.data(), 2);
+
+	if(!stream) {
+		return;
+	}
+
+	std::uint16_t recipients_size;
+	std::memcpy(&recipients_size, recipients_prefix.data(), 2);
+	recipients_size = hexi::endian::big_to_native(recipients_size);
+
+	if(!detail::ensure(stream, recipients_size, sizeof(std::uint64_t))) {
+		return;
+	}
+
+	msg.recipients.resize(recipients_size);
+
+	if(!msg.recipients.empty()) {
+		stream.get(msg.recipients.data(), msg.recipients.size());
+
+		if constexpr(std::endian::native != std::endian::big) {
+			for(auto& value : msg.recipients) {
+				value = hexi::endian::big_to_native(value);
+			}
+		}
+	}
+}
+
+// appends the message to a contiguous container, reserving the exact space up front
+template<typename container_type>
+void encode_to(container_type& container, const ChatMessage& msg) {
+	container.reserve(container.size() + encoded_size(msg));
+	hexi::buffer_adaptor adaptor(container);
+	hexi::binary_stream stream(adaptor);
+	encode(stream, msg);
+}
+
+} // example
@@ -0,0 +1,284 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/compression.h>
+#include <hexi/binary_stream.h>
+#include <hexi/buffer_adaptor.h>
+#include <hexi/dynamic_buffer.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace {
+
+std::vector<std::uint8_t> repetitive_bytes(std::mt19937& rng, const std::size_t size) {
+	const std::string_view words[] {
+		"sword ", "shield ", "potion ", "of healing ", "+1 ", "cursed ", "scroll ", "\x01\x02\x03\x04"
+	};
+
+	std::vector<std::uint8_t> bytes;
+
+	while(bytes.size() < size) {
+		const auto word = words[rng() % std::size(words)];
+		bytes.insert(bytes.end(), word.begin(), word.end());
+	}
+
+	bytes.resize(size);
+	return bytes;
+}
+
+template<typename codec_type>
+std::vector<std::uint8_t> codec_round_trip(const codec_type& codec, const std::vector<std::uint8_t>& input) {
+	std::vector<std::uint8_t> compressed(codec.bound(input.size()));
+	const auto size = codec.compress(input.data(), input.size(), compressed.data(), compressed.size());
+	EXPECT_NE(size, 0);
+
+	std::vector<std::uint8_t> output(input.size());
+	EXPECT_TRUE(codec.decompress(compressed.data(), size, output.data(), output.size()));
+	return output;
+}
+
+} // namespace
+
+TEST(compression, fast_lz_round_trip) {
+	std::mt19937 rng(0x5eed);
+	hexi::compression::fast_lz codec;
+
+	for(const std::size_t size : { 1, 5, 12, 13, 16, 100, 1000, 65536, 200000 }) {
+		const auto text = repetitive_bytes(rng, size);
+		ASSERT_EQ(codec_round_trip(codec, text), text) << size;
+
+		std::vector<std::uint8_t> random(size);
+
+		for(auto& byte : random) {
+			byte = static_cast<std::uint8_t>(rng());
+		}
+
+		ASSERT_EQ(codec_round_trip(codec, random), random) << size;
+
+		// long runs need overlapping matches and extended lengths
+		const std::vector<std::uint8_t> zeroes(size);
+		ASSERT_EQ(codec_round_trip(codec, zeroes), zeroes) << size;
+	}
+}
+
+TEST(compression, fast_lz_ratio) {
+	hexi::compression::fast_lz codec;
+	const std::vector<std::uint8_t> zeroes(16384);
+	std::vector<std::uint8_t> compressed(codec.bound(zeroes.size()));
+	const auto size = codec.compress(zeroes.data(), zeroes.size(), compressed.data(), compressed.size());
+	ASSERT_LT(size, 100);
+
+	// capacity below the bound is refused rather than overrun
+	ASSERT_EQ(codec.compress(zeroes.data(), zeroes.size(), compressed.data(), 100), 0);
+}
+
+TEST(compression, fast_lz_corrupt) {
+	std::mt19937 rng(0x5eed);
+	hexi::compression::fast_lz codec;
+	const auto input = repetitive_bytes(rng, 4096);
+	std::vector<std::uint8_t> compressed(codec.bound(input.size()));
+	compressed.resize(codec.compress(input.data(), input.size(), compressed.data(), compressed.size()));
+	std::vector<std::uint8_t> output(input.size());
+
+	// must never read or write out of bounds, whatever the input
+	for(int i = 0; i < 2000; ++i) {
+		auto corrupt = compressed;
+
+		for(int j = 0; j < 4; ++j) {
+			corrupt[rng() % corrupt.size()] = static_cast<std::uint8_t>(rng());
+		}
+
+		corrupt.resize(corrupt.size() - rng() % 2 * (rng() % corrupt.size()));
+		codec.decompress(corrupt.data(), corrupt.size(), output.data(), output.size());
+	}
+
+	ASSERT_FALSE(codec.decompress(compressed.data(), compressed.size() - 1, output.data(), output.size()));
+	ASSERT_FALSE(codec.decompress(compressed.data(), compressed.size(), output.data(), output.size() - 1));
+	ASSERT_TRUE(codec.decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+	ASSERT_EQ(output, input);
+}
+
+TEST(compression, binary_stream) {
+	hexi::dynamic_buffer<128> buffer;
+
+	{
+		hexi::compressing_buffer<decltype(buffer), hexi::compression::fast_lz, 256> compressor(buffer);
+		hexi::binary_stream stream(compressor);
+
+		for(std::uint32_t i = 0; i < 500; ++i) {
+			stream << i << std::string("inventory slot") << hexi::endian::be(std::uint16_t(i));
+		}
+
+		compressor.flush();
+		ASSERT_TRUE(stream);
+		ASSERT_EQ(compressor.total_out(), buffer.size());
+		ASSERT_LT(compressor.total_out(), compressor.total_in() / 2);
+	}
+
+	hexi::decompressing_buffer<decltype(buffer), hexi::compression::fast_lz, 256> decompressor(buffer);
+	hexi::binary_stream stream(decompressor);
+
+	for(std::uint32_t i = 0; i < 500; ++i) {
+		std::uint32_t value = 0;
+		std::string string;
+		std::uint16_t be_value = 0;
+		stream >> value >> string >> hexi::endian::be(be_value);
+		ASSERT_EQ(value, i);
+		ASSERT_EQ(string, "inventory slot");
+		ASSERT_EQ(be_value, i);
+	}
+
+	ASSERT_TRUE(stream);
+	ASSERT_TRUE(stream.empty());
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(compression, large_writes) {
+	std::mt19937 rng(0x5eed);
+	const auto input = repetitive_bytes(rng, 100000);
+	std::vector<std::uint8_t> random(5000);
+
+	for(auto& byte : random) {
+		byte = static_cast<std::uint8_t>(rng());
+	}
+
+	std::vector<std::uint8_t> compressed;
+	hexi::buffer_adaptor adaptor(compressed);
+	hexi::compressing_buffer<decltype(adaptor), hexi::compression::fast_lz, 4096> compressor(adaptor);
+	compressor.write(input.data(), 10);
+	compressor.write(input.data() + 10, input.size() - 10);
+	compressor.write(random.data(), random.size());
+	compressor.flush();
+	ASSERT_TRUE(compressor.empty());
+	ASSERT_EQ(compressor.total_in(), input.size() + random.size());
+	ASSERT_LT(compressed.size(), input.size() / 2 + random.size() + 64);
+
+	hexi::decompressing_buffer<decltype(adaptor), hexi::compression::fast_lz, 4096> decompressor(adaptor);
+	ASSERT_EQ(decompressor.size(), input.size() + random.size());
+
+	std::vector<std::uint8_t> output(input.size());
+	decompressor.skip(5);
+	decompressor.read(output.data() + 5, output.size() - 5);
+	ASSERT_TRUE(std::equal(output.begin() + 5, output.end(), input.begin() + 5));
+
+	std::vector<std::uint8_t> random_output(random.size());
+	decompressor.read(random_output.data(), random_output.size());
+	ASSERT_EQ(random_output, random);
+	ASSERT_TRUE(decompressor.empty());
+	ASSERT_EQ(decompressor.total_read(), compressed.size());
+}
+
+TEST(compression, partial_arrival) {
+	std::mt19937 rng(0x5eed);
+	const auto input = repetitive_bytes(rng, 3000);
+
+	std::vector<std::uint8_t> compressed;
+	hexi::buffer_adaptor adaptor(compressed);
+	hexi::compressing_buffer<decltype(adaptor), hexi::compression::fast_lz, 1024> compressor(adaptor);
+	compressor.write(input.data(), input.size());
+	compressor.flush();
+
+	// feed the compressed data through a few bytes at a time
+	hexi::dynamic_buffer<32> received;
+	hexi::decompressing_buffer<decltype(received), hexi::compression::fast_lz, 1024> decompressor(received);
+	std::vector<std::uint8_t> output;
+
+	for(std::size_t i = 0; i < compressed.size(); i += 7) {
+		received.write(compressed.data() + i, std::min<std::size_t>(7, compressed.size() - i));
+
+		// only complete blocks are counted
+		const auto size = decompressor.size();
+		ASSERT_TRUE(size == 0 || size == 1024 || size == input.size() % 1024) << size;
+
+		const auto offset = output.size();
+		output.resize(offset + size);
+		decompressor.read(output.data() + offset, size);
+	}
+
+	ASSERT_EQ(output, input);
+}
+
+TEST(compression, corrupt) {
+	std::vector<std::uint8_t> input(1000, 0xaa);
+	std::vector<std::uint8_t> compressed;
+	hexi::buffer_adaptor adaptor(compressed);
+	hexi::compressing_buffer compressor(adaptor);
+	compressor.write(input.data(), input.size());
+	compressor.flush();
+
+	// damaged header, which is left to the stream's error policy
+	auto bad_header = compressed;
+	bad_header[3] = 0xff;
+	hexi::buffer_adaptor header_adaptor(bad_header);
+	hexi::decompressing_buffer header_decompressor(header_adaptor);
+	hexi::binary_stream header_stream(header_decompressor, hexi::no_throw);
+	std::uint32_t value = 0;
+	header_stream >> value;
+	ASSERT_TRUE(header_decompressor.error());
+	ASSERT_EQ(header_decompressor.size(), 0);
+	ASSERT_EQ(header_stream.state(), hexi::stream_state::buff_limit_err);
+
+	hexi::buffer_adaptor throw_adaptor(bad_header);
+	hexi::decompressing_buffer throw_decompressor(throw_adaptor);
+	hexi::binary_stream throw_stream(throw_decompressor);
+	ASSERT_THROW(throw_stream >> value, hexi::buffer_underrun);
+
+	// damaged block, which isn't found until it's read
+	auto bad_block = compressed;
+	std::fill(bad_block.begin() + 8, bad_block.end(), 0);
+	hexi::buffer_adaptor block_adaptor(bad_block);
+	hexi::decompressing_buffer block_decompressor(block_adaptor);
+	hexi::binary_stream block_stream(block_decompressor, hexi::no_throw);
+	ASSERT_EQ(block_decompressor.size(), input.size());
+
+	std::vector<std::uint8_t> output(input.size(), 0xff);
+	block_stream.get(output.data(), output.size() / 2);
+	ASSERT_FALSE(block_decompressor);
+	ASSERT_EQ(block_decompressor.size(), 0);
+	ASSERT_TRUE(std::all_of(output.begin(), output.begin() + output.size() / 2,
+	                        [](auto byte) { return byte == 0; }));
+
+	block_stream.get(output.data(), output.size() / 2);
+	ASSERT_EQ(block_stream.state(), hexi::stream_state::buff_limit_err);
+}
+
+#ifdef HEXI_WITH_ZLIB
+TEST(compression, zlib) {
+	std::mt19937 rng(0x5eed);
+	const auto input = repetitive_bytes(rng, 50000);
+
+	hexi::dynamic_buffer<256> buffer;
+	hexi::compressing_buffer<decltype(buffer), hexi::compression::zlib> compressor(buffer, { .level = 9 });
+	compressor.write(input.data(), input.size());
+	compressor.flush();
+
+	hexi::decompressing_buffer<decltype(buffer), hexi::compression::zlib> decompressor(buffer);
+	std::vector<std::uint8_t> output(decompressor.size());
+	decompressor.read(output.data(), output.size());
+	ASSERT_EQ(output, input);
+}
+#endif
+
+#ifdef HEXI_WITH_ZSTD
+TEST(compression, zstd) {
+	std::mt19937 rng(0x5eed);
+	const auto input = repetitive_bytes(rng, 50000);
+
+	hexi::dynamic_buffer<256> buffer;
+	hexi::compressing_buffer<decltype(buffer), hexi::compression::zstd> compressor(buffer);
+	compressor.write(input.data(), input.size());
+	compressor.flush();
+
+	hexi::decompressing_buffer<decltype(buffer), hexi::compression::zstd> decompressor(buffer);
+	std::vector<std::uint8_t> output(decompressor.size());
+	decompressor.read(output.data(), output.size());
+	ASSERT_EQ(output, input);
+}
+#endif
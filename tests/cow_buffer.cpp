@@ -0,0 +1,126 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/cow_buffer.h>
+#include <hexi/dynamic_buffer.h>
+#include <hexi/static_buffer.h>
+#include <hexi/binary_stream.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+using namespace std::literals;
+
+TEST(cow_buffer, copy_shares) {
+	hexi::dynamic_buffer<32> buffer;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+	buffer.write(str.data(), str.size());
+
+	hexi::cow_buffer cow(std::move(buffer));
+	auto clone = cow;
+	ASSERT_TRUE(cow.shared());
+	ASSERT_TRUE(clone.shared());
+	ASSERT_EQ(&cow.get(), &clone.get());
+	ASSERT_EQ(clone.size(), str.size());
+	ASSERT_EQ(clone.find_first_of(std::byte('q')), 4);
+
+	// non-modifying access does not detach
+	std::string out(str.size(), '\0');
+	clone.copy(out.data(), out.size());
+	ASSERT_EQ(out, str);
+	ASSERT_TRUE(clone.shared());
+}
+
+TEST(cow_buffer, write_detaches) {
+	hexi::cow_buffer<hexi::dynamic_buffer<16>> cow;
+	hexi::binary_stream stream(cow);
+	stream << std::uint32_t(1) << std::uint32_t(2);
+
+	auto clone = cow;
+	hexi::binary_stream clone_stream(clone);
+	clone_stream << std::uint32_t(3);
+	ASSERT_FALSE(cow.shared());
+	ASSERT_FALSE(clone.shared());
+	ASSERT_EQ(cow.size(), 8);
+	ASSERT_EQ(clone.size(), 12);
+
+	std::uint32_t a = 0, b = 0, c = 0;
+	clone_stream >> a >> b >> c;
+	ASSERT_EQ(a, 1);
+	ASSERT_EQ(b, 2);
+	ASSERT_EQ(c, 3);
+	ASSERT_EQ(cow.size(), 8);
+}
+
+TEST(cow_buffer, read_shares) {
+	hexi::cow_buffer<hexi::dynamic_buffer<8>> cow;
+	const auto str = "retransmit me, please"sv;
+	cow.write(str.data(), str.size());
+
+	// each copy reads through its own cursor, crossing block boundaries
+	auto clone = cow;
+	std::string out(10, '\0');
+	clone.read(out.data(), out.size());
+	ASSERT_EQ(out, str.substr(0, 10));
+	ASSERT_TRUE(clone.shared());
+	ASSERT_EQ(&clone.get(), &cow.get());
+	ASSERT_EQ(clone.offset(), 10);
+	ASSERT_EQ(clone.size(), str.size() - 10);
+	ASSERT_EQ(clone[0], std::byte(str[10]));
+	ASSERT_EQ(clone.find_first_of(std::byte('p')), 5);
+	ASSERT_EQ(clone.find_first_of(std::byte('r')), clone.npos);
+
+	clone.skip(3);
+	out.resize(clone.size());
+	clone.copy(out.data(), out.size());
+	ASSERT_EQ(out, str.substr(13));
+	ASSERT_EQ(cow.size(), str.size());
+
+	// writing detaches only the unread bytes
+	clone.write('!');
+	ASSERT_FALSE(clone.shared());
+	ASSERT_EQ(clone.offset(), 0);
+	out.resize(clone.size());
+	clone.read(out.data(), out.size());
+	ASSERT_EQ(out, ", please!");
+	ASSERT_TRUE(clone.empty());
+	ASSERT_EQ(cow.size(), str.size());
+
+	// sole owner reads in place
+	const auto before = &cow.get();
+	cow.skip(4);
+	ASSERT_EQ(&cow.get(), before);
+	ASSERT_EQ(cow.size(), str.size() - 4);
+}
+
+TEST(cow_buffer, clear_shared) {
+	hexi::cow_buffer<hexi::dynamic_buffer<16>> cow;
+	cow.write(std::uint64_t(0));
+	auto clone = cow;
+	clone.clear();
+	ASSERT_TRUE(clone.empty());
+	ASSERT_EQ(cow.size(), sizeof(std::uint64_t));
+	ASSERT_FALSE(cow.shared());
+}
+
+TEST(cow_buffer, read_shares_contiguous) {
+	hexi::static_buffer<char, 16> buffer;
+	const auto str = "hello, world"sv;
+	buffer.write(str.data(), str.size());
+
+	hexi::cow_buffer cow(std::move(buffer));
+	auto clone = cow;
+	clone.skip(7);
+	ASSERT_TRUE(clone.shared());
+	ASSERT_EQ(clone.find_first_of('o'), 1);
+
+	std::string out(clone.size(), '\0');
+	clone.read(out.data(), out.size());
+	ASSERT_EQ(out, "world");
+	ASSERT_TRUE(clone.empty());
+	ASSERT_EQ(cow.size(), str.size());
+}
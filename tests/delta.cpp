@@ -0,0 +1,222 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/delta.h>
+#include <hexi/binary_stream.h>
+#include <hexi/buffer_adaptor.h>
+#include <hexi/dynamic_buffer.h>
+#include <hexi/static_buffer.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+namespace {
+
+std::vector<std::uint8_t> random_bytes(std::mt19937& rng, const std::size_t size) {
+	std::vector<std::uint8_t> bytes(size);
+
+	for(auto& byte : bytes) {
+		byte = static_cast<std::uint8_t>(rng());
+	}
+
+	return bytes;
+}
+
+template<typename base_type, typename current_type>
+std::vector<std::uint8_t> round_trip(const base_type& baseline, const current_type& current,
+                                     std::vector<std::uint8_t>& delta) {
+	hexi::buffer_adaptor delta_adaptor(delta);
+	hexi::binary_stream stream(delta_adaptor);
+	hexi::delta::encode(baseline, current, stream);
+
+	std::vector<std::uint8_t> output;
+	hexi::buffer_adaptor output_adaptor(output);
+	hexi::delta::decode(baseline, stream, output_adaptor);
+	EXPECT_TRUE(stream);
+	EXPECT_TRUE(stream.empty());
+	return output;
+}
+
+} // namespace
+
+TEST(delta, identical) {
+	std::mt19937 rng(0x5eed);
+	const auto snapshot = random_bytes(rng, 1000);
+	hexi::static_buffer<std::uint8_t, 1000> baseline;
+	baseline.write(snapshot.data(), snapshot.size());
+
+	std::vector<std::uint8_t> current = snapshot;
+	hexi::buffer_adaptor adaptor(current);
+
+	std::vector<std::uint8_t> delta;
+	ASSERT_EQ(round_trip(baseline, adaptor, delta), snapshot);
+
+	// varint size followed by the terminating run
+	ASSERT_EQ(delta.size(), 4);
+	ASSERT_EQ(baseline.size(), snapshot.size());
+	ASSERT_EQ(adaptor.size(), snapshot.size());
+}
+
+TEST(delta, run_layout) {
+	std::vector<std::uint8_t> baseline(32), current(32);
+	hexi::buffer_adaptor base_adaptor(baseline), current_adaptor(current);
+
+	// short gaps are merged into a run, longer ones split it
+	current[4] = 0x01;
+	current[6] = 0x02;
+	current[20] = 0x03;
+
+	std::vector<std::uint8_t> delta;
+	ASSERT_EQ(round_trip(base_adaptor, current_adaptor, delta), current);
+
+	const std::vector<std::uint8_t> expected {
+		32,
+		4, 3, 0x01, 0x00, 0x02,
+		13, 1, 0x03,
+		0, 0
+	};
+
+	ASSERT_EQ(delta, expected);
+}
+
+TEST(delta, sparse_changes) {
+	std::mt19937 rng(0x5eed);
+	const auto previous = random_bytes(rng, 5000);
+	auto next = previous;
+
+	for(int i = 0; i < 50; ++i) {
+		const auto offset = rng() % (next.size() - 8);
+		const auto length = rng() % 8 + 1;
+
+		for(std::size_t j = 0; j < length; ++j) {
+			next[offset + j] = static_cast<std::uint8_t>(rng());
+		}
+	}
+
+	// different block sizes, so runs cross block boundaries at different points
+	hexi::dynamic_buffer<64> baseline;
+	baseline.write(previous.data(), previous.size());
+	hexi::dynamic_buffer<100> current;
+	current.write(next.data(), next.size());
+
+	std::vector<std::uint8_t> delta;
+	ASSERT_EQ(round_trip(baseline, current, delta), next);
+	ASSERT_LT(delta.size(), 800);
+
+	// and a mix of buffer types
+	hexi::static_buffer<std::uint8_t, 5000> static_baseline;
+	static_baseline.write(previous.data(), previous.size());
+
+	std::vector<std::uint8_t> mixed_delta;
+	ASSERT_EQ(round_trip(static_baseline, current, mixed_delta), next);
+	ASSERT_EQ(mixed_delta, delta);
+}
+
+TEST(delta, large_run) {
+	std::mt19937 rng(0x5eed);
+	std::vector<std::uint8_t> previous(5000);
+	auto next = previous;
+
+	// longer than the encoder's staging area, with a short gap part way through
+	for(std::size_t i = 100; i < 3500; ++i) {
+		next[i] = static_cast<std::uint8_t>(rng() | 1);
+	}
+
+	next[1500] = 0;
+	next[1501] = 0;
+
+	hexi::buffer_adaptor base_adaptor(previous), current_adaptor(next);
+	std::vector<std::uint8_t> delta;
+	ASSERT_EQ(round_trip(base_adaptor, current_adaptor, delta), next);
+	ASSERT_LT(delta.size(), 3500);
+}
+
+TEST(delta, resize) {
+	std::mt19937 rng(0x5eed);
+	const auto previous = random_bytes(rng, 300);
+
+	hexi::dynamic_buffer<64> baseline;
+	baseline.write(previous.data(), previous.size());
+
+	// grown, the baseline is extended with zeroes
+	auto grown = previous;
+	grown.resize(400);
+	grown[350] = 0xaa;
+	hexi::buffer_adaptor grown_adaptor(grown);
+
+	std::vector<std::uint8_t> delta;
+	ASSERT_EQ(round_trip(baseline, grown_adaptor, delta), grown);
+	ASSERT_LT(delta.size(), 10);
+
+	// shrunk
+	auto shrunk = previous;
+	shrunk.resize(100);
+	shrunk[0] ^= 0xff;
+	hexi::buffer_adaptor shrunk_adaptor(shrunk);
+
+	delta.clear();
+	ASSERT_EQ(round_trip(baseline, shrunk_adaptor, delta), shrunk);
+
+	// empty
+	std::vector<std::uint8_t> empty;
+	hexi::buffer_adaptor empty_adaptor(empty);
+	delta.clear();
+	ASSERT_TRUE(round_trip(baseline, empty_adaptor, delta).empty());
+}
+
+TEST(delta, truncated) {
+	std::vector<std::uint8_t> baseline(64), current(64, 0xff);
+	hexi::buffer_adaptor base_adaptor(baseline), current_adaptor(current);
+
+	std::vector<std::uint8_t> delta;
+	hexi::buffer_adaptor delta_adaptor(delta);
+	hexi::binary_stream stream(delta_adaptor);
+	hexi::delta::encode(base_adaptor, current_adaptor, stream);
+	delta.resize(delta.size() - 10);
+
+	std::vector<std::uint8_t> output;
+	hexi::buffer_adaptor output_adaptor(output);
+	hexi::buffer_adaptor nothrow_adaptor(delta);
+	hexi::binary_stream nothrow_stream(nothrow_adaptor, hexi::no_throw);
+	hexi::delta::decode(base_adaptor, nothrow_stream, output_adaptor);
+	ASSERT_EQ(nothrow_stream.state(), hexi::stream_state::buff_limit_err);
+
+	hexi::buffer_adaptor throw_adaptor(delta);
+	hexi::binary_stream throw_stream(throw_adaptor);
+	ASSERT_THROW(hexi::delta::decode(base_adaptor, throw_stream, output_adaptor), hexi::buffer_underrun);
+}
+
+TEST(delta, malformed) {
+	std::vector<std::uint8_t> baseline(16);
+	hexi::buffer_adaptor base_adaptor(baseline);
+
+	// runs that overflow the stated size
+	std::vector<std::uint8_t> overflow { 16, 10, 7, 1, 2, 3, 4, 5, 6, 7, 0, 0 };
+	hexi::buffer_adaptor overflow_adaptor(overflow);
+	hexi::binary_stream overflow_stream(overflow_adaptor, hexi::no_throw);
+	std::vector<std::uint8_t> output;
+	hexi::buffer_adaptor output_adaptor(output);
+	hexi::delta::decode(base_adaptor, overflow_stream, output_adaptor);
+	ASSERT_EQ(overflow_stream.state(), hexi::stream_state::user_defined_err);
+
+	// stated size over the limit, so no output is produced
+	std::vector<std::uint8_t> oversized { 0xff, 0xff, 0xff, 0xff, 0x0f, 0, 0 };
+	hexi::buffer_adaptor oversized_adaptor(oversized);
+	hexi::binary_stream oversized_stream(oversized_adaptor, hexi::no_throw);
+	output.clear();
+	hexi::delta::decode(base_adaptor, oversized_stream, output_adaptor, 1024);
+	ASSERT_EQ(oversized_stream.state(), hexi::stream_state::user_defined_err);
+	ASSERT_TRUE(output.empty());
+
+	// overlong varint
+	std::vector<std::uint8_t> overlong(20, 0xff);
+	overlong.push_back(0);
+	hexi::buffer_adaptor overlong_adaptor(overlong);
+	hexi::binary_stream overlong_stream(overlong_adaptor, hexi::no_throw);
+	hexi::delta::decode(base_adaptor, overlong_stream, output_adaptor, 1024);
+	ASSERT_EQ(overlong_stream.state(), hexi::stream_state::user_defined_err);
+}
@@ -0,0 +1,142 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#define HEXI_DEBUG_ALLOCATORS
+#include <hexi/allocators/depot_allocator.h>
+#include <hexi/dynamic_buffer.h>
+
+using namespace std::literals;
+
+namespace {
+
+template<int tag>
+struct test_block {
+	std::array<std::uint8_t, 32> data;
+};
+
+} // namespace
+
+TEST(depot_allocator, reuse) {
+	hexi::depot_allocator<test_block<0>, 4> alloc;
+	const auto& depot = alloc.depot();
+
+	auto first = alloc.allocate();
+	alloc.deallocate(first);
+	auto second = alloc.allocate();
+	ASSERT_EQ(first, second);
+	ASSERT_EQ(depot.system_allocs, 1);
+	alloc.deallocate(second);
+	ASSERT_EQ(alloc.active_allocs, 0);
+}
+
+TEST(depot_allocator, magazine_exchange) {
+	using allocator = hexi::depot_allocator<test_block<1>, 4>;
+	allocator alloc;
+	std::array<test_block<1>*, 12> blocks{};
+
+	alloc.allocate_n(blocks.size(), blocks.begin());
+	ASSERT_EQ(alloc.depot().system_allocs, blocks.size());
+
+	// two magazines' worth stay cached, the rest goes to the depot
+	alloc.deallocate_list(blocks.begin(), blocks.end());
+	ASSERT_EQ(allocator::depot_size(), 1);
+	ASSERT_EQ(alloc.depot().system_deallocs, 0);
+
+	alloc.allocate_n(blocks.size(), blocks.begin());
+	ASSERT_EQ(allocator::depot_size(), 0);
+	ASSERT_EQ(alloc.depot().system_allocs, blocks.size());
+	alloc.deallocate_list(blocks.begin(), blocks.end());
+}
+
+TEST(depot_allocator, thread_exit_handoff) {
+	using allocator = hexi::depot_allocator<test_block<2>, 8>;
+	allocator alloc; // only used by one thread at a time
+	std::array<test_block<2>*, 24> blocks{};
+
+	std::thread producer([&] {
+		alloc.allocate_n(blocks.size(), blocks.begin());
+
+		for(auto block : blocks) {
+			block->data.fill(0x5a);
+		}
+
+		// half are released on this thread and cached, half outlive it
+		alloc.deallocate_list(blocks.begin(), blocks.begin() + 12);
+	});
+
+	producer.join();
+
+	// the exiting thread's cached blocks were handed over to the depot
+	ASSERT_GE(allocator::depot_size(), 1);
+	const auto system_allocs = allocator::depot().system_allocs.load();
+
+	for(auto it = blocks.begin() + 12; it != blocks.end(); ++it) {
+		ASSERT_EQ((*it)->data[0], 0x5a);
+		alloc.deallocate(*it);
+	}
+
+	// blocks can be reused by another thread without going to the system
+	std::thread consumer([&] {
+		allocator alloc;
+		std::array<test_block<2>*, 8> blocks{};
+		alloc.allocate_n(blocks.size(), blocks.begin());
+		ASSERT_EQ(allocator::depot().system_allocs, system_allocs);
+		alloc.deallocate_list(blocks.begin(), blocks.end());
+	});
+
+	consumer.join();
+}
+
+TEST(depot_allocator, concurrent) {
+	using allocator = hexi::depot_allocator<test_block<3>, 16>;
+	std::vector<std::thread> threads;
+
+	for(int t = 0; t < 4; ++t) {
+		threads.emplace_back([t] {
+			allocator alloc;
+			std::vector<test_block<3>*> blocks;
+
+			for(int i = 0; i < 2000; ++i) {
+				if(blocks.size() < 64 && (i % 3 != 0 || blocks.empty())) {
+					auto block = alloc.allocate();
+					block->data.fill(static_cast<std::uint8_t>(t));
+					blocks.emplace_back(block);
+				} else {
+					auto block = blocks.back();
+					blocks.pop_back();
+					ASSERT_EQ(block->data[31], t);
+					alloc.deallocate(block);
+				}
+			}
+
+			alloc.deallocate_list(blocks.begin(), blocks.end());
+		});
+	}
+
+	for(auto& thread : threads) {
+		thread.join();
+	}
+}
+
+TEST(depot_allocator, dynamic_buffer) {
+	using storage = hexi::dynamic_buffer<16>::storage_type;
+	hexi::dynamic_buffer<16, std::byte, hexi::depot_allocator<storage>> buffer;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+	buffer.write(str.data(), str.size());
+
+	std::string out(str.size(), '\0');
+	buffer.read(out.data(), out.size());
+	ASSERT_EQ(out, str);
+}
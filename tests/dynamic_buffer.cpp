@@ -7,9 +7,13 @@
 #define HEXI_BUFFER_DEBUG
 #include <hexi/dynamic_buffer.h>
 #include <hexi/buffer_sequence.h>
+#include <hexi/allocators/pmr_allocator.h>
+#include <hexi/allocators/ref_allocator.h>
 #undef HEXI_BUFFER_DEBUG
 #include <gtest/gtest.h>
 #include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -18,6 +22,68 @@
 
 using namespace std::literals;
 
+namespace {
+
+template<typename T>
+struct counting_allocator {
+	static inline std::size_t allocs = 0;
+	static inline std::size_t deallocs = 0;
+
+	T* allocate() {
+		++allocs;
+		return new T();
+	}
+
+	void deallocate(T* t) {
+		++deallocs;
+		delete t;
+	}
+};
+
+template<typename T>
+struct bulk_counting_allocator {
+	static inline std::size_t allocs = 0;
+	static inline std::size_t bulk_allocs = 0;
+	static inline std::size_t bulk_deallocs = 0;
+	static inline std::size_t active = 0;
+
+	T* allocate() {
+		++allocs;
+		++active;
+		return new T();
+	}
+
+	void deallocate(T* t) {
+		--active;
+		delete t;
+	}
+
+	template<typename OutputIt>
+	OutputIt allocate_n(std::size_t count, OutputIt out) {
+		++bulk_allocs;
+		active += count;
+
+		for(std::size_t i = 0; i < count; ++i) {
+			*out++ = new T();
+		}
+
+		return out;
+	}
+
+	template<typename InputIt>
+	void deallocate_list(InputIt first, InputIt last) {
+		++bulk_deallocs;
+
+		for(; first != last; ++first) {
+			--active;
+			delete *first;
+		}
+	}
+};
+
+} // unnamed
+
+
 TEST(dynamic_buffer, size) {
 	hexi::dynamic_buffer<32> chain;
 	ASSERT_EQ(0, chain.size()) << "Chain size is incorrect";
@@ -58,6 +124,22 @@ TEST(dynamic_buffer, read_write_consistency) {
 	ASSERT_EQ(0, chain.size()) << "Chain should be empty";
 }
 
+TEST(dynamic_buffer, zero_length) {
+	hexi::dynamic_buffer<32> chain;
+	const char text[] = "abc";
+	chain.write(text, 0);
+	ASSERT_TRUE(chain.empty());
+	ASSERT_LE(chain.block_count(), 1);
+
+	hexi::dynamic_buffer<32> reserved;
+	reserved.reserve(0);
+	ASSERT_TRUE(reserved.empty());
+	ASSERT_LE(reserved.block_count(), 1);
+
+	chain.write(text, sizeof(text));
+	ASSERT_EQ(chain.size(), sizeof(text));
+}
+
 TEST(dynamic_buffer, reserve_fetch_consistency) {
 	hexi::dynamic_buffer<32> chain;
 	char text[] = "The quick brown fox jumps over the lazy dog";
@@ -377,4 +459,541 @@ TEST(dynamic_buffer, find_first_of) {
 	ASSERT_EQ(pos, 0);
 	pos = buffer.find_first_of(std::byte('t'));
 	ASSERT_EQ(pos, 32);
-}
\ No newline at end of file
+}
+TEST(dynamic_buffer, inline_block_no_alloc) {
+	using storage = hexi::dynamic_buffer<64>::storage_type;
+	using allocator = counting_allocator<storage>;
+	hexi::dynamic_buffer<64, std::byte, allocator, hexi::inline_block> buffer;
+	const auto allocs = allocator::allocs;
+
+	const auto str = "The quick brown fox jumped over the lazy dog"sv;
+	buffer.write(str.data(), str.size());
+	ASSERT_EQ(buffer.size(), str.size());
+	ASSERT_EQ(buffer.block_count(), 1);
+	ASSERT_EQ(allocator::allocs, allocs);
+
+	std::string out(str.size(), '\0');
+	buffer.read(out.data(), out.size());
+	ASSERT_EQ(out, str);
+	ASSERT_TRUE(buffer.empty());
+
+	// repeated small messages should keep reusing the inline block
+	for(int i = 0; i < 100; ++i) {
+		buffer.write(&i, sizeof(i));
+		int value = 0;
+		buffer.read(&value, sizeof(value));
+		ASSERT_EQ(value, i);
+	}
+
+	ASSERT_EQ(allocator::allocs, allocs);
+}
+
+TEST(dynamic_buffer, inline_block_overflow) {
+	using storage = hexi::dynamic_buffer<16>::storage_type;
+	using allocator = counting_allocator<storage>;
+	const auto allocs = allocator::allocs;
+	const auto deallocs = allocator::deallocs;
+
+	{
+		hexi::dynamic_buffer<16, std::byte, allocator, hexi::inline_block> buffer;
+		const auto str = "The quick brown fox jumped over the lazy dog"sv;
+		buffer.write(str.data(), str.size());
+		ASSERT_EQ(buffer.block_count(), 3);
+		ASSERT_EQ(allocator::allocs, allocs + 2);
+
+		// draining the inline block should make it available for reuse
+		buffer.skip(20);
+		buffer.write(str.data(), str.size());
+		ASSERT_EQ(allocator::allocs, allocs + 4);
+		ASSERT_EQ(buffer.size(), str.size() * 2 - 20);
+
+		std::string out(buffer.size(), '\0');
+		buffer.read(out.data(), out.size());
+		ASSERT_EQ(std::string(str.substr(20)) + std::string(str), out);
+	}
+
+	ASSERT_EQ(allocator::deallocs - deallocs, allocator::allocs - allocs);
+}
+
+TEST(dynamic_buffer, inline_block_move) {
+	hexi::dynamic_buffer<8, std::byte, hexi::default_allocator<
+		hexi::dynamic_buffer<8>::storage_type>, hexi::inline_block> chain, chain2;
+	const auto str = "The quick brown fox jumped over the lazy dog"sv;
+	chain.write(str.data(), str.size());
+	chain2 = std::move(chain);
+	ASSERT_TRUE(chain.empty());
+	ASSERT_EQ(chain2.size(), str.size());
+
+	auto chain3(std::move(chain2));
+	ASSERT_TRUE(chain2.empty());
+	ASSERT_EQ(chain3.size(), str.size());
+
+	// moved-from buffers should still be usable
+	chain.write(str.data(), 4);
+	ASSERT_EQ(chain.size(), 4);
+
+	std::string out(str.size(), '\0');
+	chain3.read(out.data(), out.size());
+	ASSERT_EQ(out, str);
+}
+
+TEST(dynamic_buffer, inline_block_copy) {
+	hexi::dynamic_buffer<8, std::byte, hexi::default_allocator<
+		hexi::dynamic_buffer<8>::storage_type>, hexi::inline_block> chain;
+	const auto str = "The quick brown fox jumped over the lazy dog"sv;
+	chain.write(str.data(), str.size());
+	auto chain2 = chain;
+	ASSERT_EQ(chain2.size(), str.size());
+	ASSERT_EQ(chain2.block_count(), chain.block_count());
+
+	for(std::size_t i = 0; i < str.size(); ++i) {
+		ASSERT_EQ(chain2[i], std::byte(str[i]));
+	}
+}
+
+namespace {
+
+template<decltype(auto) block_sz>
+using slist_buffer = hexi::dynamic_buffer<block_sz, std::byte,
+	hexi::default_allocator<hexi::impl::intrusive_slist_storage<block_sz>>>;
+
+} // unnamed
+
+TEST(dynamic_buffer, slist_read_write_consistency) {
+	slist_buffer<8> chain;
+	static_assert(std::is_same_v<decltype(chain)::node_type, hexi::impl::intrusive_slist_node>);
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+
+	for(int i = 0; i < 10; ++i) {
+		chain.write(str.data(), str.size());
+		chain.write(&i, sizeof(i));
+
+		std::string out(str.size(), '\0');
+		int value = -1;
+		chain.read(out.data(), out.size());
+		chain.read(&value, sizeof(value));
+		ASSERT_EQ(out, str);
+		ASSERT_EQ(value, i);
+		ASSERT_TRUE(chain.empty());
+	}
+
+	chain.write(str.data(), str.size());
+	ASSERT_EQ(chain.block_count(), 6);
+	ASSERT_EQ(chain.find_first_of(std::byte('z')), str.find_first_of('z'));
+	chain.pop_front();
+	ASSERT_EQ(chain.block_count(), 5);
+}
+
+TEST(dynamic_buffer, slist_write_seek) {
+	slist_buffer<1> chain;
+	const std::array<std::uint8_t, 6> data {0x00, 0x01, 0x00, 0x00, 0x04, 0x05};
+	const std::array<std::uint8_t, 2> seek_data {0x02, 0x03};
+	chain.write(data.data(), data.size());
+	chain.write_seek(hexi::buffer_seek::sk_backward, 4);
+	chain.write(seek_data.data(), seek_data.size());
+	ASSERT_EQ(chain.size(), 4);
+	chain.write_seek(hexi::buffer_seek::sk_forward, 2);
+	ASSERT_EQ(chain.size(), data.size());
+
+	const std::array<std::uint8_t, 2> new_data {0x06, 0x07};
+	chain.write(new_data.data(), new_data.size());
+
+	const std::array<std::uint8_t, 8> expected {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+	std::array<std::uint8_t, 8> out{};
+	ASSERT_EQ(chain.size(), out.size());
+	chain.read(out.data(), out.size());
+	ASSERT_EQ(out, expected);
+}
+
+TEST(dynamic_buffer, write_seek_absolute) {
+	hexi::dynamic_buffer<4> chain;
+	slist_buffer<4> slist_chain;
+	const std::array<std::uint8_t, 10> data {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+	const std::uint8_t patch = 0xff;
+
+	auto check = [&](auto& buffer) {
+		buffer.write(data.data(), data.size());
+		buffer.write_seek(hexi::buffer_seek::sk_absolute, 5);
+		ASSERT_EQ(buffer.size(), 5);
+		buffer.write(&patch, sizeof(patch));
+		buffer.write_seek(hexi::buffer_seek::sk_absolute, 10);
+		ASSERT_EQ(buffer.size(), 10);
+
+		std::array<std::uint8_t, 10> out{};
+		buffer.read(out.data(), out.size());
+		ASSERT_EQ(out[4], 4);
+		ASSERT_EQ(out[5], patch);
+		ASSERT_EQ(out[6], 6);
+		ASSERT_EQ(out[9], 9);
+	};
+
+	check(chain);
+	check(slist_chain);
+}
+
+TEST(dynamic_buffer, slist_move_copy) {
+	slist_buffer<8> chain;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+	chain.write(str.data(), str.size());
+
+	auto copy = chain;
+	auto moved = std::move(chain);
+	ASSERT_TRUE(chain.empty());
+	ASSERT_EQ(moved.size(), str.size());
+	ASSERT_EQ(copy.size(), str.size());
+
+	// appending after a move must link onto the moved list, not the old one
+	moved.write(str.data(), str.size());
+	copy.write(str.data(), str.size());
+
+	std::string out(str.size() * 2, '\0'), out2(str.size() * 2, '\0');
+	moved.read(out.data(), out.size());
+	copy.read(out2.data(), out2.size());
+	ASSERT_EQ(out, std::string(str) + std::string(str));
+	ASSERT_EQ(out, out2);
+}
+
+TEST(dynamic_buffer, slist_inline_block_move) {
+	hexi::dynamic_buffer<8, std::byte,
+		hexi::default_allocator<hexi::impl::intrusive_slist_storage<8>>,
+		hexi::inline_block> chain;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+	chain.write(str.data(), str.size());
+	chain.skip(10); // inline block gets recycled to the back of the list
+	chain.write(str.data(), 6);
+
+	auto moved = std::move(chain);
+	ASSERT_EQ(moved.size(), str.size() - 4);
+	moved.write(str.data(), str.size());
+
+	std::string out(moved.size(), '\0');
+	moved.read(out.data(), out.size());
+	ASSERT_EQ(out, std::string(str.substr(10)) + std::string(str.substr(0, 6)) + std::string(str));
+}
+
+TEST(dynamic_buffer, bulk_allocation) {
+	using storage = hexi::impl::intrusive_storage<16>;
+	using allocator = bulk_counting_allocator<storage>;
+	std::vector<std::uint8_t> data(16 * 100);
+	std::iota(data.begin(), data.end(), 0);
+
+	{
+		hexi::dynamic_buffer<16, std::byte, allocator> buffer;
+		buffer.write(data.data(), data.size());
+		ASSERT_EQ(buffer.block_count(), 100);
+		ASSERT_EQ(allocator::active, 100);
+		ASSERT_EQ(allocator::allocs, 1);
+		ASSERT_EQ(allocator::bulk_allocs, 4); // batches of 32
+
+		buffer.reserve(16 * 3);
+		ASSERT_EQ(buffer.block_count(), 103);
+		ASSERT_EQ(allocator::allocs, 2);
+		ASSERT_EQ(allocator::bulk_allocs, 5);
+
+		std::vector<std::uint8_t> out(data.size());
+		buffer.read(out.data(), out.size());
+		ASSERT_EQ(out, data);
+
+		buffer.clear();
+		ASSERT_EQ(allocator::active, 0);
+		ASSERT_EQ(allocator::bulk_deallocs, 1);
+	}
+
+	ASSERT_EQ(allocator::active, 0);
+}
+
+TEST(dynamic_buffer, headroom_prepend) {
+	auto check = [](auto& chain) {
+		const auto body = "The quick brown fox jumps over the lazy dog"sv;
+		const auto header = "HDR:"sv;
+		chain.write(body.data(), body.size());
+		ASSERT_EQ(chain.headroom(), 8);
+		const auto blocks = chain.block_count();
+
+		// fits within the headroom, so no new block is needed
+		chain.prepend(header.data(), header.size());
+		ASSERT_EQ(chain.block_count(), blocks);
+		ASSERT_EQ(chain.headroom(), 4);
+		ASSERT_EQ(chain.size(), header.size() + body.size());
+		ASSERT_EQ(chain[0], std::byte('H'));
+		ASSERT_EQ(chain[header.size()], std::byte('T'));
+
+		// exceeds the remaining headroom, so blocks are linked ahead of the head
+		const auto outer = "[outer header]"sv;
+		chain.prepend(outer.data(), outer.size());
+		ASSERT_EQ(chain.block_count(), blocks + 1);
+		ASSERT_EQ(chain.size(), outer.size() + header.size() + body.size());
+		ASSERT_EQ(chain[outer.size() + header.size()], std::byte('T'));
+
+		std::string out(chain.size(), '\0');
+		chain.read(out.data(), out.size());
+		ASSERT_EQ(out, std::string(outer) + std::string(header) + std::string(body));
+
+		// headroom is restored once the buffer has been drained
+		ASSERT_EQ(chain.headroom(), 8);
+		chain.write(body.data(), 4);
+		chain.prepend(header.data(), header.size());
+		out.resize(8);
+		chain.read(out.data(), out.size());
+		ASSERT_EQ(out, "HDR:The ");
+	};
+
+	hexi::dynamic_buffer<16> chain(8);
+	slist_buffer<16> slist_chain(8);
+	check(chain);
+	check(slist_chain);
+}
+
+TEST(dynamic_buffer, prepend_no_headroom) {
+	hexi::dynamic_buffer<4> chain;
+	const auto body = "body"sv;
+	const auto header = "a longer header "sv;
+	chain.prepend(body.data(), body.size());
+	chain.prepend(header.data(), header.size());
+	ASSERT_EQ(chain.block_count(), 5);
+
+	std::string out(chain.size(), '\0');
+	chain.copy(out.data(), out.size());
+	ASSERT_EQ(out, std::string(header) + std::string(body));
+
+	auto copy = chain;
+	ASSERT_EQ(copy.size(), chain.size());
+	copy.read(out.data(), out.size());
+	ASSERT_EQ(out, std::string(header) + std::string(body));
+}
+
+TEST(dynamic_buffer, copy_used_range) {
+	auto check = [](auto& chain) {
+		const auto str = "The quick brown fox jumps over the lazy dog"sv;
+		chain.write(str.data(), str.size());
+		chain.skip(6);
+		chain.write_seek(hexi::buffer_seek::sk_backward, 10);
+
+		auto copy = chain;
+		ASSERT_EQ(copy.size(), chain.size());
+		ASSERT_EQ(copy.block_count(), chain.block_count());
+
+		// writes must continue from the copied write cursor
+		copy.write(str.data(), 3);
+		chain.write(str.data(), 3);
+
+		std::string out(chain.size(), '\0'), out2(copy.size(), '\0');
+		chain.read(out.data(), out.size());
+		copy.read(out2.data(), out2.size());
+		ASSERT_EQ(out, out2);
+		ASSERT_EQ(out, std::string(str.substr(6, str.size() - 16)) + "The");
+	};
+
+	hexi::dynamic_buffer<256> chain;
+	hexi::dynamic_buffer<8> small_chain;
+	slist_buffer<8> slist_chain;
+	check(chain);
+	check(small_chain);
+	check(slist_chain);
+}
+
+TEST(dynamic_buffer, spare_blocks) {
+	using allocator = counting_allocator<hexi::dynamic_buffer<8>::storage_type>;
+	allocator::allocs = 0;
+	allocator::deallocs = 0;
+
+	{
+		hexi::dynamic_buffer<8, std::byte, allocator,
+			hexi::no_inline_block, hexi::spare_blocks<2>> chain;
+		std::array<std::uint8_t, 12> data{};
+		std::iota(data.begin(), data.end(), 0);
+
+		// each message straddles a block boundary
+		for(int i = 0; i < 10; ++i) {
+			chain.write(data.data(), data.size());
+			std::array<std::uint8_t, 12> out{};
+			chain.read(out.data(), out.size());
+			ASSERT_EQ(out, data);
+		}
+
+		// the drained tail block stays linked, so only one is spare
+		ASSERT_EQ(allocator::allocs, 2);
+		ASSERT_EQ(allocator::deallocs, 0);
+		ASSERT_EQ(chain.spare_count(), 1);
+
+		// spares are capped, the remainder goes back to the allocator
+		std::array<std::uint8_t, 40> large{};
+		chain.write(large.data(), large.size());
+		chain.clear();
+		ASSERT_EQ(chain.spare_count(), 2);
+		ASSERT_EQ(allocator::allocs - allocator::deallocs, 2);
+
+		chain.shrink_to_fit();
+		ASSERT_EQ(chain.spare_count(), 0);
+		ASSERT_EQ(allocator::allocs, allocator::deallocs);
+
+		chain.write(data.data(), data.size());
+	}
+
+	ASSERT_EQ(allocator::allocs, allocator::deallocs);
+}
+
+TEST(dynamic_buffer, spare_blocks_bulk) {
+	using storage = hexi::impl::intrusive_storage<16>;
+	using allocator = bulk_counting_allocator<storage>;
+	const auto allocs = allocator::allocs;
+	const auto bulk_allocs = allocator::bulk_allocs;
+
+	{
+		hexi::dynamic_buffer<16, std::byte, allocator,
+			hexi::no_inline_block, hexi::spare_blocks<4>> chain;
+		std::vector<std::uint8_t> data(16 * 4);
+		chain.write(data.data(), data.size());
+		chain.clear();
+		ASSERT_EQ(chain.spare_count(), 4);
+		ASSERT_EQ(allocator::active, 4);
+
+		// satisfied entirely from the spares
+		chain.write(data.data(), data.size());
+		ASSERT_EQ(chain.spare_count(), 0);
+		ASSERT_EQ(allocator::allocs, allocs + 1);
+		ASSERT_EQ(allocator::bulk_allocs, bulk_allocs + 1);
+	}
+
+	ASSERT_EQ(allocator::active, 0);
+}
+
+namespace {
+
+template<typename T>
+struct pool_allocator {
+	std::size_t active = 0;
+	std::size_t allocs = 0;
+
+	T* allocate() {
+		++active;
+		++allocs;
+		return new T();
+	}
+
+	void deallocate(T* t) {
+		--active;
+		delete t;
+	}
+};
+
+} // namespace
+
+TEST(dynamic_buffer, pmr_allocator) {
+	using storage = hexi::dynamic_buffer<8>::storage_type;
+	using buffer_type = hexi::dynamic_buffer<8, std::byte, hexi::pmr_allocator<storage>>;
+	std::pmr::unsynchronized_pool_resource resource;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+
+	buffer_type buffer { hexi::pmr_allocator<storage>(&resource) };
+	buffer.write(str.data(), str.size());
+	ASSERT_EQ(buffer.get_allocator().resource(), &resource);
+
+	// sharing a resource allows the blocks to be relinked
+	buffer_type other { hexi::pmr_allocator<storage>(&resource) };
+	other.splice(buffer);
+	ASSERT_TRUE(buffer.empty());
+
+	std::string out(str.size(), '\0');
+	other.read(out.data(), out.size());
+	ASSERT_EQ(out, str);
+}
+
+TEST(dynamic_buffer, stateful_allocator) {
+	using storage = hexi::dynamic_buffer<8>::storage_type;
+	using pool = pool_allocator<storage>;
+	using buffer_type = hexi::dynamic_buffer<8, std::byte, hexi::ref_allocator<pool>>;
+	pool first, second;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+
+	{
+		buffer_type buffer { hexi::ref_allocator(first) };
+		buffer.write(str.data(), str.size());
+		ASSERT_EQ(first.active, 6);
+		ASSERT_EQ(second.active, 0);
+
+		// moving between buffers sharing a pool hands the blocks over
+		buffer_type moved(std::move(buffer));
+		ASSERT_EQ(first.allocs, 6);
+		ASSERT_EQ(moved.size(), str.size());
+
+		// copies allocate from the same pool as the original
+		buffer_type copy(moved);
+		ASSERT_EQ(first.active, 12);
+
+		// different pools, so the data has to be copied across
+		buffer_type other { hexi::ref_allocator(second) };
+		other = std::move(copy);
+		ASSERT_EQ(first.active, 6);
+		ASSERT_EQ(second.active, 6);
+		ASSERT_TRUE(copy.empty());
+
+		std::string out(str.size(), '\0');
+		other.read(out.data(), out.size());
+		ASSERT_EQ(out, str);
+		ASSERT_EQ(other.get_allocator(), hexi::ref_allocator(second));
+	}
+
+	ASSERT_EQ(first.active, 0);
+	ASSERT_EQ(second.active, 0);
+}
+
+TEST(dynamic_buffer, splice) {
+	auto check = [](auto& chain, auto& other) {
+		const auto str = "The quick brown fox jumps over the lazy dog"sv;
+		chain.write(str.data(), 16); // fills two blocks exactly
+		other.write(str.data() + 16, str.size() - 16);
+		const auto blocks = chain.block_count() + other.block_count();
+
+		chain.splice(other);
+		ASSERT_TRUE(other.empty());
+		ASSERT_EQ(other.block_count(), 0);
+		ASSERT_EQ(chain.block_count(), blocks);
+		ASSERT_EQ(chain.size(), str.size());
+
+		// tail is now partially filled, so this one has to be copied
+		other.write(str.data(), 4);
+		chain.splice(other);
+		ASSERT_TRUE(other.empty());
+		chain.write(str.data() + 4, 5);
+
+		std::string out(chain.size(), '\0');
+		chain.read(out.data(), out.size());
+		ASSERT_EQ(out, std::string(str) + "The quick");
+
+		// splicing into an empty buffer takes the whole chain
+		other.write(str.data(), str.size());
+		other.skip(3);
+		chain.splice(other);
+		ASSERT_EQ(chain.size(), str.size() - 3);
+		out.resize(chain.size());
+		chain.read(out.data(), out.size());
+		ASSERT_EQ(out, str.substr(3));
+	};
+
+	hexi::dynamic_buffer<8> chain, other;
+	slist_buffer<8> slist_chain, slist_other;
+	check(chain, other);
+	check(slist_chain, slist_other);
+}
+
+TEST(dynamic_buffer, blocks) {
+	hexi::dynamic_buffer<8> chain;
+	ASSERT_TRUE(std::ranges::empty(chain.blocks()));
+
+	const std::string_view str { "The quick brown fox" };
+	chain.write(str.data(), str.size());
+	chain.skip(2);
+
+	std::string out;
+	std::size_t blocks = 0;
+
+	for(const auto block : chain.blocks()) {
+		out.append(reinterpret_cast<const char*>(block.data()), block.size());
+		++blocks;
+	}
+
+	ASSERT_EQ(out, str.substr(2));
+	ASSERT_EQ(blocks, chain.block_count());
+	ASSERT_EQ(chain.size(), str.size() - 2);
+}
@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include <array>
 #include <string_view>
+#include <cstdint>
 
 
 TEST(intrusive_storage, size) {
@@ -112,3 +113,33 @@ TEST(intrusive_storage, advance_write) {
 	buffer.read(out.data(), str.size() + 1);
 	ASSERT_STREQ(str.data(), out.data());
 }
+
+TEST(intrusive_storage, compact_offsets) {
+	using small = hexi::impl::intrusive_storage<255>;
+	using medium = hexi::impl::intrusive_storage<256>;
+	using large = hexi::impl::intrusive_storage<65536>;
+	static_assert(std::is_same_v<small::offset_type, std::uint8_t>);
+	static_assert(std::is_same_v<medium::offset_type, std::uint16_t>);
+	static_assert(std::is_same_v<large::offset_type, std::uint32_t>);
+
+	// offsets should be packed in alongside the node rather than adding to the header
+	using block = hexi::impl::intrusive_storage<64>;
+	using slist_block = hexi::impl::intrusive_slist_storage<64>;
+	ASSERT_LE(sizeof(block), sizeof(hexi::impl::intrusive_node) + 64 + alignof(block));
+	ASSERT_LE(sizeof(slist_block), sizeof(hexi::impl::intrusive_slist_node) + 64 + alignof(block));
+	ASSERT_LT(sizeof(slist_block), sizeof(block));
+}
+
+TEST(intrusive_storage, full_block_offsets) {
+	hexi::impl::intrusive_storage<255, char> buffer;
+	std::array<char, 255> in{};
+	in.fill('x');
+	ASSERT_EQ(buffer.write(in.data(), in.size()), in.size());
+	ASSERT_EQ(buffer.size(), in.size());
+	ASSERT_EQ(buffer.free(), 0);
+
+	std::array<char, 255> out{};
+	ASSERT_EQ(buffer.read(out.data(), out.size()), out.size());
+	ASSERT_EQ(in, out);
+	ASSERT_EQ(buffer.size(), 0);
+}
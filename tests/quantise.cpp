@@ -0,0 +1,300 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/quantise.h>
+#include <hexi/binary_stream.h>
+#include <hexi/bit_stream.h>
+#include <hexi/buffer_adaptor.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+namespace {
+
+std::array<float, 3> random_normal(std::mt19937& rng) {
+	std::normal_distribution<float> dist;
+	std::array<float, 3> value { dist(rng), dist(rng), dist(rng) };
+	const auto length = std::sqrt(value[0] * value[0] + value[1] * value[1] + value[2] * value[2]);
+	return { value[0] / length, value[1] / length, value[2] / length };
+}
+
+std::array<float, 4> random_quaternion(std::mt19937& rng) {
+	std::normal_distribution<float> dist;
+	std::array<float, 4> value { dist(rng), dist(rng), dist(rng), dist(rng) };
+	float length = 0.0f;
+
+	for(auto component : value) {
+		length += component * component;
+	}
+
+	length = std::sqrt(length);
+
+	for(auto& component : value) {
+		component /= length;
+	}
+
+	return value;
+}
+
+} // namespace
+
+TEST(quantise, quantised_scalar) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+
+	float input = 12.345f;
+	stream << hexi::quantised<12>(input, -100.0f, 100.0f);
+	ASSERT_EQ(buffer.size(), sizeof(std::uint16_t));
+
+	float output = 0.0f;
+	stream >> hexi::quantised<12>(output, -100.0f, 100.0f);
+	ASSERT_NEAR(input, output, 200.0f / 4095 / 2);
+	ASSERT_TRUE(stream);
+}
+
+TEST(quantise, quantised_clamp) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+
+	std::array<float, 4> input {
+		-1000.0f, 1000.0f, std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()
+	};
+
+	stream << hexi::quantised<8>(input, 0.0f, 1.0f);
+	ASSERT_EQ(buffer.size(), input.size());
+	ASSERT_EQ(buffer[0], 0);
+	ASSERT_EQ(buffer[1], 255);
+	ASSERT_EQ(buffer[2], 0);
+	ASSERT_EQ(buffer[3], 255);
+}
+
+TEST(quantise, quantised_range_byte_order) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor, hexi::endian::big);
+
+	// larger than a single batch
+	std::vector<double> input(300);
+
+	for(std::size_t i = 0; i < input.size(); ++i) {
+		input[i] = double(i) / input.size();
+	}
+
+	stream << hexi::quantised<16>(input, 0.0, 1.0);
+	ASSERT_EQ(buffer.size(), input.size() * sizeof(std::uint16_t));
+
+	// 299/300 quantised to 16 bits, stored big endian
+	const auto last = std::uint16_t((buffer[598] << 8) | buffer[599]);
+	ASSERT_EQ(last, std::uint16_t(299.0 / 300.0 * 65535 + 0.5));
+
+	std::vector<double> output(input.size());
+	stream >> hexi::quantised<16>(output, 0.0, 1.0);
+	ASSERT_TRUE(stream);
+
+	for(std::size_t i = 0; i < input.size(); ++i) {
+		ASSERT_NEAR(input[i], output[i], 1.0 / 65535);
+	}
+}
+
+TEST(quantise, quantised_full_mantissa) {
+	const hexi::codec::quantise<float, 24> float_codec(-1.0f, 1.0f);
+	ASSERT_EQ(float_codec.encode(1.0f), (1u << 24) - 1);
+	ASSERT_EQ(float_codec.decode(float_codec.encode(1.0f)), 1.0f);
+	ASSERT_EQ(float_codec.decode(float_codec.encode(-1.0f)), -1.0f);
+
+	const hexi::codec::quantise<double, 53> double_codec(0.0, 1.0);
+	ASSERT_EQ(double_codec.encode(1.0), (std::uint64_t(1) << 53) - 1);
+	ASSERT_EQ(double_codec.decode(double_codec.encode(1.0)), 1.0);
+
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	std::array<float, 2> input { 1.0f, -1.0f };
+
+	hexi::bit_stream writer(adaptor);
+	writer.put(hexi::quantised<24>(input, -1.0f, 1.0f));
+	writer.flush();
+
+	std::array<float, 2> output {};
+	hexi::bit_stream reader(adaptor);
+	reader.get(hexi::quantised<24>(output, -1.0f, 1.0f));
+	ASSERT_TRUE(reader);
+	ASSERT_EQ(output, input);
+}
+
+TEST(quantise, fixed_point) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+
+	std::array<float, 4> input { 1.5f, -2.25f, 1000.0f, -1000.0f };
+	stream << hexi::fixed_point<8, std::int16_t>(input);
+	ASSERT_EQ(buffer.size(), input.size() * sizeof(std::int16_t));
+
+	std::array<std::int16_t, 4> raw{};
+	stream.get(raw.data(), raw.size());
+	ASSERT_EQ(raw[0], 384);
+	ASSERT_EQ(raw[1], -576);
+	ASSERT_EQ(raw[2], std::numeric_limits<std::int16_t>::max());
+	ASSERT_EQ(raw[3], std::numeric_limits<std::int16_t>::min());
+
+	double value = 3.14159;
+	stream << hexi::fixed_point<16>(value);
+	double output = 0.0;
+	stream >> hexi::fixed_point<16>(output);
+	ASSERT_NEAR(value, output, 1.0 / 65536);
+}
+
+TEST(quantise, half) {
+	const hexi::codec::half<float> codec;
+	ASSERT_EQ(codec.encode(1.0f), 0x3c00);
+	ASSERT_EQ(codec.encode(-2.0f), 0xc000);
+	ASSERT_EQ(codec.encode(65504.0f), 0x7bff);
+	ASSERT_EQ(codec.encode(65520.0f), 0x7c00);
+	ASSERT_EQ(codec.encode(std::ldexp(1.0f, -24)), 0x0001);
+	ASSERT_EQ(codec.encode(std::ldexp(1.0f, -26)), 0x0000);
+	ASSERT_EQ(codec.encode(-std::numeric_limits<float>::infinity()), 0xfc00);
+	ASSERT_TRUE(std::isnan(codec.decode(codec.encode(std::numeric_limits<float>::quiet_NaN()))));
+
+	// ties round to even
+	ASSERT_EQ(codec.encode(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+	ASSERT_EQ(codec.encode(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+
+	// every non-NaN half survives a round trip
+	for(std::uint32_t i = 0; i <= 0xffff; ++i) {
+		const auto value = static_cast<std::uint16_t>(i);
+
+		if((value & 0x7c00) == 0x7c00 && (value & 0x03ff)) {
+			continue;
+		}
+
+		ASSERT_EQ(codec.encode(codec.decode(value)), value) << i;
+	}
+}
+
+TEST(quantise, bfloat16) {
+	const hexi::codec::bfloat16<float> codec;
+	ASSERT_EQ(codec.encode(1.0f), 0x3f80);
+	ASSERT_EQ(codec.encode(-2.0f), 0xc000);
+	ASSERT_EQ(codec.decode(0x4049), std::bit_cast<float>(0x40490000u));
+	ASSERT_EQ(codec.encode(std::bit_cast<float>(0x3f808000u)), 0x3f80);
+	ASSERT_EQ(codec.encode(std::bit_cast<float>(0x3f818000u)), 0x3f82);
+	ASSERT_EQ(codec.encode(std::bit_cast<float>(0x3f808001u)), 0x3f81);
+	ASSERT_TRUE(std::isnan(codec.decode(codec.encode(std::numeric_limits<float>::quiet_NaN()))));
+
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	const float input = 3.140625f;
+	stream << hexi::bfloat16(input) << hexi::half_float(input);
+	ASSERT_EQ(buffer.size(), 4);
+
+	float from_bfloat = 0.0f, from_half = 0.0f;
+	stream >> hexi::bfloat16(from_bfloat) >> hexi::half_float(from_half);
+	ASSERT_EQ(from_bfloat, input);
+	ASSERT_EQ(from_half, input);
+}
+
+TEST(quantise, octahedral) {
+	std::mt19937 rng(0x5eed);
+	std::vector<std::array<float, 3>> input(1000);
+
+	for(auto& normal : input) {
+		normal = random_normal(rng);
+	}
+
+	input[0] = { 0.0f, 0.0f, -1.0f };
+	input[1] = { 1.0f, 0.0f, 0.0f };
+	input[2] = { 0.0f, -1.0f, 0.0f };
+
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	stream << hexi::octahedral<12>(input);
+	ASSERT_EQ(buffer.size(), input.size() * sizeof(std::uint32_t));
+
+	std::vector<std::array<float, 3>> output(input.size());
+	stream >> hexi::octahedral<12>(output);
+	ASSERT_TRUE(stream);
+
+	for(std::size_t i = 0; i < input.size(); ++i) {
+		for(std::size_t j = 0; j < 3; ++j) {
+			ASSERT_NEAR(input[i][j], output[i][j], 0.002f) << i;
+		}
+	}
+}
+
+TEST(quantise, smallest_three) {
+	std::mt19937 rng(0x5eed);
+	std::vector<std::array<float, 4>> input(1000);
+
+	for(auto& quat : input) {
+		quat = random_quaternion(rng);
+	}
+
+	input[0] = { 0.0f, 0.0f, 0.0f, -1.0f };
+
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+	hexi::binary_stream stream(adaptor);
+	stream << hexi::smallest_three<10>(input);
+	ASSERT_EQ(buffer.size(), input.size() * sizeof(std::uint32_t));
+
+	std::vector<std::array<float, 4>> output(input.size());
+	stream >> hexi::smallest_three<10>(output);
+	ASSERT_TRUE(stream);
+
+	for(std::size_t i = 0; i < input.size(); ++i) {
+		float dot = 0.0f;
+
+		for(std::size_t j = 0; j < 4; ++j) {
+			dot += input[i][j] * output[i][j];
+		}
+
+		// q and -q are the same rotation
+		ASSERT_NEAR(std::abs(dot), 1.0f, 1e-5f) << i;
+	}
+}
+
+TEST(quantise, bit_stream) {
+	std::vector<std::uint8_t> buffer;
+	hexi::buffer_adaptor adaptor(buffer);
+
+	std::array<float, 3> position { -50.0f, 0.0f, 75.5f };
+	std::array<float, 3> facing { 0.0f, 1.0f, 0.0f };
+	std::array<double, 2> fixed { -1.5, 2.75 };
+
+	hexi::bit_stream writer(adaptor);
+	writer.put(hexi::quantised<12>(position, -100.0f, 100.0f));
+	writer.put(hexi::octahedral<8>(facing));
+	writer.put(hexi::fixed_point<4, std::int8_t>(fixed));
+
+	// 36 + 16 + 16 bits
+	ASSERT_EQ(writer.total_write(), 68);
+	writer.flush();
+	ASSERT_EQ(buffer.size(), 9);
+
+	std::array<float, 3> position_out{}, facing_out{};
+	std::array<double, 2> fixed_out{};
+	hexi::bit_stream reader(adaptor);
+	reader.get(hexi::quantised<12>(position_out, -100.0f, 100.0f));
+	reader.get(hexi::octahedral<8>(facing_out));
+	reader.get(hexi::fixed_point<4, std::int8_t>(fixed_out));
+	ASSERT_TRUE(reader);
+
+	for(std::size_t i = 0; i < 3; ++i) {
+		ASSERT_NEAR(position[i], position_out[i], 200.0f / 4095);
+		ASSERT_NEAR(facing[i], facing_out[i], 0.01f);
+	}
+
+	ASSERT_EQ(fixed, fixed_out);
+}
@@ -0,0 +1,149 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <gtest/gtest.h>
+#include <hexi/allocators/region_allocator.h>
+#include <hexi/binary_stream.h>
+#include <hexi/dynamic_buffer.h>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std::literals;
+
+TEST(region_allocator, reuse) {
+	hexi::region region(1024);
+	auto first = region.allocate(100);
+	auto second = region.allocate(100);
+	ASSERT_NE(first, second);
+
+	// same size class, so the freed memory is handed straight back
+	region.deallocate(first, 100);
+	auto third = region.allocate(100);
+	ASSERT_EQ(first, third);
+
+	// 120 bytes falls into the next class up, so the block isn't reused
+	region.deallocate(third, 100);
+	third = region.allocate(120);
+	ASSERT_NE(first, third);
+
+	// larger than a chunk, gets its own
+	auto large = region.allocate(4096);
+	ASSERT_NE(large, nullptr);
+	region.deallocate(large, 4096);
+	region.deallocate(second, 100);
+	region.deallocate(third, 120);
+}
+
+TEST(region_allocator, size_classes) {
+	hexi::region region(64 * 1024);
+
+	// four classes per power of two, so this is rounded to 5KB rather than 8KB
+	auto first = static_cast<std::byte*>(region.allocate(4200));
+	auto second = static_cast<std::byte*>(region.allocate(4200));
+	ASSERT_EQ(second - first, 5120);
+
+	// any size within the class can reuse the block
+	region.deallocate(first, 4200);
+	ASSERT_EQ(region.allocate(5000), first);
+
+	// over-aligned requests still get aligned blocks from the same classes
+	auto aligned = region.allocate(80, 64);
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+	region.deallocate(aligned, 80, 64);
+	ASSERT_EQ(region.allocate(128, 64), aligned);
+}
+
+TEST(region_allocator, growth_reuse) {
+	hexi::region region(64 * 1024);
+	std::vector<void*> first_pass;
+
+	// like a growing vector, each allocation frees the previous one
+	for(int pass = 0; pass < 2; ++pass) {
+		void* previous = nullptr;
+		std::size_t previous_size = 0;
+
+		for(std::size_t size = 24; size < 32 * 1024; size = size * 3 / 2) {
+			auto memory = region.allocate(size);
+
+			if(pass == 0) {
+				first_pass.push_back(memory);
+			} else {
+				ASSERT_EQ(memory, first_pass[0]) << size;
+				first_pass.erase(first_pass.begin());
+			}
+
+			if(previous) {
+				region.deallocate(previous, previous_size);
+			}
+
+			previous = memory;
+			previous_size = size;
+		}
+
+		region.deallocate(previous, previous_size);
+	}
+
+	// too large for any class, so it's returned to the system when freed
+	auto large = region.allocate(1024 * 1024);
+	ASSERT_NE(large, nullptr);
+	region.deallocate(large, 1024 * 1024);
+}
+
+TEST(region_allocator, alignment) {
+	hexi::region region(256);
+
+	for(std::size_t align = 1; align <= 64; align *= 2) {
+		auto ptr = region.allocate(3, align);
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % align, 0);
+	}
+}
+
+TEST(region_allocator, dynamic_buffer) {
+	using storage = hexi::dynamic_buffer<8>::storage_type;
+	using buffer_type = hexi::dynamic_buffer<8, std::byte, hexi::region_allocator<storage>>;
+	hexi::region region;
+	const auto str = "The quick brown fox jumps over the lazy dog"sv;
+
+	{
+		buffer_type buffer { hexi::region_allocator<storage>(region) };
+		buffer.write(str.data(), str.size());
+
+		// allocators share the region, so splicing relinks rather than copies
+		buffer_type other { hexi::region_allocator<storage>(region) };
+		other.splice(buffer);
+		ASSERT_TRUE(buffer.empty());
+		ASSERT_EQ(other.size(), str.size());
+
+		std::string out(str.size(), '\0');
+		other.read(out.data(), out.size());
+		ASSERT_EQ(out, str);
+	}
+
+	region.release();
+
+	// the region is usable again after being released
+	buffer_type buffer { hexi::region_allocator<storage>(region) };
+	buffer.write(str.data(), str.size());
+	ASSERT_EQ(buffer.size(), str.size());
+}
+
+TEST(region_allocator, read_container) {
+	hexi::region region;
+	using allocator = hexi::region_std_allocator<std::uint32_t>;
+	const std::vector<std::uint32_t> input { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	hexi::dynamic_buffer<32> buffer;
+	hexi::binary_stream stream(buffer);
+	stream << hexi::prefixed(input);
+
+	std::vector<std::uint32_t, allocator> output { allocator(region) };
+	stream >> hexi::prefixed(output);
+	ASSERT_TRUE(std::ranges::equal(input, output));
+	ASSERT_TRUE(stream);
+}
@@ -0,0 +1,141 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/ring_buffer.h>
+#include <hexi/binary_stream.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std::literals;
+
+namespace {
+
+// large enough to be a multiple of common page sizes
+constexpr std::size_t ring_size = 65536;
+
+} // unnamed
+
+TEST(ring_buffer, initial_empty) {
+	hexi::ring_buffer<ring_size> buffer;
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(buffer.size(), 0);
+	ASSERT_EQ(buffer.free(), ring_size);
+}
+
+TEST(ring_buffer, mirrored_views) {
+	hexi::ring_buffer<ring_size, std::uint8_t> buffer;
+	buffer.write(std::uint32_t(0xdeadbeef));
+	const auto data = buffer.read_ptr();
+
+	// the second view should alias the first
+	std::uint32_t mirrored = 0;
+	std::memcpy(&mirrored, data + ring_size, sizeof(mirrored));
+	ASSERT_EQ(mirrored, 0xdeadbeef);
+}
+
+TEST(ring_buffer, wraparound_contiguous) {
+	hexi::ring_buffer<ring_size, std::uint8_t> buffer;
+	std::vector<std::uint8_t> filler(ring_size - 10);
+	buffer.write(filler.data(), filler.size());
+	buffer.skip(filler.size());
+	ASSERT_TRUE(buffer.empty());
+
+	// cursors are reset once the buffer has been drained, so
+	// leave some data behind to force a wrap
+	buffer.write(filler.data(), filler.size());
+	buffer.skip(filler.size() - 4);
+
+	std::array<std::uint8_t, 32> data{};
+	std::iota(data.begin(), data.end(), 0);
+	buffer.write(data.data(), data.size());
+	ASSERT_EQ(buffer.size(), data.size() + 4);
+
+	buffer.skip(4);
+	std::span<const std::uint8_t> region { buffer.read_ptr(), buffer.size() };
+	ASSERT_TRUE(std::equal(region.begin(), region.end(), data.begin()));
+
+	std::array<std::uint8_t, 32> out{};
+	buffer.read(out.data(), out.size());
+	ASSERT_EQ(data, out);
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(ring_buffer, stream_view_across_wrap) {
+	hexi::ring_buffer<ring_size> buffer;
+	hexi::binary_stream stream(buffer);
+	const auto str = "The quick brown fox jumped over the lazy dog"sv;
+	std::vector<std::byte> filler(ring_size - 20);
+
+	// leave a byte behind so the cursors aren't reset, then write across the wrap
+	buffer.write(filler.data(), filler.size());
+	buffer.skip(filler.size() - 1);
+	stream.put(str);
+	stream << std::uint8_t(0);
+	buffer.skip(1);
+
+	const auto view = stream.view();
+	ASSERT_EQ(view, str);
+	ASSERT_TRUE(buffer.empty());
+
+	stream << std::uint32_t(1) << std::uint32_t(2) << std::uint32_t(3);
+	const auto span = stream.span<std::uint32_t>(3);
+	ASSERT_EQ(span[0], 1);
+	ASSERT_EQ(span[1], 2);
+	ASSERT_EQ(span[2], 3);
+}
+
+TEST(ring_buffer, placeholder_across_wrap) {
+	hexi::ring_buffer<ring_size, std::uint8_t> buffer;
+	hexi::binary_stream stream(buffer);
+	std::vector<std::uint8_t> filler(ring_size - 10);
+	buffer.write(filler.data(), filler.size());
+	buffer.skip(filler.size() - 10);
+
+	// unread data either side of the wrap, so the slot starts after it
+	const std::vector<std::uint8_t> prefix(15, 0xaa);
+	buffer.write(prefix.data(), prefix.size());
+
+	auto slot = stream.placeholder_varint<std::uint64_t>();
+	const auto payload = "compacted"sv;
+	stream.put(payload.data(), payload.size());
+	slot.fill_compact(payload.size());
+	ASSERT_EQ(buffer.size(), 10 + prefix.size() + 1 + payload.size());
+
+	buffer.skip(10);
+	std::vector<std::uint8_t> prefix_out(prefix.size());
+	buffer.read(prefix_out.data(), prefix_out.size());
+	ASSERT_EQ(prefix_out, prefix);
+	ASSERT_EQ(hexi::impl::varint_decode<std::size_t>(stream), payload.size());
+
+	std::string output(payload.size(), '\0');
+	stream.get(output.data(), output.size());
+	ASSERT_EQ(output, payload);
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(ring_buffer, overflow) {
+	hexi::ring_buffer<ring_size> buffer;
+	std::vector<std::byte> data(ring_size);
+	buffer.write(data.data(), data.size());
+	ASSERT_TRUE(buffer.full());
+	ASSERT_THROW(buffer.write(std::uint8_t(0)), hexi::buffer_overflow);
+}
+
+TEST(ring_buffer, move) {
+	hexi::ring_buffer<ring_size> buffer;
+	buffer.write(std::uint64_t(42));
+	auto moved = std::move(buffer);
+	ASSERT_EQ(moved.size(), sizeof(std::uint64_t));
+	std::uint64_t value = 0;
+	moved.read(&value);
+	ASSERT_EQ(value, 42);
+}
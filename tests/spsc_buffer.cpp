@@ -0,0 +1,114 @@
+//  _               _ 
+// | |__   _____  _(_)
+// | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+#include <hexi/spsc_buffer.h>
+#include <hexi/binary_stream.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+using namespace std::literals;
+
+TEST(spsc_buffer, initial_empty) {
+	hexi::spsc_buffer<32> buffer;
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(buffer.size(), 0);
+}
+
+TEST(spsc_buffer, read_write_across_blocks) {
+	hexi::spsc_buffer<16> buffer;
+	std::vector<std::uint8_t> data(100);
+	std::iota(data.begin(), data.end(), 0);
+	buffer.write(data.data(), data.size());
+	ASSERT_EQ(buffer.size(), data.size());
+
+	std::vector<std::uint8_t> out(data.size());
+	buffer.read(out.data(), 40);
+	ASSERT_EQ(buffer.size(), 60);
+	buffer.read(out.data() + 40, 60);
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(data, out);
+}
+
+TEST(spsc_buffer, copy_skip_find) {
+	hexi::spsc_buffer<8, char> buffer;
+	const auto str = "The quick brown fox jumped over the lazy dog"sv;
+	buffer.write(str.data(), str.size());
+
+	std::string out(str.size(), '\0');
+	buffer.copy(out.data(), out.size());
+	ASSERT_EQ(out, str);
+	ASSERT_EQ(buffer.size(), str.size());
+
+	ASSERT_EQ(buffer.find_first_of('j'), str.find('j'));
+	ASSERT_EQ(buffer.find_first_of('!'), buffer.npos);
+
+	buffer.skip(20);
+	ASSERT_EQ(buffer.find_first_of('j'), str.find('j') - 20);
+	ASSERT_EQ(buffer.size(), str.size() - 20);
+}
+
+TEST(spsc_buffer, block_reuse) {
+	hexi::spsc_buffer<16> buffer;
+	std::array<std::uint8_t, 48> data{};
+	std::iota(data.begin(), data.end(), 0);
+	std::array<std::uint8_t, 48> out{};
+
+	for(int i = 0; i < 100; ++i) {
+		buffer.write(data.data(), data.size());
+		buffer.read(out.data(), out.size());
+		ASSERT_EQ(data, out);
+	}
+
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(spsc_buffer, stream_handoff) {
+	hexi::spsc_buffer<64> buffer;
+	constexpr std::uint32_t messages = 100'000;
+
+	std::thread producer([&] {
+		hexi::binary_stream stream(buffer);
+
+		for(std::uint32_t i = 0; i < messages; ++i) {
+			stream << i << std::uint16_t(i & 0xffff);
+		}
+	});
+
+	hexi::binary_stream stream(buffer);
+	std::uint64_t sum = 0;
+	std::uint32_t received = 0;
+
+	while(received < messages) {
+		if(buffer.size() < sizeof(std::uint32_t) + sizeof(std::uint16_t)) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::uint32_t value = 0;
+		std::uint16_t check = 0;
+		stream >> value >> check;
+
+		// a fatal assertion would return before the producer is joined
+		if(value != received || check != (received & 0xffff)) {
+			EXPECT_EQ(value, received);
+			EXPECT_EQ(check, received & 0xffff);
+			break;
+		}
+
+		sum += value;
+		++received;
+	}
+
+	producer.join();
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(sum, std::uint64_t(messages - 1) * messages / 2);
+}
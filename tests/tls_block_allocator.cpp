@@ -117,4 +117,91 @@ TEST(tls_block_allocator, thread_mismatch) {
 
 	// needed to stop further asserts from triggering
 	tlsalloc.deallocate(chunk);
-}
\ No newline at end of file
+}
+
+TEST(tls_block_allocator, numa_node) {
+	hexi::tls_block_allocator<
+		std::uint64_t, 4, hexi::no_ref_counting, hexi::safe_entrant,
+		hexi::natural_alignment, hexi::mapped_slab, hexi::numa_local
+	> tlsalloc;
+
+	// single node machines and non-Linux platforms are still expected to work
+	const auto node = tlsalloc.numa_node();
+	ASSERT_GE(node, -1);
+
+	auto chunk = tlsalloc.allocate();
+	*chunk = 0xdeadbeef;
+	tlsalloc.deallocate(chunk);
+
+	hexi::tls_block_allocator<std::uint64_t, 4> unaware;
+	ASSERT_EQ(unaware.numa_node(), -1);
+}
+
+TEST(tls_block_allocator, numa_remote_free) {
+	using allocator_type = hexi::tls_block_allocator<
+		std::uint64_t, 1, hexi::no_ref_counting, hexi::safe_entrant,
+		hexi::natural_alignment, hexi::inline_slab, hexi::numa_local
+	>;
+
+	allocator_type tlsalloc;
+	auto slab_chunk = tlsalloc.allocate();
+	auto heap_chunk = tlsalloc.allocate(); // slab exhausted
+	auto owner = tlsalloc.allocator();
+	ASSERT_EQ(owner->storage_active_count, 1);
+	ASSERT_EQ(owner->new_active_count, 1);
+
+	std::thread thread([&] {
+		tlsalloc.deallocate(slab_chunk);
+		tlsalloc.deallocate(heap_chunk);
+	});
+
+	thread.join();
+
+	// reclaimed lazily by the owner once its free list is empty
+	ASSERT_EQ(owner->storage_active_count, 1);
+	auto chunk = tlsalloc.allocate();
+	ASSERT_EQ(chunk, slab_chunk);
+	ASSERT_EQ(owner->remote_frees, 2);
+	ASSERT_EQ(owner->storage_active_count, 1);
+	ASSERT_EQ(owner->new_active_count, 0);
+	tlsalloc.deallocate(chunk);
+}
+
+TEST(tls_block_allocator, numa_bulk_remote_free) {
+	using allocator_type = hexi::tls_block_allocator<
+		std::uint64_t, 4, hexi::no_ref_counting, hexi::safe_entrant,
+		hexi::natural_alignment, hexi::inline_slab, hexi::numa_local
+	>;
+
+	allocator_type tlsalloc;
+	std::array<std::uint64_t*, 6> chunks{};
+	auto end = tlsalloc.allocate_n(chunks.size(), chunks.begin());
+	ASSERT_EQ(end, chunks.end());
+
+	auto owner = tlsalloc.allocator();
+	ASSERT_EQ(owner->storage_active_count, 4);
+	ASSERT_EQ(owner->new_active_count, 2);
+
+	for(auto chunk : chunks) {
+		*chunk = 0xdeadbeef;
+	}
+
+	// each block knows its owner, so no lookup is needed to route it back
+	std::thread thread([&] {
+		tlsalloc.deallocate_list(chunks.begin(), chunks.end());
+	});
+
+	thread.join();
+
+	std::array<std::uint64_t*, 4> reused{};
+	tlsalloc.allocate_n(reused.size(), reused.begin());
+	ASSERT_EQ(owner->remote_frees, 6);
+	ASSERT_EQ(owner->storage_active_count, 4);
+	ASSERT_EQ(owner->new_active_count, 0);
+
+	for(auto chunk : reused) {
+		ASSERT_TRUE(owner->owns(chunk));
+	}
+
+	tlsalloc.deallocate_list(reused.begin(), reused.end());
+}
@@ -0,0 +1,516 @@
+#!/usr/bin/env python3
+
+#  _               _ 
+# | |__   _____  _(_)
+# | '_ \ / _ \ \/ / | MIT & Apache 2.0 dual licensed
+# | | | |  __/>  <| | Version 1.3.5
+# |_| |_|\___/_/\_\_| https://github.com/EmberEmu/hexi
+
+# Generates header-only encode/decode functions for binary_stream from a
+# JSON message schema. See README.md for the schema format.
+
+import argparse
+import json
+import sys
+
+SCALARS = {
+	"u8":   ("std::uint8_t",  1),
+	"u16":  ("std::uint16_t", 2),
+	"u32":  ("std::uint32_t", 4),
+	"u64":  ("std::uint64_t", 8),
+	"i8":   ("std::int8_t",   1),
+	"i16":  ("std::int16_t",  2),
+	"i32":  ("std::int32_t",  4),
+	"i64":  ("std::int64_t",  8),
+	"f32":  ("float",         4),
+	"f64":  ("double",        8),
+	"bool": ("bool",          1),
+}
+
+PREFIXES = ("u8", "u16", "u32", "varint", "null")
+ENDIANS = ("little", "big", "native")
+
+BANNER = """//  _               _ 
+// | |__   _____  _(_)
+// | '_ \\ / _ \\ \\/ / | MIT & Apache 2.0 dual licensed
+// | | | |  __/>  <| | Version 1.3.5
+// |_| |_|\\___/_/\\_\\_| https://github.com/EmberEmu/hexi
+"""
+
+class SchemaError(Exception):
+	pass
+
+# One element of a message's wire format. Adjacent fixed-size elements are
+# grouped into segments so that each segment is a single write or read.
+class Element(object):
+	def __init__(self, kind, field, size=0, role="value"):
+		self.kind = kind    # "fixed", "varint", "string", "array" or "cstring"
+		self.field = field
+		self.size = size
+		self.role = role    # "value" or "prefix"
+
+class Field(object):
+	def __init__(self, schema, default_endian):
+		self.name = schema.get("name")
+		self.type = schema.get("type")
+		self.endian = schema.get("endian", default_endian)
+		self.prefix = schema.get("prefix", "u32")
+		self.varint = schema.get("varint", False)
+		self.size = schema.get("size", 0)
+		self.of = schema.get("of")
+
+		if not self.name or not self.name.isidentifier():
+			raise SchemaError("invalid field name: %r" % self.name)
+
+		if self.endian not in ENDIANS:
+			raise SchemaError("%s: unknown endian %r" % (self.name, self.endian))
+
+		if self.type in SCALARS:
+			if self.varint and not self.type.startswith("u"):
+				raise SchemaError("%s: varints must be unsigned" % self.name)
+		elif self.type in ("string", "array"):
+			if self.prefix not in PREFIXES:
+				raise SchemaError("%s: unknown prefix %r" % (self.name, self.prefix))
+			if self.type == "array":
+				if self.of not in SCALARS or self.of == "bool":
+					raise SchemaError("%s: arrays must be of a numeric type" % self.name)
+				if self.prefix == "null":
+					raise SchemaError("%s: arrays can't be null terminated" % self.name)
+		elif self.type == "bytes":
+			if not isinstance(self.size, int) or self.size <= 0:
+				raise SchemaError("%s: bytes requires a positive size" % self.name)
+		else:
+			raise SchemaError("%s: unknown type %r" % (self.name, self.type))
+
+	def cpp_type(self):
+		if self.type in SCALARS:
+			return SCALARS[self.type][0]
+		elif self.type == "string":
+			return "std::string"
+		elif self.type == "array":
+			return "std::vector<%s>" % SCALARS[self.of][0]
+		else:
+			return "std::array<std::uint8_t, %d>" % self.size
+
+	def elements(self):
+		if self.type in SCALARS:
+			if self.varint:
+				return [Element("varint", self)]
+			return [Element("fixed", self, SCALARS[self.type][1])]
+		elif self.type == "bytes":
+			return [Element("fixed", self, self.size)]
+		elif self.prefix == "null":
+			return [Element("cstring", self)]
+		elif self.prefix == "varint":
+			return [Element("varint", self, role="prefix"), Element(self.type, self)]
+		else:
+			size = SCALARS[self.prefix][1]
+			return [Element("fixed", self, size, role="prefix"), Element(self.type, self)]
+
+def segments(elements):
+	result = []
+
+	for element in elements:
+		if element.kind == "fixed" and result and isinstance(result[-1], list):
+			result[-1].append(element)
+		elif element.kind == "fixed":
+			result.append([element])
+		else:
+			result.append(element)
+
+	return result
+
+def conversion(endian, direction):
+	if endian == "native":
+		return None
+	return "hexi::endian::%s" % (("native_to_" + endian) if direction == "in" else (endian + "_to_native"))
+
+def value_type(element):
+	field = element.field
+
+	if element.role == "prefix":
+		return SCALARS[field.prefix][0] if field.prefix != "varint" else "std::uint64_t"
+	return SCALARS[field.type][0]
+
+def value_expr(element):
+	field = element.field
+
+	if element.role == "prefix":
+		return "static_cast<%s>(msg.%s.size())" % (value_type(element), field.name)
+	return "msg.%s" % field.name
+
+def at(name, offset):
+	return "%s.data()" % name if offset == 0 else "%s.data() + %d" % (name, offset)
+
+def local_name(element):
+	return "%s_%s" % (element.field.name, "size" if element.role == "prefix" else "value")
+
+class Generator(object):
+	def __init__(self, schema):
+		self.namespace = schema.get("namespace", "messages")
+		self.endian = schema.get("endian", "little")
+		self.lines = []
+
+		if self.endian not in ENDIANS:
+			raise SchemaError("unknown endian %r" % self.endian)
+
+		self.messages = []
+
+		for message in schema.get("messages", []):
+			name = message.get("name")
+
+			if not name or not name.isidentifier():
+				raise SchemaError("invalid message name: %r" % name)
+
+			fields = [Field(field, self.endian) for field in message.get("fields", [])]
+
+			if not fields:
+				raise SchemaError("%s: no fields" % name)
+
+			self.messages.append((name, fields))
+
+	def emit(self, line="", indent=0):
+		self.lines.append(("\t" * indent + line) if line else "")
+
+	def min_size(self, fields):
+		size = 0
+
+		for field in fields:
+			for element in field.elements():
+				if element.kind == "fixed":
+					size += element.size
+				elif element.kind in ("varint", "cstring"):
+					size += 1
+
+		return size
+
+	def generate(self):
+		self.lines = BANNER.splitlines()
+		self.emit()
+		self.emit("// Generated by tools/codegen/codegen.py, do not edit by hand.")
+		self.emit()
+		self.emit("#pragma once")
+		self.emit()
+
+		for include in ("<hexi/binary_stream.h>", "<hexi/buffer_adaptor.h>", "<hexi/endian.h>",
+		                "<array>", "<bit>", "<string>", "<vector>", "<cassert>", "<cstddef>",
+		                "<cstdint>", "<cstring>"):
+			self.emit("#include %s" % include)
+
+		self.emit()
+		self.emit("namespace %s {" % self.namespace)
+		self.emit()
+		self.generate_detail()
+
+		for name, fields in self.messages:
+			self.generate_message(name, fields)
+
+		self.emit("} // %s" % self.namespace)
+		return "\n".join(self.lines) + "\n"
+
+	def generate_detail(self):
+		self.emit("namespace detail {")
+		self.emit()
+		self.emit("inline std::size_t varint_size(std::uint64_t value) {")
+		self.emit("std::size_t size = 1;", 1)
+		self.emit()
+		self.emit("while(value > 0x7f) {", 1)
+		self.emit("value >>= 7;", 2)
+		self.emit("++size;", 2)
+		self.emit("}", 1)
+		self.emit()
+		self.emit("return size;", 1)
+		self.emit("}")
+		self.emit()
+		self.emit("// stages the encoding so that it can be written with a single call")
+		self.emit("template<typename stream_type>")
+		self.emit("void put_varint(stream_type& stream, std::uint64_t value) {")
+		self.emit("std::array<std::uint8_t, 10> encoded;", 1)
+		self.emit("std::size_t size = 0;", 1)
+		self.emit()
+		self.emit("while(value > 0x7f) {", 1)
+		self.emit("encoded[size++] = static_cast<std::uint8_t>(value & 0x7f) | 0x80;", 2)
+		self.emit("value >>= 7;", 2)
+		self.emit("}", 1)
+		self.emit()
+		self.emit("encoded[size++] = static_cast<std::uint8_t>(value);", 1)
+		self.emit("stream.put(encoded.data(), size);", 1)
+		self.emit("}")
+		self.emit()
+		self.emit("// raises the stream's usual error if fewer than count elements remain,")
+		self.emit("// without the multiplication being able to overflow on a corrupt count")
+		self.emit("template<typename stream_type>")
+		self.emit("bool ensure(stream_type& stream, const std::size_t count, const std::size_t size = 1) {")
+		self.emit("if(count > stream.size() / size) [[unlikely]] {", 1)
+		self.emit("stream.skip(stream.size() + 1);", 2)
+		self.emit("return false;", 2)
+		self.emit("}", 1)
+		self.emit()
+		self.emit("return static_cast<bool>(stream);", 1)
+		self.emit("}")
+		self.emit()
+		self.emit("} // detail")
+		self.emit()
+
+	def generate_message(self, name, fields):
+		elements = [element for field in fields for element in field.elements()]
+		parts = segments(elements)
+
+		self.emit("struct %s {" % name)
+
+		for field in fields:
+			init = "{}" if field.type in SCALARS or field.type == "bytes" else ""
+			self.emit("%s %s%s;" % (field.cpp_type(), field.name, init), 1)
+
+		self.emit()
+		self.emit("// smallest possible encoding, as checked before decoding", 1)
+		self.emit("static constexpr std::size_t min_size = %d;" % self.min_size(fields), 1)
+		self.emit()
+		self.emit("bool operator==(const %s&) const = default;" % name, 1)
+		self.emit("};")
+		self.emit()
+		self.generate_size(name, elements)
+		self.generate_encode(name, parts)
+		self.generate_decode(name, parts)
+		self.generate_encode_to(name)
+
+	def generate_size(self, name, elements):
+		fixed = sum(element.size for element in elements if element.kind == "fixed")
+		terms = ["%d" % fixed]
+
+		for element in elements:
+			field = element.field
+
+			if element.kind == "varint" and element.role == "prefix":
+				terms.append("detail::varint_size(msg.%s.size())" % field.name)
+			elif element.kind == "varint":
+				terms.append("detail::varint_size(msg.%s)" % field.name)
+			elif element.kind == "string":
+				terms.append("msg.%s.size()" % field.name)
+			elif element.kind == "cstring":
+				terms.append("msg.%s.size() + 1" % field.name)
+			elif element.kind == "array":
+				terms.append("msg.%s.size() * sizeof(%s)" % (field.name, SCALARS[field.of][0]))
+
+		self.emit("// the exact number of bytes that encode() will write")
+		param = "msg" if len(terms) > 1 else "/*msg*/"
+		self.emit("inline std::size_t encoded_size(const %s& %s) {" % (name, param))
+		self.emit("return %s;" % "\n\t\t+ ".join(terms), 1)
+		self.emit("}")
+		self.emit()
+
+	def generate_encode(self, name, parts):
+		self.emit("template<typename stream_type>")
+		self.emit("void encode(stream_type& stream, const %s& msg) {" % name)
+		first = True
+
+		for part in parts:
+			if not first:
+				self.emit()
+
+			first = False
+
+			if isinstance(part, list):
+				self.encode_segment(part)
+			else:
+				self.encode_element(part)
+
+		self.emit("}")
+		self.emit()
+
+	def encode_segment(self, segment):
+		size = sum(element.size for element in segment)
+		names = ", ".join(element.field.name + (" size" if element.role == "prefix" else "")
+		                  for element in segment)
+		self.emit("// %s" % names, 1)
+		self.emit("{", 1)
+		self.emit("std::array<char, %d> segment;" % size, 2)
+		offset = 0
+
+		for element in segment:
+			field = element.field
+
+			if element.role == "prefix":
+				limit = {"u8": "UINT8_MAX", "u16": "UINT16_MAX", "u32": "UINT32_MAX"}[field.prefix]
+				self.emit("assert(msg.%s.size() <= %s);" % (field.name, limit), 2)
+
+			if field.type == "bytes":
+				self.emit("std::memcpy(%s, msg.%s.data(), %d);"
+				          % (at("segment", offset), field.name, element.size), 2)
+			else:
+				convert = conversion(field.endian, "in") if element.size > 1 else None
+				expr = value_expr(element)
+
+				if convert:
+					expr = "%s(%s)" % (convert, expr)
+
+				local = local_name(element)
+				self.emit("const %s %s = %s;" % (value_type(element), local, expr), 2)
+				self.emit("std::memcpy(%s, &%s, %d);" % (at("segment", offset), local, element.size), 2)
+
+			offset += element.size
+
+		self.emit("stream.put(segment.data(), segment.size());", 2)
+		self.emit("}", 1)
+
+	def encode_element(self, element):
+		field = element.field
+
+		if element.kind == "varint":
+			if element.role == "prefix":
+				self.emit("detail::put_varint(stream, msg.%s.size());" % field.name, 1)
+			else:
+				self.emit("detail::put_varint(stream, msg.%s);" % field.name, 1)
+		elif element.kind == "string":
+			self.emit("stream.put(msg.%s.data(), msg.%s.size());" % (field.name, field.name), 1)
+		elif element.kind == "cstring":
+			self.emit("assert(msg.%s.find('\\0') == std::string::npos);" % field.name, 1)
+			self.emit("stream.put(msg.%s.c_str(), msg.%s.size() + 1);" % (field.name, field.name), 1)
+		elif element.kind == "array":
+			elem_size = SCALARS[field.of][1]
+			self.emit("if(!msg.%s.empty()) {" % field.name, 1)
+
+			if field.endian == "native" or elem_size == 1:
+				self.emit("stream.put(msg.%s.data(), msg.%s.size());" % (field.name, field.name), 2)
+			else:
+				self.emit("if constexpr(std::endian::native == std::endian::%s) {" % field.endian, 2)
+				self.emit("stream.put(msg.%s.data(), msg.%s.size());" % (field.name, field.name), 3)
+				self.emit("} else {", 2)
+				self.emit("for(const auto value : msg.%s) {" % field.name, 3)
+				self.emit("const auto converted = %s(value);" % conversion(field.endian, "in"), 4)
+				self.emit("stream.put(&converted, 1);", 4)
+				self.emit("}", 3)
+				self.emit("}", 2)
+
+			self.emit("}", 1)
+
+	def generate_decode(self, name, parts):
+		self.emit("template<typename stream_type>")
+		self.emit("void decode(stream_type& stream, %s& msg) {" % name)
+		self.emit("if(!detail::ensure(stream, %s::min_size)) {" % name, 1)
+		self.emit("return;", 2)
+		self.emit("}", 1)
+
+		for part in parts:
+			self.emit()
+
+			if isinstance(part, list):
+				self.decode_segment(part)
+			else:
+				self.decode_element(part)
+
+		self.emit("}")
+		self.emit()
+
+	def decode_segment(self, segment):
+		size = sum(element.size for element in segment)
+		self.emit("std::array<char, %d> %s;" % (size, self.segment_name(segment)), 1)
+		self.emit("stream.get(%s.data(), %d);" % (self.segment_name(segment), size), 1)
+		self.emit()
+		self.emit("if(!stream) {", 1)
+		self.emit("return;", 2)
+		self.emit("}", 1)
+		self.emit()
+		offset = 0
+
+		for element in segment:
+			field = element.field
+			segment_name = self.segment_name(segment)
+
+			if field.type == "bytes":
+				self.emit("std::memcpy(msg.%s.data(), %s, %d);"
+				          % (field.name, at(segment_name, offset), element.size), 1)
+			elif field.type == "bool":
+				self.emit("msg.%s = %s[%d] != 0;" % (field.name, segment_name, offset), 1)
+			else:
+				target = local_name(element) if element.role == "prefix" else "msg." + field.name
+
+				if element.role == "prefix":
+					self.emit("%s %s;" % (value_type(element), target), 1)
+
+				self.emit("std::memcpy(&%s, %s, %d);" % (target, at(segment_name, offset), element.size), 1)
+				convert = conversion(field.endian, "out") if element.size > 1 else None
+
+				if convert:
+					self.emit("%s = %s(%s);" % (target, convert, target), 1)
+
+			offset += element.size
+
+	def segment_name(self, segment):
+		element = segment[0]
+		return "%s_%s" % (element.field.name, "prefix" if element.role == "prefix" else "segment")
+
+	def decode_element(self, element):
+		field = element.field
+
+		if element.kind == "varint":
+			if element.role == "prefix":
+				self.emit("const auto %s = hexi::impl::varint_decode<std::size_t>(stream);" % local_name(element), 1)
+			else:
+				self.emit("msg.%s = hexi::impl::varint_decode<%s>(stream);" % (field.name, SCALARS[field.type][0]), 1)
+		elif element.kind == "string":
+			self.emit("stream.get(msg.%s, %s);" % (field.name, field.name + "_size"), 1)
+		elif element.kind == "cstring":
+			self.emit("stream >> hexi::null_terminated(msg.%s);" % field.name, 1)
+		elif element.kind == "array":
+			elem_type = SCALARS[field.of][0]
+			count = field.name + "_size"
+			# check before resizing, so a corrupt count can't trigger a huge allocation
+			self.emit("if(!detail::ensure(stream, %s, sizeof(%s))) {" % (count, elem_type), 1)
+			self.emit("return;", 2)
+			self.emit("}", 1)
+			self.emit()
+			self.emit("msg.%s.resize(%s);" % (field.name, count), 1)
+			self.emit()
+			self.emit("if(!msg.%s.empty()) {" % field.name, 1)
+			self.emit("stream.get(msg.%s.data(), msg.%s.size());" % (field.name, field.name), 2)
+
+			if field.endian != "native" and SCALARS[field.of][1] > 1:
+				self.emit()
+				self.emit("if constexpr(std::endian::native != std::endian::%s) {" % field.endian, 2)
+				self.emit("for(auto& value : msg.%s) {" % field.name, 3)
+				self.emit("value = %s(value);" % conversion(field.endian, "out"), 4)
+				self.emit("}", 3)
+				self.emit("}", 2)
+
+			self.emit("}", 1)
+
+		if element.kind == "varint":
+			self.emit()
+			self.emit("if(!stream) {", 1)
+			self.emit("return;", 2)
+			self.emit("}", 1)
+
+	def generate_encode_to(self, name):
+		self.emit("// appends the message to a contiguous container, reserving the exact space up front")
+		self.emit("template<typename container_type>")
+		self.emit("void encode_to(container_type& container, const %s& msg) {" % name)
+		self.emit("container.reserve(container.size() + encoded_size(msg));", 1)
+		self.emit("hexi::buffer_adaptor adaptor(container);", 1)
+		self.emit("hexi::binary_stream stream(adaptor);", 1)
+		self.emit("encode(stream, msg);", 1)
+		self.emit("}")
+		self.emit()
+
+def main():
+	parser = argparse.ArgumentParser(description="Generates binary_stream codecs from a message schema.")
+	parser.add_argument("-s", "--schema", required=True, help="path to the JSON schema")
+	parser.add_argument("-o", "--output", required=True, help="path of the header to write")
+	args = parser.parse_args()
+
+	with open(args.schema) as file:
+		schema = json.load(file)
+
+	try:
+		output = Generator(schema).generate()
+	except SchemaError as error:
+		print("%s: %s" % (args.schema, error), file=sys.stderr)
+		return 1
+
+	with open(args.output, "w") as file:
+		file.write(output)
+
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main())